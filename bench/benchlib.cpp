@@ -0,0 +1,287 @@
+
+#include "benchlib.hpp"
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+
+static std::atomic<std::size_t> tcmplxAbench_alloc_count(0u);
+static std::atomic<std::size_t> tcmplxAbench_alloc_bytes(0u);
+
+static
+void* tcmplxAbench_alloc(std::size_t sz) noexcept;
+static
+unsigned int tcmplxAbench_lcg(unsigned int& x);
+static
+void tcmplxAbench_put16(std::vector<unsigned char>& out, unsigned int v);
+static
+void tcmplxAbench_csv_text(std::ostream& out, std::string const& s);
+static
+void tcmplxAbench_json_text(std::ostream& out, std::string const& s);
+
+
+//BEGIN global allocation
+void* operator new(std::size_t sz) {
+  void* const p = tcmplxAbench_alloc(sz);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t sz) {
+  void* const p = tcmplxAbench_alloc(sz);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(std::size_t sz, std::nothrow_t const& ) noexcept {
+  return tcmplxAbench_alloc(sz);
+}
+
+void* operator new[](std::size_t sz, std::nothrow_t const& ) noexcept {
+  return tcmplxAbench_alloc(sz);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t ) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t ) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::nothrow_t const& ) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const& ) noexcept {
+  std::free(p);
+}
+//END   global allocation
+
+
+void* tcmplxAbench_alloc(std::size_t sz) noexcept {
+  tcmplxAbench_alloc_count.fetch_add(1u, std::memory_order_relaxed);
+  tcmplxAbench_alloc_bytes.fetch_add(sz, std::memory_order_relaxed);
+  return std::malloc(sz ? sz : 1u);
+}
+
+unsigned int tcmplxAbench_lcg(unsigned int& x) {
+  x = (x*1103515245u + 12345u)&0xFFffFFffu;
+  return (x>>16)&0x7FFFu;
+}
+
+void tcmplxAbench_put16(std::vector<unsigned char>& out, unsigned int v) {
+  out.push_back(static_cast<unsigned char>(v&255u));
+  out.push_back(static_cast<unsigned char>((v>>8)&255u));
+}
+
+tcmplxAbench_allocs tcmplxAbench_get_allocs(void) {
+  tcmplxAbench_allocs out;
+  out.count = tcmplxAbench_alloc_count.load(std::memory_order_relaxed);
+  out.bytes = tcmplxAbench_alloc_bytes.load(std::memory_order_relaxed);
+  return out;
+}
+
+double tcmplxAbench_now(void) {
+  std::chrono::duration<double> const t =
+    std::chrono::steady_clock::now().time_since_epoch();
+  return t.count();
+}
+
+char const* tcmplxAbench_corpus_name(int n) {
+  switch (n) {
+  case tcmplxAbench_Text: return "text";
+  case tcmplxAbench_Binary: return "binary";
+  case tcmplxAbench_Font: return "font";
+  case tcmplxAbench_Random: return "random";
+  case tcmplxAbench_Runs: return "runs";
+  default: return "?";
+  }
+}
+
+std::vector<unsigned char> tcmplxAbench_gen_corpus
+    (int n, std::size_t size, unsigned int seed)
+{
+  static char const* const words[] = {
+      "the", "of", "and", "to", "in", "a", "is", "that", "for", "it",
+      "as", "was", "with", "be", "by", "on", "not", "he", "this", "are",
+      "or", "his", "from", "at", "which", "but", "have", "an", "had",
+      "they", "you", "were", "their", "one", "all", "we", "can", "her",
+      "has", "there", "been", "if", "more", "when", "will", "would",
+      "who", "so", "no", "glyph", "table", "font", "stream", "window",
+      "compression", "dictionary", "sequence", "character", "outline"
+    };
+  static std::size_t const word_count = sizeof(words)/sizeof(words[0]);
+  std::vector<unsigned char> out;
+  unsigned int x = seed;
+  out.reserve(size+64u);
+  switch (n) {
+  case tcmplxAbench_Text:
+    {
+      std::size_t sentence = 0u;
+      while (out.size() < size) {
+        std::string const w = words[tcmplxAbench_lcg(x)%word_count];
+        if (sentence == 0u && !w.empty()) {
+          out.push_back(static_cast<unsigned char>(w[0]-'a'+'A'));
+          out.insert(out.end(), w.begin()+1, w.end());
+        } else out.insert(out.end(), w.begin(), w.end());
+        sentence += 1u;
+        if (sentence > 4u && tcmplxAbench_lcg(x)%8u == 0u) {
+          out.push_back('.');
+          out.push_back(tcmplxAbench_lcg(x)%4u ? ' ' : '\n');
+          sentence = 0u;
+        } else if (tcmplxAbench_lcg(x)%12u == 0u) {
+          out.push_back(',');
+          out.push_back(' ');
+        } else out.push_back(' ');
+      }
+    } break;
+  case tcmplxAbench_Binary:
+    {
+      unsigned int id = 0u;
+      unsigned int stamp = tcmplxAbench_lcg(x);
+      while (out.size() < size) {
+        /* 16-byte record: id, stamp, kind, value, checksum */
+        id += 1u;
+        stamp += tcmplxAbench_lcg(x)%64u;
+        tcmplxAbench_put16(out, id);
+        tcmplxAbench_put16(out, id>>16);
+        tcmplxAbench_put16(out, stamp);
+        tcmplxAbench_put16(out, stamp>>16);
+        tcmplxAbench_put16(out, tcmplxAbench_lcg(x)%6u);
+        tcmplxAbench_put16(out, tcmplxAbench_lcg(x)%1000u);
+        tcmplxAbench_put16(out, (id^stamp)&0xFFFFu);
+        tcmplxAbench_put16(out, 0u);
+      }
+    } break;
+  case tcmplxAbench_Font:
+    {
+      unsigned int offset = 0u;
+      while (out.size() < size) {
+        /* glyph-like record: header, flags, deltas, then a loca entry */
+        unsigned int const points = 4u + tcmplxAbench_lcg(x)%28u;
+        unsigned int i;
+        tcmplxAbench_put16(out, 1u);
+        tcmplxAbench_put16(out, tcmplxAbench_lcg(x)%64u);
+        tcmplxAbench_put16(out, tcmplxAbench_lcg(x)%64u);
+        tcmplxAbench_put16(out, 512u + tcmplxAbench_lcg(x)%512u);
+        tcmplxAbench_put16(out, 512u + tcmplxAbench_lcg(x)%512u);
+        tcmplxAbench_put16(out, points-1u);
+        for (i = 0u; i < points; ++i) {
+          out.push_back(static_cast<unsigned char>
+              (tcmplxAbench_lcg(x)%3u ? 0x37u : 0x01u));
+        }
+        for (i = 0u; i < points*2u; ++i) {
+          out.push_back(static_cast<unsigned char>(tcmplxAbench_lcg(x)%48u));
+        }
+        offset += points*3u + 12u;
+        tcmplxAbench_put16(out, offset>>1);
+      }
+    } break;
+  case tcmplxAbench_Random:
+    while (out.size() < size) {
+      unsigned int const v = tcmplxAbench_lcg(x) ^ (tcmplxAbench_lcg(x)<<7);
+      out.push_back(static_cast<unsigned char>(v&255u));
+    }
+    break;
+  case tcmplxAbench_Runs:
+    while (out.size() < size) {
+      unsigned int const v = tcmplxAbench_lcg(x)%16u;
+      std::size_t const len = 1u + tcmplxAbench_lcg(x)%300u;
+      out.insert(out.end(), len, static_cast<unsigned char>(v*17u));
+    }
+    break;
+  default:
+    break;
+  }
+  if (out.size() > size)
+    out.resize(size);
+  return out;
+}
+
+void tcmplxAbench_csv_text(std::ostream& out, std::string const& s) {
+  out << '"';
+  for (char const c : s) {
+    if (c == '"')
+      out << "\"\"";
+    else out << c;
+  }
+  out << '"';
+}
+
+void tcmplxAbench_json_text(std::ostream& out, std::string const& s) {
+  out << '"';
+  for (char const c : s) {
+    unsigned char const u = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\')
+      out << '\\' << c;
+    else if (u < 32u) {
+      char esc[8];
+      std::snprintf(esc, sizeof(esc), "\\u%04x", u);
+      out << esc;
+    } else out << c;
+  }
+  out << '"';
+}
+
+void tcmplxAbench_csv_header(std::ostream& out) {
+  out << "name,input,params,in_bytes,out_bytes,ratio,seconds,mb_per_s,"
+         "allocs,alloc_bytes,ok\n";
+}
+
+void tcmplxAbench_csv_line(std::ostream& out, tcmplxAbench_result const& r) {
+  double const ratio = r.in_size
+    ? static_cast<double>(r.out_size)/static_cast<double>(r.in_size) : 0.0;
+  double const speed = r.seconds > 0.0
+    ? static_cast<double>(r.in_size)/1048576.0/r.seconds : 0.0;
+  tcmplxAbench_csv_text(out, r.name);
+  out << ',';
+  tcmplxAbench_csv_text(out, r.input);
+  out << ',';
+  tcmplxAbench_csv_text(out, r.params);
+  out << ',' << r.in_size << ',' << r.out_size << ',' << ratio
+    << ',' << r.seconds << ',' << speed
+    << ',' << r.alloc_count << ',' << r.alloc_bytes
+    << ',' << (r.ok ? 1 : 0) << '\n';
+}
+
+void tcmplxAbench_json(std::ostream& out,
+    std::vector<tcmplxAbench_result> const& rs)
+{
+  std::size_t i;
+  out << "[\n";
+  for (i = 0u; i < rs.size(); ++i) {
+    tcmplxAbench_result const& r = rs[i];
+    double const ratio = r.in_size
+      ? static_cast<double>(r.out_size)/static_cast<double>(r.in_size) : 0.0;
+    double const speed = r.seconds > 0.0
+      ? static_cast<double>(r.in_size)/1048576.0/r.seconds : 0.0;
+    out << "  {\"name\": ";
+    tcmplxAbench_json_text(out, r.name);
+    out << ", \"input\": ";
+    tcmplxAbench_json_text(out, r.input);
+    out << ", \"params\": ";
+    tcmplxAbench_json_text(out, r.params);
+    out << ", \"in_bytes\": " << r.in_size
+      << ", \"out_bytes\": " << r.out_size
+      << ", \"ratio\": " << ratio
+      << ", \"seconds\": " << r.seconds
+      << ", \"mb_per_s\": " << speed
+      << ", \"allocs\": " << r.alloc_count
+      << ", \"alloc_bytes\": " << r.alloc_bytes
+      << ", \"ok\": " << (r.ok ? "true" : "false")
+      << (i+1u < rs.size() ? "},\n" : "}\n");
+  }
+  out << "]\n";
+}
@@ -0,0 +1,144 @@
+/**
+ * @file bench/benchlib.hpp
+ * @brief Shared timing, corpus and report support for the benchmarks.
+ */
+#ifndef hg_TCMPLXAP_BENCHLIB_Hpp_
+#define hg_TCMPLXAP_BENCHLIB_Hpp_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <ostream>
+
+/**
+ * @brief Kinds of generated corpus data.
+ */
+enum tcmplxAbench_corpus {
+  /** @brief English-like words and punctuation. */
+  tcmplxAbench_Text = 0,
+  /** @brief Fixed-size little-endian records with slowly changing fields. */
+  tcmplxAbench_Binary = 1,
+  /** @brief Font-table-like data: flags, small coordinate deltas, offsets. */
+  tcmplxAbench_Font = 2,
+  /** @brief Uniform pseudorandom bytes. */
+  tcmplxAbench_Random = 3,
+  /** @brief Runs of repeated bytes with varying lengths. */
+  tcmplxAbench_Runs = 4,
+  tcmplxAbench_MAX
+};
+
+/**
+ * @brief Allocation counters, updated by the replacement global
+ *   `operator new` in the benchmark program.
+ * @note Allocations made inside a shared library build on some
+ *   platforms bypass the replacement and go uncounted.
+ */
+struct tcmplxAbench_allocs {
+  std::size_t count;
+  std::size_t bytes;
+};
+
+/**
+ * @brief One benchmark measurement.
+ */
+struct tcmplxAbench_result {
+  /** @brief benchmark name, such as `zcvt` or `hash_chain::find` */
+  std::string name;
+  /** @brief input name, such as a corpus kind or file name */
+  std::string input;
+  /** @brief free-form parameter list, as `key=value` pairs */
+  std::string params;
+  /** @brief bytes (or items) processed per run */
+  std::size_t in_size;
+  /** @brief bytes produced per run, or zero if not applicable */
+  std::size_t out_size;
+  /** @brief best time per run, in seconds */
+  double seconds;
+  /** @brief allocations per run */
+  std::size_t alloc_count;
+  /** @brief bytes allocated per run */
+  std::size_t alloc_bytes;
+  /** @brief whether the output checked out */
+  bool ok;
+};
+
+/**
+ * @return the name of a corpus kind
+ * @param n a @link tcmplxAbench_corpus @endlink value
+ */
+char const* tcmplxAbench_corpus_name(int n);
+
+/**
+ * @brief Generate corpus data.
+ * @param n a @link tcmplxAbench_corpus @endlink value
+ * @param size number of bytes to generate
+ * @param seed generator seed
+ * @return the generated bytes
+ * @note The output depends only on the parameters, so the same
+ *   corpus is produced on every platform and in every release.
+ */
+std::vector<unsigned char> tcmplxAbench_gen_corpus
+    (int n, std::size_t size, unsigned int seed);
+
+/**
+ * @brief Read the current allocation counters.
+ * @return the counters
+ */
+tcmplxAbench_allocs tcmplxAbench_get_allocs(void);
+
+/**
+ * @brief Read a monotonic clock.
+ * @return a time in seconds
+ */
+double tcmplxAbench_now(void);
+
+/**
+ * @brief Run a function repeatedly, keeping the best time.
+ * @param repeat number of runs
+ * @param f function to run; returns whether the run succeeded
+ * @param[out] r time and allocation fields to fill
+ * @return whether every run succeeded
+ */
+template <typename Fn>
+bool tcmplxAbench_time(unsigned int repeat, Fn f, tcmplxAbench_result& r) {
+  unsigned int i;
+  bool ok = true;
+  r.seconds = 0.0;
+  r.alloc_count = 0u;
+  r.alloc_bytes = 0u;
+  for (i = 0u; i < repeat; ++i) {
+    tcmplxAbench_allocs const a0 = tcmplxAbench_get_allocs();
+    double const t0 = tcmplxAbench_now();
+    ok = f() && ok;
+    double const t1 = tcmplxAbench_now();
+    tcmplxAbench_allocs const a1 = tcmplxAbench_get_allocs();
+    if (i == 0u || t1-t0 < r.seconds)
+      r.seconds = t1-t0;
+    r.alloc_count = a1.count-a0.count;
+    r.alloc_bytes = a1.bytes-a0.bytes;
+  }
+  return ok;
+}
+
+/**
+ * @brief Write the CSV header line.
+ * @param out stream to write
+ */
+void tcmplxAbench_csv_header(std::ostream& out);
+
+/**
+ * @brief Write a result as one CSV line.
+ * @param out stream to write
+ * @param r result to write
+ */
+void tcmplxAbench_csv_line(std::ostream& out, tcmplxAbench_result const& r);
+
+/**
+ * @brief Write a list of results as a JSON array.
+ * @param out stream to write
+ * @param rs results to write
+ */
+void tcmplxAbench_json(std::ostream& out,
+    std::vector<tcmplxAbench_result> const& rs);
+
+#endif /*hg_TCMPLXAP_BENCHLIB_Hpp_*/
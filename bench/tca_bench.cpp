@@ -0,0 +1,365 @@
+
+#include "benchlib.hpp"
+#include <text-complex-plus/access/zcvt.hpp>
+#include <text-complex-plus/access/brcvt.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+/**
+ * @brief Benchmark settings.
+ */
+struct bench_options {
+  std::size_t corpus_size;
+  unsigned int repeat;
+  unsigned int seed;
+  bool json;
+  bool quick;
+  std::string codec;
+  std::string ofilename;
+  std::vector<std::string> files;
+};
+
+/**
+ * @brief One point of the parameter sweep.
+ */
+struct bench_params {
+  tca::uint32 block_size;
+  tca::uint32 window;
+  std::size_t chain_length;
+};
+
+/**
+ * @brief Compressor and decompressor pair for one codec.
+ */
+struct bench_codec {
+  char const* name;
+  bool (*compress)(bench_params const& ,
+      std::vector<unsigned char> const& , std::vector<unsigned char>& );
+  bool (*decompress)(bench_params const& ,
+      std::vector<unsigned char> const& , std::vector<unsigned char>& );
+  /** @brief sweep of parameters to try */
+  std::vector<bench_params> sweep;
+};
+
+/**
+ * @brief Bytes of output space handed to each conversion call.
+ */
+static std::size_t const bench_chunk = 65536u;
+
+template <typename State,
+  tca::api_error (*Convert)(State&,
+    unsigned char const*, unsigned char const*, unsigned char const*&,
+    unsigned char*, unsigned char*, unsigned char*&),
+  tca::api_error (*Unshift)(State&,
+    unsigned char*, unsigned char*, unsigned char*&)>
+static
+bool bench_run_out(State& state, std::vector<unsigned char> const& in,
+    std::vector<unsigned char>& out)
+{
+  unsigned char const* src = in.data();
+  unsigned char const* const src_end = src+in.size();
+  out.clear();
+  while (src < src_end) {
+    std::size_t const pos = out.size();
+    unsigned char* dst;
+    out.resize(pos+bench_chunk);
+    tca::api_error const res = Convert
+      (state, src, src_end, src, &out[pos], &out[pos]+bench_chunk, dst);
+    out.resize(static_cast<std::size_t>(dst-out.data()));
+    if (res < tca::api_error::Success)
+      return false;
+  }
+  for (;;) {
+    std::size_t const pos = out.size();
+    unsigned char* dst;
+    out.resize(pos+bench_chunk);
+    tca::api_error const res =
+      Unshift(state, &out[pos], &out[pos]+bench_chunk, dst);
+    out.resize(static_cast<std::size_t>(dst-out.data()));
+    if (res < tca::api_error::Success)
+      return false;
+    else if (res == tca::api_error::EndOfFile)
+      return true;
+  }
+}
+
+template <typename State,
+  tca::api_error (*Convert)(State&,
+    unsigned char const*, unsigned char const*, unsigned char const*&,
+    unsigned char*, unsigned char*, unsigned char*&)>
+static
+bool bench_run_in(State& state, std::vector<unsigned char> const& in,
+    std::vector<unsigned char>& out)
+{
+  unsigned char const* src = in.data();
+  unsigned char const* const src_end = src+in.size();
+  out.clear();
+  while (src < src_end) {
+    std::size_t const pos = out.size();
+    unsigned char* dst;
+    out.resize(pos+bench_chunk);
+    tca::api_error const res = Convert
+      (state, src, src_end, src, &out[pos], &out[pos]+bench_chunk, dst);
+    out.resize(static_cast<std::size_t>(dst-out.data()));
+    if (res < tca::api_error::Success)
+      return false;
+    else if (res == tca::api_error::EndOfFile)
+      break;
+  }
+  return true;
+}
+
+static
+bool bench_zcvt_out(bench_params const& p,
+    std::vector<unsigned char> const& in, std::vector<unsigned char>& out)
+{
+  tca::zcvt_state state(p.block_size, p.window, p.chain_length);
+  return bench_run_out<tca::zcvt_state, tca::zcvt_out, tca::zcvt_unshift>
+    (state, in, out);
+}
+
+static
+bool bench_zcvt_in(bench_params const& ,
+    std::vector<unsigned char> const& in, std::vector<unsigned char>& out)
+{
+  tca::zcvt_state state(1u, 32768u, 1u);
+  return bench_run_in<tca::zcvt_state, tca::zcvt_in>(state, in, out);
+}
+
+static
+bool bench_brcvt_out(bench_params const& p,
+    std::vector<unsigned char> const& in, std::vector<unsigned char>& out)
+{
+  tca::brcvt_state state(p.block_size, p.window, p.chain_length);
+  return bench_run_out<tca::brcvt_state, tca::brcvt_out, tca::brcvt_unshift>
+    (state, in, out);
+}
+
+static
+bool bench_brcvt_in(bench_params const& p,
+    std::vector<unsigned char> const& in, std::vector<unsigned char>& out)
+{
+  tca::brcvt_state state(1u, p.window, 1u);
+  return bench_run_in<tca::brcvt_state, tca::brcvt_in>(state, in, out);
+}
+
+static
+std::vector<bench_params> bench_sweep
+  ( std::vector<tca::uint32> const& blocks,
+    std::vector<tca::uint32> const& windows,
+    std::vector<std::size_t> const& chains)
+{
+  std::vector<bench_params> out;
+  for (tca::uint32 const b : blocks) {
+    for (tca::uint32 const w : windows) {
+      for (std::size_t const c : chains) {
+        bench_params const p = {b, w, c};
+        out.push_back(p);
+      }
+    }
+  }
+  return out;
+}
+
+static
+std::string bench_param_text(bench_params const& p) {
+  std::ostringstream s;
+  s << "block=" << p.block_size << ";window=" << p.window
+    << ";chain=" << p.chain_length;
+  return s.str();
+}
+
+static
+void bench_codec_input(bench_options const& opts, bench_codec const& codec,
+    std::string const& input_name, std::vector<unsigned char> const& data,
+    std::vector<tcmplxAbench_result>& results, std::ostream* csv)
+{
+  for (bench_params const& p : codec.sweep) {
+    std::vector<unsigned char> packed;
+    std::vector<unsigned char> unpacked;
+    tcmplxAbench_result out_r;
+    tcmplxAbench_result in_r;
+    bool ok;
+    out_r.name = std::string(codec.name) + "/compress";
+    out_r.input = input_name;
+    out_r.params = bench_param_text(p);
+    out_r.in_size = data.size();
+    out_r.ok = tcmplxAbench_time(opts.repeat,
+        [&]{ return codec.compress(p, data, packed); }, out_r);
+    out_r.out_size = packed.size();
+    in_r.name = std::string(codec.name) + "/decompress";
+    in_r.input = input_name;
+    in_r.params = out_r.params;
+    in_r.in_size = data.size();
+    ok = out_r.ok && tcmplxAbench_time(opts.repeat,
+        [&]{ return codec.decompress(p, packed, unpacked); }, in_r);
+    in_r.out_size = unpacked.size();
+    in_r.ok = ok && unpacked == data;
+    if (csv) {
+      tcmplxAbench_csv_line(*csv, out_r);
+      tcmplxAbench_csv_line(*csv, in_r);
+      csv->flush();
+    }
+    results.push_back(out_r);
+    results.push_back(in_r);
+  }
+}
+
+static
+bool bench_read_file(std::string const& name, std::vector<unsigned char>& out)
+{
+  std::ifstream f(name.c_str(), std::ios_base::in | std::ios_base::binary);
+  if (!f)
+    return false;
+  out.assign(std::istreambuf_iterator<char>(f),
+      std::istreambuf_iterator<char>());
+  return !f.bad();
+}
+
+static
+void bench_usage(void) {
+  std::cerr << "usage: tcmplx_access_plus_bench [options] [files...]\n"
+    "  --codec name  zcvt, brcvt or all (default all)\n"
+    "  --size n      bytes of each generated corpus (default 1048576)\n"
+    "  --repeat n    runs per measurement; the best is kept (default 3)\n"
+    "  --seed n      corpus generator seed (default 1)\n"
+    "  --quick       use a reduced parameter sweep\n"
+    "  --json        write JSON instead of CSV\n"
+    "  -o file       write results to a file instead of standard output\n"
+    "Files given on the command line are benchmarked after the"
+    " generated corpus." << std::endl;
+}
+
+static
+bool bench_parse_args(bench_options& opts, int argc, char** argv) {
+  int i;
+  opts.corpus_size = 1048576u;
+  opts.repeat = 3u;
+  opts.seed = 1u;
+  opts.json = false;
+  opts.quick = false;
+  opts.codec = "all";
+  for (i = 1; i < argc; ++i) {
+    char const* const arg = argv[i];
+    unsigned long value = 0u;
+    bool const numeric = (std::strcmp(arg, "--size") == 0
+      || std::strcmp(arg, "--repeat") == 0
+      || std::strcmp(arg, "--seed") == 0);
+    if (numeric || std::strcmp(arg, "--codec") == 0
+    ||  std::strcmp(arg, "-o") == 0)
+    {
+      if (i+1 >= argc)
+        return false;
+      if (numeric) {
+        char* end;
+        value = std::strtoul(argv[i+1], &end, 0);
+        if (*end != 0)
+          return false;
+      }
+    }
+    if (std::strcmp(arg, "--size") == 0) {
+      opts.corpus_size = value;
+      ++i;
+    } else if (std::strcmp(arg, "--repeat") == 0) {
+      if (value == 0u)
+        return false;
+      opts.repeat = static_cast<unsigned int>(value);
+      ++i;
+    } else if (std::strcmp(arg, "--seed") == 0) {
+      opts.seed = static_cast<unsigned int>(value);
+      ++i;
+    } else if (std::strcmp(arg, "--codec") == 0) {
+      opts.codec = argv[++i];
+    } else if (std::strcmp(arg, "-o") == 0) {
+      opts.ofilename = argv[++i];
+    } else if (std::strcmp(arg, "--json") == 0) {
+      opts.json = true;
+    } else if (std::strcmp(arg, "--quick") == 0) {
+      opts.quick = true;
+    } else if (arg[0] == '-') {
+      return false;
+    } else opts.files.push_back(arg);
+  }
+  return opts.codec == "all" || opts.codec == "zcvt"
+    || opts.codec == "brcvt";
+}
+
+int main(int argc, char** argv) {
+  bench_options opts;
+  std::vector<bench_codec> codecs;
+  std::vector<tcmplxAbench_result> results;
+  std::ofstream ofile;
+  std::ostream* out = &std::cout;
+  std::ostream* csv = nullptr;
+  if (!bench_parse_args(opts, argc, argv)) {
+    bench_usage();
+    return EXIT_FAILURE;
+  }
+  if (!opts.ofilename.empty()) {
+    ofile.open(opts.ofilename.c_str());
+    if (!ofile) {
+      std::cerr << "failed to open output file" << std::endl;
+      return EXIT_FAILURE;
+    }
+    out = &ofile;
+  }
+  if (opts.codec != "brcvt") {
+    bench_codec const z = {
+        "zcvt", bench_zcvt_out, bench_zcvt_in,
+        opts.quick
+          ? bench_sweep({16384u}, {32768u}, {16u, 256u})
+          : bench_sweep({4096u, 16384u, 65535u}, {4096u, 32768u},
+              {16u, 256u, 1024u})
+      };
+    codecs.push_back(z);
+  }
+  if (opts.codec != "zcvt") {
+    bench_codec const br = {
+        "brcvt", bench_brcvt_out, bench_brcvt_in,
+        opts.quick
+          ? bench_sweep({32768u}, {32768u}, {16u, 256u})
+          : bench_sweep({4096u, 16384u, 32768u}, {32768u, 1048560u},
+              {16u, 256u, 1024u})
+      };
+    codecs.push_back(br);
+  }
+  if (!opts.json) {
+    /* stream CSV lines as they finish */
+    csv = out;
+    tcmplxAbench_csv_header(*csv);
+  }
+  int n;
+  for (n = 0; n < tcmplxAbench_MAX; ++n) {
+    std::vector<unsigned char> const data =
+      tcmplxAbench_gen_corpus(n, opts.corpus_size, opts.seed);
+    for (bench_codec const& codec : codecs) {
+      bench_codec_input(opts, codec, tcmplxAbench_corpus_name(n), data,
+        results, csv);
+    }
+  }
+  for (std::string const& name : opts.files) {
+    std::vector<unsigned char> data;
+    if (!bench_read_file(name, data)) {
+      std::cerr << "failed to read " << name << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (bench_codec const& codec : codecs) {
+      bench_codec_input(opts, codec, name, data, results, csv);
+    }
+  }
+  if (opts.json)
+    tcmplxAbench_json(*out, results);
+  out->flush();
+  for (tcmplxAbench_result const& r : results) {
+    if (!r.ok)
+      return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,448 @@
+
+#include "benchlib.hpp"
+#include <text-complex-plus/access/hashchain.hpp>
+#include <text-complex-plus/access/ringslide.hpp>
+#include <text-complex-plus/access/fixlist.hpp>
+#include <text-complex-plus/access/inscopy.hpp>
+#include <text-complex-plus/access/ctxtspan.hpp>
+#include <text-complex-plus/access/bdict.hpp>
+#include <text-complex-plus/access/zutil.hpp>
+#include <text-complex-plus/access/seq.hpp>
+#include <text-complex-plus/access/sfnt.hpp>
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+/**
+ * @brief Keeps benchmark results alive past the optimizer.
+ */
+static volatile unsigned long micro_sink = 0u;
+
+/**
+ * @brief Benchmark run settings and collected results.
+ */
+struct micro_run {
+  unsigned int repeat;
+  bool json;
+  bool quick;
+  std::string filter;
+  std::string ofilename;
+  std::ostream* csv;
+  std::vector<tcmplxAbench_result> results;
+
+  /**
+   * @brief Measure one case.
+   * @param name benchmark name
+   * @param params parameter text
+   * @param items items processed per run
+   * @param f function to run; returns whether the run succeeded
+   */
+  template <typename Fn>
+  void add(char const* name, std::string const& params,
+      std::size_t items, Fn f)
+  {
+    tcmplxAbench_result r;
+    r.name = name;
+    r.input = "generated";
+    r.params = params;
+    r.in_size = items;
+    r.out_size = 0u;
+    r.ok = tcmplxAbench_time(repeat, f, r);
+    if (csv) {
+      tcmplxAbench_csv_line(*csv, r);
+      csv->flush();
+    }
+    results.push_back(r);
+  }
+};
+
+/**
+ * @brief Entry in the benchmark table.
+ */
+struct micro_entry {
+  char const* name;
+  void (*fn)(micro_run& );
+};
+
+static
+std::string micro_param(char const* k1, std::size_t v1,
+    char const* k2 = nullptr, std::size_t v2 = 0u)
+{
+  std::ostringstream s;
+  s << k1 << '=' << v1;
+  if (k2)
+    s << ';' << k2 << '=' << v2;
+  return s.str();
+}
+
+static
+void micro_hash_chain(micro_run& run) {
+  std::size_t const count = run.quick ? 262144u : 1048576u;
+  std::vector<unsigned char> const data =
+    tcmplxAbench_gen_corpus(tcmplxAbench_Text, count+2u, 1u);
+  tca::uint32 const windows[] = {4096u, 32768u, 1048576u};
+  std::size_t const chains[] = {16u, 256u, 1024u};
+  for (tca::uint32 const w : windows) {
+    run.add("hash_chain::push_front", micro_param("window", w), count, [&]{
+        tca::hash_chain chain(w, 256u);
+        std::size_t i;
+        for (i = 0u; i < count; ++i)
+          chain.push_front(data[i]);
+        micro_sink += chain.size();
+        return true;
+      });
+    for (std::size_t const c : chains) {
+      tca::hash_chain chain(w, c);
+      std::size_t i;
+      for (i = 0u; i < w && i < count; ++i)
+        chain.push_front(data[i]);
+      std::size_t const finds = run.quick ? 16384u : 65536u;
+      run.add("hash_chain::find", micro_param("window", w, "chain", c),
+        finds, [&]{
+          std::size_t j;
+          unsigned long total = 0u;
+          for (j = 0u; j < finds; ++j)
+            total += chain.find(&data[(j*7919u)%count]);
+          micro_sink += total;
+          return true;
+        });
+    }
+  }
+}
+
+static
+void micro_slide_ring(micro_run& run) {
+  std::size_t const count = run.quick ? 262144u : 1048576u;
+  std::vector<unsigned char> const data =
+    tcmplxAbench_gen_corpus(tcmplxAbench_Binary, count, 2u);
+  tca::uint32 const windows[] = {4096u, 32768u, 1048576u, 16777216u};
+  for (tca::uint32 const w : windows) {
+    run.add("slide_ring::push_front", micro_param("window", w), count, [&]{
+        tca::slide_ring ring(w);
+        std::size_t i;
+        for (i = 0u; i < count; ++i)
+          ring.push_front(data[i]);
+        micro_sink += ring.size();
+        return true;
+      });
+    tca::slide_ring ring(w);
+    std::size_t i;
+    for (i = 0u; i < w && i < count; ++i)
+      ring.push_front(data[i]);
+    tca::uint32 const filled = ring.size();
+    run.add("slide_ring::operator[]", micro_param("window", w), count, [&]{
+        std::size_t j;
+        unsigned long total = 0u;
+        for (j = 0u; j < count; ++j)
+          total += ring[static_cast<tca::uint32>((j*7919u)%filled)];
+        micro_sink += total;
+        return true;
+      });
+  }
+}
+
+static
+void micro_fixlist(micro_run& run) {
+  std::size_t const sizes[] = {19u, 64u, 286u, 704u};
+  std::size_t const rounds = run.quick ? 256u : 1024u;
+  for (std::size_t const n : sizes) {
+    tca::prefix_histogram histogram(n);
+    tca::prefix_list list(n);
+    std::size_t i;
+    unsigned int const max_bits = (n <= 19u) ? 7u : 15u;
+    for (i = 0u; i < n; ++i) {
+      /* skewed counts, roughly Zipf-like */
+      histogram[i] = static_cast<tca::uint32>(65536u/(i+1u) + (i%3u));
+    }
+    run.add("fixlist_gen_lengths", micro_param("symbols", n), rounds, [&]{
+        std::size_t j;
+        tca::api_error ae = tca::api_error::Success;
+        for (j = 0u; j < rounds && ae == tca::api_error::Success; ++j)
+          tca::fixlist_gen_lengths(list, histogram, max_bits, ae);
+        return ae == tca::api_error::Success;
+      });
+    run.add("fixlist_gen_codes", micro_param("symbols", n), rounds, [&]{
+        std::size_t j;
+        tca::api_error ae = tca::api_error::Success;
+        for (j = 0u; j < rounds && ae == tca::api_error::Success; ++j)
+          tca::fixlist_gen_codes(list, ae);
+        return ae == tca::api_error::Success;
+      });
+    tca::fixlist_codesort(list);
+    std::size_t const searches = rounds*64u;
+    run.add("fixlist_codebsearch", micro_param("symbols", n), searches, [&]{
+        std::size_t j;
+        bool ok = true;
+        for (j = 0u; j < searches; ++j) {
+          tca::prefix_line const& line = list[(j*7919u)%n];
+          if (line.len == 0u)
+            continue;
+          ok = (tca::fixlist_codebsearch(list, line.len, line.code) < n)
+            && ok;
+        }
+        return ok;
+      });
+  }
+}
+
+static
+void micro_inscopy(micro_run& run) {
+  std::size_t const count = run.quick ? 262144u : 1048576u;
+  struct {
+    tca::insert_copy_preset preset;
+    char const* name;
+    /* DEFLATE length codes carry no insert length */
+    unsigned long insert_max;
+    unsigned long copy_max;
+  } const tables[] = {
+    { tca::insert_copy_preset::Deflate, "deflate", 1u, 258u },
+    { tca::insert_copy_preset::BrotliIC, "brotli_ic", 1024u, 1024u }
+  };
+  for (auto const& t : tables) {
+    tca::insert_copy_table ict;
+    tca::inscopy_preset(ict, t.preset);
+    tca::inscopy_lengthsort(ict);
+    std::ostringstream params;
+    params << "table=" << t.name;
+    run.add("inscopy_encode", params.str(), count, [&]{
+        std::size_t j;
+        bool ok = true;
+        for (j = 0u; j < count; ++j) {
+          unsigned long const i = (j*31u)%t.insert_max;
+          unsigned long const c = 3u + (j*17u)%(t.copy_max-2u);
+          ok = (tca::inscopy_encode(ict, i, c) < ict.size()) && ok;
+        }
+        return ok;
+      });
+  }
+}
+
+static
+void micro_ctxtspan(micro_run& run) {
+  std::size_t const sizes[] = {1024u, 16384u, 65536u, 1048576u};
+  for (std::size_t const n : sizes) {
+    std::vector<unsigned char> const data =
+      tcmplxAbench_gen_corpus(tcmplxAbench_Font, n, 3u);
+    std::size_t const rounds = (run.quick ? 1048576u : 4194304u)/n;
+    run.add("ctxtspan_subdivide", micro_param("bytes", n), rounds*n, [&]{
+        std::size_t j;
+        for (j = 0u; j < rounds; ++j) {
+          tca::context_span spans = {};
+          tca::ctxtspan_subdivide(spans, data.data(), data.size(), 16u);
+          micro_sink += spans.count;
+        }
+        return true;
+      });
+  }
+}
+
+static
+void micro_bdict(micro_run& run) {
+  std::size_t const rounds = run.quick ? 4u : 16u;
+  std::size_t words = 0u;
+  unsigned int j;
+  for (j = 0u; j <= 24u; ++j)
+    words += tca::bdict_word_count(j);
+  run.add("bdict_get_word", micro_param("words", words), words*rounds, [&]{
+      std::size_t r;
+      unsigned long total = 0u;
+      for (r = 0u; r < rounds; ++r) {
+        unsigned int len;
+        for (len = 0u; len <= 24u; ++len) {
+          unsigned int const n = tca::bdict_word_count(len);
+          unsigned int i;
+          for (i = 0u; i < n; ++i)
+            total += tca::bdict_get_word(len, i).size();
+        }
+      }
+      micro_sink += total;
+      return true;
+    });
+  for (unsigned int len = 4u; len <= 24u; len += 10u) {
+    unsigned int const n = tca::bdict_word_count(len);
+    std::size_t const transforms = n*121u;
+    run.add("bdict_transform", micro_param("length", len), transforms, [&]{
+        unsigned int i;
+        unsigned long total = 0u;
+        tca::api_error ae = tca::api_error::Success;
+        for (i = 0u; i < n && ae == tca::api_error::Success; ++i) {
+          unsigned int k;
+          for (k = 0u; k < 121u; ++k) {
+            tca::bdict_word word = tca::bdict_get_word(len, i);
+            tca::bdict_transform(word, k, ae);
+            total += word.size();
+          }
+        }
+        micro_sink += total;
+        return ae == tca::api_error::Success;
+      });
+  }
+}
+
+static
+void micro_zutil(micro_run& run) {
+  std::size_t const sizes[] = {64u, 4096u, 65536u, 1048576u};
+  for (std::size_t const n : sizes) {
+    std::vector<unsigned char> const data =
+      tcmplxAbench_gen_corpus(tcmplxAbench_Random, n, 4u);
+    std::size_t const rounds = (run.quick ? 16777216u : 67108864u)/n;
+    run.add("zutil_adler32", micro_param("bytes", n), rounds*n, [&]{
+        std::size_t j;
+        tca::uint32 chk = 1u;
+        for (j = 0u; j < rounds; ++j)
+          chk = tca::zutil_adler32(data.size(), data.data(), chk);
+        micro_sink += chk;
+        return true;
+      });
+  }
+}
+
+static
+void micro_sequential(micro_run& run) {
+  std::size_t const sizes[] = {4096u, 1048576u, 16777216u};
+  for (std::size_t const n : sizes) {
+    if (run.quick && n > 1048576u)
+      break;
+    std::vector<unsigned char> const data =
+      tcmplxAbench_gen_corpus(tcmplxAbench_Binary, n, 5u);
+    std::unique_ptr<mmaptwo::mmaptwo_i> const fh(
+        mmaptwo::memopen(data.data(), data.size()));
+    std::size_t const rounds = n < 1048576u ? 1048576u/n : 1u;
+    run.add("sequential::get_byte", micro_param("bytes", n), rounds*n, [&]{
+        std::size_t j;
+        unsigned long total = 0u;
+        for (j = 0u; j < rounds; ++j) {
+          tca::sequential seq(fh.get());
+          int ch;
+          while ((ch = seq.get_byte()) >= 0)
+            total += static_cast<unsigned int>(ch);
+        }
+        micro_sink += total;
+        return true;
+      });
+  }
+}
+
+static
+void micro_checksum(micro_run& run) {
+  std::size_t const sizes[] = {4096u, 65536u, 1048576u};
+  for (std::size_t const n : sizes) {
+    std::vector<unsigned char> const data =
+      tcmplxAbench_gen_corpus(tcmplxAbench_Font, n, 6u);
+    std::size_t const rounds = (run.quick ? 16777216u : 67108864u)/n;
+    run.add("sfnt_checksum", micro_param("bytes", n), rounds*n, [&]{
+        std::size_t j;
+        unsigned long total = 0u;
+        for (j = 0u; j < rounds; ++j)
+          total += tca::sfnt_checksum(data.data(), data.size(), j);
+        micro_sink += total;
+        return true;
+      });
+  }
+}
+
+static
+void micro_usage(micro_entry const* entries, std::size_t n) {
+  std::size_t i;
+  std::cerr << "usage: tcmplx_access_plus_microbench [options]\n"
+    "  --filter s    run only benchmarks whose group contains `s`\n"
+    "  --repeat n    runs per measurement; the best is kept (default 5)\n"
+    "  --quick       use smaller sizes\n"
+    "  --json        write JSON instead of CSV\n"
+    "  -o file       write results to a file instead of standard output\n"
+    "groups:";
+  for (i = 0u; i < n; ++i)
+    std::cerr << ' ' << entries[i].name;
+  std::cerr << std::endl;
+}
+
+static
+bool micro_parse_args(micro_run& run, int argc, char** argv) {
+  int i;
+  run.repeat = 5u;
+  run.json = false;
+  run.quick = false;
+  run.csv = nullptr;
+  for (i = 1; i < argc; ++i) {
+    char const* const arg = argv[i];
+    if (std::strcmp(arg, "--filter") == 0 || std::strcmp(arg, "-o") == 0
+    ||  std::strcmp(arg, "--repeat") == 0)
+    {
+      if (i+1 >= argc)
+        return false;
+    }
+    if (std::strcmp(arg, "--filter") == 0) {
+      run.filter = argv[++i];
+    } else if (std::strcmp(arg, "-o") == 0) {
+      run.ofilename = argv[++i];
+    } else if (std::strcmp(arg, "--repeat") == 0) {
+      char* end;
+      unsigned long const value = std::strtoul(argv[++i], &end, 0);
+      if (*end != 0 || value == 0u)
+        return false;
+      run.repeat = static_cast<unsigned int>(value);
+    } else if (std::strcmp(arg, "--json") == 0) {
+      run.json = true;
+    } else if (std::strcmp(arg, "--quick") == 0) {
+      run.quick = true;
+    } else return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  static micro_entry const entries[] = {
+      { "hash_chain", micro_hash_chain },
+      { "slide_ring", micro_slide_ring },
+      { "fixlist", micro_fixlist },
+      { "inscopy", micro_inscopy },
+      { "ctxtspan", micro_ctxtspan },
+      { "bdict", micro_bdict },
+      { "zutil", micro_zutil },
+      { "sequential", micro_sequential },
+      { "checksum", micro_checksum }
+    };
+  static std::size_t const entry_count = sizeof(entries)/sizeof(entries[0]);
+  micro_run run;
+  std::ofstream ofile;
+  std::ostream* out = &std::cout;
+  std::size_t i;
+  if (!micro_parse_args(run, argc, argv)) {
+    micro_usage(entries, entry_count);
+    return EXIT_FAILURE;
+  }
+  if (!run.ofilename.empty()) {
+    ofile.open(run.ofilename.c_str());
+    if (!ofile) {
+      std::cerr << "failed to open output file" << std::endl;
+      return EXIT_FAILURE;
+    }
+    out = &ofile;
+  }
+  if (!run.json) {
+    run.csv = out;
+    tcmplxAbench_csv_header(*out);
+  }
+  for (i = 0u; i < entry_count; ++i) {
+    if (!run.filter.empty()
+    &&  std::string(entries[i].name).find(run.filter) == std::string::npos)
+      continue;
+    entries[i].fn(run);
+  }
+  if (run.json)
+    tcmplxAbench_json(*out, run.results);
+  out->flush();
+  for (tcmplxAbench_result const& r : run.results) {
+    if (!r.ok)
+      return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -10,6 +10,10 @@
 #include <new>
 #include <cstdlib>
 #include <cerrno>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <system_error>
 
 namespace mmaptwo {
   /**
@@ -25,6 +29,8 @@ namespace mmaptwo {
     char privy;
     /** \brief flag for enabling access from child processes */
     char bequeath;
+    /** \brief flag for faulting in pages at acquisition */
+    char populate;
   };
 
   /**
@@ -129,6 +135,13 @@ namespace mmaptwo {
      * \note Offset is measured from start of source mappable.
      */
     size_t offset(void) const noexcept override;
+
+    /**
+     * \brief Give a hint about future access to the mapped area.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \return zero on success, nonzero if the hint was not applied
+     */
+    int advise(int hint) noexcept override;
   };
 
   /**
@@ -188,6 +201,15 @@ namespace mmaptwo {
      * \return the offset of the mappable region from start of file
      */
     size_t offset(void) const noexcept override;
+
+    /**
+     * \brief Give a hint about future access to part of the mappable area.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \param siz size of the range in bytes
+     * \param off offset of the range into the file data
+     * \return zero on success, nonzero if the hint was not applied
+     */
+    int advise(int hint, size_t siz, size_t off) noexcept override;
   };
 
   /**
@@ -219,6 +241,27 @@ namespace mmaptwo {
    */
   static int mode_flag_cvt(int mprivy);
 
+  /**
+   * \brief Convert a `mmaptwo` populate flag to a POSIX `mmap` flag.
+   * \param mpopulate the populate flag to convert
+   * \return an `mmap` flag on success, zero otherwise
+   */
+  static int mode_populate_cvt(int mpopulate);
+
+  /**
+   * \brief Convert a `mmaptwo` advice value to a `posix_madvise` hint.
+   * \param hint the value to convert
+   * \return a `posix_madvise` hint on success, -1 otherwise
+   */
+  static int advice_madv_cvt(int hint);
+
+  /**
+   * \brief Convert a `mmaptwo` advice value to a `posix_fadvise` hint.
+   * \param hint the value to convert
+   * \return a `posix_fadvise` hint on success, -1 otherwise
+   */
+  static int advice_fadv_cvt(int hint);
+
   /**
    * \brief Fetch a file size from a file descriptor.
    * \param fd target file descriptor
@@ -420,9 +463,300 @@ namespace mmaptwo {
 #endif /*MMAPTWO_PLUS_OS*/
 
 namespace mmaptwo {
+  /**
+   * \brief Page held by a `mmaptwo` page cache.
+   */
+  struct cache_entry {
+    /** \brief page acquired from the source */
+    page_i* page;
+    /** \brief offset of the page from start of source */
+    size_t off;
+    /** \brief length of the page */
+    size_t len;
+    /** \brief number of page handlers using this page */
+    size_t refs;
+  };
+
+  /**
+   * \brief Shared state between a page cache and its page handlers.
+   */
+  struct cache_core {
+    std::mutex lock;
+    /** \brief cached pages, most recently used first */
+    std::list<cache_entry> entries;
+    /** \brief maximum number of idle pages */
+    size_t count;
+    size_t hits;
+    size_t misses;
+
+    cache_core(size_t n);
+    ~cache_core(void);
+    /**
+     * \brief Release the least recently used idle pages beyond
+     *   the capacity.
+     * \note The caller must hold `lock`.
+     */
+    void trim(void) noexcept;
+  };
+
+  /**
+   * \brief Page handler structure for the `mmaptwo` page cache.
+   */
+  class page_cache : public page_i {
+  private:
+    /** \brief cache state, kept alive while this page exists */
+    std::shared_ptr<cache_core> core;
+    /** \brief page shared with the cache */
+    cache_entry* entry;
+    /** \brief offset from start of shared page to user-requested space */
+    size_t shift;
+    /** \brief length of user-requested space */
+    size_t len;
+    /** \brief offset from start of source to user-requested space */
+    size_t offnum;
+
+    page_cache(page_cache const& ) = delete;
+    page_cache& operator=(page_cache const& ) = delete;
+    page_cache(void) = delete;
+
+  public:
+    /**
+     * \brief Attach to a shared page.
+     * \param c cache state
+     * \param e shared page covering the requested space
+     * \param sz size of page instance to request
+     * \param pre_off offset of page from start of source
+     */
+    page_cache(std::shared_ptr<cache_core> const& c, cache_entry* e,
+        size_t sz, size_t pre_off) noexcept;
+
+    /**
+     * \brief Destructor; returns the shared page to the cache.
+     */
+    ~page_cache(void) override;
+
+    /**
+     * \brief Get a pointer to the space.
+     * \return pointer to space
+     */
+    void* get(void) noexcept override;
+
+    /**
+     * \brief Get a pointer to the space.
+     * \return pointer to space
+     */
+    void const* get(void) const noexcept override;
+
+    /**
+     * \brief Check the length of the mapped area.
+     * \return the length of the mapped region exposed by this interface
+     */
+    size_t length(void) const noexcept override;
+
+    /**
+     * \brief Check the offset of the mapped area.
+     * \return the offset of the mapped region exposed by this interface
+     * \note Offset is measured from start of source mappable.
+     */
+    size_t offset(void) const noexcept override;
+
+    /**
+     * \brief Give a hint about future access to the shared page.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \return zero on success, nonzero if the hint was not applied
+     */
+    int advise(int hint) noexcept override;
+  };
+
+  /**
+   * \brief File handler structure for the `mmaptwo` page cache.
+   */
+  class mmaptwo_cache : public cache_i {
+  private:
+    /** \brief wrapped mappable */
+    mmaptwo_i* source;
+    /** \brief cache state */
+    std::shared_ptr<cache_core> core;
+
+    mmaptwo_cache(mmaptwo_cache const& ) = delete;
+    mmaptwo_cache& operator=(mmaptwo_cache const& ) = delete;
+    mmaptwo_cache(void) = delete;
+
+  public:
+    /**
+     * \brief Prepare a page cache.
+     * \param src mappable to wrap
+     * \param count maximum number of idle pages
+     * \throws `std::bad_alloc`
+     */
+    mmaptwo_cache(mmaptwo_i* src, size_t count);
+
+    /**
+     * \brief Destructor; releases idle pages.
+     */
+    ~mmaptwo_cache(void) override;
+
+  public:
+    /**
+     * \brief Acquire a mapping to the space.
+     * \param siz size of the map to acquire
+     * \param off offset into the file data
+     * \return pointer to a page interface on success, `nullptr` otherwise
+     */
+    page_i* acquire(size_t siz, size_t off) noexcept override;
+
+    /**
+     * \brief Check the length of the mappable area.
+     * \return the length of the mappable region exposed by this interface
+     */
+    size_t length(void) const noexcept override;
+
+    /**
+     * \brief Check the offset of the mappable area.
+     * \return the offset of the mappable region from start of file
+     */
+    size_t offset(void) const noexcept override;
+
+    /**
+     * \brief Give a hint about future access to part of the mappable area.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \param siz size of the range in bytes
+     * \param off offset of the range into the file data
+     * \return zero on success, nonzero if the hint was not applied
+     */
+    int advise(int hint, size_t siz, size_t off) noexcept override;
+
+    /**
+     * \brief Check the number of acquisitions served from the cache.
+     * \return a hit count
+     */
+    size_t hits(void) const noexcept override;
+
+    /**
+     * \brief Check the number of acquisitions that had to map new pages.
+     * \return a miss count
+     */
+    size_t misses(void) const noexcept override;
+
+    /**
+     * \brief Check the maximum number of idle pages kept mapped.
+     * \return a page count
+     */
+    size_t capacity(void) const noexcept override;
+  };
+
+  /**
+   * \brief Page handler structure for the memory `mmaptwo` implementation.
+   */
+  class page_memory : public page_i {
+  private:
+    /** \brief share of the source buffer */
+    std::shared_ptr<void const> buf;
+    /** \brief start of user-requested space */
+    unsigned char const* ptr;
+    /** \brief length of space */
+    size_t len;
+    /** \brief offset from start of source to user-requested space */
+    size_t offnum;
+
+    page_memory(page_memory const& ) = delete;
+    page_memory& operator=(page_memory const& ) = delete;
+    page_memory(void) = delete;
+
+  public:
+    /**
+     * \brief Acquire a view of the buffer.
+     * \param b share of the source buffer
+     * \param p start of the view
+     * \param sz size of the view
+     * \param pre_off offset of the view from start of source
+     */
+    page_memory(std::shared_ptr<void const> const& b,
+        unsigned char const* p, size_t sz, size_t pre_off) noexcept;
+
+    /**
+     * \brief Destructor; drops the share of the buffer.
+     */
+    ~page_memory(void) override;
+
+    /**
+     * \brief Get a pointer to the space.
+     * \return pointer to space
+     */
+    void* get(void) noexcept override;
+
+    /**
+     * \brief Get a pointer to the space.
+     * \return pointer to space
+     */
+    void const* get(void) const noexcept override;
+
+    /**
+     * \brief Check the length of the mapped area.
+     * \return the length of the mapped region exposed by this interface
+     */
+    size_t length(void) const noexcept override;
+
+    /**
+     * \brief Check the offset of the mapped area.
+     * \return the offset of the mapped region exposed by this interface
+     * \note Offset is measured from start of source mappable.
+     */
+    size_t offset(void) const noexcept override;
+  };
+
+  /**
+   * \brief File handler structure for the memory `mmaptwo` implementation.
+   */
+  class mmaptwo_memory : public mmaptwo_i {
+  private:
+    /** \brief share of the source buffer */
+    std::shared_ptr<void const> buf;
+    /** \brief length of space */
+    size_t len;
+
+    mmaptwo_memory(mmaptwo_memory const& ) = delete;
+    mmaptwo_memory& operator=(mmaptwo_memory const& ) = delete;
+    mmaptwo_memory(void) = delete;
+
+  public:
+    /**
+     * \brief Prepare a memory map interface.
+     * \param b share of the source buffer
+     * \param sz size of the buffer
+     */
+    mmaptwo_memory(std::shared_ptr<void const> const& b, size_t sz) noexcept;
+
+    /**
+     * \brief Destructor; drops the share of the buffer.
+     */
+    ~mmaptwo_memory(void) override;
+
+  public:
+    /**
+     * \brief Acquire a view of the buffer.
+     * \param siz size of the view to acquire
+     * \param off offset into the buffer
+     * \return pointer to a page interface on success, `nullptr` otherwise
+     */
+    page_i* acquire(size_t siz, size_t off) noexcept override;
+
+    /**
+     * \brief Check the length of the mappable area.
+     * \return the length of the mappable region exposed by this interface
+     */
+    size_t length(void) const noexcept override;
+
+    /**
+     * \brief Check the offset of the mappable area.
+     * \return zero
+     */
+    size_t offset(void) const noexcept override;
+  };
+
   //BEGIN static functions
   struct mode_tag mode_parse(char const* mmode) {
-    struct mode_tag out = { 0, 0, 0, 0 };
+    struct mode_tag out = { 0, 0, 0, 0, 0 };
     int i;
     for (i = 0; i < 8; ++i) {
       switch (mmode[i]) {
@@ -443,6 +777,9 @@ namespace mmaptwo {
       case mode_bequeath:
         out.bequeath = mode_bequeath;
         break;
+      case mode_populate:
+        out.populate = mode_populate;
+        break;
       }
     }
     return out;
@@ -510,6 +847,56 @@ namespace mmaptwo {
     return mprivy ? MAP_PRIVATE : MAP_SHARED;
   }
 
+  int mode_populate_cvt(int mpopulate) {
+#if (defined MAP_POPULATE)
+    return mpopulate ? MAP_POPULATE : 0;
+#else
+    return 0;
+#endif /*MAP_POPULATE*/
+  }
+
+  int advice_madv_cvt(int hint) {
+#if (defined POSIX_MADV_NORMAL)
+    switch (hint) {
+    case advice_normal:
+      return POSIX_MADV_NORMAL;
+    case advice_sequential:
+      return POSIX_MADV_SEQUENTIAL;
+    case advice_random:
+      return POSIX_MADV_RANDOM;
+    case advice_willneed:
+      return POSIX_MADV_WILLNEED;
+    case advice_dontneed:
+      return POSIX_MADV_DONTNEED;
+    default:
+      return -1;
+    }
+#else
+    return -1;
+#endif /*POSIX_MADV_NORMAL*/
+  }
+
+  int advice_fadv_cvt(int hint) {
+#if (defined POSIX_FADV_NORMAL)
+    switch (hint) {
+    case advice_normal:
+      return POSIX_FADV_NORMAL;
+    case advice_sequential:
+      return POSIX_FADV_SEQUENTIAL;
+    case advice_random:
+      return POSIX_FADV_RANDOM;
+    case advice_willneed:
+      return POSIX_FADV_WILLNEED;
+    case advice_dontneed:
+      return POSIX_FADV_DONTNEED;
+    default:
+      return -1;
+    }
+#else
+    return -1;
+#endif /*POSIX_FADV_NORMAL*/
+  }
+
   size_t file_size_e(int fd) {
     struct stat fsi;
     std::memset(&fsi, 0, sizeof(fsi));
@@ -692,6 +1079,14 @@ namespace mmaptwo {
     return;
   }
 
+  int mmaptwo_i::advise(int , size_t , size_t ) noexcept {
+    return -1;
+  }
+
+  int page_i::advise(int ) noexcept {
+    return -1;
+  }
+
 #if MMAPTWO_PLUS_OS == MMAPTWO_OS_UNIX
   mmaptwo_unix::mmaptwo_unix
     (int fd, struct mode_tag const mt, size_t sz, size_t off)
@@ -793,7 +1188,7 @@ namespace mmaptwo {
       }
     }
     ptr = ::mmap(nullptr, fullsize, mode_prot_cvt(mt.mode),
-         mode_flag_cvt(mt.privy), fd, fulloff);
+         mode_flag_cvt(mt.privy)|mode_populate_cvt(mt.populate), fd, fulloff);
     if (ptr == MAP_FAILED) {
       throw std::runtime_error
         ("mmaptwo::page_unix::page_unix: mmap failure");
@@ -836,6 +1231,48 @@ namespace mmaptwo {
   void const* page_unix::get(void) const noexcept {
     return static_cast<unsigned char const*>(this->ptr)+this->shift;
   }
+
+  int page_unix::advise(int hint) noexcept {
+    int const madv = advice_madv_cvt(hint);
+    if (madv < 0) {
+      errno = EDOM;
+      return -1;
+    }
+#if (defined POSIX_MADV_NORMAL)
+    /* `ptr` holds the page-aligned start of the mapping */{
+      int const res = ::posix_madvise(this->ptr, this->len, madv);
+      if (res != 0) {
+        errno = res;
+        return -1;
+      } else return 0;
+    }
+#else
+    return -1;
+#endif /*POSIX_MADV_NORMAL*/
+  }
+
+  int mmaptwo_unix::advise(int hint, size_t sz, size_t pre_off) noexcept {
+    int const fadv = advice_fadv_cvt(hint);
+    if (fadv < 0
+    ||  pre_off > this->len
+    ||  sz > this->len - pre_off)
+    {
+      errno = EDOM;
+      return -1;
+    }
+#if (defined POSIX_FADV_NORMAL)
+    /* advise the file directly, since the range need not be mapped */{
+      int const res = ::posix_fadvise(this->fd,
+          (off_t)(pre_off + this->offnum), (off_t)sz, fadv);
+      if (res != 0) {
+        errno = res;
+        return -1;
+      } else return 0;
+    }
+#else
+    return -1;
+#endif /*POSIX_FADV_NORMAL*/
+  }
 #elif MMAPTWO_PLUS_OS == MMAPTWO_OS_WIN32
   mmaptwo_win32::mmaptwo_win32
     (HANDLE fd, struct mode_tag const mt, size_t sz, size_t off)
@@ -1083,6 +1520,258 @@ namespace mmaptwo {
   //END   public method
 };
 
+namespace mmaptwo {
+  //BEGIN memory mapping
+  page_memory::page_memory
+      ( std::shared_ptr<void const> const& b, unsigned char const* p,
+        size_t sz, size_t pre_off) noexcept
+    : buf(b), ptr(p), len(sz), offnum(pre_off)
+  {
+    return;
+  }
+
+  page_memory::~page_memory(void) {
+    ptr = nullptr;
+    return;
+  }
+
+  void* page_memory::get(void) noexcept {
+    return const_cast<unsigned char*>(this->ptr);
+  }
+
+  void const* page_memory::get(void) const noexcept {
+    return this->ptr;
+  }
+
+  size_t page_memory::length(void) const noexcept {
+    return this->len;
+  }
+
+  size_t page_memory::offset(void) const noexcept {
+    return this->offnum;
+  }
+
+  mmaptwo_memory::mmaptwo_memory
+      (std::shared_ptr<void const> const& b, size_t sz) noexcept
+    : buf(b), len(sz)
+  {
+    return;
+  }
+
+  mmaptwo_memory::~mmaptwo_memory(void) {
+    return;
+  }
+
+  page_i* mmaptwo_memory::acquire(size_t sz, size_t pre_off) noexcept {
+    /* check input size and offset */{
+      if (pre_off > this->len
+      ||  sz > this->len - pre_off
+      ||  sz == 0u)
+      {
+        errno = EDOM;
+        return nullptr;
+      }
+    }
+    try {
+      unsigned char const* const p =
+        static_cast<unsigned char const*>(buf.get())+pre_off;
+      return new page_memory(buf, p, sz, pre_off);
+    } catch (std::bad_alloc const& ) {
+#if (defined ENOMEM)
+      errno = ENOMEM;
+#else
+      errno = ERANGE;
+#endif /*ENOMEM*/
+      return nullptr;
+    }
+  }
+
+  size_t mmaptwo_memory::length(void) const noexcept {
+    return this->len;
+  }
+
+  size_t mmaptwo_memory::offset(void) const noexcept {
+    return 0u;
+  }
+  //END   memory mapping
+
+  //BEGIN page cache
+  cache_i::~cache_i(void) {
+    return;
+  }
+
+  cache_core::cache_core(size_t n)
+    : count(n), hits(0u), misses(0u)
+  {
+    return;
+  }
+
+  cache_core::~cache_core(void) {
+    for (cache_entry& e : entries) {
+      delete e.page;
+      e.page = nullptr;
+    }
+    return;
+  }
+
+  void cache_core::trim(void) noexcept {
+    size_t kept = 0u;
+    std::list<cache_entry>::iterator it = entries.begin();
+    while (it != entries.end()) {
+      if (it->refs > 0u) {
+        ++it;
+      } else if (kept < count) {
+        kept += 1u;
+        ++it;
+      } else {
+        delete it->page;
+        it = entries.erase(it);
+      }
+    }
+    return;
+  }
+
+  page_cache::page_cache
+      ( std::shared_ptr<cache_core> const& c, cache_entry* e,
+        size_t sz, size_t pre_off) noexcept
+    : core(c), entry(e), shift(pre_off-e->off), len(sz), offnum(pre_off)
+  {
+    return;
+  }
+
+  page_cache::~page_cache(void) {
+    std::lock_guard<std::mutex> guard(core->lock);
+    entry->refs -= 1u;
+    core->trim();
+    entry = nullptr;
+    return;
+  }
+
+  void* page_cache::get(void) noexcept {
+    return static_cast<unsigned char*>(entry->page->get())+this->shift;
+  }
+
+  void const* page_cache::get(void) const noexcept {
+    page_i const* const page = entry->page;
+    return static_cast<unsigned char const*>(page->get())+this->shift;
+  }
+
+  size_t page_cache::length(void) const noexcept {
+    return this->len;
+  }
+
+  size_t page_cache::offset(void) const noexcept {
+    return this->offnum;
+  }
+
+  int page_cache::advise(int hint) noexcept {
+    return entry->page->advise(hint);
+  }
+
+  mmaptwo_cache::mmaptwo_cache(mmaptwo_i* src, size_t count)
+    : source(src), core(std::make_shared<cache_core>(count))
+  {
+    return;
+  }
+
+  mmaptwo_cache::~mmaptwo_cache(void) {
+    /* let pages still in use release themselves */{
+      std::lock_guard<std::mutex> guard(core->lock);
+      core->count = 0u;
+      core->trim();
+    }
+    source = nullptr;
+    return;
+  }
+
+  page_i* mmaptwo_cache::acquire(size_t sz, size_t pre_off) noexcept {
+    /* check input size and offset */{
+      size_t const len = source->length();
+      if (pre_off > len
+      ||  sz > len - pre_off
+      ||  sz == 0u)
+      {
+        errno = EDOM;
+        return nullptr;
+      }
+    }
+    try {
+      std::lock_guard<std::mutex> guard(core->lock);
+      std::list<cache_entry>& entries = core->entries;
+      std::list<cache_entry>::iterator it;
+      for (it = entries.begin(); it != entries.end(); ++it) {
+        if (it->off <= pre_off
+        &&  pre_off - it->off <= it->len
+        &&  sz <= it->len - (pre_off - it->off))
+          break;
+      }
+      if (it != entries.end()) {
+        /* reuse, marking as most recent */
+        entries.splice(entries.begin(), entries, it);
+        core->hits += 1u;
+      } else {
+        size_t const psize = get_page_size();
+        size_t const start =
+          (psize > 0u) ? pre_off - pre_off%psize : pre_off;
+        size_t const fullsize = sz + (pre_off-start);
+        page_i* const page = source->acquire(fullsize, start);
+        if (!page)
+          return nullptr;
+        try {
+          entries.push_front(cache_entry{page, start, fullsize, 0u});
+        } catch (std::bad_alloc const& ) {
+          delete page;
+          throw;
+        }
+        core->misses += 1u;
+      }
+      cache_entry* const e = &entries.front();
+      page_i* const out = new page_cache(core, e, sz, pre_off);
+      e->refs += 1u;
+      core->trim();
+      return out;
+    } catch (std::bad_alloc const& ) {
+#if (defined ENOMEM)
+      errno = ENOMEM;
+#else
+      errno = ERANGE;
+#endif /*ENOMEM*/
+      return nullptr;
+    } catch (std::system_error const& ) {
+      errno = EDOM;
+      return nullptr;
+    }
+  }
+
+  size_t mmaptwo_cache::length(void) const noexcept {
+    return source->length();
+  }
+
+  size_t mmaptwo_cache::offset(void) const noexcept {
+    return source->offset();
+  }
+
+  int mmaptwo_cache::advise(int hint, size_t sz, size_t pre_off) noexcept {
+    return source->advise(hint, sz, pre_off);
+  }
+
+  size_t mmaptwo_cache::hits(void) const noexcept {
+    std::lock_guard<std::mutex> guard(core->lock);
+    return core->hits;
+  }
+
+  size_t mmaptwo_cache::misses(void) const noexcept {
+    std::lock_guard<std::mutex> guard(core->lock);
+    return core->misses;
+  }
+
+  size_t mmaptwo_cache::capacity(void) const noexcept {
+    std::lock_guard<std::mutex> guard(core->lock);
+    return core->count;
+  }
+  //END   page cache
+};
+
 namespace mmaptwo {
   //BEGIN error handling
   int get_errno(void) noexcept {
@@ -1316,5 +2005,48 @@ namespace mmaptwo {
   }
 #endif /*MMAPTWO_PLUS_OS*/
   //END   open functions
+
+  //BEGIN memory functions
+  mmaptwo_i* memopen(void const* buf, size_t sz, bool throwing) {
+    try {
+      /* the caller keeps ownership, so share without deleting */
+      std::shared_ptr<void const> const b(buf, [](void const*){});
+      return memopen(b, sz, throwing);
+    } catch (...) {
+      if (throwing) throw;
+      else return nullptr;
+    }
+  }
+
+  mmaptwo_i* memopen
+    (std::shared_ptr<void const> const& buf, size_t sz, bool throwing)
+  {
+    try {
+      if (!buf && sz > 0u) {
+        errno = EDOM;
+        throw std::invalid_argument("mmaptwo::memopen: missing buffer");
+      }
+      return new mmaptwo_memory(buf, sz);
+    } catch (...) {
+      if (throwing) throw;
+      else return nullptr;
+    }
+  }
+  //END   memory functions
+
+  //BEGIN cache functions
+  cache_i* cache(mmaptwo_i* source, size_t count, bool throwing) {
+    try {
+      if (!source) {
+        errno = EDOM;
+        throw std::invalid_argument("mmaptwo::cache: missing source");
+      }
+      return new mmaptwo_cache(source, count);
+    } catch (...) {
+      if (throwing) throw;
+      else return nullptr;
+    }
+  }
+  //END   cache functions
 };
 
@@ -7,6 +7,7 @@
 #define hg_MMapTwo_Plus_mmapTwo_H_
 
 #include <cstddef>
+#include <memory>
 
 #ifdef MMAPTWO_PLUS_WIN32_DLL
 #  ifdef MMAPTWO_PLUS_WIN32_DLL_INTERNAL
@@ -66,7 +67,40 @@ namespace mmaptwo {
      *   to return. Otherwise, the file descriptor of the mapped file
      *   may leak.
      */
-    mode_bequeath = 0x71
+    mode_bequeath = 0x71,
+
+    /**
+     * \brief Fault in the pages of each mapping at acquisition time.
+     * \note Ignored where the target backend cannot populate mappings
+     *   in advance.
+     */
+    mode_populate = 0x66
+  };
+
+  /**
+   * \brief Expected access patterns for mapped memory.
+   */
+  enum advice {
+    /**
+     * \brief No special treatment.
+     */
+    advice_normal = 0,
+    /**
+     * \brief Expect reads in increasing address order.
+     */
+    advice_sequential = 1,
+    /**
+     * \brief Expect reads in no particular order.
+     */
+    advice_random = 2,
+    /**
+     * \brief Expect access in the near future; start reading ahead.
+     */
+    advice_willneed = 3,
+    /**
+     * \brief Expect no access in the near future.
+     */
+    advice_dontneed = 4
   };
 
   /**
@@ -105,6 +139,14 @@ namespace mmaptwo {
      * \note Offset is measured from start of source mappable.
      */
     virtual size_t offset(void) const noexcept = 0;
+
+    /**
+     * \brief Give a hint about future access to the mapped area.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \return zero on success, nonzero if the hint was not applied
+     * \note The default implementation applies no hints.
+     */
+    virtual int advise(int hint) noexcept;
   };
 
   /**
@@ -137,6 +179,48 @@ namespace mmaptwo {
      * \return the offset of this interface's region from start of file
      */
     virtual size_t offset(void) const noexcept = 0;
+
+    /**
+     * \brief Give a hint about future access to part of the mappable area.
+     * \param hint an \link mmaptwo::advice \endlink value
+     * \param siz size of the range in bytes
+     * \param off offset of the range into the file data
+     * \return zero on success, nonzero if the hint was not applied
+     * \note Useful for reading ahead of pages not yet acquired.
+     * \note The default implementation applies no hints.
+     */
+    virtual int advise(int hint, size_t siz, size_t off) noexcept;
+  };
+
+  /**
+   * \brief Memory-mapped input-output interface that keeps recently
+   *   used pages mapped for reuse.
+   */
+  class MMAPTWO_PLUS_API cache_i : public mmaptwo_i {
+  public:
+    /**
+     * \brief Destructor; releases idle pages.
+     * \note Pages still held by the caller remain valid.
+     */
+    virtual ~cache_i(void) = 0;
+
+    /**
+     * \brief Check the number of acquisitions served from the cache.
+     * \return a hit count
+     */
+    virtual size_t hits(void) const noexcept = 0;
+
+    /**
+     * \brief Check the number of acquisitions that had to map new pages.
+     * \return a miss count
+     */
+    virtual size_t misses(void) const noexcept = 0;
+
+    /**
+     * \brief Check the maximum number of idle pages kept mapped.
+     * \return a page count
+     */
+    virtual size_t capacity(void) const noexcept = 0;
   };
 
   /* BEGIN error handling */
@@ -189,7 +273,8 @@ namespace mmaptwo {
    * \param nm name of file to map
    * \param mode one of 'r' (for readonly) or 'w' (writeable),
    *   optionally followed by 'e' to extend map to end of file,
-   *   optionally followed by 'p' to make write changes private
+   *   optionally followed by 'p' to make write changes private,
+   *   optionally followed by 'f' to fault in pages when acquired
    * \param sz size in bytes of region to provide for mapping
    * \param off file offset of region to provide for mapping
    * \param throwing whether to pass on exceptions to the caller
@@ -209,7 +294,8 @@ namespace mmaptwo {
    * \param nm name of file to map
    * \brief mode one of 'r' (for readonly) or 'w' (writeable),
    *   optionally followed by 'e' to extend map to end of file,
-   *   optionally followed by 'p' to make write changes private
+   *   optionally followed by 'p' to make write changes private,
+   *   optionally followed by 'f' to fault in pages when acquired
    * \param sz size in bytes of region to provide for mapping
    * \param off file offset of region to provide for mapping
    * \param throwing whether to pass on exceptions to the caller
@@ -230,7 +316,8 @@ namespace mmaptwo {
    * \param nm name of file to map
    * \brief mode one of 'r' (for readonly) or 'w' (writeable),
    *   optionally followed by 'e' to extend map to end of file,
-   *   optionally followed by 'p' to make write changes private
+   *   optionally followed by 'p' to make write changes private,
+   *   optionally followed by 'f' to fault in pages when acquired
    * \param sz size in bytes of region to provide for mapping
    * \param off file offset of region to provide for mapping
    * \param throwing whether to pass on exceptions to the caller
@@ -247,6 +334,59 @@ namespace mmaptwo {
     ( wchar_t const* nm, char const* mode, size_t sz, size_t off,
       bool throwing=true);
   /* END   open functions */
+
+  /* BEGIN memory functions */
+  /**
+   * \brief Provide a memory buffer through the mapping interface.
+   * \param buf start of the buffer
+   * \param sz size of the buffer in bytes
+   * \param throwing whether to pass on exceptions to the caller
+   * \return an interface on success, `nullptr` otherwise
+   * \throws `std::invalid_argument` and `std::bad_alloc`, but only when
+   *   `throwing` is set to `true`.
+   * \note The caller keeps ownership of the buffer, which must outlive
+   *   the interface and all pages acquired from it.
+   * \note Pages point directly into the buffer, without copying.
+   *   They are read-only; do not write through `page_i::get`.
+   */
+  MMAPTWO_PLUS_API
+  mmaptwo_i* memopen(void const* buf, size_t sz, bool throwing=true);
+
+  /**
+   * \brief Provide a shared memory buffer through the mapping interface.
+   * \param buf start of the buffer
+   * \param sz size of the buffer in bytes
+   * \param throwing whether to pass on exceptions to the caller
+   * \return an interface on success, `nullptr` otherwise
+   * \throws `std::invalid_argument` and `std::bad_alloc`, but only when
+   *   `throwing` is set to `true`.
+   * \note The interface and each page acquired from it hold a share
+   *   of the buffer, so pages remain valid after the interface closes.
+   * \note Pages point directly into the buffer, without copying.
+   *   They are read-only; do not write through `page_i::get`.
+   */
+  MMAPTWO_PLUS_API
+  mmaptwo_i* memopen
+    (std::shared_ptr<void const> const& buf, size_t sz, bool throwing=true);
+  /* END   memory functions */
+
+  /* BEGIN cache functions */
+  /**
+   * \brief Wrap a mappable in a page cache.
+   * \param source the mappable to wrap
+   * \param count maximum number of idle pages to keep mapped
+   * \param throwing whether to pass on exceptions to the caller
+   * \return an interface on success, `nullptr` otherwise
+   * \throws `std::invalid_argument` and `std::bad_alloc`, but only when
+   *   `throwing` is set to `true`.
+   * \note Does not take control of the source's lifetime. The source
+   *   must outlive the cache.
+   * \note A request is served from the cache when an earlier page,
+   *   aligned to \link mmaptwo::get_page_size \endlink, covers it.
+   */
+  MMAPTWO_PLUS_API
+  cache_i* cache(mmaptwo_i* source, size_t count = 8u, bool throwing=true);
+  /* END   cache functions */
 };
 
 #endif /*hg_MMapTwo_Plus_mmapTwo_H_*/
@@ -40,6 +40,8 @@ namespace text_complex {
     /** @brief Unsigned integer at least 32 bits. */
     typedef unsigned long int uint32;
 #endif /*UINT_MAX*/
+    /** @brief Unsigned integer at least 64 bits. */
+    typedef unsigned long long int uint64;
     using std::size_t;
 
     //BEGIN error codes
@@ -11,6 +11,7 @@
 namespace text_complex {
   namespace access {
     class hash_chain;
+    struct cvt_stats;
 
     /**
      * @defgroup blockbuf DEFLATE block buffer
@@ -194,6 +195,7 @@ namespace text_complex {
       block_string output;
       bool use_bdict;
       uint32 input_block_size;
+      uint32 copy_max;
 
     public: /** @name rule-of-six*//** @{ */
       /**
@@ -380,6 +382,16 @@ namespace text_complex {
        * @note The input buffer is retained.
        */
       block_buffer& try_block(api_error& ae) noexcept;
+      /**
+       * @brief Process the current block of input bytes.
+       * @param[in,out] stats statistics to which to add match finder
+       *   counters
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   other value on failure
+       * @return `*this`
+       * @note The input buffer is retained.
+       */
+      block_buffer& try_block(cvt_stats& stats, api_error& ae) noexcept;
       /**
        * @brief Copy input bytes to output without processing.
        * @return `*this`
@@ -411,6 +423,11 @@ namespace text_complex {
        * @brief Clear the input buffer.
        */
       void clear_input(void) noexcept;
+      /**
+       * @brief Clear both buffers and the sliding window.
+       * @note The storage stays allocated for reuse.
+       */
+      void clear(void) noexcept;
       /**
        * @brief Add some bytes to the slide ring,
        *   bypassing the input buffer.
@@ -431,6 +448,23 @@ namespace text_complex {
        */
       size_t bypass
         (unsigned char const* s, size_t count, api_error& ae) noexcept;
+      /**
+       * @brief Replace the slide ring and its match index
+       *   with a copy of a prebuilt one.
+       * @param window hash chain to copy; must have the same
+       *   window size as this buffer
+       * @throw api_exception on failure
+       */
+      void load_window(hash_chain const& window);
+      /**
+       * @brief Replace the slide ring and its match index
+       *   with a copy of a prebuilt one.
+       * @param window hash chain to copy; must have the same
+       *   window size as this buffer
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   other value on failure
+       */
+      void load_window(hash_chain const& window, api_error& ae) noexcept;
 
       /**
        * @brief Query a past byte.
@@ -463,6 +497,18 @@ namespace text_complex {
        * @return start of pending input data in the buffer
        */
       block_string const& input_data(void) const noexcept;
+      /**
+       * @brief Query the longest copy command to generate.
+       * @return a copy length in bytes
+       */
+      uint32 copy_limit(void) const noexcept;
+      /**
+       * @brief Limit the length of generated copy commands.
+       * @param n maximum copy length; clamped to the range supported
+       *   by the block string format (at least 3)
+       * @note DEFLATE streams cannot express copies over 258 bytes.
+       */
+      void set_copy_limit(uint32 n) noexcept;
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
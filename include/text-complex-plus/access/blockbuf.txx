@@ -83,6 +83,15 @@ namespace text_complex {
       } else return out;
     }
 
+    inline
+    void block_buffer::load_window(hash_chain const& window) {
+      api_error ae;
+      load_window(window, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return;
+    }
+
     inline
     unsigned char block_buffer::peek(uint32 i) const {
       api_error ae;
@@ -14,6 +14,7 @@
 #include "brmeta.hpp"
 #include "ctxtspan.hpp"
 #include "gaspvec.hpp"
+#include "cvtstats.hpp"
 
 namespace text_complex {
   namespace access {
@@ -138,6 +139,8 @@ namespace text_complex {
       prefix_histogram dist_histogram;
       /** @brief Histogram used for generating insert-and-copy trees. */
       prefix_histogram ins_histogram;
+      /** @brief Work space for prefix code length generation. */
+      prefix_histogram length_scratch;
       /** @brief ... */
       uint32 bits;
       /** @brief Read count for bits used after a Huffman code. */
@@ -233,6 +236,11 @@ namespace text_complex {
       uint32 extra_bits[2];
       /** @brief Map from mode to outflow context index. */
       unsigned char ctxt_mode_map[4];
+      /**
+       * @brief Stage timers and counters.
+       * @note Updated by every conversion call.
+       */
+      cvt_stats stats;
 
     public: /** @name rule-of-zero*//** @{ */
       /**
@@ -326,6 +334,26 @@ namespace text_complex {
      */
     TCMPLX_AP_API
     void brcvt_destroy(brcvt_state* x) noexcept;
+
+    /**
+     * @brief Return a brcvt state to its start for a new stream.
+     * @param state the state to reset
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @note The sliding window keeps its storage, so a state reused for
+     *   many streams stops allocating once the window has grown.
+     * @note A prefix dictionary does not survive the reset.
+     */
+    TCMPLX_AP_API
+    void brcvt_reset(brcvt_state& state, api_error& ae) noexcept;
+
+    /**
+     * @brief Return a brcvt state to its start for a new stream.
+     * @param state the state to reset
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    void brcvt_reset(brcvt_state& state);
     //END   brcvt state / allocation (namespace local)
 
     //BEGIN brcvt state / namespace local
@@ -376,6 +404,96 @@ namespace text_complex {
     size_t brcvt_bypass
       (brcvt_state& state, unsigned char const* buf, size_t sz);
 
+    /**
+     * @brief Prepare a compressor to continue an existing Brotli stream.
+     * @param state the conversion state to configure
+     * @param buf buffer of bytes already encoded by the stream
+     * @param sz size of the buffer in bytes
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @return count of bytes added
+     * @note Call before any output. The stream header is skipped, and
+     *   the distance ring is marked unknown, so that the compressor's
+     *   meta-blocks can follow any byte-aligned stream prefix whose
+     *   output ends with `buf`. The buffer should hold the last
+     *   `n` bytes of that prefix, where `n` is the sliding window size
+     *   given to the state: copies reach back at most `n` bytes, and
+     *   the compressor emits no static dictionary references.
+     */
+    TCMPLX_AP_API
+    size_t brcvt_continue
+      ( brcvt_state& state, unsigned char const* buf, size_t sz,
+        api_error& ae) noexcept;
+
+    /**
+     * @brief Prepare a compressor to continue an existing Brotli stream.
+     * @param state the conversion state to configure
+     * @param buf buffer of bytes already encoded by the stream
+     * @param sz size of the buffer in bytes
+     * @return count of bytes added
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    size_t brcvt_continue
+      (brcvt_state& state, unsigned char const* buf, size_t sz);
+
+    /**
+     * @brief Prime a Brotli state with a custom prefix dictionary.
+     * @param state the conversion state to configure
+     * @param buf the prefix dictionary
+     * @param sz size of the dictionary in bytes
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @return count of bytes added
+     * @note Call before any input or output, on both the compressor
+     *   and the decompressor. The stream then behaves as though it
+     *   started with the dictionary: backward distances may reach into
+     *   it, and static dictionary references start past it. The
+     *   dictionary is not part of the stream, so both sides must agree
+     *   on it out of band.
+     */
+    TCMPLX_AP_API
+    size_t brcvt_set_prefix
+      ( brcvt_state& state, unsigned char const* buf, size_t sz,
+        api_error& ae) noexcept;
+
+    /**
+     * @brief Prime a Brotli state with a custom prefix dictionary.
+     * @param state the conversion state to configure
+     * @param buf the prefix dictionary
+     * @param sz size of the dictionary in bytes
+     * @return count of bytes added
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    size_t brcvt_set_prefix
+      (brcvt_state& state, unsigned char const* buf, size_t sz);
+
+    /**
+     * @brief Prime a Brotli state with a prebuilt prefix dictionary.
+     * @param state the conversion state to configure
+     * @param prefix hash chain holding the dictionary, with the same
+     *   sliding window size as the state
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @note Same as the byte buffer version, but copies the match index
+     *   instead of building it, so one index can serve many states.
+     */
+    TCMPLX_AP_API
+    void brcvt_set_prefix
+      ( brcvt_state& state, hash_chain const& prefix,
+        api_error& ae) noexcept;
+
+    /**
+     * @brief Prime a Brotli state with a prebuilt prefix dictionary.
+     * @param state the conversion state to configure
+     * @param prefix hash chain holding the dictionary, with the same
+     *   sliding window size as the state
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    void brcvt_set_prefix(brcvt_state& state, hash_chain const& prefix);
+
     /**
      * @brief Convert a byte stream to a Brotli stream.
      * @param state the Brotli conversion state to use
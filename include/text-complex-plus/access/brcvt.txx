@@ -32,6 +32,46 @@ namespace text_complex {
         throw api_exception(ae);
       } else return out;
     }
+
+    inline
+    size_t brcvt_continue
+      (brcvt_state& state, unsigned char const* buf, size_t sz)
+    {
+      api_error ae;
+      size_t const out = brcvt_continue(state, buf, sz, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    size_t brcvt_set_prefix
+      (brcvt_state& state, unsigned char const* buf, size_t sz)
+    {
+      api_error ae;
+      size_t const out = brcvt_set_prefix(state, buf, sz, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    void brcvt_reset(brcvt_state& state) {
+      api_error ae;
+      brcvt_reset(state, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return;
+    }
+
+    inline
+    void brcvt_set_prefix(brcvt_state& state, hash_chain const& prefix) {
+      api_error ae;
+      brcvt_set_prefix(state, prefix, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return;
+    }
 #endif //TextComplexAccessP_NO_EXCEPT
   };
 };
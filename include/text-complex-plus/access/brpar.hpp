@@ -0,0 +1,197 @@
+/**
+ * @file text-complex-plus/access/brpar.hpp
+ * @brief Parallel Brotli compression state
+ */
+#ifndef hg_TextComplexAccessP_BrPar_H_
+#define hg_TextComplexAccessP_BrPar_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @defgroup brpar Parallel Brotli compression state
+     *   (access/brpar.hpp)
+     * @{
+     */
+    struct brpar_core;
+    struct brpar_access;
+
+    //BEGIN brpar state
+    /**
+     * @brief Parallel Brotli compression state.
+     * @note Input is cut into fixed-size segments. Each segment is
+     *   compressed on a worker thread by its own
+     *   @link brcvt_state @endlink, primed with the tail of the previous
+     *   segment. The output depends only on the constructor parameters
+     *   other than `threads`.
+     */
+    class TCMPLX_AP_API brpar_state final {
+    private:
+      brpar_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param block_size amount of input data to process at once
+       * @param n maximum sliding window size
+       * @param chain_length run-time parameter limiting hash chain length
+       * @param segment_size amount of input data per worker task
+       * @param threads number of worker threads, or zero to use
+       *   the number of hardware threads available
+       * @throw std::bad_alloc if something breaks
+       * @throw api_exception on bad parameters or thread failure
+       */
+      brpar_state
+        ( uint32 block_size = 4096u, uint32 n = 1048560u,
+          size_t chain_length = 256u, uint32 segment_size = 4194304u,
+          unsigned int threads = 0u);
+      /**
+       * @brief Destructor.
+       * @note Waits for any tasks still running.
+       */
+      ~brpar_state(void);
+      /**
+       * @brief Move constructor.
+       */
+      brpar_state(brpar_state&& other) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this state
+       */
+      brpar_state& operator=(brpar_state&& other) noexcept;
+      brpar_state(brpar_state const& ) = delete;
+      brpar_state& operator=(brpar_state const& ) = delete;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `brpar_state` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `brpar_state[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `brpar_state` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `brpar_state[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public:
+      /**
+       * @ingroup methods
+       * @return the number of worker threads in use
+       */
+      unsigned int threads(void) const noexcept;
+
+    private:
+      friend struct brpar_access;
+    };
+    //END   brpar state
+
+    //BEGIN brpar state / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<brpar_state>;
+    //END   brpar state / exports
+
+    //BEGIN brpar state / allocation (namespace local)
+    /**
+     * @brief Non-throwing brpar state allocator.
+     * @param block_size amount of input data to process at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @param segment_size amount of input data per worker task
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a brpar state on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    brpar_state* brpar_new
+        ( uint32 block_size = 4096u, uint32 n = 1048560u,
+          size_t chain_length = 256u, uint32 segment_size = 4194304u,
+          unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Non-throwing brpar state allocator.
+     * @param block_size amount of input data to process at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @param segment_size amount of input data per worker task
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a brpar state on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<brpar_state> brpar_unique
+        ( uint32 block_size = 4096u, uint32 n = 1048560u,
+          size_t chain_length = 256u, uint32 segment_size = 4194304u,
+          unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Destroy a brpar state.
+     * @param x (nullable) the brpar state to destroy
+     */
+    TCMPLX_AP_API
+    void brpar_destroy(brpar_state* x) noexcept;
+    //END   brpar state / allocation (namespace local)
+
+    //BEGIN brpar state / namespace local
+    /**
+     * @brief Convert a byte stream to a Brotli stream using worker threads.
+     * @param state the parallel conversion state to use
+     * @param from source buffer
+     * @param from_end pointer to end of source buffer
+     * @param[out] from_next location of next byte to process
+     * @param to destination buffer
+     * @param to_end pointer to end of destination buffer
+     * @param[out] to_next location of next output byte
+     * @return api_error::Success when the destination is full,
+     *   api_error::Partial if more input is needed,
+     *   other nonzero otherwise
+     * @note Finished segments are written in input order. Output for
+     *   segments still in progress appears in later calls.
+     */
+    TCMPLX_AP_API
+    api_error brpar_out(brpar_state& state,
+        unsigned char const* from, unsigned char const* from_end,
+        unsigned char const*& from_next,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next);
+
+    /**
+     * @brief Finish a Brotli stream using worker threads.
+     * @param state the parallel conversion state to use
+     * @param to destination buffer
+     * @param to_end pointer to end of destination buffer
+     * @param[out] to_next location of next output byte
+     * @return api_error::Success when the destination is full,
+     *   api_error::EndOfFile at end of stream, other nonzero otherwise
+     * @note Blocks until the remaining segments are compressed.
+     */
+    TCMPLX_AP_API
+    api_error brpar_unshift(brpar_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next);
+    //END   brpar state / namespace local
+    /** @} */
+  };
+};
+
+#endif //hg_TextComplexAccessP_BrPar_H_
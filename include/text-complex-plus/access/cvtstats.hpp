@@ -0,0 +1,96 @@
+/**
+ * @file text-complex-plus/access/cvtstats.hpp
+ * @brief Conversion statistics
+ */
+#ifndef hg_TextComplexAccessP_CvtStats_H_
+#define hg_TextComplexAccessP_CvtStats_H_
+
+#include "api.hpp"
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @defgroup cvtstats Conversion statistics
+     *   (access/cvtstats.hpp)
+     * @{
+     */
+    //BEGIN conversion statistics
+    /**
+     * @brief Stage timers and counters for a conversion state.
+     * @note Counters accumulate across calls. Assign a value-initialized
+     *   `cvt_stats()` to start over.
+     * @note Building the library with `TextComplexAccessP_NO_STATS`
+     *   defined compiles out the collection; every field then stays zero.
+     *   Use @link cvt_stats_enabled @endlink to tell the two apart.
+     */
+    struct cvt_stats {
+      /**
+       * @brief Nanoseconds spent looking for matches, including
+       *   hash chain updates made by the match finder.
+       */
+      unsigned long long match_ns;
+      /** @brief Nanoseconds spent filling symbol histograms. */
+      unsigned long long histogram_ns;
+      /** @brief Nanoseconds spent building prefix code trees. */
+      unsigned long long tree_ns;
+      /**
+       * @brief Nanoseconds spent in conversion calls outside of the
+       *   other stages, mostly on bit emission.
+       */
+      unsigned long long emit_ns;
+      /**
+       * @brief Nanoseconds spent staging input and dictionary data
+       *   into the sliding window.
+       */
+      unsigned long long window_ns;
+      /** @brief Bytes consumed from the caller. */
+      unsigned long long bytes_in;
+      /** @brief Bytes produced for the caller. */
+      unsigned long long bytes_out;
+      /** @brief Blocks (or metablocks) stored without compression. */
+      unsigned long long stored_blocks;
+      /** @brief Blocks compressed with fixed prefix codes. */
+      unsigned long long fixed_blocks;
+      /** @brief Blocks (or metablocks) compressed with dynamic codes. */
+      unsigned long long dynamic_blocks;
+      /** @brief Metadata metablocks. */
+      unsigned long long metadata_blocks;
+      /** @brief Matches found by the match finder. */
+      unsigned long long matches;
+      /** @brief Bytes covered by matches. */
+      unsigned long long copy_bytes;
+      /** @brief Bytes left as literals by the match finder. */
+      unsigned long long literal_bytes;
+      /** @brief Positions searched in the hash chain. */
+      unsigned long long searches;
+      /** @brief Hash chain entries probed over all searches. */
+      unsigned long long probes;
+
+      /**
+       * @return the mean match length, or zero without matches
+       */
+      double average_match_length(void) const noexcept;
+      /**
+       * @return the mean hash chain probes per searched position,
+       *   or zero without searches
+       */
+      double probes_per_search(void) const noexcept;
+    };
+    //END   conversion statistics
+
+    //BEGIN conversion statistics / namespace local
+    /**
+     * @brief Check whether statistics collection was built in.
+     * @return false if the library was built with
+     *   `TextComplexAccessP_NO_STATS`, true otherwise
+     */
+    TCMPLX_AP_API
+    bool cvt_stats_enabled(void) noexcept;
+    //END   conversion statistics / namespace local
+    /** @} */
+  };
+};
+
+#include "cvtstats.txx"
+
+#endif //hg_TextComplexAccessP_CvtStats_H_
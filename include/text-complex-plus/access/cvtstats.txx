@@ -0,0 +1,30 @@
+/**
+ * @file text-complex-plus/access/cvtstats.txx
+ * @brief Conversion statistics
+ */
+#ifndef hg_TextComplexAccessP_CvtStats_Txx_
+#define hg_TextComplexAccessP_CvtStats_Txx_
+
+#ifndef hg_TextComplexAccessP_CvtStats_H_
+#  error "Use cvtstats.hpp instead."
+#endif //hg_TextComplexAccessP_CvtStats_H_
+
+namespace text_complex {
+  namespace access {
+    inline
+    double cvt_stats::average_match_length(void) const noexcept {
+      return matches
+        ? static_cast<double>(copy_bytes)/static_cast<double>(matches)
+        : 0.0;
+    }
+
+    inline
+    double cvt_stats::probes_per_search(void) const noexcept {
+      return searches
+        ? static_cast<double>(probes)/static_cast<double>(searches)
+        : 0.0;
+    }
+  };
+};
+
+#endif //hg_TextComplexAccessP_CvtStats_Txx_
@@ -522,6 +522,42 @@ namespace text_complex {
         unsigned int max_bits);
 #endif //TextComplexAccessP_NO_EXCEPT
 
+    /**
+     * @brief Generate prefix code lengths given a prefix list and
+     *   histogram of code frequencies, using caller-owned work space.
+     * @param dst list to populate with lengths
+     * @param table frequency histogram, flat array as long as number
+     *   of prefixes in the list
+     * @param max_bits maximum output length
+     * @param scratch work space; grown to three times the size of `dst`
+     *   only if smaller, so reusing it across calls avoids allocation
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   nonzero otherwise
+     */
+    TCMPLX_AP_API
+    void fixlist_gen_lengths
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, prefix_histogram& scratch,
+        api_error& ae) noexcept;
+
+#if  (!(defined TextComplexAccessP_NO_EXCEPT))
+    /**
+     * @brief Generate prefix code lengths given a prefix list and
+     *   histogram of code frequencies, using caller-owned work space.
+     * @param dst list to populate with lengths
+     * @param table frequency histogram, flat array as long as number
+     *   of prefixes in the list
+     * @param max_bits maximum output length
+     * @param scratch work space; grown to three times the size of `dst`
+     *   only if smaller, so reusing it across calls avoids allocation
+     * @throw api_exception on storage or code length error
+     */
+    TCMPLX_AP_API
+    void fixlist_gen_lengths
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, prefix_histogram& scratch);
+#endif //TextComplexAccessP_NO_EXCEPT
+
     /**
      * @brief Sort a prefix list by Huffman code.
      * @param dst list to sort
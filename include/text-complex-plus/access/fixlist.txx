@@ -41,6 +41,18 @@ namespace text_complex {
       } else return;
     }
 
+    inline
+    void fixlist_gen_lengths
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, prefix_histogram& scratch)
+    {
+      api_error ae;
+      fixlist_gen_lengths(dst, table, max_bits, scratch, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return;
+    }
+
     inline
     void fixlist_codesort(prefix_list& dst) {
       api_error ae;
@@ -0,0 +1,347 @@
+/**
+ * @file text-complex-plus/access/fontcache.hpp
+ * @brief Cache of decoded fonts
+ */
+#ifndef hg_TextComplexAccessP_FontCache_H_
+#define hg_TextComplexAccessP_FontCache_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace mmaptwo {
+  class mmaptwo_i;
+};
+
+namespace text_complex {
+  namespace access {
+    class offset_table;
+    class sequential;
+    class task_pool;
+    class woff2;
+    struct font_image;
+    struct fontcache_core;
+
+    /**
+     * @defgroup fontcache Cache of decoded fonts
+     *   (access/fontcache.hpp)
+     * @{
+     */
+    //BEGIN font cache / hash
+    /**
+     * @brief Compute the content hash of a buffer.
+     * @param s bytes to hash
+     * @param n number of bytes
+     * @return a 64-bit hash (XXH64 with seed zero)
+     */
+    TCMPLX_AP_API
+    uint64 fontcache_hash(unsigned char const* s, size_t n) noexcept;
+
+    /**
+     * @brief Compute the content hash of a stream.
+     * @param seq stream to hash from the read position to the end
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @return a 64-bit hash, equal to the buffer hash of the same bytes
+     * @note The stream is read through its mapped windows, without
+     *   copies; the read position ends at the end of the stream.
+     */
+    TCMPLX_AP_API
+    uint64 fontcache_hash(sequential& seq, api_error& ae) noexcept;
+    //END   font cache / hash
+
+    //BEGIN font view
+    /**
+     * @brief Shared read-only view of a decoded font.
+     * @note Copies share the font. The font stays alive as long as any
+     *   view of it, even after the cache evicts it.
+     */
+    class TCMPLX_AP_API font_view final {
+    private:
+      font_image* image;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor for an empty view.
+       */
+      font_view(void) noexcept;
+      /**
+       * @brief Destructor.
+       */
+      ~font_view(void);
+      /**
+       * @brief Copy constructor.
+       */
+      font_view(font_view const& ) noexcept;
+      /**
+       * @brief Copy assignment operator.
+       * @return this font view
+       */
+      font_view& operator=(font_view const& ) noexcept;
+      /**
+       * @brief Move constructor.
+       */
+      font_view(font_view&& ) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this font view
+       */
+      font_view& operator=(font_view&& ) noexcept;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `font_view` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `font_view[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `font_view` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `font_view[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public: /** @name methods *//** @{ */
+      /**
+       * @brief Check whether the view holds a font.
+       * @return true for an empty view
+       */
+      bool empty(void) const noexcept;
+      /**
+       * @brief Access the decoded sfnt image.
+       * @return the start of the image, or `nullptr` for an empty view
+       */
+      unsigned char const* get_data(void) const noexcept;
+      /**
+       * @brief Query the length of the decoded sfnt image.
+       * @return a length in bytes
+       */
+      size_t size(void) const noexcept;
+      /**
+       * @brief Acquire the list of tables in the decoded image.
+       * @return (nullable) an offset table, with offsets from the start
+       *   of the image
+       */
+      offset_table const* get_offsets(void) const noexcept;
+      /**
+       * @brief Query the cache key of the font.
+       * @return the content hash of the source
+       */
+      uint64 get_key(void) const noexcept;
+      /** @} */
+
+    private:
+      explicit font_view(font_image* ) noexcept;
+      friend class font_cache;
+    };
+    //END   font view
+
+    //BEGIN font cache
+    /**
+     * @brief Counters of a font cache.
+     */
+    struct TCMPLX_AP_API fontcache_stats final {
+      /** @brief Lookups served from the cache. */
+      size_t hits;
+      /** @brief Lookups that found nothing. */
+      size_t misses;
+      /** @brief Fonts dropped to stay under the memory cap. */
+      size_t evictions;
+      /** @brief Fonts held by the cache. */
+      size_t entries;
+      /** @brief Bytes held by the cache. */
+      size_t bytes;
+      /** @brief Memory cap in bytes. */
+      size_t capacity;
+    };
+
+    /**
+     * @brief Thread-safe cache of decoded fonts, keyed by content hash.
+     * @note The least recently used fonts go first when the held bytes
+     *   exceed the memory cap. A font larger than the cap is handed out
+     *   but not kept.
+     */
+    class TCMPLX_AP_API font_cache final {
+    private:
+      fontcache_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param capacity memory cap in bytes
+       * @throw std::bad_alloc if something breaks
+       */
+      font_cache(size_t capacity = 67108864u);
+      /**
+       * @brief Destructor.
+       * @note Views handed out stay valid.
+       */
+      ~font_cache(void);
+      /**
+       * @brief Copy constructor.
+       */
+      font_cache(font_cache const& ) = delete;
+      /**
+       * @brief Copy assignment operator.
+       * @return this font cache
+       */
+      font_cache& operator=(font_cache const& ) = delete;
+      /**
+       * @brief Move constructor.
+       */
+      font_cache(font_cache&& ) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this font cache
+       */
+      font_cache& operator=(font_cache&& ) noexcept;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `font_cache` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `font_cache[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `font_cache` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `font_cache[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public: /** @name methods *//** @{ */
+      /**
+       * @brief Look up a font.
+       * @param key content hash of the source
+       * @return a view of the font, or an empty view if not cached
+       */
+      font_view find(uint64 key) noexcept;
+      /**
+       * @brief Decode a WOFF2 file through the cache.
+       * @param xfh source file; the cache does not take ownership
+       * @param pool (nullable) worker threads for decoding
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize on a bad file, other value on failure
+       * @return a view of the decoded font, or an empty view on failure
+       * @note The source is hashed through a @link sequential @endlink
+       *   and decoded only on a miss. A hit also needs the same source
+       *   length and the same hash under a seed private to this cache,
+       *   so files whose content hashes collide never share a font.
+       */
+      font_view fetch(mmaptwo::mmaptwo_i* xfh, task_pool* pool,
+          api_error& ae) noexcept;
+      /**
+       * @brief Decode a WOFF2 file through the cache.
+       * @param xfh source file; the cache does not take ownership
+       * @param pool (nullable) worker threads for decoding
+       * @return a view of the decoded font
+       * @throw api_exception on failure
+       */
+      font_view fetch(mmaptwo::mmaptwo_i* xfh, task_pool* pool = nullptr);
+      /**
+       * @brief Decode an open WOFF2 file into the cache.
+       * @param key content hash of the source
+       * @param src the file to decode
+       * @param pool (nullable) worker threads for decoding
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   other value on failure
+       * @return a view of the decoded font, or an empty view on failure
+       * @note If the key is already cached, nothing is decoded. The
+       *   key alone identifies the font, so a later fetch of a file
+       *   with the same content hash decodes that file and replaces it.
+       */
+      font_view insert(uint64 key, woff2& src, task_pool* pool,
+          api_error& ae) noexcept;
+      /**
+       * @brief Query the counters.
+       * @return a snapshot of the counters
+       */
+      fontcache_stats get_stats(void) const noexcept;
+      /**
+       * @brief Change the memory cap.
+       * @param capacity memory cap in bytes
+       * @note Evicts fonts as needed to fit under the new cap.
+       */
+      void set_capacity(size_t capacity) noexcept;
+      /**
+       * @brief Drop all fonts.
+       * @note Dropped fonts do not count as evictions.
+       */
+      void clear(void) noexcept;
+      /** @} */
+
+    private: /** @name rule-of-six *//** @{ */
+      void transfer(font_cache&& ) noexcept;
+      void transfer(font_cache const& ) = delete;
+      /** @} */
+    };
+    //END   font cache
+
+    //BEGIN font cache / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<font_cache>;
+    //END   font cache / exports
+
+    //BEGIN font cache / namespace local
+    /**
+     * @brief Non-throwing font cache allocator.
+     * @param capacity memory cap in bytes
+     * @return a font cache on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    font_cache* fontcache_new(size_t capacity = 67108864u) noexcept;
+
+    /**
+     * @brief Non-throwing font cache allocator.
+     * @param capacity memory cap in bytes
+     * @return a font cache on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<font_cache> fontcache_unique
+      (size_t capacity = 67108864u) noexcept;
+
+    /**
+     * @brief Destroy a font cache.
+     * @param x (nullable) the font cache to destroy
+     */
+    TCMPLX_AP_API
+    void fontcache_destroy(font_cache* x) noexcept;
+    //END   font cache / namespace local
+    /** @} */
+  };
+};
+
+#endif //hg_TextComplexAccessP_FontCache_H_
@@ -52,13 +52,15 @@ namespace text_complex {
       ~hash_chain(void);
       /**
        * @brief Copy constructor.
+       * @throw std::bad_alloc if something breaks
        */
-      hash_chain(hash_chain const& ) = delete;
+      hash_chain(hash_chain const& );
       /**
        * @brief Copy assignment operator.
        * @return this hash chain
+       * @throw std::bad_alloc if something breaks
        */
-      hash_chain& operator=(hash_chain const& ) = delete;
+      hash_chain& operator=(hash_chain const& );
       /**
        * @brief Move constructor.
        */
@@ -148,10 +150,26 @@ namespace text_complex {
        *   sequence, or #npos if not found
        */
       uint32 find(unsigned char const* b, uint32 pos = 0u) const noexcept;
+      /**
+       * @brief Search for a byte sequence.
+       * @param b three byte sequence for which to look
+       * @param pos number of bytes to go back; zero is most recent
+       * @param[in,out] probes counter to which to add the number of
+       *   chain entries examined
+       * @return a backward distance where to find the three-byte
+       *   sequence, or #npos if not found
+       */
+      uint32 find
+        (unsigned char const* b, uint32 pos, size_t& probes) const noexcept;
+      /**
+       * @brief Forget all past bytes and chain entries.
+       * @note The storage stays allocated for reuse.
+       */
+      void clear(void) noexcept;
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
-      //void duplicate(hash_chain const& );
+      void duplicate(hash_chain const& );
       void transfer(hash_chain&& ) noexcept;
       void transfer(hash_chain const& ) = delete;
       /** @} */
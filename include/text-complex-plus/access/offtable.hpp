@@ -11,6 +11,8 @@
 
 namespace text_complex {
   namespace access {
+    struct offset_key;
+
     /**
      * @defgroup offtable Access point for TrueType files
      *   (access/offtable.hpp)
@@ -40,6 +42,20 @@ namespace text_complex {
        */
       uint32 length;
     };
+
+    /**
+     * \brief View of a table's bytes.
+     */
+    struct TCMPLX_AP_API table_span final {
+      /**
+       * \brief First byte of the table.
+       */
+      unsigned char const* data;
+      /**
+       * \brief Length of the table in bytes, without padding.
+       */
+      size_t size;
+    };
     //END   offset line
 
     //BEGIN offset table
@@ -50,6 +66,7 @@ namespace text_complex {
     private:
       struct offset_line* p;
       size_t n;
+      struct offset_key* ix;
 
     public: /** @name container-compat *//** @{ */
       /** @brief Type holds the size of an offset table. */
@@ -125,6 +142,7 @@ namespace text_complex {
       /**
        * \brief `begin` method for range-based `for`.
        * \return a pointer to the first line, or `nullptr` for empty tables
+       * \note Drops the tag index, as the lines may change.
        */
       offset_line* begin(void) noexcept;
       /**
@@ -136,6 +154,7 @@ namespace text_complex {
        * \brief `end` method for range-based `for`.
        * \return a pointer to one-past the last line,
        *   or `nullptr` for empty tables
+       * \note Drops the tag index, as the lines may change.
        */
       offset_line* end(void) noexcept;
       /**
@@ -156,6 +175,7 @@ namespace text_complex {
        * \brief Array index operator.
        * \param i array index
        * \return a reference to the line at the given index
+       * \note Drops the tag index, as the line may change.
        */
       offset_line& operator[](size_t i) noexcept;
       /**
@@ -169,6 +189,7 @@ namespace text_complex {
        * \param i an array index
        * \return a reference to an offset line
        * \throw std::out_of_range on bad index
+       * \note Drops the tag index, as the line may change.
        */
       offset_line& at(size_t i);
       /**
@@ -178,6 +199,29 @@ namespace text_complex {
        * \throw std::out_of_range on bad index
        */
       offset_line const& at(size_t i) const;
+      /**
+       * \brief Build the tag lookup index.
+       * \throw std::bad_alloc on allocation error
+       * \note Call after filling the table. Writable access to the
+       *   lines drops the index; until the next call,
+       *   @link find @endlink scans the lines.
+       */
+      void reindex(void);
+      /**
+       * \brief Find a line by tag.
+       * \param tag four-byte table tag
+       * \return the index of the first line with the tag,
+       *   or @link size @endlink if none match
+       */
+      size_t find(unsigned char const* tag) const noexcept;
+      /**
+       * \brief Find a line by tag.
+       * \param tag table tag packed big-endian into an integer
+       *   (for example `0x68656164` for `head`)
+       * \return the index of the first line with the tag,
+       *   or @link size @endlink if none match
+       */
+      size_t find(uint32 tag) const noexcept;
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
@@ -185,6 +229,7 @@ namespace text_complex {
       void transfer(offset_table&& ) noexcept;
       void transfer(offset_table const& ) = delete;
       void resize(size_t n);
+      void drop_index(void) noexcept;
       /** @} */
     };
     //END   offset table
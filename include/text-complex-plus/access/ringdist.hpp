@@ -196,6 +196,15 @@ namespace text_complex {
        * @param[out] ae Success on success, nonzero otherwise
        */
       void reconfigure(bool special, unsigned int direct, unsigned int postfix);
+
+      /**
+       * @ingroup ringdist-methods
+       * @brief Mark all ring entries as unknown.
+       * @note Used by encoders that start mid-stream, where the decoder's
+       *   ring contents cannot be predicted. Unknown entries never match
+       *   during encoding, so output stays valid for any decoder history.
+       */
+      void forget(void) noexcept;
       /** @} */
     };
     //END   distance ring
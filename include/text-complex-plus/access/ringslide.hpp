@@ -139,6 +139,11 @@ namespace text_complex {
        * @return a sliding window size
        */
       uint32 extent(void) const noexcept;
+      /**
+       * @brief Forget all past bytes.
+       * @note The storage stays allocated for reuse.
+       */
+      void clear(void) noexcept;
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
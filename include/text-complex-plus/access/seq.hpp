@@ -41,6 +41,33 @@ namespace text_complex {
     };
     //END   sequential whence
 
+    //BEGIN sequential window
+    /**
+     * @brief Policy for sizing the mapped window of a sequential.
+     */
+    enum struct seq_window : int {
+      /**
+       * @brief Map two system pages around the read position.
+       */
+      Page = 0,
+      /**
+       * @brief Map a window of a fixed size.
+       */
+      Fixed = 1,
+      /**
+       * @brief Start with two pages and double the window each time
+       *   a read runs off its end, up to a maximum size.
+       * @note Seeking outside of the window starts over at two pages.
+       */
+      Adaptive = 2,
+      /**
+       * @brief Map the whole file at once if it fits in the maximum size,
+       *   else fall back to a fixed window of that size.
+       */
+      Whole = 3
+    };
+    //END   sequential window
+
     //BEGIN sequential
     /**
      * @brief Adapter providing sequential access to bytes from a mmaptwo
@@ -53,6 +80,9 @@ namespace text_complex {
       size_t pos;
       size_t off;
       size_t last;
+      seq_window wmode;
+      size_t wsize;
+      size_t wcur;
 
     public: /** @name rule-of-six*//** @{ */
       /**
@@ -120,6 +150,11 @@ namespace text_complex {
        * @return a read position
        */
       size_t get_pos(void) const noexcept;
+      /**
+       * @brief Query the length of the underlying file.
+       * @return a length in bytes, or zero if no file access is set
+       */
+      size_t get_length(void) const noexcept;
       /**
        * @brief Configure the read position.
        * @param i a read position
@@ -139,6 +174,101 @@ namespace text_complex {
        * @return the byte on success, -1 at end of stream, -2 otherwise
        */
       int get_byte(void) noexcept;
+      /**
+       * @brief Read several bytes from the sequential.
+       * @param[out] buf destination buffer
+       * @param n number of bytes to read
+       * @return the number of bytes read, less than `n` only at end
+       *   of stream or on error
+       */
+      size_t read(void* buf, size_t n) noexcept;
+      /**
+       * @brief Access bytes at the read position without copying.
+       * @param n number of bytes needed
+       * @return a pointer to `n` contiguous bytes in mapped memory,
+       *   or `nullptr` if fewer than `n` bytes remain or on error
+       * @note Does not move the read position. The pointer is valid
+       *   until the next call that reads or moves the position.
+       */
+      unsigned char const* peek_span(size_t n) noexcept;
+      /**
+       * @brief Read a big-endian 16-bit unsigned integer.
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize if the stream is too short,
+       *   other value on failure
+       * @return the integer
+       * @note On failure, the read position is left unchanged.
+       */
+      unsigned short read_u16be(api_error& ae) noexcept;
+      /**
+       * @brief Read a big-endian 16-bit unsigned integer.
+       * @return the integer
+       * @throw api_exception on failure
+       */
+      unsigned short read_u16be(void);
+      /**
+       * @brief Read a big-endian 32-bit unsigned integer.
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize if the stream is too short,
+       *   other value on failure
+       * @return the integer
+       * @note On failure, the read position is left unchanged.
+       */
+      uint32 read_u32be(api_error& ae) noexcept;
+      /**
+       * @brief Read a big-endian 32-bit unsigned integer.
+       * @return the integer
+       * @throw api_exception on failure
+       */
+      uint32 read_u32be(void);
+      /**
+       * @brief Read a WOFF2 `UIntBase128` integer.
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize if the encoding is bad or too short,
+       *   other value on failure
+       * @return the integer
+       * @note On failure, the read position is left unchanged.
+       */
+      uint32 read_uv128(api_error& ae) noexcept;
+      /**
+       * @brief Read a WOFF2 `UIntBase128` integer.
+       * @return the integer
+       * @throw api_exception on failure
+       */
+      uint32 read_uv128(void);
+      /**
+       * @brief Read a WOFF2 `255UInt16` integer.
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize if the stream is too short,
+       *   other value on failure
+       * @return the integer
+       * @note On failure, the read position is left unchanged.
+       */
+      unsigned short read_u255(api_error& ae) noexcept;
+      /**
+       * @brief Read a WOFF2 `255UInt16` integer.
+       * @return the integer
+       * @throw api_exception on failure
+       */
+      unsigned short read_u255(void);
+      /**
+       * @brief Configure the mapped window policy.
+       * @param mode a @link seq_window @endlink value
+       * @param size maximum window size in bytes, or zero for the default
+       *   of 64 MiB (or no limit for seq_window::Whole)
+       * @note Takes effect at the next remapping.
+       */
+      void set_window(seq_window mode, size_t size = 0u) noexcept;
+      /**
+       * @brief Query the mapped window policy.
+       * @return a @link seq_window @endlink value
+       */
+      seq_window get_window(void) const noexcept;
+      /**
+       * @brief Query the maximum window size.
+       * @return a size in bytes, or zero for the policy default
+       */
+      size_t get_window_size(void) const noexcept;
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
@@ -148,7 +278,8 @@ namespace text_complex {
       /** @} */
 
     private:
-      bool reset_sync(size_t);
+      bool reset_sync(size_t, size_t need = 1u);
+      size_t window_for(size_t p, size_t len, size_t pagesize) noexcept;
     };
     //END   sequential
 
@@ -189,6 +320,7 @@ namespace text_complex {
 
 #if  (!(defined TextComplexAccessP_NO_IOSTREAM)) \
   && (!(defined TextComplexAccessP_NO_LOCALE))
+#include <new>
 #include <streambuf>
 #include <istream>
 #include <locale>
@@ -353,6 +485,23 @@ namespace text_complex {
        * @see `std::streambuf::setbuf`
        */
       std::basic_streambuf<ch,tr>* setbuf(ch* s, std::streamsize n) override;
+      /**
+       * @brief `xsgetn` implementation for `std::streambuf` interface.
+       * @param s destination buffer
+       * @param n number of values to read
+       * @return the number of values read
+       * @note Without conversion, large reads copy directly from the
+       *   mapped file, bypassing the get buffer.
+       * @see `std::streambuf::xsgetn`
+       */
+      std::streamsize xsgetn(ch* s, std::streamsize n) override;
+      /**
+       * @brief `showmanyc` implementation for `std::streambuf` interface.
+       * @return the number of values certainly available past the
+       *   get buffer, or -1 at end of stream
+       * @see `std::streambuf::showmanyc`
+       */
+      std::streamsize showmanyc(void) override;
       /** @} */
 
     private:
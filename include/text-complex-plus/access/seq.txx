@@ -8,6 +8,50 @@
 
 #include "seq.hpp"
 
+namespace text_complex {
+  namespace access {
+#if  (!(defined TextComplexAccessP_NO_EXCEPT))
+    //BEGIN sequential / exceptional
+    inline
+    unsigned short sequential::read_u16be(void) {
+      api_error ae;
+      unsigned short const out = read_u16be(ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    uint32 sequential::read_u32be(void) {
+      api_error ae;
+      uint32 const out = read_u32be(ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    uint32 sequential::read_uv128(void) {
+      api_error ae;
+      uint32 const out = read_uv128(ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    unsigned short sequential::read_u255(void) {
+      api_error ae;
+      unsigned short const out = read_u255(ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+    //END   sequential / exceptional
+#endif //TextComplexAccessP_NO_EXCEPT
+  };
+};
+
 #if  (!(defined TextComplexAccessP_NO_IOSTREAM)) \
   && (!(defined TextComplexAccessP_NO_LOCALE))
 namespace text_complex {
@@ -57,13 +101,14 @@ namespace text_complex {
         ch* const transfer_sb_buf = other.sb_buf;
         std::size_t transfer_sb_size = other.sb_size;
         std::streamsize right_sb_retell =
-          other.sb_retellp ? other.sb_retellp-sb_buf : -1;
+          other.sb_retellp ? other.sb_retellp-other.sb_buf : -1;
         ch transfer_sb_one = static_cast<ch&&>(other.sb_one);
+        bool const transfer_one = (transfer_sb_buf == &other.sb_one);
         other.sb_buf = nullptr;
         other.sb_size = 0u;
         /* reset */
         sb_dropbuf();
-        sb_buf = transfer_sb_buf;
+        sb_buf = transfer_one ? &sb_one : transfer_sb_buf;
         sb_size = transfer_sb_size;
         sb_one = static_cast<ch&&>(transfer_sb_one);
         sb_retellp = (right_sb_retell < 0) ? nullptr : sb_buf+right_sb_retell;
@@ -129,7 +174,7 @@ namespace text_complex {
         ch tmp_sb_one;
         std::streamsize left_sb_retell = sb_retellp ? sb_retellp-sb_buf : -1;
         std::streamsize right_sb_retell =
-          other.sb_retellp ? other.sb_retellp-sb_buf : -1;
+          other.sb_retellp ? other.sb_retellp-other.sb_buf : -1;
         tmp_sb_one = static_cast<ch&&>(sb_one);
         tmp_sb_buf = ((sb_buf==&sb_one) ? &tmp_sb_one : sb_buf);
             sb_one = static_cast<ch&&>(other.sb_one);
@@ -489,6 +534,7 @@ namespace text_complex {
         if (retellg_res == 0) {
           seq_startpos = pos;
           seq_startmb = mb;
+          sb_dropbuf();
           sb_buf = s;
           sb_size = static_cast<std::size_t>(n);
           sb_retellp = s;
@@ -499,6 +545,73 @@ namespace text_complex {
       }
       return /*unconditional*/ this;
     }
+
+    template <class ch, class tr>
+    std::streamsize basic_sequentialbuf<ch,tr>::xsgetn
+        (ch* s, std::streamsize n)
+    {
+      using mb_type = typename tr::state_type;
+      std::streamsize count = 0;
+      if (n <= 0)
+        return 0;
+      /* drain the get buffer */{
+        std::streamsize const avail = this->egptr()-this->gptr();
+        if (avail > 0) {
+          count = (avail < n) ? avail : n;
+          tr::copy(s, this->gptr(), static_cast<std::size_t>(count));
+          this->gbump(static_cast<int>(count));
+        }
+      }
+      if (count >= n) {
+        return count;
+      } else if (seq && seq_noconv && sizeof(ch) == 1u
+      &&  static_cast<std::size_t>(n-count) >= sb_size)
+      {
+        /* large read: copy straight from the mapped pages */
+        std::size_t pos;
+        mb_type mb;
+        if (seq_retellg(pos, mb) != 0 || seq->set_pos(pos) != pos)
+          return count;
+        std::size_t const got =
+          seq->read(s+count, static_cast<std::size_t>(n-count));
+        ch *const to = sb_getbuf();
+        seq_startpos = pos+got;
+        seq_startmb = mb;
+        sb_retellp = to;
+        sb_error_loss = 0u;
+        this->setg(to,to,to);
+        return count + static_cast<std::streamsize>(got);
+      } else {
+        return count + std::basic_streambuf<ch,tr>::xsgetn(s+count, n-count);
+      }
+    }
+
+    template <class ch, class tr>
+    std::streamsize basic_sequentialbuf<ch,tr>::showmanyc(void) {
+      using mb_type = typename tr::state_type;
+      if (!seq)
+        return -1;
+      std::size_t pos;
+      mb_type mb;
+      if (seq_noconv) {
+        /* get buffer is empty here, so the next byte is at its end */
+        pos = seq_startpos
+          + static_cast<std::size_t>(this->egptr()-this->eback());
+      } else if (seq_retellg(pos, mb) != 0) {
+        return 0;
+      }
+      std::size_t const len = seq->get_length();
+      if (pos >= len)
+        return -1;
+      else if (!seq_noconv) {
+        /* at least one byte remains; the character count is unknown */
+        return 0;
+      }
+      std::size_t const left = len-pos;
+      return (left > static_cast<std::size_t>(util_ssize_max()))
+        ? static_cast<std::streamsize>(util_ssize_max())
+        : static_cast<std::streamsize>(left);
+    }
     //END   sequential streambuf / protected streambuf-override
 
     //BEGIN sequential streambuf / private methods
@@ -514,9 +627,16 @@ namespace text_complex {
 
     template <class ch, class tr>
     ch* basic_sequentialbuf<ch,tr>::sb_getbuf(void) {
+      constexpr std::size_t sb_default = 4096u;
       if (!sb_buf) {
-        sb_buf = &sb_one;
-        sb_size = 1u;
+        sb_buf = new (std::nothrow) ch[sb_default];
+        if (sb_buf) {
+          sb_size = sb_default;
+        } else {
+          /* fall back to unbuffered */
+          sb_buf = &sb_one;
+          sb_size = 1u;
+        }
         sb_external = false;
       }
       return sb_buf;
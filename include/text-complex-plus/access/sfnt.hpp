@@ -0,0 +1,250 @@
+/**
+ * @file text-complex-plus/access/sfnt.hpp
+ * @brief TrueType and OpenType file utility API
+ * @author Cody Licorish (svgmovement@gmail.com)
+ */
+#ifndef hg_TextComplexAccessP_Sfnt_H_
+#define hg_TextComplexAccessP_Sfnt_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace mmaptwo {
+  class mmaptwo_i;
+};
+
+namespace text_complex {
+  namespace access {
+    class offset_table;
+    struct table_span;
+    struct sfnt_core;
+
+    /**
+     * @defgroup sfnt TrueType and OpenType file utility API
+     *   (access/sfnt.hpp)
+     * @{
+     */
+    //BEGIN sfnt
+    /**
+     * @brief Plain sfnt (TrueType, OpenType or collection) access
+     */
+    TCMPLX_AP_API
+    class sfnt final {
+    private:
+      mmaptwo::mmaptwo_i* fh;
+      offset_table* offsets;
+      sfnt_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param xfh File access instance to use for the sfnt.
+       * @param sane_tf Sanitize the file before processing. (Default to true)
+       * @throw std::bad_alloc if something breaks
+       * @throw api_exception on a bad header or table directory
+       * @note Sanitizing also verifies the checksum of each table.
+       */
+      sfnt(mmaptwo::mmaptwo_i* xfh, bool sane_tf = true);
+      /**
+       * @brief Destructor.
+       */
+      ~sfnt(void);
+      /**
+       * @brief Copy constructor.
+       */
+      sfnt(sfnt const& ) = delete;
+      /**
+       * @brief Copy assignment operator.
+       * @return this sfnt
+       */
+      sfnt& operator=(sfnt const& ) = delete;
+      /**
+       * @brief Move constructor.
+       */
+      sfnt(sfnt&& ) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this sfnt
+       */
+      sfnt& operator=(sfnt&& ) noexcept;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `sfnt` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `sfnt[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `sfnt` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `sfnt[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public: /** @name methods *//** @{ */
+      /**
+       * @brief Acquire the list of tables.
+       * @return an offset table, with offsets from the start of the file
+       * @note Tables shared by fonts of a collection appear once.
+       */
+      offset_table const& get_offsets(void) const noexcept;
+      /**
+       * @brief Query the flavor of the font.
+       * @return the sfnt version of the font, or `0x74746366` (`ttcf`)
+       *   for font collections
+       */
+      uint32 get_flavor(void) const noexcept;
+      /**
+       * @brief Query the number of fonts in the file.
+       * @return the number of fonts in a collection, or one otherwise
+       */
+      size_t font_count(void) const noexcept;
+      /**
+       * @brief Query the flavor of one font.
+       * @param font index of a font in the collection
+       * @return the sfnt version of the font, or zero if out of range
+       */
+      uint32 get_flavor(size_t font) const noexcept;
+      /**
+       * @brief Query the number of tables in one font.
+       * @param font index of a font in the collection
+       * @return the length of the font's table directory
+       */
+      size_t font_table_count(size_t font) const noexcept;
+      /**
+       * @brief Look up one table of one font.
+       * @param font index of a font in the collection
+       * @param j position in the font's table directory
+       * @return an index into the offset table, or the size of
+       *   the offset table if out of range
+       */
+      size_t font_table(size_t font, size_t j) const noexcept;
+      /**
+       * @brief Access one table by position.
+       * @param i index into the offset table
+       * @return a view of the table, valid for the life of the sfnt,
+       *   or an empty view if out of range
+       */
+      table_span table_at(size_t i) const noexcept;
+      /**
+       * @brief Access one table.
+       * @param tag four-byte table tag
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::OutOfRange if no table has the tag,
+       *   other value on failure
+       * @return a view of the table, valid for the life of the sfnt
+       * @note The view points into the file mapping; nothing is copied.
+       * @note In a collection, the first table with the tag is used.
+       */
+      table_span table(unsigned char const* tag, api_error& ae) noexcept;
+      /**
+       * @brief Access one table.
+       * @param tag four-byte table tag
+       * @return a view of the table, valid for the life of the sfnt
+       * @throw api_exception on failure
+       */
+      table_span table(unsigned char const* tag);
+      /**
+       * @brief Access one table of one font.
+       * @param font index of a font in the collection
+       * @param tag four-byte table tag
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::OutOfRange if the font lacks the table,
+       *   other value on failure
+       * @return a view of the table, valid for the life of the sfnt
+       */
+      table_span table(size_t font, unsigned char const* tag,
+          api_error& ae) noexcept;
+      /** @} */
+
+    private: /** @name rule-of-six *//** @{ */
+      void transfer(sfnt&& ) noexcept;
+      void transfer(sfnt const& ) = delete;
+      void initparse(bool);
+      /** @} */
+    };
+    //END   sfnt
+
+    //BEGIN sfnt / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<sfnt>;
+    //END   sfnt / exports
+
+    //BEGIN sfnt / namespace local
+    /**
+     * @brief Non-throwing sfnt allocator.
+     * @param xfh File access instance to use for the sfnt.
+     * @param sane_tf Sanitize the file before processing. (Default to true)
+     * @return an sfnt on success, `nullptr` otherwise
+     * @note The sfnt takes ownership of the mmaptwo instance on success.
+     */
+    TCMPLX_AP_API
+    sfnt* sfnt_new(mmaptwo::mmaptwo_i* xfh, bool sane_tf = true) noexcept;
+
+    /**
+     * @brief Non-throwing sfnt allocator.
+     * @param xfh File access instance to use for the sfnt.
+     * @param sane_tf Sanitize the file before processing. (Default to true)
+     * @return an sfnt on success, `nullptr` otherwise
+     * @note The sfnt takes ownership of the mmaptwo instance on success.
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<sfnt> sfnt_unique
+      (mmaptwo::mmaptwo_i* xfh, bool sane_tf = true) noexcept;
+
+    /**
+     * @brief Destroy an sfnt.
+     * @param x (nullable) the sfnt to destroy
+     */
+    TCMPLX_AP_API
+    void sfnt_destroy(sfnt* x) noexcept;
+    //END   sfnt / namespace local
+
+    //BEGIN sfnt / checksum
+    /**
+     * @brief Sum a piece of a table as big-endian 32-bit words.
+     * @param s bytes to sum
+     * @param n number of bytes
+     * @param pos offset of the first byte from the start of the table
+     * @return the partial checksum, modulo 2<sup>32</sup>
+     * @note Missing bytes of the last word count as zero, so the sums
+     *   of consecutive pieces add up to the sum of the whole table.
+     */
+    TCMPLX_AP_API
+    uint32 sfnt_checksum
+      (unsigned char const* s, size_t n, size_t pos = 0u) noexcept;
+
+    /**
+     * @brief Compute the directory checksum of a table.
+     * @param tag four-byte table tag
+     * @param s table contents
+     * @param n table length in bytes
+     * @return the checksum, skipping the `checkSumAdjustment` field
+     *   of a `head` table
+     */
+    TCMPLX_AP_API
+    uint32 sfnt_table_checksum
+      (unsigned char const* tag, unsigned char const* s, size_t n) noexcept;
+    //END   sfnt / checksum
+    /** @} */
+  };
+};
+
+#endif //hg_TextComplexAccessP_Sfnt_H_
@@ -0,0 +1,163 @@
+/**
+ * @file text-complex-plus/access/taskpool.hpp
+ * @brief Worker thread pool
+ */
+#ifndef hg_TextComplexAccessP_TaskPool_H_
+#define hg_TextComplexAccessP_TaskPool_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @defgroup taskpool Worker thread pool
+     *   (access/taskpool.hpp)
+     * @{
+     */
+    //BEGIN task pool
+    /**
+     * @brief Task entry point.
+     * @param arg task argument given at posting time
+     */
+    typedef void (*task_callback)(void* arg);
+
+    struct taskpool_core;
+
+    /**
+     * @brief Fixed-size pool of worker threads.
+     * @note Tasks run in the order posted, but may finish in any order.
+     */
+    class TCMPLX_AP_API task_pool final {
+    private:
+      taskpool_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param threads number of worker threads, or zero to use
+       *   the number of hardware threads available
+       * @throw std::bad_alloc if something breaks
+       * @throw api_exception if a worker thread could not be started
+       */
+      task_pool(unsigned int threads = 0u);
+      /**
+       * @brief Destructor.
+       * @note Waits for all posted tasks to finish.
+       */
+      ~task_pool(void);
+      /**
+       * @brief Move constructor.
+       */
+      task_pool(task_pool&& other) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this task pool
+       */
+      task_pool& operator=(task_pool&& other) noexcept;
+      task_pool(task_pool const& ) = delete;
+      task_pool& operator=(task_pool const& ) = delete;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `task_pool` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `task_pool[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `task_pool` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `task_pool[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public:
+      /**
+       * @ingroup taskpool-methods
+       * @brief Query the number of worker threads.
+       * @return a thread count, or zero for a moved-from pool
+       */
+      unsigned int size(void) const noexcept;
+      /**
+       * @ingroup taskpool-methods
+       * @brief Queue a task for a worker thread.
+       * @param fn task entry point
+       * @param arg argument to pass to the task
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   other value on failure
+       */
+      void post(task_callback fn, void* arg, api_error& ae) noexcept;
+#if  (!(defined TextComplexAccessP_NO_EXCEPT))
+      /**
+       * @ingroup taskpool-methods
+       * @brief Queue a task for a worker thread.
+       * @param fn task entry point
+       * @param arg argument to pass to the task
+       * @throw api_exception on failure
+       */
+      void post(task_callback fn, void* arg);
+#endif //TextComplexAccessP_NO_EXCEPT
+      /**
+       * @ingroup taskpool-methods
+       * @brief Wait until all posted tasks have finished.
+       */
+      void wait(void) noexcept;
+    };
+    //END   task pool
+
+    //BEGIN task pool / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<task_pool>;
+    //END   task pool / exports
+
+    //BEGIN task pool / allocation (namespace local)
+    /**
+     * @brief Non-throwing task pool allocator.
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a task pool on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    task_pool* taskpool_new(unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Non-throwing task pool allocator.
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a task pool on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<task_pool> taskpool_unique(unsigned int threads = 0u)
+      noexcept;
+
+    /**
+     * @brief Destroy a task pool.
+     * @param x (nullable) the task pool to destroy
+     */
+    TCMPLX_AP_API
+    void taskpool_destroy(task_pool* x) noexcept;
+    //END   task pool / allocation (namespace local)
+    /** @} */
+  };
+};
+
+#include "taskpool.txx"
+
+#endif //hg_TextComplexAccessP_TaskPool_H_
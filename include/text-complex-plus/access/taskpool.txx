@@ -0,0 +1,26 @@
+/**
+ * @file text-complex-plus/access/taskpool.txx
+ * @brief Worker thread pool
+ */
+#ifndef hg_TextComplexAccessP_TaskPool_Txx_
+#define hg_TextComplexAccessP_TaskPool_Txx_
+
+#include "taskpool.hpp"
+#include "api.hpp"
+
+namespace text_complex {
+  namespace access {
+#if  (!(defined TextComplexAccessP_NO_EXCEPT))
+    inline
+    void task_pool::post(task_callback fn, void* arg) {
+      api_error ae;
+      post(fn, arg, ae);
+      if (ae < api_error::Success)
+        throw api_exception(ae);
+      return;
+    }
+#endif //TextComplexAccessP_NO_EXCEPT
+  };
+};
+
+#endif //hg_TextComplexAccessP_TaskPool_Txx_
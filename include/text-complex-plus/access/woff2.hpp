@@ -16,6 +16,12 @@ namespace mmaptwo {
 namespace text_complex {
   namespace access {
     class offset_table;
+    struct table_span;
+    class task_pool;
+    class sfnt;
+    class brcvt_state;
+    struct woff2_core;
+    struct woff2_encoder_core;
 
     /**
      * @defgroup woff2 WOFF2 file utility API
@@ -50,6 +56,7 @@ namespace text_complex {
     private:
       mmaptwo::mmaptwo_i* fh;
       offset_table* offsets;
+      woff2_core* core;
 
     public: /** @name rule-of-six*//** @{ */
       /**
@@ -118,6 +125,117 @@ namespace text_complex {
        * @return an offset table
        */
       offset_table const& get_offsets(void) const noexcept;
+      /**
+       * @brief Query the flavor of the encoded font.
+       * @return the sfnt version of the font, or `0x74746366` (`ttcf`)
+       *   for font collections
+       */
+      uint32 get_flavor(void) const noexcept;
+      /**
+       * @brief Query the space needed to decode the font.
+       * @return a size in bytes for the output arena of
+       *   @link decode_sfnt @endlink
+       * @note Reconstructed `glyf` tables may differ in size from the
+       *   original. Until a decode measures them, fonts with transformed
+       *   tables get an estimate from `totalSfntSize` and the table
+       *   directory. A decode that fails with api_error::BlockOverflow
+       *   leaves the exact size here.
+       */
+      size_t sfnt_size(void) const noexcept;
+      /**
+       * @brief Decode the font into an sfnt (TrueType or OpenType) image.
+       * @param[out] dst output arena
+       * @param dst_size size of the output arena in bytes, at least
+       *   @link sfnt_size @endlink
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::BlockOverflow if the arena is too small,
+       *   api_error::Sanitize on a bad table stream,
+       *   other value on failure
+       * @return the number of bytes written to the arena
+       * @note The table stream decompresses straight into place in the
+       *   arena. Tables are padded to four bytes and the directory is
+       *   sorted by tag, with checksums filled in.
+       * @note Transformed `glyf`, `loca` and `hmtx` tables are
+       *   reconstructed after the other tables.
+       */
+      size_t decode_sfnt
+        (unsigned char* dst, size_t dst_size, api_error& ae) noexcept;
+      /**
+       * @brief Decode the font into an sfnt (TrueType or OpenType) image.
+       * @param[out] dst output arena
+       * @param dst_size size of the output arena in bytes, at least
+       *   @link sfnt_size @endlink
+       * @param pool (nullable) worker threads for rebuilding glyphs
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::BlockOverflow if the arena is too small,
+       *   api_error::Sanitize on a bad table stream,
+       *   other value on failure
+       * @return the number of bytes written to the arena
+       */
+      size_t decode_sfnt(unsigned char* dst, size_t dst_size,
+          task_pool* pool, api_error& ae) noexcept;
+      /**
+       * @brief Decode the font into an sfnt (TrueType or OpenType) image.
+       * @param[out] dst output arena
+       * @param dst_size size of the output arena in bytes, at least
+       *   @link sfnt_size @endlink
+       * @param state decompressor for the table stream, either new or
+       *   reset by @link brcvt_reset @endlink
+       * @param pool (nullable) worker threads for rebuilding glyphs
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::BlockOverflow if the arena is too small,
+       *   api_error::Sanitize on a bad table stream,
+       *   other value on failure
+       * @return the number of bytes written to the arena
+       * @note Callers decoding many fonts can keep one state and reset
+       *   it between fonts, instead of building a state per font.
+       */
+      size_t decode_sfnt(unsigned char* dst, size_t dst_size,
+          brcvt_state& state, task_pool* pool, api_error& ae) noexcept;
+      /**
+       * @brief Decode the font into an sfnt (TrueType or OpenType) image.
+       * @param[out] dst output arena
+       * @param dst_size size of the output arena in bytes, at least
+       *   @link sfnt_size @endlink
+       * @return the number of bytes written to the arena
+       * @throw api_exception on failure
+       */
+      size_t decode_sfnt(unsigned char* dst, size_t dst_size);
+      /**
+       * @brief Decode the font into an sfnt (TrueType or OpenType) image.
+       * @param[out] dst output arena
+       * @param dst_size size of the output arena in bytes, at least
+       *   @link sfnt_size @endlink
+       * @param pool (nullable) worker threads for rebuilding glyphs
+       * @return the number of bytes written to the arena
+       * @throw api_exception on failure
+       */
+      size_t decode_sfnt
+        (unsigned char* dst, size_t dst_size, task_pool* pool);
+      /**
+       * @brief Access one table without decoding the whole font.
+       * @param tag four-byte table tag
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::OutOfRange if no table has the tag,
+       *   api_error::Sanitize on a bad table stream,
+       *   other value on failure
+       * @return a view of the table, valid for the life of the woff2
+       * @note The table stream decompresses only as far as the end of
+       *   the table, and the decoded prefix is kept for later calls.
+       *   Transformed tables are rebuilt on first access.
+       * @note The `head` view keeps the checkSumAdjustment stored in the
+       *   file. @link decode_sfnt @endlink instead rewrites bytes 8-11 of
+       *   `head` to match the image it builds.
+       * @note In a collection, the first table with the tag is used.
+       */
+      table_span table(unsigned char const* tag, api_error& ae) noexcept;
+      /**
+       * @brief Access one table without decoding the whole font.
+       * @param tag four-byte table tag
+       * @return a view of the table, valid for the life of the woff2
+       * @throw api_exception on failure
+       */
+      table_span table(unsigned char const* tag);
       /** @} */
 
     private: /** @name rule-of-six *//** @{ */
@@ -163,6 +281,162 @@ namespace text_complex {
     TCMPLX_AP_API
     void woff2_destroy(woff2* x) noexcept;
     //END   woff2 / namespace local
+
+    //BEGIN woff2 encoder
+    /**
+     * @brief WOFF2 encoder for plain sfnt files
+     */
+    TCMPLX_AP_API
+    class woff2_encoder final {
+    private:
+      woff2_encoder_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param block_size amount of table data to compress at once
+       * @param n maximum sliding window size
+       * @param chain_length run-time parameter limiting hash chain length
+       * @throw std::bad_alloc if something breaks
+       * @note The defaults suit font tables: a window like that of
+       *   other WOFF2 encoders, 16 KiB blocks (four times the
+       *   brcvt_state default) and a short chain.
+       */
+      woff2_encoder(uint32 block_size = 16384u, uint32 n = 4194288u,
+          size_t chain_length = 1u);
+      /**
+       * @brief Destructor.
+       */
+      ~woff2_encoder(void);
+      /**
+       * @brief Copy constructor.
+       */
+      woff2_encoder(woff2_encoder const& ) = delete;
+      /**
+       * @brief Copy assignment operator.
+       * @return this woff2 encoder
+       */
+      woff2_encoder& operator=(woff2_encoder const& ) = delete;
+      /**
+       * @brief Move constructor.
+       */
+      woff2_encoder(woff2_encoder&& ) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this woff2 encoder
+       */
+      woff2_encoder& operator=(woff2_encoder&& ) noexcept;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `woff2_encoder` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `woff2_encoder[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `woff2_encoder` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `woff2_encoder[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public: /** @name methods *//** @{ */
+      /**
+       * @brief Encode a font into a WOFF2 file.
+       * @param src font to encode
+       * @param pool (nullable) worker threads for the table transforms
+       * @param[out] ae @em error-code api_error::Success on success,
+       *   api_error::Sanitize if the font cannot fit in a WOFF2 file,
+       *   other value on failure
+       * @return the length of the encoded file in bytes
+       * @note `glyf` and `loca` tables are transformed when their glyphs
+       *   parse and the result rebuilds; `hmtx` tables are transformed
+       *   when their side bearings repeat the glyph `xMin` values. Other
+       *   tables, and tables that fail to transform, are stored as is.
+       * @note Each table transforms in a task of its own.
+       */
+      size_t encode(sfnt const& src, task_pool* pool, api_error& ae) noexcept;
+      /**
+       * @brief Encode a font into a WOFF2 file.
+       * @param src font to encode
+       * @param pool (nullable) worker threads for the table transforms
+       * @return the length of the encoded file in bytes
+       * @throw api_exception on failure
+       */
+      size_t encode(sfnt const& src, task_pool* pool = nullptr);
+      /**
+       * @brief Access the last encoded file.
+       * @return the start of the file, or `nullptr` if none
+       */
+      unsigned char const* get_data(void) const noexcept;
+      /**
+       * @brief Query the length of the last encoded file.
+       * @return a length in bytes
+       */
+      size_t size(void) const noexcept;
+      /** @} */
+
+    private: /** @name rule-of-six *//** @{ */
+      void transfer(woff2_encoder&& ) noexcept;
+      void transfer(woff2_encoder const& ) = delete;
+      /** @} */
+    };
+    //END   woff2 encoder
+
+    //BEGIN woff2 encoder / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<woff2_encoder>;
+    //END   woff2 encoder / exports
+
+    //BEGIN woff2 encoder / namespace local
+    /**
+     * @brief Non-throwing woff2 encoder allocator.
+     * @param block_size amount of table data to compress at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @return a woff2 encoder on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    woff2_encoder* woff2_encoder_new
+        ( uint32 block_size = 16384u, uint32 n = 4194288u,
+          size_t chain_length = 1u) noexcept;
+
+    /**
+     * @brief Non-throwing woff2 encoder allocator.
+     * @param block_size amount of table data to compress at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @return a woff2 encoder on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<woff2_encoder> woff2_encoder_unique
+        ( uint32 block_size = 16384u, uint32 n = 4194288u,
+          size_t chain_length = 1u) noexcept;
+
+    /**
+     * @brief Destroy a woff2 encoder.
+     * @param x (nullable) the woff2 encoder to destroy
+     */
+    TCMPLX_AP_API
+    void woff2_encoder_destroy(woff2_encoder* x) noexcept;
+    //END   woff2 encoder / namespace local
     /** @} */
   };
 };
@@ -0,0 +1,206 @@
+/**
+ * @file text-complex-plus/access/woff2batch.hpp
+ * @brief Batch decoding of WOFF2 files
+ */
+#ifndef hg_TextComplexAccessP_Woff2Batch_H_
+#define hg_TextComplexAccessP_Woff2Batch_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace mmaptwo {
+  class mmaptwo_i;
+};
+
+namespace text_complex {
+  namespace access {
+    struct woff2batch_core;
+
+    /**
+     * @defgroup woff2batch Batch decoding of WOFF2 files
+     *   (access/woff2batch.hpp)
+     * @{
+     */
+    //BEGIN woff2 batch / result
+    /**
+     * @brief Outcome of decoding one file of a batch.
+     */
+    struct TCMPLX_AP_API woff2batch_result final {
+      /** @brief Position of the file in the source list. */
+      size_t index;
+      /** @brief api_error::Success, or the reason the decode failed. */
+      api_error status;
+      /**
+       * @brief Decoded sfnt image, or `nullptr` on failure.
+       * @note The image lives in the worker's scratch arena and is only
+       *   valid until the callback returns.
+       */
+      unsigned char const* data;
+      /** @brief Length of the decoded image in bytes. */
+      size_t size;
+      /** @brief Index of the worker that decoded the file. */
+      unsigned int worker;
+    };
+
+    /**
+     * @brief Receiver of batch results.
+     * @param arg user data passed to @link woff2_batch::decode @endlink
+     * @param result outcome of one file
+     * @note Workers call this from their own threads as each file
+     *   finishes, so calls may overlap and arrive in any order.
+     */
+    typedef void (*woff2batch_callback)
+      (void* arg, woff2batch_result const& result);
+    //END   woff2 batch / result
+
+    //BEGIN woff2 batch
+    /**
+     * @brief Decoder for many WOFF2 files at once.
+     * @note Each worker keeps its own Brotli state and output arena
+     *   across files and batches. Files start out split evenly among
+     *   the workers; a worker that runs out steals from the others.
+     */
+    class TCMPLX_AP_API woff2_batch final {
+    private:
+      woff2batch_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param threads number of workers, or zero for one per
+       *   hardware thread
+       * @throw std::bad_alloc if something breaks
+       */
+      woff2_batch(unsigned int threads = 0u);
+      /**
+       * @brief Destructor.
+       */
+      ~woff2_batch(void);
+      /**
+       * @brief Copy constructor.
+       */
+      woff2_batch(woff2_batch const& ) = delete;
+      /**
+       * @brief Copy assignment operator.
+       * @return this batch decoder
+       */
+      woff2_batch& operator=(woff2_batch const& ) = delete;
+      /**
+       * @brief Move constructor.
+       */
+      woff2_batch(woff2_batch&& ) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this batch decoder
+       */
+      woff2_batch& operator=(woff2_batch&& ) noexcept;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `woff2_batch` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `woff2_batch[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `woff2_batch` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `woff2_batch[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public: /** @name methods *//** @{ */
+      /**
+       * @brief Query the number of workers.
+       * @return the worker count
+       */
+      unsigned int size(void) const noexcept;
+      /**
+       * @brief Decode a list of WOFF2 files.
+       * @param sources files to decode; the batch does not take
+       *   ownership, and null entries fail with api_error::Param
+       * @param count number of files
+       * @param fn callback to receive each result
+       * @param arg user data for the callback
+       * @param[out] ae @em error-code api_error::Success once every
+       *   file has been reported, other value if the batch could not run
+       * @note The calling thread works as the first worker. The call
+       *   returns after the last callback.
+       * @note A failed file does not stop the batch; its result carries
+       *   the error.
+       * @note One batch runs at a time per decoder.
+       */
+      void decode(mmaptwo::mmaptwo_i* const* sources, size_t count,
+          woff2batch_callback fn, void* arg, api_error& ae) noexcept;
+      /**
+       * @brief Decode a list of WOFF2 files.
+       * @param sources files to decode; the batch does not take ownership
+       * @param count number of files
+       * @param fn callback to receive each result
+       * @param arg user data for the callback
+       * @throw api_exception if the batch could not run
+       */
+      void decode(mmaptwo::mmaptwo_i* const* sources, size_t count,
+          woff2batch_callback fn, void* arg = nullptr);
+      /** @} */
+
+    private: /** @name rule-of-six *//** @{ */
+      void transfer(woff2_batch&& ) noexcept;
+      void transfer(woff2_batch const& ) = delete;
+      /** @} */
+    };
+    //END   woff2 batch
+
+    //BEGIN woff2 batch / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<woff2_batch>;
+    //END   woff2 batch / exports
+
+    //BEGIN woff2 batch / namespace local
+    /**
+     * @brief Non-throwing batch decoder allocator.
+     * @param threads number of workers, or zero for one per
+     *   hardware thread
+     * @return a batch decoder on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    woff2_batch* woff2batch_new(unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Non-throwing batch decoder allocator.
+     * @param threads number of workers, or zero for one per
+     *   hardware thread
+     * @return a batch decoder on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<woff2_batch> woff2batch_unique
+      (unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Destroy a batch decoder.
+     * @param x (nullable) the batch decoder to destroy
+     */
+    TCMPLX_AP_API
+    void woff2batch_destroy(woff2_batch* x) noexcept;
+    //END   woff2 batch / namespace local
+    /** @} */
+  };
+};
+
+#endif //hg_TextComplexAccessP_Woff2Batch_H_
@@ -11,6 +11,7 @@
 #include "fixlist.hpp"
 #include "inscopy.hpp"
 #include "ringdist.hpp"
+#include "cvtstats.hpp"
 
 namespace text_complex {
   namespace access {
@@ -49,6 +50,8 @@ namespace text_complex {
       prefix_histogram dist_histogram;
       /** @brief Check for large blocks. */
       prefix_histogram seq_histogram;
+      /** @brief Work space for prefix code length generation. */
+      prefix_histogram length_scratch;
       /** @brief Tree description sequence. */
       block_string sequence_list;
       /** @brief ... */
@@ -75,6 +78,11 @@ namespace text_complex {
       uint32 bit_cap;
       /** @brief Scratch space for last byte generated. */
       unsigned char write_scratch;
+      /**
+       * @brief Stage timers and counters.
+       * @note Updated by every conversion call.
+       */
+      cvt_stats stats;
 
     public: /** @name rule-of-zero*//** @{ */
       /**
@@ -177,8 +185,10 @@ namespace text_complex {
      *
      * @note This function returns api_error::ZDictionary if the input
      *   stream expects a ZLIB dictionary. If the caller expects to
-     *   supply a dictionary, use @link zcvt_bypass @endlink
+     *   supply a dictionary, use @link zcvt_set_dictionary @endlink
      *   to add the dictionary corresponding to the state's `checksum` field.
+     *   A matching dictionary set before the stream header skips
+     *   this step.
      * @see @link zcvt_state#checksum @endlink
      */
     TCMPLX_AP_API
@@ -214,6 +224,69 @@ namespace text_complex {
     size_t zcvt_bypass
       (zcvt_state& state, unsigned char const* buf, size_t sz);
 
+    /**
+     * @brief Set a preset dictionary (FDICT).
+     * @param state the conversion state to configure
+     * @param buf the dictionary
+     * @param sz size of the dictionary in bytes
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   api_error::ZDictionary if the dictionary does not match the
+     *   stream's dictionary identifier, other value on failure
+     * @return count of bytes added
+     * @note Call either before the stream header, or after
+     *   @link zcvt_in @endlink returns api_error::ZDictionary. In the
+     *   first case, the compressor announces the dictionary in its
+     *   header. In the second case, the dictionary is checked against
+     *   the state's `checksum` field first, and left out on a mismatch,
+     *   so another dictionary may be tried.
+     */
+    TCMPLX_AP_API
+    size_t zcvt_set_dictionary
+      ( zcvt_state& state, unsigned char const* buf, size_t sz,
+        api_error& ae) noexcept;
+
+    /**
+     * @brief Set a preset dictionary (FDICT).
+     * @param state the conversion state to configure
+     * @param buf the dictionary
+     * @param sz size of the dictionary in bytes
+     * @return count of bytes added
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    size_t zcvt_set_dictionary
+      (zcvt_state& state, unsigned char const* buf, size_t sz);
+
+    /**
+     * @brief Prepare a compressor to continue an existing DEFLATE stream.
+     * @param state the conversion state to configure
+     * @param buf buffer of bytes already encoded by the stream
+     * @param sz size of the buffer in bytes
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @return count of bytes added
+     * @note Call before any output. The zlib header is skipped, and
+     *   the state's `checksum` covers only the bytes compressed
+     *   afterward, so that the compressor's blocks can follow any
+     *   byte-aligned stream prefix whose output ends with `buf`.
+     */
+    TCMPLX_AP_API
+    size_t zcvt_continue
+      ( zcvt_state& state, unsigned char const* buf, size_t sz,
+        api_error& ae) noexcept;
+
+    /**
+     * @brief Prepare a compressor to continue an existing DEFLATE stream.
+     * @param state the conversion state to configure
+     * @param buf buffer of bytes already encoded by the stream
+     * @param sz size of the buffer in bytes
+     * @return count of bytes added
+     * @throw api_exception on failure
+     */
+    TCMPLX_AP_API
+    size_t zcvt_continue
+      (zcvt_state& state, unsigned char const* buf, size_t sz);
+
     /**
      * @brief Convert a byte stream to a zlib stream.
      * @param state the zlib conversion state to use
@@ -251,6 +324,26 @@ namespace text_complex {
     api_error zcvt_unshift(zcvt_state& state,
         unsigned char* to, unsigned char* to_end,
         unsigned char*& to_next);
+
+    /**
+     * @brief Flush a zlib stream to a byte using an empty stored block.
+     * @param state the zlib conversion state to use
+     * @param to destination buffer
+     * @param to_end pointer to end of destination buffer
+     * @param[out] to_next location of next output byte
+     * @return api_error::Success on success,
+     *   api_error::Partial if the next block is ready or more output
+     *   data can be written, other nonzero otherwise
+     * @note The conversion state referred to by `state` is updated based
+     *   on the conversion result, whether successful or failed.
+     *
+     * @note Any bytes remaining in the conversion state will
+     *   be processed before outputting the stored block.
+     */
+    TCMPLX_AP_API
+    api_error zcvt_flush(zcvt_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next);
     //END   zcvt state / namespace local
     /** @} */
   };
@@ -21,6 +21,28 @@ namespace text_complex {
         throw api_exception(ae);
       } else return out;
     }
+
+    inline
+    size_t zcvt_set_dictionary
+      (zcvt_state& state, unsigned char const* buf, size_t sz)
+    {
+      api_error ae;
+      size_t const out = zcvt_set_dictionary(state, buf, sz, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
+
+    inline
+    size_t zcvt_continue
+      (zcvt_state& state, unsigned char const* buf, size_t sz)
+    {
+      api_error ae;
+      size_t const out = zcvt_continue(state, buf, sz, ae);
+      if (ae < api_error::Success) {
+        throw api_exception(ae);
+      } else return out;
+    }
 #endif //TextComplexAccessP_NO_EXCEPT
   };
 };
@@ -0,0 +1,198 @@
+/**
+ * @file text-complex-plus/access/zpar.hpp
+ * @brief Parallel zlib compression state
+ */
+#ifndef hg_TextComplexAccessP_ZPar_H_
+#define hg_TextComplexAccessP_ZPar_H_
+
+#include "api.hpp"
+#include "util.hpp"
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @defgroup zpar Parallel zlib compression state
+     *   (access/zpar.hpp)
+     * @{
+     */
+    struct zpar_core;
+    struct zpar_access;
+
+    //BEGIN zpar state
+    /**
+     * @brief Parallel zlib compression state.
+     * @note Input is cut into fixed-size segments. Each segment is
+     *   compressed on a worker thread by its own
+     *   @link zcvt_state @endlink, primed with the tail of the previous
+     *   segment. The per-segment Adler-32 checksums are combined
+     *   into the stream trailer. The output depends only on the
+     *   constructor parameters other than `threads`.
+     */
+    class TCMPLX_AP_API zpar_state final {
+    private:
+      zpar_core* core;
+
+    public: /** @name rule-of-six*//** @{ */
+      /**
+       * @brief Constructor.
+       * @param block_size amount of input data to process at once
+       * @param n maximum sliding window size
+       * @param chain_length run-time parameter limiting hash chain length
+       * @param segment_size amount of input data per worker task
+       * @param threads number of worker threads, or zero to use
+       *   the number of hardware threads available
+       * @throw std::bad_alloc if something breaks
+       * @throw api_exception on bad parameters or thread failure
+       */
+      zpar_state
+        ( uint32 block_size = 4096u, uint32 n = 32768u,
+          size_t chain_length = 256u, uint32 segment_size = 1048576u,
+          unsigned int threads = 0u);
+      /**
+       * @brief Destructor.
+       * @note Waits for any tasks still running.
+       */
+      ~zpar_state(void);
+      /**
+       * @brief Move constructor.
+       */
+      zpar_state(zpar_state&& other) noexcept;
+      /**
+       * @brief Move assignment operator.
+       * @return this state
+       */
+      zpar_state& operator=(zpar_state&& other) noexcept;
+      zpar_state(zpar_state const& ) = delete;
+      zpar_state& operator=(zpar_state const& ) = delete;
+      /** @} */
+
+    public: /** @name allocation *//** @{ */
+      /**
+       * @brief Scalar memory allocator.
+       * @param sz size in `char`s of `zpar_state` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new(std::size_t sz);
+      /**
+       * @brief Array memory allocator.
+       * @param sz size in `char`s of `zpar_state[]` to allocate
+       * @return a pointer to memory on success
+       * @throw std::bad_alloc on allocation error
+       */
+      static void* operator new[](std::size_t sz);
+      /**
+       * @brief Scalar memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `zpar_state` to free
+       */
+      static void operator delete(void* p, std::size_t sz) noexcept;
+      /**
+       * @brief Array memory free callback.
+       * @param p pointer to memory to free
+       * @param sz size in `char`s of `zpar_state[]` to free
+       */
+      static void operator delete[](void* p, std::size_t sz) noexcept;
+      /** @} */
+
+    public:
+      /**
+       * @ingroup methods
+       * @return the number of worker threads in use
+       */
+      unsigned int threads(void) const noexcept;
+
+    private:
+      friend struct zpar_access;
+    };
+    //END   zpar state
+
+    //BEGIN zpar state / exports
+    template
+    class TCMPLX_AP_API util_unique_ptr<zpar_state>;
+    //END   zpar state / exports
+
+    //BEGIN zpar state / allocation (namespace local)
+    /**
+     * @brief Non-throwing zpar state allocator.
+     * @param block_size amount of input data to process at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @param segment_size amount of input data per worker task
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a zpar state on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    zpar_state* zpar_new
+        ( uint32 block_size = 4096u, uint32 n = 32768u,
+          size_t chain_length = 256u, uint32 segment_size = 1048576u,
+          unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Non-throwing zpar state allocator.
+     * @param block_size amount of input data to process at once
+     * @param n maximum sliding window size
+     * @param chain_length run-time parameter limiting hash chain length
+     * @param segment_size amount of input data per worker task
+     * @param threads number of worker threads, or zero to use
+     *   the number of hardware threads available
+     * @return a zpar state on success, `nullptr` otherwise
+     */
+    TCMPLX_AP_API
+    util_unique_ptr<zpar_state> zpar_unique
+        ( uint32 block_size = 4096u, uint32 n = 32768u,
+          size_t chain_length = 256u, uint32 segment_size = 1048576u,
+          unsigned int threads = 0u) noexcept;
+
+    /**
+     * @brief Destroy a zpar state.
+     * @param x (nullable) the zpar state to destroy
+     */
+    TCMPLX_AP_API
+    void zpar_destroy(zpar_state* x) noexcept;
+    //END   zpar state / allocation (namespace local)
+
+    //BEGIN zpar state / namespace local
+    /**
+     * @brief Convert a byte stream to a zlib stream using worker threads.
+     * @param state the parallel conversion state to use
+     * @param from source buffer
+     * @param from_end pointer to end of source buffer
+     * @param[out] from_next location of next byte to process
+     * @param to destination buffer
+     * @param to_end pointer to end of destination buffer
+     * @param[out] to_next location of next output byte
+     * @return api_error::Success when the destination is full,
+     *   api_error::Partial if more input is needed,
+     *   other nonzero otherwise
+     * @note Finished segments are written in input order. Output for
+     *   segments still in progress appears in later calls.
+     */
+    TCMPLX_AP_API
+    api_error zpar_out(zpar_state& state,
+        unsigned char const* from, unsigned char const* from_end,
+        unsigned char const*& from_next,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next);
+
+    /**
+     * @brief Finish a zlib stream using worker threads.
+     * @param state the parallel conversion state to use
+     * @param to destination buffer
+     * @param to_end pointer to end of destination buffer
+     * @param[out] to_next location of next output byte
+     * @return api_error::Success when the destination is full,
+     *   api_error::EndOfFile at end of stream, other nonzero otherwise
+     * @note Blocks until the remaining segments are compressed.
+     */
+    TCMPLX_AP_API
+    api_error zpar_unshift(zpar_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next);
+    //END   zpar state / namespace local
+    /** @} */
+  };
+};
+
+#endif //hg_TextComplexAccessP_ZPar_H_
@@ -26,6 +26,17 @@ namespace text_complex {
     TCMPLX_AP_API
     uint32 zutil_adler32
       (size_t len, unsigned char const* buf, uint32 chk = 1u) noexcept;
+
+    /**
+     * @brief Combine two checksums.
+     * @param chk1 checksum of the first buffer
+     * @param chk2 checksum of the second buffer, started from one (1)
+     * @param len2 length of the second buffer
+     * @return the checksum of both buffers concatenated
+     */
+    TCMPLX_AP_API
+    uint32 zutil_adler32_combine
+      (uint32 chk1, uint32 chk2, size_t len2) noexcept;
     //END   zutil / namespace local
     /** @} */
   };
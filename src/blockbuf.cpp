@@ -5,6 +5,7 @@
 #define TCMPLX_AP_WIN32_DLL_INTERNAL
 #include "text-complex-plus/access/blockbuf.hpp"
 #include "text-complex-plus/access/hashchain.hpp"
+#include "cvtstats_p.hpp"
 #include <limits>
 #include <memory>
 #include <utility>
@@ -89,7 +90,7 @@ namespace text_complex {
       unsigned int i;
       if (match_size >= 64u) {
         uint32 const t = match_size-64u;
-        buf[0] = static_cast<unsigned char>((t&63u)>>8)|192u;
+        buf[0] = static_cast<unsigned char>((t>>8)&63u)|192u;
         buf[1] = static_cast<unsigned char>(t&255u);
         i = 2u;
       } else {
@@ -321,7 +322,7 @@ namespace text_complex {
     block_buffer::block_buffer
         (uint32 block_size, uint32 n, size_t chain_length, bool bdict_tf)
       : chain(nullptr), input(), output(), use_bdict(bdict_tf),
-        input_block_size(0u)
+        input_block_size(0u), copy_max(blockbuf_out_code_max)
     {
       /* truncate lengths */{
         if (block_size > blockbuf_size_max/2u)
@@ -350,7 +351,7 @@ namespace text_complex {
 
     block_buffer::block_buffer(block_buffer&& other) noexcept
       : chain(nullptr), input(), output(), use_bdict(false),
-        input_block_size(0u)
+        input_block_size(0u), copy_max(blockbuf_out_code_max)
     {
       transfer(static_cast<block_buffer&&>(other));
       return;
@@ -365,6 +366,8 @@ namespace text_complex {
       hash_chain* const new_chain = util_exchange(other.chain, nullptr);
       bool const new_bdict_tf = util_exchange(other.use_bdict, false);
       uint32 const new_size = util_exchange(other.input_block_size, 0u);
+      uint32 const new_copy_max =
+        util_exchange(other.copy_max, blockbuf_out_code_max);
       /* drop old */{
         if (chain)
           delete chain;
@@ -375,6 +378,7 @@ namespace text_complex {
         output = std::move(other.output);
         use_bdict = new_bdict_tf;
         input_block_size = new_size;
+        copy_max = new_copy_max;
       }
       return;
     }
@@ -438,6 +442,20 @@ namespace text_complex {
     block_string const& block_buffer::input_data(void) const noexcept {
       return input;
     }
+
+    uint32 block_buffer::copy_limit(void) const noexcept {
+      return copy_max;
+    }
+
+    void block_buffer::set_copy_limit(uint32 n) noexcept {
+      if (n < 3u)
+        copy_max = 3u;
+      else if (n > blockbuf_out_code_max)
+        copy_max = blockbuf_out_code_max;
+      else
+        copy_max = n;
+      return;
+    }
     //END   block_buffer / public
 
     //BEGIN block_buffer / ostringstream-compat
@@ -501,6 +519,13 @@ namespace text_complex {
     }
 
     block_buffer& block_buffer::try_block(api_error& ae) noexcept {
+      cvt_stats stats = {};
+      return try_block(stats, ae);
+    }
+
+    block_buffer& block_buffer::try_block
+        (cvt_stats& stats, api_error& ae) noexcept
+    {
       api_error res = api_error::Success;
       uint32 const n = 51u;
       uint32 j = output.size();
@@ -512,6 +537,11 @@ namespace text_complex {
       uint32 other_match_size = 0u;
       unsigned char state = 0;
       unsigned char skipped_byte = 0u;
+      size_t probes = 0u;
+      size_t searches = 0u;
+      size_t matches = 0u;
+      size_t copy_bytes = 0u;
+      size_t literal_bytes = 0u;
       for (i = 0u; i < input_sz && res == api_error::Success; ++i) {
         switch (state) {
         case 2:
@@ -520,11 +550,12 @@ namespace text_complex {
             unsigned char const other_q = (*chain)[other_v];
             if (q != input[i]) {
               res = blockstr_update_literal(output, skipped_byte, j);
+              literal_bytes += 1u;
               v = other_v;
               match_size = other_match_size;
               state = 1;
             } else if (other_q != input[i]
-                || match_size >= blockbuf_out_code_max)
+                || match_size >= copy_max)
             {
               state = 1;
             } else {
@@ -540,13 +571,15 @@ namespace text_complex {
         case 1: /* one thing */
           {
             unsigned int const q = (*chain)[v];
-            if (q == input[i] && match_size < blockbuf_out_code_max) {
+            if (q == input[i] && match_size < copy_max) {
               match_size += 1u;
               chain->push_front(input[i], res);
               break;
             } else {
               /* close the match */
               res = blockstr_add_copy(output, match_size, v);
+              matches += 1u;
+              copy_bytes += match_size;
               if (res != api_error::Success)
                 break;
               else j = output.size();
@@ -555,12 +588,20 @@ namespace text_complex {
           }
           /* [[fallthrough]] */;
         case 0:
-          if (i <= input_sz - 4u && chain) {
+          if (i+3u <= input_sz && chain) {
             /* look for the item in the chain */
-            v = chain->find(&input[i]);
+            v = chain->find(&input[i], 0u, probes);
+            searches += 1u;
             if (v != hash_chain::npos) {
-              other_v = chain->find(&input[i+1]);
-              if (other_v != hash_chain::npos) {
+              /* the shifted match needs a fourth byte */
+              if (i+4u <= input_sz) {
+                other_v = chain->find(&input[i+1], 0u, probes);
+                searches += 1u;
+              } else other_v = hash_chain::npos;
+              /* the shifted match must stay inside a full window */
+              if (other_v != hash_chain::npos
+              &&  other_v+1u < chain->extent())
+              {
                 other_v += 1u;
                 other_match_size = 2u;
                 state = 2;
@@ -585,6 +626,7 @@ namespace text_complex {
             res = blockstr_update_literal(output, input[i], j);
             if (res != api_error::Success)
               break;
+            literal_bytes += 1u;
             chain->push_front(input[i], res);
           } break;
         }
@@ -592,7 +634,14 @@ namespace text_complex {
       if (res == api_error::Success && state > 0) {
         /* close the match */
         res = blockstr_add_copy(output, match_size, v);
+        matches += 1u;
+        copy_bytes += match_size;
       }
+      cvtstats_add(stats.searches, searches);
+      cvtstats_add(stats.probes, probes);
+      cvtstats_add(stats.matches, matches);
+      cvtstats_add(stats.copy_bytes, copy_bytes);
+      cvtstats_add(stats.literal_bytes, literal_bytes);
       ae = res;
       return *this;
     }
@@ -601,6 +650,14 @@ namespace text_complex {
       input.clear();
       return;
     }
+
+    void block_buffer::clear(void) noexcept {
+      input.clear();
+      output.clear();
+      if (chain)
+        chain->clear();
+      return;
+    }
     //END   block_buffer / methods
 
     //BEGIN block_buffer / slide_ring access
@@ -613,6 +670,7 @@ namespace text_complex {
         for (i = 0u; i < count && chain_ae == api_error::Success; ++i) {
           chain->push_front(s[i], chain_ae);
         }
+        ae = chain_ae;
         return i;
       } else {
         ae = api_error::Init;
@@ -620,6 +678,22 @@ namespace text_complex {
       }
     }
 
+    void block_buffer::load_window
+        (hash_chain const& window, api_error& ae) noexcept
+    {
+      if (!chain) {
+        ae = api_error::Init;
+      } else if (window.extent() != chain->extent()) {
+        ae = api_error::Param;
+      } else try {
+        *chain = window;
+        ae = api_error::Success;
+      } catch (std::bad_alloc const& ) {
+        ae = api_error::Memory;
+      }
+      return;
+    }
+
     unsigned char block_buffer::peek
         (uint32 i, api_error& ae) const noexcept
     {
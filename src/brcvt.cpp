@@ -8,10 +8,13 @@
 #include "text-complex-plus/access/util.hpp"
 #include "text-complex-plus/access/bdict.hpp"
 #include "text-complex-plus/access/ringdist.hpp"
+#include "text-complex-plus/access/hashchain.hpp"
+#include "cvtstats_p.hpp"
 #include <array>
 #include <limits>
 #include <new>
 #include <algorithm>
+#include <utility>
 #include <cstring>
 #include <cassert>
 
@@ -181,10 +184,12 @@ namespace text_complex {
      * @param ps Brotli conversion state to update
      * @param value block code [0, 26)
      * @param next_state follow-up state in case of zero-length extra bits
+     * @param[out] ae set to Sanitize if `value` is out of range
      * @return base block count
      */
     static uint32 brcvt_config_count
-      (brcvt_state& state, unsigned long value, unsigned char next_state);
+      (brcvt_state& state, unsigned long value, unsigned char next_state,
+        api_error& ae);
     /**
      * @brief Accumulate the extra bits of a block count onto a bytes-remaining counter.
      * @param state Brotli conversion state for bit collection
@@ -287,13 +292,14 @@ namespace text_complex {
      * @brief Apply a histogram to a prefix list.
      * @param tree prefix list to replace and update
      * @param histogram item frequencies
+     * @param scratch work space for code length generation
      * @param[in,out] ae error code on failure; fast-quits if set
      * @return the number of bits that would be used to encode the prefix list
      *   @em and the stream that uses the new prefix list
      */
     static std::size_t brcvt_apply_histogram(
       gasp_vector::root& tree_info, prefix_histogram const& histogram,
-      api_error &ae) noexcept;
+      prefix_histogram& scratch, api_error &ae) noexcept;
     /**
      * @brief Encode a nonzero entry in a context map using run-length encoding.
      * @param[out] buffer storage of intermediate encoding
@@ -338,6 +344,25 @@ namespace text_complex {
      */
     static api_error brcvt_handle_inskip(brcvt_state& ps,
       unsigned char* to, unsigned char* to_end, unsigned char*& to_next) noexcept;
+    /**
+     * @brief Find the single-symbol value of the tree for the next literal.
+     * @param ps conversion state
+     * @return the only value of the tree, or `brcvt_NoSkip`
+     */
+    static unsigned short brcvt_literal_skip(brcvt_state const& ps) noexcept;
+    /**
+     * @brief Find the single-symbol value of the tree for the next
+     *   insert-and-copy command.
+     * @param ps conversion state
+     * @return the only value of the tree, or `brcvt_NoSkip`
+     */
+    static unsigned short brcvt_insert_skip(brcvt_state const& ps) noexcept;
+    /**
+     * @brief Find the single-symbol value of the tree for the next distance.
+     * @param ps conversion state
+     * @return the only value of the tree, or `brcvt_NoSkip`
+     */
+    static unsigned short brcvt_distance_skip(brcvt_state const& ps) noexcept;
     /**
      * @brief Determine if a meta block should end.
      * @param state inflow conversion state
@@ -524,7 +549,7 @@ namespace text_complex {
           return brcvt_meta_endcode(state);
         }
         state.bit_length = 0;
-        state.state = (state.blocktypeD_remaining
+        state.state = ((state.blocktypeD_remaining || state.fwd.ctxt_i)
           ? BrCvt_Distance : BrCvt_DistanceRestart);
         state.fwd.literal_i = 0;
         state.fwd.literal_total = state.fwd.stop;
@@ -740,6 +765,26 @@ namespace text_complex {
       return api_error::Success;
     }
 
+    unsigned short brcvt_literal_skip(brcvt_state const& ps) noexcept {
+      context_map_mode const mode =
+        ps.literals_map.get_mode(ps.blocktypeL_index.current);
+      std::size_t const column = ctxtmap_literal_context(mode,
+        ps.fwd.literal_ctxt[1], ps.fwd.literal_ctxt[0]);
+      int const index = ps.literals_map(ps.blocktypeL_index.current, column);
+      return ps.literals_forest[index].noskip;
+    }
+
+    unsigned short brcvt_insert_skip(brcvt_state const& ps) noexcept {
+      return ps.insert_forest[ps.blocktypeI_index.current].noskip;
+    }
+
+    unsigned short brcvt_distance_skip(brcvt_state const& ps) noexcept {
+      std::size_t const column =
+        ctxtmap_distance_context(ps.fwd.literal_total);
+      int const index = ps.distance_map(ps.blocktypeD_index.current, column);
+      return ps.distance_forest[index].noskip;
+    }
+
     api_error brcvt_handle_inskip(brcvt_state& ps,
       unsigned char* to, unsigned char* to_end, unsigned char*& to_next) noexcept
     {
@@ -749,8 +794,8 @@ namespace text_complex {
       for (repeat = 0; repeat < 134217728L && skip; ++repeat) {
         switch (ps.state) {
         case BrCvt_DataInsertCopy:
-          if (ps.insert_skip != brcvt_NoSkip) {
-            api_error const res = brcvt_inflow_insert(ps, ps.insert_skip);
+          if (brcvt_insert_skip(ps) != brcvt_NoSkip) {
+            api_error const res = brcvt_inflow_insert(ps, brcvt_insert_skip(ps));
             if (res != api_error::Success)
               return res;
             continue;
@@ -759,7 +804,7 @@ namespace text_complex {
           if (ps.fwd.literal_i >= ps.fwd.literal_total) {
             if (brcvt_metaterm(ps, true))
               return brcvt_meta_endcode(ps);
-            ps.state = (ps.blocktypeD_remaining
+            ps.state = ((ps.blocktypeD_remaining || ps.fwd.ctxt_i)
               ? BrCvt_Distance : BrCvt_DistanceRestart);
             ps.fwd.literal_i = 0;
             ps.fwd.literal_total = ps.fwd.stop;
@@ -767,10 +812,10 @@ namespace text_complex {
             ps.bit_length = 0;
             ps.bits = 0;
             continue;
-          } else if (ps.literal_skip != brcvt_NoSkip) {
+          } else if (brcvt_literal_skip(ps) != brcvt_NoSkip) {
             if (to_next >= to_end)
               return api_error::Partial;
-            brcvt_inflow_literal(ps, ps.literal_skip, to, to_end, to_next);
+            brcvt_inflow_literal(ps, brcvt_literal_skip(ps), to, to_end, to_next);
 	    ps.fwd.literal_i += 1;
             brcvt_dec_literal_rem(ps);
             continue;
@@ -782,15 +827,19 @@ namespace text_complex {
             if (res == api_error::Success)
               return res;
             continue;
-          } else if (ps.distance_skip != brcvt_NoSkip) {
-            api_error const res = brcvt_inflow_distance(ps, ps.distance_skip);
+          } else if (brcvt_distance_skip(ps) != brcvt_NoSkip) {
+            api_error const res = brcvt_inflow_distance(ps, brcvt_distance_skip(ps));
             ps.blocktypeD_remaining -= 1;
             if (res == api_error::Success)
               return res;
             continue;
           } else return api_error::Success;
         case BrCvt_DoCopy:
-          return brcvt_inflow_do_copy(ps, to, to_end, to_next);
+          {
+            api_error const res = brcvt_inflow_do_copy(ps, to, to_end, to_next);
+            if (res != api_error::Success || ps.state == BrCvt_DoCopy)
+              return res;
+          } continue;
         case BrCvt_BDict:
           if (fwd.literal_total > sizeof(fwd.bstore))
             return api_error::Sanitize;
@@ -805,22 +854,31 @@ namespace text_complex {
           break;
         case BrCvt_InsertRecount:
           if (ps.extra_length == 0 && ps.blockcountI_skip != brcvt_NoSkip) {
-            ps.blocktypeI_remaining = brcvt_config_count(ps, ps.blockcountI_skip, BrCvt_DataInsertCopy);
-            if (ps.extra_length == 0)
+            api_error ae = api_error::Success;
+            ps.blocktypeI_remaining = brcvt_config_count(ps, ps.blockcountI_skip, BrCvt_DataInsertCopy, ae);
+            if (ae != api_error::Success)
+              return ae;
+            else if (ps.extra_length == 0)
               continue;
           }
           return api_error::Success;
         case BrCvt_DistanceRecount:
           if (ps.extra_length == 0 && ps.blockcountD_skip != brcvt_NoSkip) {
-            ps.blocktypeD_remaining = brcvt_config_count(ps, ps.blockcountD_skip, BrCvt_Distance);
-            if (ps.extra_length == 0)
+            api_error ae = api_error::Success;
+            ps.blocktypeD_remaining = brcvt_config_count(ps, ps.blockcountD_skip, BrCvt_Distance, ae);
+            if (ae != api_error::Success)
+              return ae;
+            else if (ps.extra_length == 0)
               continue;
           }
           return api_error::Success;
         case BrCvt_LiteralRecount:
           if (ps.extra_length == 0 && ps.blockcountL_skip != brcvt_NoSkip) {
-            ps.blocktypeL_remaining = brcvt_config_count(ps, ps.blockcountL_skip, BrCvt_Literal);
-            if (ps.extra_length == 0)
+            api_error ae = api_error::Success;
+            ps.blocktypeL_remaining = brcvt_config_count(ps, ps.blockcountL_skip, BrCvt_Literal, ae);
+            if (ae != api_error::Success)
+              return ae;
+            else if (ps.extra_length == 0)
               continue;
           }
           return api_error::Success;
@@ -1063,10 +1121,16 @@ namespace text_complex {
         unsigned char* to, unsigned char* to_end,
         unsigned char*& to_next)
     {
-      unsigned int i;
-      api_error ae = api_error::Success;
-      for (i = state.bit_index; i < 8u && ae == api_error::Success; ++i) {
+      unsigned int i = state.bit_index;
+      /* finish output paused by a full buffer before reading on */
+      api_error ae = brcvt_handle_inskip(state, to, to_end, to_next);
+      for (; i < 8u && ae == api_error::Success; ++i) {
         unsigned int x = (y>>i)&1u;
+        if (state.state == BrCvt_Literal && to_next >= to_end) {
+          /* leave this bit for the next call */
+          ae = api_error::Partial;
+          break;
+        }
         switch (state.state) {
         case BrCvt_WBits:
           if (state.bit_length == 0)
@@ -1139,6 +1203,13 @@ namespace text_complex {
               ? BrCvt_MetaLength : BrCvt_MetaText);
             state.count = 0;
             state.backward = 0;
+            if (state.state == BrCvt_MetaText && i == 7) {
+              /* empty and already aligned: next byte starts a new block */
+              state.state = (state.h_end
+                ? BrCvt_Done : BrCvt_LastCheck);
+              if (state.h_end)
+                ae = api_error::EndOfFile;
+            }
           }
           break;
         case BrCvt_MetaLength:
@@ -1147,7 +1218,8 @@ namespace text_complex {
             state.count += 1;
           }
           if (state.count >= state.bit_length) {
-            if (!(state.backward>>(state.count-8)))
+            /* only a multi-byte length must keep its last byte nonzero */
+            if (state.count > 8 && !(state.backward>>(state.count-8)))
               ae = api_error::Sanitize;
             state.backward += 1;
             state.metablock_pos = 0;
@@ -1218,13 +1290,13 @@ namespace text_complex {
               state.bit_length = 0;
             } else {
               unsigned const alphasize = (state.bits>>4)+(1u<<(state.count-4))+1u;
-              state.treety.count = static_cast<unsigned short>(alphasize);
+              state.treety.count = static_cast<unsigned short>(alphasize+2u);
               state.alphabits = util_bitwidth(alphasize+1u); //BITWIDTH(NBLTYPESx + 2)
               state.state += 1;
               state.blocktypeL_max = static_cast<unsigned char>(alphasize-1u);
             }
             try {
-              state.literals_map = context_map(state.treety.count, 64);
+              state.literals_map = context_map(state.blocktypeL_max+1u, 64);
             } catch (std::bad_alloc const& ) {
               ae = api_error::Memory;
               break;
@@ -1238,6 +1310,7 @@ namespace text_complex {
               state.blocktypeL_skip = brcvt_resolve_skip(state.literal_blocktype);
               brcvt_reset19(state.treety);
               state.state += 1;
+              state.treety.count = 26; /* block count codes */
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1255,7 +1328,7 @@ namespace text_complex {
               state.blocktypeL_remaining = 0;
               fixlist_codesort(state.literal_blockcount, ae);
               if (state.blockcountL_skip != brcvt_NoSkip)
-                state.blocktypeL_remaining = brcvt_config_count(state, state.blockcountL_skip, state.state + 1);
+                state.blocktypeL_remaining = brcvt_config_count(state, state.blockcountL_skip, state.state + 1, ae);
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1265,7 +1338,7 @@ namespace text_complex {
             unsigned const line_value = brcvt_inflow_lookup(state, state.literal_blockcount, x);
             if (line_value >= 26)
               break;
-            state.blocktypeL_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state));
+            state.blocktypeL_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state), ae);
           } else if (state.bit_length < state.extra_length) {
             brcvt_accum_remain(state, state.blocktypeL_remaining, x, brcvt_next_state(state.state));
           } else ae = api_error::Sanitize;
@@ -1293,13 +1366,13 @@ namespace text_complex {
               state.bit_length = 0;
             } else {
               unsigned const alphasize = (state.bits>>4)+(1u<<(state.count-4))+1u;
-              state.treety.count = static_cast<unsigned short>(alphasize);
+              state.treety.count = static_cast<unsigned short>(alphasize+2u);
               state.alphabits = util_bitwidth(alphasize+1u); //BITWIDTH(NBLTYPESx + 2)
               state.state += 1;
               state.blocktypeI_max = static_cast<unsigned char>(alphasize-1u);
             }
             try {
-              state.insert_forest = gasp_vector(state.treety.count);
+              state.insert_forest = gasp_vector(state.blocktypeI_max+1u);
             } catch (std::bad_alloc const&) {
               ae = api_error::Memory;
             }
@@ -1312,6 +1385,7 @@ namespace text_complex {
               state.blocktypeI_skip = brcvt_resolve_skip(state.insert_blocktype);
               brcvt_reset19(state.treety);
               state.state += 1;
+              state.treety.count = 26; /* block count codes */
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1329,7 +1403,7 @@ namespace text_complex {
               state.blocktypeI_remaining = 0;
               fixlist_codesort(state.insert_blockcount, ae);
               if (state.blockcountI_skip != brcvt_NoSkip)
-                state.blocktypeI_remaining = brcvt_config_count(state, state.blockcountI_skip, state.state + 1);
+                state.blocktypeI_remaining = brcvt_config_count(state, state.blockcountI_skip, state.state + 1, ae);
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1339,7 +1413,7 @@ namespace text_complex {
             unsigned const line_value = brcvt_inflow_lookup(state, state.insert_blockcount, x);
             if (line_value >= 26)
               break;
-            state.blocktypeI_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state));
+            state.blocktypeI_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state), ae);
           } else if (state.bit_length < state.extra_length) {
             brcvt_accum_remain(state, state.blocktypeI_remaining, x, brcvt_next_state(state.state));
           } else ae = api_error::Sanitize;
@@ -1367,13 +1441,13 @@ namespace text_complex {
               state.bit_length = 0;
             } else {
               unsigned const alphasize = (state.bits>>4)+(1u<<(state.count-4))+1u;
-              state.treety.count = static_cast<unsigned short>(alphasize);
+              state.treety.count = static_cast<unsigned short>(alphasize+2u);
               state.alphabits = util_bitwidth(alphasize+1u); //BITWIDTH(NBLTYPESx + 2)
               state.state += 1;
               state.blocktypeD_max = static_cast<unsigned char>(alphasize-1u);
             }
             try {
-              state.distance_map = context_map(state.treety.count, 4);
+              state.distance_map = context_map(state.blocktypeD_max+1u, 4);
             } catch (std::bad_alloc const& ) {
               ae = api_error::Memory;
               break;
@@ -1387,6 +1461,7 @@ namespace text_complex {
               state.blocktypeD_skip = brcvt_resolve_skip(state.distance_blocktype);
               brcvt_reset19(state.treety);
               state.state += 1;
+              state.treety.count = 26; /* block count codes */
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1404,7 +1479,7 @@ namespace text_complex {
               state.blocktypeD_remaining = 0;
               fixlist_codesort(state.distance_blockcount, ae);
               if (state.blockcountD_skip != brcvt_NoSkip)
-                state.blocktypeD_remaining = brcvt_config_count(state, state.blockcountD_skip, state.state + 1);
+                state.blocktypeD_remaining = brcvt_config_count(state, state.blockcountD_skip, state.state + 1, ae);
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -1414,7 +1489,7 @@ namespace text_complex {
             unsigned const line_value = brcvt_inflow_lookup(state, state.distance_blockcount, x);
             if (line_value >= 26)
               break;
-            state.blocktypeD_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state));
+            state.blocktypeD_remaining = brcvt_config_count(state, line_value, brcvt_next_state(state.state), ae);
           } else if (state.bit_length < state.extra_length) {
             brcvt_accum_remain(state, state.blocktypeD_remaining, x, brcvt_next_state(state.state));
           } else ae = api_error::Sanitize;
@@ -1513,7 +1588,7 @@ namespace text_complex {
             state.state += 1;
             brcvt_reset19(state.treety);
             state.treety.count = static_cast<unsigned short>(state.rlemax + ntrees);
-            state.alphabits = static_cast<unsigned char>(state.rlemax + ntrees);
+            state.alphabits = util_bitwidth(state.treety.count-1);
           } break;
         case BrCvt_ContextPrefixL:
         case BrCvt_ContextPrefixD:
@@ -1637,8 +1712,14 @@ namespace text_complex {
                 state.state += 1;
                 state.index = 0;
                 uint32 const old_accum = state.fwd.accum;
+                unsigned char const old_ctxt[2] = {
+                    state.fwd.literal_ctxt[0], state.fwd.literal_ctxt[1]
+                  };
                 state.fwd = {};
                 state.fwd.accum = old_accum;
+                /* literal context carries across meta-blocks */
+                state.fwd.literal_ctxt[0] = old_ctxt[0];
+                state.fwd.literal_ctxt[1] = old_ctxt[1];
                 if (state.state != BrCvt_DataInsertCopy || state.insert_skip == brcvt_NoSkip)
                   break;
                 ae = brcvt_handle_inskip(state, to, to_end, to_next);
@@ -1670,8 +1751,6 @@ namespace text_complex {
               bool end = false;
               state.state = BrCvt_Literal;
               ae = brcvt_land_insert_copy(state, end);
-              if (end)
-                return ae;
             }
           } break;
         case BrCvt_DataCopyExtra:
@@ -1685,13 +1764,9 @@ namespace text_complex {
             bool end = false;
             state.state = BrCvt_Literal;
             ae = brcvt_land_insert_copy(state, end);
-            if (end)
-              return ae;
           } break;
         case BrCvt_Literal:
-          if (to_next >= to_end)
-            ae = api_error::Partial;
-          else {
+          {
             context_map_mode const mode = state.literals_map.get_mode(state.blocktypeL_index.current);
             std::size_t const column = ctxtmap_literal_context(mode, state.fwd.literal_ctxt[1],
               state.fwd.literal_ctxt[0]);
@@ -1755,8 +1830,8 @@ namespace text_complex {
           ae = brcvt_handle_inskip(state, to, to_end, to_next);
           break;
         case BrCvt_LiteralRestart:
-          if (!brcvt_inflow_restart(state, state.distance_blocktype,
-            state.blocktypeD_index, state.blocktypeD_max, BrCvt_DistanceRecount, x))
+          if (!brcvt_inflow_restart(state, state.literal_blocktype,
+            state.blocktypeL_index, state.blocktypeL_max, BrCvt_LiteralRecount, x))
           {
             break;
           }
@@ -1766,16 +1841,18 @@ namespace text_complex {
           ae = api_error::Sanitize;
           break;
         }
-        if (ae > api_error::Success)
-          /* halt the read position here: */break;
-        else if (ae == api_error::Success)
-        {
+        if (ae == api_error::Success)
           ae = brcvt_handle_inskip(state, to, to_end, to_next);
-          if (ae != api_error::Success)
-            break;
-        }
+        if (ae == api_error::Partial) {
+          /* this bit is spent; the output resumes on the next call */
+          ++i;
+          break;
+        } else if (ae != api_error::Success)
+          /* halt the read position here: */break;
       }
-      state.bit_index = i&7u;
+      /* a full byte under Partial stays at 8 until the output drains */
+      state.bit_index = static_cast<unsigned char>
+        (ae == api_error::Partial ? i : (i&7u));
       return ae;
     }
 
@@ -1795,8 +1872,13 @@ namespace text_complex {
     }
 
     uint32 brcvt_config_count
-      (brcvt_state& state, unsigned long value, unsigned char next_state)
+      (brcvt_state& state, unsigned long value, unsigned char next_state,
+        api_error& ae)
     {
+      if (value >= state.blockcounts.size()) {
+        ae = api_error::Sanitize;
+        return 0;
+      }
       insert_copy_row const& row = state.blockcounts[static_cast<std::size_t>(value)];
       state.extra_length = row.insert_bits;
       state.bits = 0;
@@ -1872,7 +1954,7 @@ namespace text_complex {
           } catch (std::bad_alloc const&) {
             return api_error::Memory;
           }
-          treety.count = new_count;
+          /* `count` keeps the alphabet size until the symbols are read */
           treety.index = 0;
           treety.bit_length = 0;
           treety.bits = 0;
@@ -1881,11 +1963,14 @@ namespace text_complex {
       case BrCvt_TSimpleAlpha:
         treety.bits |= (x<<(treety.bit_length++));
         if (treety.bit_length == alphabits) {
+          if (treety.bits >= treety.count)
+            return api_error::Sanitize;
           treety.nineteen[treety.index].value = treety.bits;
           treety.index += 1;
           treety.bits = 0;
           treety.bit_length = 0;
-          if (treety.index >= treety.count) {
+          if (treety.index >= treety.nineteen.size()) {
+            treety.count = static_cast<unsigned short>(treety.nineteen.size());
             if (treety.count == 4) {
               treety.state = BrCvt_TSimpleFour;
               break;
@@ -1934,9 +2019,10 @@ namespace text_complex {
             treety.nonzero += 1;
             if (treety.len_check > 32)
               return api_error::Sanitize;
+            /* zero lengths after the first nonzero one must not replace it */
+            if (treety.nonzero == 1)
+              treety.singular = brcvt_clen[treety.index];
           }
-          if (treety.nonzero == 1)
-            treety.singular = brcvt_clen[treety.index];
           treety.nineteen[treety.index++].len = len;
           if (treety.index >= brcvt_CLenExtent || treety.len_check >= 32) {
             if (treety.nonzero > 1 && treety.len_check != 32)
@@ -2507,8 +2593,9 @@ namespace text_complex {
       std::size_t try_bit_count = 0;
       state.buffer.clear_output();
       /* try to compress the block */{
+        cvtstats_timer const timer(state.stats.match_ns);
         api_error ae{};
-        state.buffer.try_block(ae);
+        state.buffer.try_block(state.stats, ae);
         if (ae != api_error::Success)
           return ae;
       }
@@ -2519,6 +2606,7 @@ namespace text_complex {
           return ae;
       }
       /* calculate the guesses */
+      cvtstats_timer histogram_timer(state.stats.histogram_ns);
       prefix_histogram ctxt_histogram(4);
       /** @brief Map from outflow context index to mode. */
       std::array<context_map_mode,4> ctxt_mode_revmap = {{
@@ -2604,7 +2692,8 @@ namespace text_complex {
                 to_record ? std::numeric_limits<uint32>::max() : 0, ae);
               if (ae != api_error::Success)
                 return api_error::Sanitize;
-              try_bit_count += extra;
+              /* `extra` holds the bits themselves; count them */
+              try_bit_count += state.try_ring.bit_count(cmd);
               state.dist_histogram[cmd] += 1;
             } break;
           default:
@@ -2613,6 +2702,8 @@ namespace text_complex {
         }
         assert(ctxt_i < literal_lengths.size());
         literal_lengths[ctxt_i] = literal_counter;
+        histogram_timer.stop();
+        cvtstats_timer const tree_timer(state.stats.tree_ns);
         /* NOTE: Context creation moved here to avoid the zero-item prefix list. */
         for (unsigned ctxt_j = 0; ctxt_j <= ctxt_i; ++ctxt_j) {
           if (literal_lengths[ctxt_j] == 0)
@@ -2640,6 +2731,8 @@ namespace text_complex {
         prefix_preset blocktype_tree = fixlist_match_preset(state.literal_blocktype);
         if (blocktype_tree == prefix_preset::BrotliComplex)
           return api_error::Sanitize;
+        /* block type numbers follow the symbol values, not the code order */
+        fixlist_valuesort(state.literal_blocktype);
         try_bit_count += 4;
         /* NOTE: This context map generation is delayed until after the tokens are generated. */
         std::size_t const btypes = state.literal_blocktype.size();
@@ -2673,14 +2766,16 @@ namespace text_complex {
         /* apply histograms to the trees */
         api_error ae {};
         try_bit_count += brcvt_apply_histogram(
-          state.distance_forest[0], state.dist_histogram, ae);
+          state.distance_forest[0], state.dist_histogram,
+          state.length_scratch, ae);
         try_bit_count += brcvt_apply_histogram(
-          state.insert_forest[0], state.ins_histogram, ae);
+          state.insert_forest[0], state.ins_histogram,
+          state.length_scratch, ae);
         for (unsigned btype_j = 0; btype_j < btypes; ++btype_j) {
           int const btype = static_cast<int>(state.literals_map.get_mode(btype_j));
           try_bit_count += brcvt_apply_histogram(
             state.literals_forest[btype_j],
-            state.lit_histogram[btype], ae);
+            state.lit_histogram[btype], state.length_scratch, ae);
         }
         std::copy(literal_lengths.begin(), literal_lengths.end(), state.guess_lengths);
       }
@@ -2719,7 +2814,7 @@ namespace text_complex {
 
     std::size_t brcvt_apply_histogram(
       gasp_vector::root& tree_info, prefix_histogram const& histogram,
-      api_error &ae) noexcept
+      prefix_histogram& scratch, api_error &ae) noexcept
     {
       prefix_list& tree = tree_info.tree;
       if (ae != api_error::Success)
@@ -2734,7 +2829,7 @@ namespace text_complex {
       for (std::size_t i = 0; i < histogram.size(); ++i) {
         tree[i].value = static_cast<unsigned>(i);
       }
-      fixlist_gen_lengths(tree, histogram, 15, ae);
+      fixlist_gen_lengths(tree, histogram, 15, scratch, ae);
       if (ae != api_error::Success)
         return 0;
       fixlist_gen_codes(tree, ae);
@@ -2826,7 +2921,10 @@ namespace text_complex {
           std::size_t const from_count = from_end - p;
           std::size_t const min_count = (input_space < from_count)
             ? static_cast<std::size_t>(input_space) : from_count;
-          state.buffer.write(p, min_count, ae);
+          /* */{
+            cvtstats_timer const timer(state.stats.window_ns);
+            state.buffer.write(p, min_count, ae);
+          }
           if (ae != api_error::Success)
             break;
           p += min_count;
@@ -2879,6 +2977,7 @@ namespace text_complex {
             state.count += 1u;
           }
           if (state.count >= brcvt_MetaHeaderLen) {
+            cvtstats_add(state.stats.metadata_blocks, 1u);
             if (state.backward)
               state.state = BrCvt_MetaLength;
             else if (i == 7)
@@ -2977,6 +3076,8 @@ namespace text_complex {
         case BrCvt_CompressCheck:
           if (state.bit_length == 0) {
             bool const want_compress = (brcvt_check_compress(state)==api_error::Success);
+            cvtstats_add(want_compress
+              ? state.stats.dynamic_blocks : state.stats.stored_blocks, 1u);
             if (!want_compress) {
               x = 1;
               state.buffer.clear_output();
@@ -3037,6 +3138,7 @@ namespace text_complex {
               state.bit_length = 0;
               brcvt_reset19(state.treety);
               state.state += 1;
+              fixlist_valuesort(state.literal_blocktype, ae);
             } else if (res != api_error::Success)
               ae = res;
           } break;
@@ -3077,7 +3179,9 @@ namespace text_complex {
             for (unsigned j = 0; j < 26; ++j) {
               state.literal_blockcount[j].value = j;
             }
-            fixlist_gen_lengths(state.literal_blockcount, histogram, 15, ae);
+            cvtstats_timer const tree_timer(state.stats.tree_ns);
+            fixlist_gen_lengths(state.literal_blockcount, histogram, 15,
+              state.length_scratch, ae);
             if (ae != api_error::Success)
               break;
             fixlist_gen_codes(state.literal_blockcount, ae);
@@ -3236,11 +3340,11 @@ namespace text_complex {
             constexpr unsigned HistogramSize = 10;
             prefix_histogram histogram(HistogramSize);
             unsigned int const rlemax = state.rlemax;
-            unsigned char const alphabits = static_cast<unsigned char>(rlemax+btypes);
+            std::size_t const alphasize = rlemax+btypes;
             std::fill(histogram.begin(), histogram.end(), 0);
             /* calculate prefix tree */
             try {
-              state.context_tree = prefix_list(alphabits);
+              state.context_tree = prefix_list(alphasize);
             } catch (std::bad_alloc const&) {
               ae = api_error::Memory;
               break;
@@ -3260,14 +3364,16 @@ namespace text_complex {
                 histogram[ch&(brcvt_ZeroBit-1)] += 1;
               } else continue;
             }
-            fixlist_gen_lengths(state.context_tree, histogram, 8, ae);
+            cvtstats_timer const tree_timer(state.stats.tree_ns);
+            fixlist_gen_lengths(state.context_tree, histogram, 8,
+              state.length_scratch, ae);
             if (ae != api_error::Success)
               break;
             fixlist_gen_codes(state.context_tree, ae);
             if (ae != api_error::Success)
               break;
             brcvt_reset19(state.treety);
-            state.alphabits = alphabits;
+            state.alphabits = util_bitwidth(static_cast<unsigned>(alphasize-1));
             state.state += 1;
           } break;
         case BrCvt_ContextPrefixL:
@@ -3462,6 +3568,7 @@ namespace text_complex {
         wbits(15u), values(704u),
         ring(true,4,0), try_ring(true,4,0),
         lit_histogram{{256u}, {256u}, {256u}, {256u}}, dist_histogram(68u), ins_histogram(704u),
+        length_scratch(704u*2u),
         bits(0u), extra_length(0u), h_end(0u),
         bit_length(0u), state(0u), bit_index(0u),
         backward(0u), metablock_pos(0u), count(0u), index(0u),
@@ -3478,7 +3585,8 @@ namespace text_complex {
         blocktypeI_skip(brcvt_NoSkip), blockcountI_skip(brcvt_NoSkip),
         blocktypeD_skip(brcvt_NoSkip), blockcountD_skip(brcvt_NoSkip),
         literal_skip(brcvt_NoSkip), insert_skip(brcvt_NoSkip), distance_skip(brcvt_NoSkip),
-        context_skip(brcvt_NoSkip), fwd{}, extra_bits{}, ctxt_mode_map{}
+        context_skip(brcvt_NoSkip), fwd{}, extra_bits{}, ctxt_mode_map{},
+        stats()
     {
       if (n > 16777200u)
         n = 16777200u;
@@ -3538,6 +3646,26 @@ namespace text_complex {
         delete x;
       }
     }
+
+    void brcvt_reset(brcvt_state& state, api_error& ae) noexcept {
+      try {
+        /* fresh tables around the old window storage */
+        brcvt_state fresh(1u, 1u, 1u);
+        fresh.wbits_select = state.wbits_select;
+        fresh.max_len_meta = state.max_len_meta;
+        fresh.buffer = std::move(state.buffer);
+        fresh.buffer.clear();
+        state = std::move(fresh);
+      } catch (api_exception const& e) {
+        ae = e.to_error();
+        return;
+      } catch (std::bad_alloc const& ) {
+        ae = api_error::Memory;
+        return;
+      }
+      ae = api_error::Success;
+      return;
+    }
     //END   brcvt_state / allocation
 
     //BEGIN brcvt_state / public
@@ -3607,6 +3735,7 @@ namespace text_complex {
         case BrCvt_BDict:
         case BrCvt_InsertRecount:
         case BrCvt_DistanceRecount:
+        case BrCvt_LiteralRecount:
           ae = brcvt_in_bits(state, (*p), to, to_end, to_out);
           break;
         case BrCvt_MetaText:
@@ -3628,6 +3757,8 @@ namespace text_complex {
           }
           if (state.metablock_pos >= state.backward) {
             state.metatext = nullptr;
+            /* the skip length left its bit count behind */
+            state.bit_length = 0;
             state.state = (state.h_end
               ? BrCvt_Done : BrCvt_LastCheck);
             if (state.h_end)
@@ -3645,6 +3776,8 @@ namespace text_complex {
             (*to_out) = (*p);
             to_out += 1;
             state.metablock_pos += 1;
+            state.fwd.literal_ctxt[0] = state.fwd.literal_ctxt[1];
+            state.fwd.literal_ctxt[1] = (*p);
           }
           if (state.metablock_pos >= state.backward) {
             state.metatext = nullptr;
@@ -3664,6 +3797,9 @@ namespace text_complex {
         if (ae >= api_error::Partial)
           /* halt the read position here: */break;
       }
+      cvtstats_add(state.stats.bytes_in, static_cast<std::size_t>(p-from));
+      cvtstats_add(state.stats.bytes_out,
+        static_cast<std::size_t>(to_out-to));
       from_next = p;
       to_next = to_out;
       return ae;
@@ -3680,6 +3816,65 @@ namespace text_complex {
       return state.buffer.bypass(buf, sz, ae);
     }
 
+    size_t brcvt_continue
+      (brcvt_state& state, unsigned char const* buf, size_t sz, api_error& ae)
+      noexcept
+    {
+      if (state.state != BrCvt_WBits || state.bit_length != 0u) {
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+      ae = api_error::Success;
+      size_t const out = state.buffer.bypass(buf, sz, ae);
+      if (ae != api_error::Success)
+        return out;
+      /* the decoder's distance history is unknown here */
+      state.ring.forget();
+      state.try_ring.forget();
+      state.fwd.accum = static_cast<uint32>(
+          std::min<size_t>(state.fwd.accum + out, 16777200u));
+      /* skip the stream header */
+      brcvt_next_block(state);
+      state.bit_length = 0;
+      return out;
+    }
+
+    size_t brcvt_set_prefix
+      (brcvt_state& state, unsigned char const* buf, size_t sz, api_error& ae)
+      noexcept
+    {
+      if (state.state != BrCvt_WBits || state.bit_length != 0u
+      ||  state.buffer.ring_size() != 0u)
+      {
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+      ae = api_error::Success;
+      size_t const out = state.buffer.bypass(buf, sz, ae);
+      /* distances may reach back into the prefix */
+      state.fwd.accum = static_cast<uint32>(
+          std::min<size_t>(out, 16777200u));
+      return out;
+    }
+
+    void brcvt_set_prefix
+      (brcvt_state& state, hash_chain const& prefix, api_error& ae) noexcept
+    {
+      if (state.state != BrCvt_WBits || state.bit_length != 0u
+      ||  state.buffer.ring_size() != 0u)
+      {
+        ae = api_error::Sanitize;
+        return;
+      }
+      state.buffer.load_window(prefix, ae);
+      if (ae != api_error::Success)
+        return;
+      /* distances may reach back into the prefix */
+      state.fwd.accum = static_cast<uint32>(
+          std::min<uint32>(prefix.size(), 16777200u));
+      return;
+    }
+
     api_error brcvt_out(brcvt_state& state,
         unsigned char const* from, unsigned char const* from_end,
         unsigned char const*& from_next,
@@ -3689,6 +3884,7 @@ namespace text_complex {
       api_error ae = api_error::Success;
       unsigned char* to_out;
       unsigned char const* p = from;
+      cvtstats_call call(state.stats);
       for (to_out = to; to_out < to_end && ae == api_error::Success;
           ++to_out)
       {
@@ -3776,6 +3972,8 @@ namespace text_complex {
         if (ae >= api_error::Partial)
           break;
       }
+      call.done(static_cast<std::size_t>(p-from),
+        static_cast<std::size_t>(to_out-to));
       from_next = p;
       to_next = to_out;
       return ae;
@@ -0,0 +1,178 @@
+/**
+ * @file tcmplx-access-plus/brpar.cpp
+ * @brief Parallel Brotli compression state
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#if (defined TextComplexAccessP_NO_EXCEPT)
+#  undef TextComplexAccessP_NO_EXCEPT
+#endif //TextComplexAccessP_NO_EXCEPT
+#include "text-complex-plus/access/brpar.hpp"
+#include "text-complex-plus/access/brcvt.hpp"
+#include "segpar_p.hpp"
+#include <algorithm>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Brotli policy for the segment pipeline.
+     * @note Each segment primes its window with the last `n` bytes
+     *   before it. Copies reach back at most `n` bytes and the encoder
+     *   emits no static dictionary references, so `n` bytes are enough
+     *   even when the Brotli window is larger.
+     */
+    struct brpar_codec {
+      typedef brcvt_state state;
+      /** @brief Brotli streams carry no checksum. */
+      struct check {};
+
+      static check check_start(void) noexcept {
+        return check();
+      }
+      static void cvt_continue(brcvt_state& cvt,
+          unsigned char const* buf, std::size_t size, api_error& ae)
+      {
+        brcvt_continue(cvt, buf, size, ae);
+      }
+      static api_error cvt_out(brcvt_state& cvt,
+          unsigned char const* from, unsigned char const* from_end,
+          unsigned char const*& from_next,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return brcvt_out(cvt, from, from_end, from_next, to, to_end, to_next);
+      }
+      static api_error cvt_flush(brcvt_state& cvt,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return brcvt_flush(cvt, to, to_end, to_next);
+      }
+      static api_error cvt_unshift(brcvt_state& cvt,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return brcvt_unshift(cvt, to, to_end, to_next);
+      }
+      static void record(check& , brcvt_state const& ) noexcept {
+        return;
+      }
+      static api_error combine
+          (check& , segpar_job<brpar_codec>& ) noexcept
+      {
+        return api_error::Success;
+      }
+    };
+
+    struct brpar_core : segpar_core<brpar_codec> {
+      using segpar_core<brpar_codec>::segpar_core;
+    };
+
+    struct brpar_access {
+      static brpar_core* get(brpar_state& s) noexcept {
+        return s.core;
+      }
+    };
+
+    //BEGIN brpar_state / rule-of-six
+    brpar_state::brpar_state(uint32 block_size, uint32 n,
+        size_t chain_length, uint32 segment_size, unsigned int threads)
+      : core(nullptr)
+    {
+      if (segment_size == 0u)
+        throw api_exception(api_error::Param);
+      core = new brpar_core(block_size, std::min<uint32>(n, 16777200u),
+        chain_length, segment_size, threads);
+      return;
+    }
+
+    brpar_state::~brpar_state(void) {
+      if (core)
+        delete core;
+      core = nullptr;
+      return;
+    }
+
+    brpar_state::brpar_state(brpar_state&& other) noexcept
+      : core(util_exchange(other.core, nullptr))
+    {
+      return;
+    }
+
+    brpar_state& brpar_state::operator=(brpar_state&& other) noexcept {
+      brpar_core* const old_core =
+        util_exchange(core, util_exchange(other.core, nullptr));
+      if (old_core)
+        delete old_core;
+      return *this;
+    }
+    //END   brpar_state / rule-of-six
+
+    //BEGIN brpar_state / allocation
+    void* brpar_state::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* brpar_state::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void brpar_state::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void brpar_state::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    brpar_state* brpar_new
+        ( uint32 block_size, uint32 n, size_t chain_length,
+          uint32 segment_size, unsigned int threads) noexcept
+    {
+      try {
+        return new brpar_state(block_size,n,chain_length,segment_size,threads);
+      } catch (api_exception const& ) {
+        return nullptr;
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<brpar_state> brpar_unique
+        ( uint32 block_size, uint32 n, size_t chain_length,
+          uint32 segment_size, unsigned int threads) noexcept
+    {
+      return util_unique_ptr<brpar_state>(
+        brpar_new(block_size,n,chain_length,segment_size,threads));
+    }
+
+    void brpar_destroy(brpar_state* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   brpar_state / allocation
+
+    //BEGIN brpar_state / public
+    unsigned int brpar_state::threads(void) const noexcept {
+      return core ? core->pool.size() : 0u;
+    }
+    //END   brpar_state / public
+
+    //BEGIN brpar / namespace local
+    api_error brpar_out(brpar_state& state,
+        unsigned char const* from, unsigned char const* from_end,
+        unsigned char const*& from_next,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next)
+    {
+      return segpar_out<brpar_codec>(brpar_access::get(state),
+        from, from_end, from_next, to, to_end, to_next);
+    }
+
+    api_error brpar_unshift(brpar_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next)
+    {
+      return segpar_unshift<brpar_codec>(brpar_access::get(state),
+        to, to_end, to_next);
+    }
+    //END   brpar / namespace local
+  };
+};
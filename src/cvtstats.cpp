@@ -0,0 +1,22 @@
+/**
+ * @file tcmplx-access-plus/cvtstats.cpp
+ * @brief Conversion statistics
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#include "text-complex-plus/access/api.hpp"
+#include "text-complex-plus/access/cvtstats.hpp"
+#include "cvtstats_p.hpp"
+
+namespace text_complex {
+  namespace access {
+    //BEGIN conversion statistics / namespace local
+    bool cvt_stats_enabled(void) noexcept {
+#if  (!(defined TextComplexAccessP_NO_STATS))
+      return true;
+#else
+      return false;
+#endif //TextComplexAccessP_NO_STATS
+    }
+    //END   conversion statistics / namespace local
+  };
+};
@@ -0,0 +1,122 @@
+/**
+ * @file tcmplx-access-plus/cvtstats_p.hpp
+ * @brief Conversion statistics
+ */
+#ifndef hg_TextComplexAccessP_CvtStats_pH_
+#define hg_TextComplexAccessP_CvtStats_pH_
+
+#include "text-complex-plus/access/cvtstats.hpp"
+#if  (!(defined TextComplexAccessP_NO_STATS))
+#  include <chrono>
+#endif //TextComplexAccessP_NO_STATS
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Scoped stage timer.
+     * @note Adds the lifetime of the timer to a statistics field.
+     */
+    class cvtstats_timer final {
+#if  (!(defined TextComplexAccessP_NO_STATS))
+    private:
+      unsigned long long& field;
+      std::chrono::steady_clock::time_point start;
+      bool running;
+
+    public:
+      explicit cvtstats_timer(unsigned long long& f) noexcept
+        : field(f), start(std::chrono::steady_clock::now()), running(true)
+      {
+      }
+      ~cvtstats_timer(void) {
+        stop();
+      }
+      /**
+       * @brief Stop the timer early.
+       */
+      void stop(void) noexcept {
+        if (!running)
+          return;
+        field += static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start
+            ).count()
+          );
+        running = false;
+      }
+#else
+    public:
+      explicit cvtstats_timer(unsigned long long& ) noexcept {}
+      void stop(void) noexcept {}
+#endif //TextComplexAccessP_NO_STATS
+      cvtstats_timer(cvtstats_timer const& ) = delete;
+      cvtstats_timer& operator=(cvtstats_timer const& ) = delete;
+    };
+
+    /**
+     * @brief Conversion call timer.
+     * @note Charges the part of a conversion call not spent in other
+     *   stages to the emission stage, and counts the bytes moved.
+     */
+    class cvtstats_call final {
+#if  (!(defined TextComplexAccessP_NO_STATS))
+    private:
+      cvt_stats& stats;
+      unsigned long long staged;
+      std::chrono::steady_clock::time_point start;
+
+      unsigned long long stage_sum(void) const noexcept {
+        return stats.match_ns + stats.histogram_ns + stats.tree_ns
+          + stats.window_ns;
+      }
+
+    public:
+      explicit cvtstats_call(cvt_stats& s) noexcept
+        : stats(s), staged(stage_sum()),
+          start(std::chrono::steady_clock::now())
+      {
+      }
+      /**
+       * @brief Finish the call.
+       * @param in bytes consumed
+       * @param out bytes produced
+       */
+      void done(std::size_t in, std::size_t out) noexcept {
+        unsigned long long const elapsed = static_cast<unsigned long long>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start
+            ).count()
+          );
+        unsigned long long const other = stage_sum() - staged;
+        if (elapsed > other)
+          stats.emit_ns += elapsed - other;
+        stats.bytes_in += in;
+        stats.bytes_out += out;
+      }
+#else
+    public:
+      explicit cvtstats_call(cvt_stats& ) noexcept {}
+      void done(std::size_t , std::size_t ) noexcept {}
+#endif //TextComplexAccessP_NO_STATS
+      cvtstats_call(cvtstats_call const& ) = delete;
+      cvtstats_call& operator=(cvtstats_call const& ) = delete;
+    };
+
+    /**
+     * @brief Add to a statistics counter.
+     * @param field the counter
+     * @param n amount to add
+     */
+    inline
+    void cvtstats_add(unsigned long long& field, std::size_t n) noexcept {
+#if  (!(defined TextComplexAccessP_NO_STATS))
+      field += n;
+#else
+      (void)field;
+      (void)n;
+#endif //TextComplexAccessP_NO_STATS
+    }
+  };
+};
+
+#endif //hg_TextComplexAccessP_CvtStats_pH_
@@ -11,7 +11,6 @@
 #include <utility>
 #include <cstring>
 #include <algorithm>
-#include <vector>
 #include <climits>
 #include <cassert>
 
@@ -93,86 +92,19 @@ namespace text_complex {
 
     /**
      * @internal
-     * @brief Back reference to prefix list.
+     * @brief Frequency comparator for symbol indices.
      */
-    struct prefix_ref {
-      /** @internal @brief Left child. */
-      unsigned int index;
-      /** @internal @brief Right child. */
-      uint32 freq;
-    };
-    /**
-     * @internal
-     * @brief Min-heap item for code tree building.
-     * @todo use std::push_heap and std::pop_heap
-     */
-    struct prefix_heapitem {
-      /** @internal @brief histogram value. */
-      uint32 freq;
-      /** @internal @brief block width. */
-      uint32 total_frac;
-      /** @internal @brief block width below midline. */
-      uint32 small_frac;
-      /** @internal @brief number of cells on the midline. */
-      uint32 midline;
-    };
-    /**
-     * @internal
-     * @brief Arguments for length generator recursive call.
-     */
-    struct prefix_arg {
-      /** @internal Reference index, first reference. */
-      unsigned int begin;
-      /** @internal Reference index, one-past-last reference. */
-      unsigned int end;
-      /** @internal block fraction upper bound. */
-      int upper_bound;
-      /** @internal block fraction lower bound. */
-      int lower_bound;
-      /** @internal @brief goal block width. */
-      uint32 total_frac;
-    };
-    /**
-     * @internal
-     * @brief Data for length generator recursive call.
-     */
-    struct prefix_state {
-      struct prefix_arg args;
-      struct prefix_heapitem item;
-    };
-
-    /**
-     * @internal
-     * @brief Queue of length generator recursive calls.
-     */
-    template <size_t n>
-    class prefix_statequeue {
-    private:
-      struct prefix_state p[n];
-      size_t current;
-      size_t total;
-
-    public:
-      /** @internal @brief Constructor. */
-      prefix_statequeue(void) noexcept;
-      /** @internal @return whether the queue is empty */
-      bool empty(void) const noexcept;
+    struct prefix_freq_cmp {
+      /** @internal @brief Histogram of symbol frequencies. */
+      prefix_histogram const& table;
       /**
-       * @internal @brief Push a state onto the queue.
-       * @param st state to push
+       * @internal
+       * @brief Compare two symbol indices.
+       * @param a one index
+       * @param b another index
+       * @return whether `a` is less frequent than `b`
        */
-      void push(prefix_state st) noexcept;
-      /** @internal @brief Remove the next element from the queue. */
-      void pop(void) noexcept;
-      /** @internal @return the next item in the queue */
-      prefix_state& front(void) noexcept;
-      /**
-       * @internal @brief Array index.
-       * @param i index
-       * @return the item at `[i]`
-       */
-      prefix_state& operator[](size_t i) noexcept;
-      size_t capacity(void) const noexcept;
+      bool operator()(uint32 a, uint32 b) const noexcept;
     };
 
     /**
@@ -182,6 +114,13 @@ namespace text_complex {
     static
     constexpr unsigned int fixlist_codecmp_maxdiff =
         (CHAR_BIT)*sizeof(unsigned short);
+    /**
+     * @internal
+     * @brief Largest alphabet for which length generation uses
+     *   stack work space when the caller provides none.
+     */
+    static
+    constexpr size_t fixlist_SmallScratch = 32u;
 
     /**
      * @brief Add two numbers, clamping the result.
@@ -191,51 +130,55 @@ namespace text_complex {
      */
     static
     uint32 fixlist_addclamp(uint32 a, uint32 b);
-    /**
-     * @brief Sum two heap items together.
-     * @param a one addend
-     * @param b another addend
-     * @return sum heap item
-     */
-    static
-    prefix_heapitem operator+(prefix_heapitem a, prefix_heapitem b);
-    /**
-     * @brief Compare two heap items.
-     * @param a one item
-     * @param b another item
-     * @return whether `a` is "less than" `b`
-     */
-    static
-    bool prefix_heap_cmp(prefix_heapitem const& a, prefix_heapitem const& b);
     /**
      * @internal
-     * @brief Compare two prefix list references.
-     * @param a one reference
-     * @param b another reference
-     * @return true if `a`'s frequency is greater than `b`'s,
-     *   zero otherwise
+     * @brief Generate prefix code lengths using caller-owned work space.
+     * @param dst list to populate with lengths
+     * @param table frequency histogram
+     * @param max_bits maximum output length
+     * @param scratch work space of at least `3*dst.size()` items
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   nonzero otherwise
      */
     static
-    bool prefix_ref_cmp(prefix_ref const& a, prefix_ref const& b);
+    void fixlist_gen_lengths_mk
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, uint32* scratch, api_error& ae) noexcept;
     /**
      * @internal
-     * @brief Find the least significant set bit.
-     * @param x input
-     * @return a number with only that set bit
+     * @brief Count the leaves of a length-limited code by package-merge.
+     * @param[out] counts number of symbols per code length
+     * @param table frequency histogram
+     * @param refs symbol indices, sorted by ascending frequency
+     * @param n number of symbols, more than two
+     * @param max_bits maximum output length, with `n <= 2**max_bits`
+     * @param work work space of at least `2*n` items
+     * @note Only the number of leaves each level takes is kept, so the
+     *   levels are rebuilt from the bottom for each level: O(n*L*L)
+     *   time in O(n) space.
      */
     static
-    uint32 fixlist_min_frac(uint32 x) noexcept;
+    void fixlist_gen_counts_pm
+      ( size_t* counts, prefix_histogram const& table, uint32 const* refs,
+        size_t n, unsigned int max_bits, uint32* work) noexcept;
     /**
-     * @brief Check if the heap can provide packable items.
-     * @param h heap represented by an array
-     * @param n size of heap
-     * @param frac fraction to meet
-     * @return nonzero if two items can fit in such
+     * @internal
+     * @brief Merge the leaves with one level of packages.
+     * @param table frequency histogram
+     * @param refs symbol indices, sorted by ascending frequency
+     * @param n number of symbols
+     * @param pk package weights of this level, ascending
+     * @param pk_n number of packages
+     * @param take number of merged items to count leaves in
+     * @param[out] next (nullable) package weights of the next level up
+     * @param[out] next_n number of packages written to `next`
+     * @return the number of leaves among the first `take` merged items
      */
     static
-    bool fixlist_heap_packable
-      ( std::vector<prefix_heapitem>::iterator begin,
-        std::vector<prefix_heapitem>::iterator end, uint32 frac);
+    size_t fixlist_pm_merge
+      ( prefix_histogram const& table, uint32 const* refs, size_t n,
+        uint32 const* pk, size_t pk_n, size_t take,
+        uint32* next, size_t& next_n) noexcept;
     /**
      * @internal
      * @brief Compare two lines.
@@ -272,60 +215,198 @@ namespace text_complex {
     void fixline_reverse(prefix_line& line) noexcept;
 
     //BEGIN prefix-list / static
-    prefix_heapitem operator+(prefix_heapitem a, prefix_heapitem b) {
-      struct prefix_heapitem const out = {
-        fixlist_addclamp(a.freq,b.freq),
-        fixlist_addclamp(a.total_frac, b.total_frac),
-        fixlist_addclamp(a.small_frac, b.small_frac),
-        fixlist_addclamp(a.midline, b.midline)
-      };
-      return out;
-    }
-
     uint32 fixlist_addclamp(uint32 a, uint32 b) {
       return a > 0xFFffFFff-b ? 0xFFffFFff : a+b;
     }
 
-    bool prefix_ref_cmp(prefix_ref const& a, prefix_ref const& b) {
-      return a.freq > b.freq;
+    bool prefix_freq_cmp::operator()(uint32 a, uint32 b) const noexcept {
+      if (table[a] < table[b])
+        return true;
+      else if (table[a] > table[b])
+        return false;
+      else return a < b;
     }
 
-    bool prefix_heap_cmp(prefix_heapitem const& a, prefix_heapitem const& b) {
-      if (a.total_frac < b.total_frac)
-        return false;
-      else if (a.total_frac > b.total_frac)
-        return true;
-      else return a.freq > b.freq;
+    void fixlist_gen_lengths_mk
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, uint32* scratch, api_error& ae) noexcept
+    {
+      size_t const sz = dst.size();
+      /* symbol indices, sorted by ascending frequency */
+      uint32* const refs = scratch;
+      /* in-place work array (Moffat-Katajainen), then package-merge */
+      uint32* const work = scratch+sz;
+      size_t n = 0u;
+      /* collect nonzero frequencies */{
+        size_t i;
+        for (i = 0u; i < sz; ++i) {
+          if (table[i] > 0u) {
+            refs[n] = static_cast<uint32>(i);
+            n += 1u;
+          } else {
+            dst[i].len = 0u;
+          }
+        }
+        if (n <= 2u) {
+          if (max_bits > 0u) {
+            for (i = 0u; i < n; ++i)
+              dst[refs[i]].len = 1u;
+            ae = api_error::Success;
+            return;
+          } else {
+            ae = api_error::FixLenRange;
+            return;
+          }
+        } else if (n > (static_cast<size_t>(1u)<<max_bits)) {
+          ae = api_error::FixLenRange;
+          return;
+        }
+        prefix_freq_cmp const cmp = { table };
+        std::sort(refs, refs+n, cmp);
+        for (i = 0u; i < n; ++i)
+          work[i] = table[refs[i]];
+      }
+      /* first pass: combine weights, leaving parent pointers */{
+        size_t root = 0u;
+        size_t leaf = 2u;
+        size_t next;
+        work[0] = fixlist_addclamp(work[0], work[1]);
+        for (next = 1u; next < n-1u; ++next) {
+          /* first item of the pair */
+          if (leaf >= n || work[root] < work[leaf]) {
+            work[next] = work[root];
+            work[root] = static_cast<uint32>(next);
+            root += 1u;
+          } else {
+            work[next] = work[leaf];
+            leaf += 1u;
+          }
+          /* second item of the pair */
+          if (leaf >= n || (root < next && work[root] < work[leaf])) {
+            work[next] = fixlist_addclamp(work[next], work[root]);
+            work[root] = static_cast<uint32>(next);
+            root += 1u;
+          } else {
+            work[next] = fixlist_addclamp(work[next], work[leaf]);
+            leaf += 1u;
+          }
+        }
+      }
+      /* second pass: internal node depths */{
+        size_t next;
+        work[n-2u] = 0u;
+        for (next = n-2u; next > 0u; --next)
+          work[next-1u] = work[work[next-1u]]+1u;
+      }
+      /* leaf counts per length */{
+        size_t counts[16] = {0u};
+        if (work[0]+1u > max_bits) {
+          /* too deep: the optimal limited code instead */
+          fixlist_gen_counts_pm(counts, table, refs, n, max_bits, work);
+        } else {
+          size_t avail = 1u;
+          size_t root = n-1u;
+          unsigned int depth = 0u;
+          while (avail > 0u) {
+            size_t used = 0u;
+            while (root > 0u && work[root-1u] == depth) {
+              used += 1u;
+              root -= 1u;
+            }
+            counts[depth] = avail-used;
+            avail = 2u*used;
+            depth += 1u;
+          }
+        }
+        /* post to the prefix list */{
+          size_t i = n;
+          unsigned int j;
+          for (j = 1u; j <= max_bits; ++j) {
+            size_t k;
+            for (k = counts[j]; k > 0u; --k) {
+              i -= 1u;
+              dst[refs[i]].len = static_cast<unsigned short>(j);
+            }
+          }
+        }
+      }
+      ae = api_error::Success;
+      return;
     }
 
-    uint32 fixlist_min_frac(uint32 x) noexcept {
-      unsigned int n;
-      if (x == 0u)
-        return 0u;
-      else for (n = 0u; (x & 1u) == 0u; x >>= 1, ++n) {
-        continue;
+    size_t fixlist_pm_merge
+      ( prefix_histogram const& table, uint32 const* refs, size_t n,
+        uint32 const* pk, size_t pk_n, size_t take,
+        uint32* next, size_t& next_n) noexcept
+    {
+      /* no level uses more than `2*n-2` items */
+      size_t const limit = 2u*n-2u;
+      size_t leaf = 0u;
+      size_t i = 0u;
+      size_t k;
+      uint32 pending = 0u;
+      size_t leaves_taken = 0u;
+      next_n = 0u;
+      for (k = 0u; k < limit && (leaf < n || i < pk_n); ++k) {
+        uint32 w;
+        if (i >= pk_n || (leaf < n && table[refs[leaf]] <= pk[i])) {
+          w = table[refs[leaf]];
+          leaf += 1u;
+          if (k < take)
+            leaves_taken += 1u;
+        } else {
+          w = pk[i];
+          i += 1u;
+        }
+        if (next) {
+          if (k&1u) {
+            next[next_n] = fixlist_addclamp(pending, w);
+            next_n += 1u;
+          } else pending = w;
+        }
       }
-      return static_cast<uint32>(1u)<<n;
+      return leaves_taken;
     }
 
-    bool fixlist_heap_packable
-      ( std::vector<prefix_heapitem>::iterator begin,
-        std::vector<prefix_heapitem>::iterator end, uint32 frac)
+    void fixlist_gen_counts_pm
+      ( size_t* counts, prefix_histogram const& table, uint32 const* refs,
+        size_t n, unsigned int max_bits, uint32* work) noexcept
     {
-      if (end-begin < 2)
-        return false;
-      else if (begin->total_frac > frac)
-        return false;
-      else {
-        std::vector<prefix_heapitem>::iterator it = begin;
-        ++it;
-        if (it->total_frac <= frac)
-          return true;
-        ++it;
-        if (it == end)
-          return false;
-        else return (it->total_frac <= frac);
+      /* leaves taken at each level, deepest first */
+      size_t taken[16] = {0u};
+      size_t take = 2u*n-2u;
+      unsigned int level;
+      for (level = max_bits; level > 0u; --level) {
+        uint32* pk = work;
+        uint32* next = work+n;
+        size_t pk_n = 0u;
+        unsigned int j;
+        /* rebuild the packages of this level */
+        for (j = 1u; j < level; ++j) {
+          size_t next_n;
+          fixlist_pm_merge(table, refs, n, pk, pk_n, 0u, next, next_n);
+          std::swap(pk, next);
+          pk_n = next_n;
+        }
+        /* the packages taken here fix what the level below takes */{
+          size_t unused;
+          taken[level] = fixlist_pm_merge
+            (table, refs, n, pk, pk_n, take, nullptr, unused);
+        }
+        take = 2u*(take-taken[level]);
+      }
+      /* a symbol's length is the number of levels that take it */{
+        size_t i;
+        for (i = 0u; i < n; ++i) {
+          unsigned int len = 0u;
+          for (level = 1u; level <= max_bits; ++level) {
+            if (i < taken[level])
+              len += 1u;
+          }
+          counts[len] += 1u;
+        }
       }
+      return;
     }
 
     bool fixlist_code_cmp(prefix_line const& a, prefix_line const& b) {
@@ -358,48 +439,6 @@ namespace text_complex {
     }
     //END   prefix-list / static
 
-    //BEGIN prefix-state-queue / public internal
-    template <size_t n>
-    prefix_statequeue<n>::prefix_statequeue(void) noexcept
-      : current(0u), total(0u)
-    {
-#ifndef NDEBUG
-      std::memset(p, 0, sizeof(p));
-#endif /*NDEBUG*/
-    }
-
-    template <size_t n>
-    bool prefix_statequeue<n>::empty(void) const noexcept {
-      return current >= total;
-    }
-
-    template <size_t n>
-    void prefix_statequeue<n>::push(prefix_state st) noexcept {
-      p[total] = st;
-      total += 1u;
-    }
-
-    template <size_t n>
-    void prefix_statequeue<n>::pop(void) noexcept {
-      current += 1u;
-    }
-
-    template <size_t n>
-    prefix_state& prefix_statequeue<n>::front(void) noexcept {
-      return p[current];
-    }
-
-    template <size_t n>
-    prefix_state& prefix_statequeue<n>::operator[](size_t i) noexcept {
-      return p[i];
-    }
-
-    template <size_t n>
-    size_t prefix_statequeue<n>::capacity(void) const noexcept {
-      return total;
-    }
-    //END   prefix-state-queue / public internal
-
     //BEGIN prefix_list / rule-of-six
     prefix_list::prefix_list(size_t n)
       : p(nullptr), n(0u)
@@ -864,188 +903,35 @@ namespace text_complex {
       if (dst.size() > 32768u || max_bits > 15u) {
         ae = api_error::FixLenRange;
         return;
+      } else if (dst.size() <= fixlist_SmallScratch) {
+        uint32 scratch[fixlist_SmallScratch*3u];
+        fixlist_gen_lengths_mk(dst, table, max_bits, scratch, ae);
+        return;
       } else {
-        std::vector<prefix_ref> nodes;
-        std::vector<prefix_heapitem> heap;
+        prefix_histogram scratch;
+        fixlist_gen_lengths(dst, table, max_bits, scratch, ae);
+        return;
+      }
+    }
+
+    void fixlist_gen_lengths
+      ( prefix_list& dst, prefix_histogram const& table,
+        unsigned int max_bits, prefix_histogram& scratch,
+        api_error& ae) noexcept
+    {
+      if (dst.size() > 32768u || max_bits > 15u) {
+        ae = api_error::FixLenRange;
+        return;
+      } else if (scratch.size() < dst.size()*3u) {
         try {
-          nodes.reserve(dst.size());
-          heap.reserve(dst.size()*2u);
+          scratch = prefix_histogram(dst.size()*3u);
         } catch (std::bad_alloc const& ) {
           ae = api_error::Memory;
           return;
         }
-        /* */{
-          size_t i;
-          for (i = 0u; i < dst.size(); ++i) {
-            if (table[i] > 0u) {
-              struct prefix_ref const ref =
-                { static_cast<unsigned int>(i), table[i] };
-              nodes.push_back(ref);
-            } else {
-              dst[i].len = 0u;
-            }
-          }
-          if (nodes.size() <= 2u) {
-            if (max_bits > 0u) {
-              for (i = 0u; i < nodes.size(); ++i)
-                dst[nodes[i].index].len = 1u;
-              ae = api_error::Success;
-              return;
-            } else {
-              ae = api_error::FixLenRange;
-              return;
-            }
-          }
-          std::sort(nodes.begin(), nodes.end(), prefix_ref_cmp);
-        }
-        /* do the algorithm */{
-          prefix_statequeue<16> states;
-          /* initialize */{
-            uint32 const n = static_cast<uint32>(nodes.size());
-            struct prefix_state const st = {
-                { /* begin */0u,
-                  /* end */static_cast<unsigned int>(n),
-                  /* upper_bound */-1,
-                  /* lower_bound */-static_cast<int>(max_bits),
-                  /* total_frac */(n-1u)<<max_bits }
-              };
-            states.push(st);
-          }
-          /* run */while (!states.empty()) {
-            struct prefix_state& st = states.front();
-            int l;
-            unsigned long int rem_frac = st.args.total_frac;
-            int const midline = st.args.upper_bound +
-              (st.args.lower_bound-st.args.upper_bound-1)/2;
-            /* */{
-              std::memset(&st.item, 0, sizeof(struct prefix_heapitem));
-            }
-            for (l = st.args.lower_bound; rem_frac > 0u; ++l) {
-              uint32 const frac = 1u<<(static_cast<int>(max_bits)+l);
-              uint32 const min_frac = fixlist_min_frac(rem_frac);
-              /* add some items */if (l <= st.args.upper_bound) {
-                size_t i;
-                for (i = st.args.begin; i < st.args.end; ++i) {
-                  struct prefix_heapitem const it =
-                    { /* freq */nodes[i].freq, /*total_frac */frac,
-                      /* small_frac */(l < midline ? frac : 0u),
-                      /* midline */(l == midline ? 1u : 0u)};
-                  heap.push_back(it);
-                }
-                std::make_heap(heap.begin(), heap.end(), prefix_heap_cmp);
-              }
-              /* inspect */
-              if (heap.empty() || frac > min_frac) {
-                ae = api_error::FixLenRange;
-                return;
-              } else if (frac == min_frac) {
-                if (heap.front().total_frac != min_frac) {
-                  ae = api_error::FixLenRange;
-                  return;
-                } else {
-                  rem_frac -= min_frac;
-                  st.item = st.item + heap.front();
-                  std::pop_heap(heap.begin(), heap.end(), prefix_heap_cmp);
-                  heap.pop_back();
-                }
-              }
-              /* pack the rest */{
-                std::vector<prefix_heapitem>::iterator it = heap.end();
-                while (fixlist_heap_packable(heap.begin(), it, frac)) {
-                  struct prefix_heapitem item1 = heap.front();
-                  std::pop_heap(heap.begin(), it, prefix_heap_cmp);
-                  --it;
-                  struct prefix_heapitem item2 = heap.front();
-                  std::pop_heap(heap.begin(), it, prefix_heap_cmp);
-                  --it;
-                  *it = item1 + item2;
-                  ++it;
-                  std::push_heap(heap.begin(), it, prefix_heap_cmp);
-                }
-                if ((!heap.empty()) && heap.front().total_frac <= frac) {
-                  /* discard */
-                  std::pop_heap(heap.begin(), it, prefix_heap_cmp);
-                  --it;
-                }
-                heap.resize(it-heap.begin());
-              }
-            }
-            /* add new states */{
-              int const bound_span =
-                (st.args.upper_bound-st.args.lower_bound);
-              if (bound_span >= 3) {
-                /* construct "D" span */{
-                  struct prefix_state const d_state = {
-                      { /* begin */ st.args.end-st.item.midline,
-                        /* end */ st.args.end,
-                        /* upper_bound */midline-1,
-                        /* lower_bound */st.args.lower_bound,
-                        /* total_frac */st.item.small_frac }
-                    };
-                  states.push(d_state);
-                }
-                /* construct "A" span */{
-                  int const imax_bits = static_cast<int>(max_bits);
-                  struct prefix_state const a_state = {
-                      { /* begin */ st.args.begin,
-                        /* end */ st.args.end-st.item.midline,
-                        /* upper_bound */st.args.upper_bound,
-                        /* lower_bound */midline+1,
-                        /* total_frac */st.item.total_frac
-                            - st.item.small_frac
-                            -   ( (1u<<(imax_bits+st.args.upper_bound+1))
-                                - (1u<<(imax_bits+midline)))
-                              * st.item.midline }
-                    };
-                  states.push(a_state);
-                }
-              }
-            }
-            states.pop();
-            heap.clear();
-          }
-          /* parse out the lengths */{
-            size_t i;
-            uint32 lengths[16] = {0u};
-            int const imax_bits = max_bits;
-            for (i = 0u; i < states.capacity(); ++i) {
-              struct prefix_state const& st = states[i];
-              uint32 const offset =
-                static_cast<uint32>(nodes.size())-st.args.end;
-              int const bound_span = st.args.upper_bound-st.args.lower_bound;
-              int const midline = st.args.lower_bound+(bound_span/2);
-              lengths[-midline] = offset+st.item.midline;
-              if (bound_span <= 2) {
-                if (st.args.upper_bound > midline) {
-                  uint32 const x =
-                      st.item.total_frac
-                    - (st.item.midline<<(imax_bits+midline))
-                    - st.item.small_frac;
-                  lengths[-st.args.upper_bound] =
-                    (x>>(imax_bits+st.args.upper_bound)) + offset;
-                }
-                if (st.args.lower_bound < midline) {
-                  uint32 const x = st.item.small_frac;
-                  lengths[-st.args.lower_bound] =
-                    (x>>(imax_bits+st.args.lower_bound)) + offset;
-                }
-              }
-            }
-            /* post to the prefix list */{
-              size_t i = nodes.size();
-              size_t j;
-              for (j = 15u; j > 0u; --j) {
-                size_t const front = nodes.size()-lengths[j];
-                for (; i > front; --i) {
-                  dst[nodes[i-1u].index].len = j;
-                }
-              }
-            }
-          }
-        }
-        ae = api_error::Success;
-        return;
       }
+      fixlist_gen_lengths_mk(dst, table, max_bits, scratch.begin(), ae);
+      return;
     }
 
     void fixlist_codesort(prefix_list& dst, api_error& ae) noexcept {
@@ -0,0 +1,796 @@
+/**
+ * @file tcmplx-access-plus/fontcache.cpp
+ * @brief Cache of decoded fonts
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#include "text-complex-plus/access/fontcache.hpp"
+#include "text-complex-plus/access/offtable.hpp"
+#include "text-complex-plus/access/seq.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
+#include "text-complex-plus/access/woff2.hpp"
+#include "woff2_p.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include <new>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <chrono>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Identity of a source file beyond its content hash.
+     */
+    struct fontcache_source {
+      /** @brief Length of the source in bytes; zero if unknown. */
+      size_t size;
+      /** @brief Hash of the source under the cache's private seed. */
+      uint64 check;
+    };
+
+    /**
+     * @brief Decoded font shared by a cache and its views.
+     */
+    struct font_image {
+      /** @brief Holders of the font: views, and the cache while cached. */
+      std::atomic<size_t> refs;
+      /** @brief Content hash of the source. */
+      uint64 key;
+      /** @brief Source identity, for confirming a hit by content. */
+      fontcache_source source;
+      /** @brief Decoded sfnt image. */
+      std::vector<unsigned char> data;
+      /** @brief Length of the image in bytes. */
+      size_t size;
+      /** @brief Tables of the image. */
+      offset_table offsets;
+      /** @brief Bytes charged against the memory cap. */
+      size_t cost;
+    };
+
+    /**
+     * @brief Shared state of a font cache.
+     */
+    struct fontcache_core {
+      mutable std::mutex lock;
+      /** @brief Cached fonts, most recently used first. */
+      std::list<font_image*> order;
+      /** @brief Position of each cached font in the use order. */
+      std::unordered_map<uint64, std::list<font_image*>::iterator> index;
+      size_t hits;
+      size_t misses;
+      size_t evictions;
+      size_t bytes;
+      size_t capacity;
+      /** @brief Private seed of the confirming hash. */
+      uint64 seed;
+    };
+
+    /**
+     * @brief Running state of a content hash.
+     */
+    struct fontcache_hasher {
+      /** @brief Lane accumulators. */
+      uint64 v[4];
+      /** @brief Bytes of an incomplete stripe. */
+      unsigned char stripe[32];
+      /** @brief Number of bytes in the incomplete stripe. */
+      size_t buffered;
+      /** @brief Number of bytes hashed so far. */
+      uint64 total;
+      /** @brief Seed of the hash. */
+      uint64 seed;
+    };
+
+    /** @brief XXH64 prime 1. */
+    static constexpr uint64 fontcache_p1 = 11400714785074694791ull;
+    /** @brief XXH64 prime 2. */
+    static constexpr uint64 fontcache_p2 = 14029467366897019727ull;
+    /** @brief XXH64 prime 3. */
+    static constexpr uint64 fontcache_p3 = 1609587929392839161ull;
+    /** @brief XXH64 prime 4. */
+    static constexpr uint64 fontcache_p4 = 9650029242287828579ull;
+    /** @brief XXH64 prime 5. */
+    static constexpr uint64 fontcache_p5 = 2870177450012600261ull;
+    /** @brief Largest window to hash from a stream at once. */
+    static constexpr size_t fontcache_window = 65536u;
+
+    /**
+     * @brief Rotate a 64-bit value to the left.
+     * @param x the value
+     * @param r rotation in bits, from 1 to 63
+     * @return the rotated value
+     */
+    static
+    uint64 fontcache_rotl(uint64 x, unsigned int r) noexcept;
+    /**
+     * @brief Parse out a little-endian 64-bit integer.
+     * @param s from here
+     * @return the integer
+     */
+    static
+    uint64 fontcache_read_u64le(unsigned char const* s) noexcept;
+    /**
+     * @brief Parse out a little-endian 32-bit integer.
+     * @param s from here
+     * @return the integer
+     */
+    static
+    uint64 fontcache_read_u32le(unsigned char const* s) noexcept;
+    /**
+     * @brief Mix one word into a lane.
+     * @param acc lane value
+     * @param input word to mix in
+     * @return the new lane value
+     */
+    static
+    uint64 fontcache_round(uint64 acc, uint64 input) noexcept;
+    /**
+     * @brief Start a content hash.
+     * @param[out] h hash state to reset
+     * @param seed XXH64 seed
+     */
+    static
+    void fontcache_hash_start(fontcache_hasher& h, uint64 seed) noexcept;
+    /**
+     * @brief Add bytes to a content hash.
+     * @param h hash state
+     * @param s bytes to add
+     * @param n number of bytes
+     */
+    static
+    void fontcache_hash_add
+      (fontcache_hasher& h, unsigned char const* s, size_t n) noexcept;
+    /**
+     * @brief Finish a content hash.
+     * @param h hash state
+     * @return the hash
+     */
+    static
+    uint64 fontcache_hash_end(fontcache_hasher const& h) noexcept;
+    /**
+     * @brief Add the rest of a stream to several content hashes.
+     * @param seq stream to hash from the read position to the end
+     * @param h hash states
+     * @param count number of hash states
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     */
+    static
+    void fontcache_hash_seq(sequential& seq, fontcache_hasher* h,
+        size_t count, api_error& ae) noexcept;
+    /**
+     * @brief Pick a seed for the confirming hash of a new cache.
+     * @return a seed that other processes cannot predict
+     */
+    static
+    uint64 fontcache_seed(void) noexcept;
+    /**
+     * @brief Take a share of a font.
+     * @param p (nullable) the font
+     * @return the font
+     */
+    static
+    font_image* fontcache_acquire(font_image* p) noexcept;
+    /**
+     * @brief Drop a share of a font, freeing it with the last share.
+     * @param p (nullable) the font
+     */
+    static
+    void fontcache_release(font_image* p) noexcept;
+    /**
+     * @brief Look up a font and count the hit or miss.
+     * @param core cache state, locked by the caller
+     * @param key content hash of the source
+     * @param src (nullable) source identity the font must match
+     * @return (nullable) a new share of the font
+     */
+    static
+    font_image* fontcache_lookup(fontcache_core& core, uint64 key,
+        fontcache_source const* src) noexcept;
+    /**
+     * @brief Check whether a font came from a given source.
+     * @param p the font
+     * @param src source identity to match
+     * @return true if both lengths are known and both identities agree
+     */
+    static
+    bool fontcache_same_source
+      (font_image const& p, fontcache_source const& src) noexcept;
+    /**
+     * @brief Add a decoded font to the cache.
+     * @param core cache state
+     * @param p the font, with one share held by the caller
+     * @return the caller's share of the font to use, which is an earlier
+     *   font from the same source if another thread stored one first
+     * @note A cached font with the same key but another known source is
+     *   replaced, so a planted hash collision cannot shadow a file.
+     */
+    static
+    font_image* fontcache_store(fontcache_core& core, font_image* p) noexcept;
+    /**
+     * @brief Evict fonts until the cache fits under its cap.
+     * @param core cache state, locked by the caller
+     */
+    static
+    void fontcache_trim(fontcache_core& core) noexcept;
+    /**
+     * @brief Wrap a decoded image in a new font.
+     * @param key content hash of the source
+     * @param data decoded sfnt image; taken by the font
+     * @param len length of the image in bytes
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   other value on failure
+     * @return (nullable) the font, with one share for the caller
+     */
+    static
+    font_image* fontcache_image(uint64 key, std::vector<unsigned char>& data,
+        size_t len, api_error& ae) noexcept;
+
+    //BEGIN font cache / static
+    uint64 fontcache_rotl(uint64 x, unsigned int r) noexcept {
+      return (x<<r)|(x>>(64u-r));
+    }
+
+    uint64 fontcache_read_u64le(unsigned char const* s) noexcept {
+      return fontcache_read_u32le(s)|(fontcache_read_u32le(s+4)<<32);
+    }
+
+    uint64 fontcache_read_u32le(unsigned char const* s) noexcept {
+      return static_cast<uint64>(s[0])
+        |  (static_cast<uint64>(s[1])<<8)
+        |  (static_cast<uint64>(s[2])<<16)
+        |  (static_cast<uint64>(s[3])<<24);
+    }
+
+    uint64 fontcache_round(uint64 acc, uint64 input) noexcept {
+      acc += input*fontcache_p2;
+      return fontcache_rotl(acc, 31u)*fontcache_p1;
+    }
+
+    void fontcache_hash_start(fontcache_hasher& h, uint64 seed) noexcept {
+      h.v[0] = seed+fontcache_p1+fontcache_p2;
+      h.v[1] = seed+fontcache_p2;
+      h.v[2] = seed;
+      h.v[3] = seed-fontcache_p1;
+      h.buffered = 0u;
+      h.total = 0u;
+      h.seed = seed;
+      return;
+    }
+
+    void fontcache_hash_add
+      (fontcache_hasher& h, unsigned char const* s, size_t n) noexcept
+    {
+      h.total += n;
+      /* finish a stripe left over from the last call */
+      if (h.buffered) {
+        size_t const take = std::min<size_t>(32u-h.buffered, n);
+        std::memcpy(h.stripe+h.buffered, s, take);
+        h.buffered += take;
+        s += take;
+        n -= take;
+        if (h.buffered < 32u)
+          return;
+        for (unsigned int k = 0u; k < 4u; ++k)
+          h.v[k] = fontcache_round(h.v[k],
+            fontcache_read_u64le(h.stripe+8u*k));
+        h.buffered = 0u;
+      }
+      /* four independent lanes per stripe */
+      for (; n >= 32u; s += 32, n -= 32u) {
+        h.v[0] = fontcache_round(h.v[0], fontcache_read_u64le(s));
+        h.v[1] = fontcache_round(h.v[1], fontcache_read_u64le(s+8));
+        h.v[2] = fontcache_round(h.v[2], fontcache_read_u64le(s+16));
+        h.v[3] = fontcache_round(h.v[3], fontcache_read_u64le(s+24));
+      }
+      if (n) {
+        std::memcpy(h.stripe, s, n);
+        h.buffered = n;
+      }
+      return;
+    }
+
+    uint64 fontcache_hash_end(fontcache_hasher const& h) noexcept {
+      uint64 x;
+      if (h.total >= 32u) {
+        x = fontcache_rotl(h.v[0], 1u) + fontcache_rotl(h.v[1], 7u)
+          + fontcache_rotl(h.v[2], 12u) + fontcache_rotl(h.v[3], 18u);
+        for (unsigned int k = 0u; k < 4u; ++k) {
+          x ^= fontcache_round(0u, h.v[k]);
+          x = x*fontcache_p1+fontcache_p4;
+        }
+      } else x = h.seed+fontcache_p5;
+      x += h.total;
+      /* tail */{
+        unsigned char const* s = h.stripe;
+        size_t n = h.buffered;
+        for (; n >= 8u; s += 8, n -= 8u) {
+          x ^= fontcache_round(0u, fontcache_read_u64le(s));
+          x = fontcache_rotl(x, 27u)*fontcache_p1+fontcache_p4;
+        }
+        if (n >= 4u) {
+          x ^= fontcache_read_u32le(s)*fontcache_p1;
+          x = fontcache_rotl(x, 23u)*fontcache_p2+fontcache_p3;
+          s += 4;
+          n -= 4u;
+        }
+        for (; n > 0u; ++s, --n) {
+          x ^= (*s)*fontcache_p5;
+          x = fontcache_rotl(x, 11u)*fontcache_p1;
+        }
+      }
+      /* avalanche */
+      x ^= x>>33;
+      x *= fontcache_p2;
+      x ^= x>>29;
+      x *= fontcache_p3;
+      x ^= x>>32;
+      return x;
+    }
+
+    void fontcache_hash_seq(sequential& seq, fontcache_hasher* h,
+        size_t count, api_error& ae) noexcept
+    {
+      size_t const length = seq.get_length();
+      size_t pos = seq.get_pos();
+      while (pos < length) {
+        size_t const n = std::min(length-pos, fontcache_window);
+        unsigned char const* const s = seq.peek_span(n);
+        if (!s) {
+          ae = api_error::Memory;
+          return;
+        }
+        for (size_t k = 0u; k < count; ++k)
+          fontcache_hash_add(h[k], s, n);
+        pos = seq.set_pos(pos+n);
+      }
+      ae = api_error::Success;
+      return;
+    }
+
+    uint64 fontcache_seed(void) noexcept {
+      uint64 x = static_cast<uint64>(
+          std::chrono::steady_clock::now().time_since_epoch().count());
+      try {
+        std::random_device rd;
+        x ^= (static_cast<uint64>(rd())<<32) ^ rd();
+      } catch (std::exception const& ) {
+        /* keep the clock alone */
+      }
+      return x;
+    }
+
+    font_image* fontcache_acquire(font_image* p) noexcept {
+      if (p)
+        p->refs.fetch_add(1u, std::memory_order_relaxed);
+      return p;
+    }
+
+    void fontcache_release(font_image* p) noexcept {
+      if (p && p->refs.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        delete p;
+      return;
+    }
+
+    font_image* fontcache_lookup(fontcache_core& core, uint64 key,
+        fontcache_source const* src) noexcept
+    {
+      auto const it = core.index.find(key);
+      if (it == core.index.end()
+      ||  (src && !fontcache_same_source(**it->second, *src)))
+      {
+        core.misses += 1u;
+        return nullptr;
+      }
+      core.hits += 1u;
+      core.order.splice(core.order.begin(), core.order, it->second);
+      return fontcache_acquire(*it->second);
+    }
+
+    bool fontcache_same_source
+      (font_image const& p, fontcache_source const& src) noexcept
+    {
+      return p.source.size != 0u && p.source.size == src.size
+        &&  p.source.check == src.check;
+    }
+
+    font_image* fontcache_store(fontcache_core& core, font_image* p) noexcept {
+      std::lock_guard<std::mutex> guard(core.lock);
+      auto const it = core.index.find(p->key);
+      if (it != core.index.end()) {
+        font_image* const q = *it->second;
+        if (p->source.size == 0u || fontcache_same_source(*q, p->source)) {
+          /* another thread decoded the same font first */
+          fontcache_acquire(q);
+          core.order.splice(core.order.begin(), core.order, it->second);
+          fontcache_release(p);
+          return q;
+        }
+        /* same key, other source: the newer font takes the slot */
+        core.order.erase(it->second);
+        core.index.erase(it);
+        core.bytes -= q->cost;
+        core.evictions += 1u;
+        fontcache_release(q);
+      }
+      if (p->cost > core.capacity) {
+        return p;
+      }
+      try {
+        core.order.push_front(p);
+        try {
+          core.index.emplace(p->key, core.order.begin());
+        } catch (std::bad_alloc const& ) {
+          core.order.pop_front();
+          return p;
+        }
+      } catch (std::bad_alloc const& ) {
+        return p;
+      }
+      fontcache_acquire(p);
+      core.bytes += p->cost;
+      fontcache_trim(core);
+      return p;
+    }
+
+    void fontcache_trim(fontcache_core& core) noexcept {
+      while (core.bytes > core.capacity && !core.order.empty()) {
+        font_image* const p = core.order.back();
+        core.order.pop_back();
+        core.index.erase(p->key);
+        core.bytes -= p->cost;
+        core.evictions += 1u;
+        fontcache_release(p);
+      }
+      return;
+    }
+
+    font_image* fontcache_image(uint64 key, std::vector<unsigned char>& data,
+        size_t len, api_error& ae) noexcept
+    {
+      std::unique_ptr<font_image> p;
+      try {
+        p.reset(new font_image());
+        p->data.swap(data);
+        /* list the tables of the image */{
+          mmaptwo::mmaptwo_i* const m2i =
+            mmaptwo::memopen(p->data.data(), len, false);
+          if (!m2i) {
+            ae = api_error::Memory;
+            return nullptr;
+          }
+          util_unique_ptr<sfnt> const image = sfnt_unique(m2i, false);
+          if (!image) {
+            delete m2i;
+            ae = api_error::Sanitize;
+            return nullptr;
+          }
+          p->offsets = image->get_offsets();
+        }
+        p->refs.store(1u, std::memory_order_relaxed);
+        p->key = key;
+        p->source.size = 0u;
+        p->source.check = 0u;
+        p->size = len;
+        p->cost = sizeof(font_image) + len
+          + p->offsets.size()*sizeof(offset_line);
+      } catch (std::bad_alloc const& ) {
+        ae = api_error::Memory;
+        return nullptr;
+      }
+      ae = api_error::Success;
+      return p.release();
+    }
+    //END   font cache / static
+
+    //BEGIN font cache / hash
+    uint64 fontcache_hash(unsigned char const* s, size_t n) noexcept {
+      fontcache_hasher h;
+      fontcache_hash_start(h, 0u);
+      fontcache_hash_add(h, s, n);
+      return fontcache_hash_end(h);
+    }
+
+    uint64 fontcache_hash(sequential& seq, api_error& ae) noexcept {
+      fontcache_hasher h;
+      fontcache_hash_start(h, 0u);
+      fontcache_hash_seq(seq, &h, 1u, ae);
+      if (ae != api_error::Success)
+        return 0u;
+      return fontcache_hash_end(h);
+    }
+    //END   font cache / hash
+
+    //BEGIN font view / rule-of-six
+    font_view::font_view(void) noexcept
+      : image(nullptr)
+    {
+    }
+
+    font_view::font_view(font_image* p) noexcept
+      : image(p)
+    {
+    }
+
+    font_view::~font_view(void) {
+      fontcache_release(image);
+      return;
+    }
+
+    font_view::font_view(font_view const& other) noexcept
+      : image(fontcache_acquire(other.image))
+    {
+    }
+
+    font_view& font_view::operator=(font_view const& other) noexcept {
+      font_image* const n_image = fontcache_acquire(other.image);
+      fontcache_release(this->image);
+      this->image = n_image;
+      return *this;
+    }
+
+    font_view::font_view(font_view&& other) noexcept
+      : image(other.image)
+    {
+      other.image = nullptr;
+    }
+
+    font_view& font_view::operator=(font_view&& other) noexcept {
+      font_image* const n_image = other.image;
+      other.image = nullptr;
+      fontcache_release(this->image);
+      this->image = n_image;
+      return *this;
+    }
+    //END   font view / rule-of-six
+
+    //BEGIN font view / allocation
+    void* font_view::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* font_view::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void font_view::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void font_view::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+    //END   font view / allocation
+
+    //BEGIN font view / public
+    bool font_view::empty(void) const noexcept {
+      return this->image == nullptr;
+    }
+
+    unsigned char const* font_view::get_data(void) const noexcept {
+      return this->image ? this->image->data.data() : nullptr;
+    }
+
+    size_t font_view::size(void) const noexcept {
+      return this->image ? this->image->size : 0u;
+    }
+
+    offset_table const* font_view::get_offsets(void) const noexcept {
+      return this->image ? &this->image->offsets : nullptr;
+    }
+
+    uint64 font_view::get_key(void) const noexcept {
+      return this->image ? this->image->key : 0u;
+    }
+    //END   font view / public
+
+    //BEGIN font cache / rule-of-six
+    font_cache::font_cache(size_t capacity)
+      : core(new fontcache_core())
+    {
+      core->hits = 0u;
+      core->misses = 0u;
+      core->evictions = 0u;
+      core->bytes = 0u;
+      core->capacity = capacity;
+      core->seed = fontcache_seed();
+    }
+
+    font_cache::~font_cache(void) {
+      if (core) {
+        clear();
+        delete core;
+      }
+      return;
+    }
+
+    font_cache::font_cache(font_cache&& other) noexcept
+      : core(nullptr)
+    {
+      transfer(static_cast<font_cache&&>(other));
+      return;
+    }
+
+    font_cache& font_cache::operator=(font_cache&& other) noexcept {
+      transfer(static_cast<font_cache&&>(other));
+      return *this;
+    }
+
+    void font_cache::transfer(font_cache&& other) noexcept {
+      fontcache_core *n_core = other.core;
+      other.core = nullptr;
+      if (this->core) {
+        clear();
+        delete this->core;
+      }
+      this->core = n_core;
+      return;
+    }
+    //END   font cache / rule-of-six
+
+    //BEGIN font cache / allocation
+    void* font_cache::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* font_cache::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void font_cache::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void font_cache::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    font_cache* fontcache_new(size_t capacity) noexcept {
+      try {
+        return new font_cache(capacity);
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<font_cache> fontcache_unique(size_t capacity) noexcept {
+      return util_unique_ptr<font_cache>(fontcache_new(capacity));
+    }
+
+    void fontcache_destroy(font_cache* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   font cache / allocation
+
+    //BEGIN font cache / public
+    font_view font_cache::find(uint64 key) noexcept {
+      if (!this->core)
+        return font_view();
+      std::lock_guard<std::mutex> guard(this->core->lock);
+      return font_view(fontcache_lookup(*this->core, key, nullptr));
+    }
+
+    font_view font_cache::fetch
+        (mmaptwo::mmaptwo_i* xfh, task_pool* pool, api_error& ae) noexcept
+    {
+      if (!this->core || !xfh) {
+        ae = api_error::Init;
+        return font_view();
+      }
+      uint64 key;
+      fontcache_source source;
+      /* hash the source */{
+        util_unique_ptr<sequential> const seq = seq_unique(xfh);
+        if (!seq) {
+          ae = api_error::Memory;
+          return font_view();
+        }
+        /* the content hash, and a private one to confirm hits */
+        fontcache_hasher h[2];
+        fontcache_hash_start(h[0], 0u);
+        fontcache_hash_start(h[1], this->core->seed);
+        source.size = seq->get_length() - seq->get_pos();
+        fontcache_hash_seq(*seq, h, 2u, ae);
+        if (ae != api_error::Success)
+          return font_view();
+        key = fontcache_hash_end(h[0]);
+        source.check = fontcache_hash_end(h[1]);
+      }
+      /* look up */{
+        std::lock_guard<std::mutex> guard(this->core->lock);
+        font_image* const p = fontcache_lookup(*this->core, key, &source);
+        if (p) {
+          ae = api_error::Success;
+          return font_view(p);
+        }
+      }
+      std::vector<unsigned char> data;
+      size_t const len = woff2_decode_file(xfh, data, nullptr, pool, ae);
+      if (ae != api_error::Success)
+        return font_view();
+      font_image* const p = fontcache_image(key, data, len, ae);
+      if (!p)
+        return font_view();
+      p->source = source;
+      return font_view(fontcache_store(*this->core, p));
+    }
+
+    font_view font_cache::fetch(mmaptwo::mmaptwo_i* xfh, task_pool* pool) {
+      api_error ae;
+      font_view out = fetch(xfh, pool, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return out;
+    }
+
+    font_view font_cache::insert(uint64 key, woff2& src, task_pool* pool,
+        api_error& ae) noexcept
+    {
+      if (!this->core) {
+        ae = api_error::Init;
+        return font_view();
+      }
+      /* look up */{
+        std::lock_guard<std::mutex> guard(this->core->lock);
+        font_image* const p = fontcache_lookup(*this->core, key, nullptr);
+        if (p) {
+          ae = api_error::Success;
+          return font_view(p);
+        }
+      }
+      std::vector<unsigned char> data;
+      size_t const len = woff2_decode_grow(src, data, nullptr, pool, ae);
+      if (ae != api_error::Success)
+        return font_view();
+      font_image* const p = fontcache_image(key, data, len, ae);
+      if (!p)
+        return font_view();
+      return font_view(fontcache_store(*this->core, p));
+    }
+
+    fontcache_stats font_cache::get_stats(void) const noexcept {
+      fontcache_stats out = {};
+      if (!this->core)
+        return out;
+      std::lock_guard<std::mutex> guard(this->core->lock);
+      out.hits = this->core->hits;
+      out.misses = this->core->misses;
+      out.evictions = this->core->evictions;
+      out.entries = this->core->order.size();
+      out.bytes = this->core->bytes;
+      out.capacity = this->core->capacity;
+      return out;
+    }
+
+    void font_cache::set_capacity(size_t capacity) noexcept {
+      if (!this->core)
+        return;
+      std::lock_guard<std::mutex> guard(this->core->lock);
+      this->core->capacity = capacity;
+      fontcache_trim(*this->core);
+      return;
+    }
+
+    void font_cache::clear(void) noexcept {
+      if (!this->core)
+        return;
+      std::lock_guard<std::mutex> guard(this->core->lock);
+      for (font_image* const p : this->core->order)
+        fontcache_release(p);
+      this->core->order.clear();
+      this->core->index.clear();
+      this->core->bytes = 0u;
+      return;
+    }
+    //END   font cache / public
+  };
+};
@@ -72,6 +72,22 @@ namespace text_complex {
       return;
     }
 
+    hash_chain::hash_chain(hash_chain const& other)
+      : sr(other.sr), last_count(0u), counter(0u), chains(nullptr),
+        positions(nullptr), chain_length(0u)
+    {
+      duplicate(other);
+      return;
+    }
+
+    hash_chain& hash_chain::operator=(hash_chain const& other) {
+      if (this != &other) {
+        hash_chain tmp(other);
+        *this = static_cast<hash_chain&&>(tmp);
+      }
+      return *this;
+    }
+
     hash_chain::hash_chain(hash_chain&& other) noexcept
       : sr(std::move(other.sr)), last_count(0u),
         counter(0u), chains(nullptr),
@@ -82,12 +98,43 @@ namespace text_complex {
     }
 
     hash_chain& hash_chain::operator=(hash_chain&& other) noexcept {
-      sr = std::move(other.sr);
-      transfer(static_cast<hash_chain&&>(other));
+      if (this != &other) {
+        sr = std::move(other.sr);
+        transfer(static_cast<hash_chain&&>(other));
+      }
       return *this;
     }
 
+    void hash_chain::duplicate(hash_chain const& other) {
+      size_t const chain_total = other.chain_length*251u;
+      uint32* const new_chains = new uint32[chain_total];
+      size_t* new_positions;
+      try {
+        new_positions = new size_t[251u];
+      } catch (std::bad_alloc const& ) {
+        delete[] new_chains;
+        throw;
+      }
+      std::memcpy(new_chains, other.chains, sizeof(uint32)*chain_total);
+      std::memcpy(new_positions, other.positions, sizeof(size_t)*251u);
+      /* drop old */{
+        delete[] positions;
+        delete[] chains;
+      }
+      chains = new_chains;
+      positions = new_positions;
+      chain_length = other.chain_length;
+      last_count = other.last_count;
+      counter = other.counter;
+      std::memcpy(last_bytes, other.last_bytes, 3*sizeof(unsigned char));
+      return;
+    }
+
     void hash_chain::transfer(hash_chain&& other) noexcept {
+      /* drop old */{
+        delete[] positions;
+        delete[] chains;
+      }
       last_count = util_exchange(other.last_count, 0u);
       counter = util_exchange(other.counter, 0u);
       chains = util_exchange(other.chains, nullptr);
@@ -175,6 +222,13 @@ namespace text_complex {
     //BEGIN hash_chain / public
     uint32 hash_chain::find
         (unsigned char const* b, uint32 pos) const noexcept
+    {
+      size_t probes = 0u;
+      return find(b, pos, probes);
+    }
+
+    uint32 hash_chain::find
+        (unsigned char const* b, uint32 pos, size_t& probes) const noexcept
     {
       if (sr.size() < 3u)
         return npos;
@@ -191,19 +245,34 @@ namespace text_complex {
           uint32 const y = here-chain[--chain_i]-1u;
           if (y < pos)
             continue;
-          else if (y >= size)
+          else if (y >= size) {
+            probes += j;
             return npos;
-          else {
+          } else {
             unsigned char tmp[3];
             hashchain_fetch(sr, tmp, y);
             if (std::memcmp(tmp, b, 3u*sizeof(unsigned char)) == 0) {
+              probes += j+1u;
               return y+2u;
             }
           }
         }
+        probes += j;
         return npos;
       }
     }
+
+    void hash_chain::clear(void) noexcept {
+      sr.clear();
+      last_count = 0u;
+      counter = 0u;
+      std::memset(last_bytes, 0, sizeof(unsigned char)*3u);
+      if (chains)
+        std::memset(chains, 0, sizeof(uint32)*chain_length*251u);
+      if (positions)
+        std::memset(positions, 0, sizeof(size_t)*251u);
+      return;
+    }
     //END   hash_chain / public
   };
 };
@@ -8,28 +8,72 @@
 #include <new>
 #include <limits>
 #include <stdexcept>
+#include <algorithm>
 
 namespace text_complex {
   namespace access {
+    /**
+     * \brief Entry of the tag lookup index.
+     */
+    struct offset_key {
+      /** \brief Tag packed big-endian, so integer order is tag order. */
+      uint32 tag;
+      /** \brief Index of the line in the table. */
+      size_t i;
+    };
+
+    /**
+     * \brief Pack a tag into an integer.
+     * \param s four-byte tag
+     * \return the tag as a big-endian integer
+     */
+    static
+    uint32 offtable_pack(unsigned char const* s) noexcept;
+    /**
+     * \brief Order index entries by tag, then by line.
+     * \param v left entry
+     * \param w right entry
+     * \return whether `v` sorts before `w`
+     */
+    static
+    bool offtable_key_cmp(offset_key const& v, offset_key const& w) noexcept;
+
+    //BEGIN offset_table / static
+    uint32 offtable_pack(unsigned char const* s) noexcept {
+      return (static_cast<uint32>(s[0])<<24)
+        |  (static_cast<uint32>(s[1])<<16)
+        |  (static_cast<uint32>(s[2])<<8)
+        |  static_cast<uint32>(s[3]);
+    }
+
+    bool offtable_key_cmp(offset_key const& v, offset_key const& w) noexcept {
+      return v.tag < w.tag || (v.tag == w.tag && v.i < w.i);
+    }
+    //END   offset_table / static
+
     //BEGIN offset_table / rule-of-six
     offset_table::offset_table(size_t n)
-      : p(nullptr), n(0u)
+      : p(nullptr), n(0u), ix(nullptr)
     {
       resize(n);
       return;
     }
 
     offset_table::~offset_table(void) {
+      if (this->ix) {
+        delete[] this->ix;
+      }
       if (this->p) {
         delete[] this->p;
       }
+      this->ix = nullptr;
       this->p = nullptr;
       this->n = 0u;
       return;
     }
 
     offset_table::offset_table(offset_table const& other)
-      : p(nullptr), n(0u)
+      : p(nullptr), n(0u), ix(nullptr)
     {
       duplicate(other);
       return;
@@ -41,7 +85,7 @@ namespace text_complex {
     }
 
     offset_table::offset_table(offset_table&& other) noexcept
-      : p(nullptr), n(0u)
+      : p(nullptr), n(0u), ix(nullptr)
     {
       transfer(static_cast<offset_table&&>(other));
       return;
@@ -60,22 +104,34 @@ namespace text_complex {
       for (i = 0; i < n; ++i) {
         p[i] = other.p[i];
       }
+      if (other.ix) {
+        reindex();
+      }
       return;
     }
 
     void offset_table::transfer(offset_table&& other) noexcept {
       if (this == &other)
         return;
+      if (this->ix) {
+        delete[] this->ix;
+      }
       if (this->p) {
         delete[] this->p;
       }
       this->p = other.p;
       this->n = other.n;
+      this->ix = other.ix;
+      other.p = nullptr;
+      other.n = 0u;
+      other.ix = nullptr;
       return;
     }
 
     void offset_table::resize(size_t n) {
       struct offset_line *ptr;
+      /* the index no longer matches */
+      drop_index();
       if (n == 0u) {
         if (this->p) {
           delete[] this->p;
@@ -97,6 +153,14 @@ namespace text_complex {
       this->n = n;
       return;
     }
+
+    void offset_table::drop_index(void) noexcept {
+      if (this->ix) {
+        delete[] this->ix;
+        this->ix = nullptr;
+      }
+      return;
+    }
     //END   offset_table / rule-of-six
 
     //BEGIN offset_table / allocation
@@ -137,6 +201,7 @@ namespace text_complex {
 
     //BEGIN offset_table / range-based
     offset_line* offset_table::begin(void) noexcept {
+      drop_index();
       return this->p;
     }
 
@@ -145,6 +210,7 @@ namespace text_complex {
     }
 
     offset_line* offset_table::end(void) noexcept {
+      drop_index();
       return this->p+this->n;
     }
 
@@ -159,6 +225,7 @@ namespace text_complex {
     }
 
     offset_line& offset_table::operator[](size_t i) noexcept {
+      drop_index();
       return this->p[i];
     }
 
@@ -169,6 +236,7 @@ namespace text_complex {
     offset_line& offset_table::at(size_t i) {
       if (i >= this->n)
         throw std::out_of_range("text_complex::access::offset_table::at");
+      drop_index();
       return this->p[i];
     }
 
@@ -177,6 +245,38 @@ namespace text_complex {
         throw std::out_of_range("text_complex::access::offset_table::at");
       return this->p[i];
     }
+
+    void offset_table::reindex(void) {
+      drop_index();
+      if (this->n == 0u)
+        return;
+      offset_key* const keys = new offset_key[this->n];
+      for (size_t i = 0u; i < this->n; ++i) {
+        keys[i].tag = offtable_pack(this->p[i].tag);
+        keys[i].i = i;
+      }
+      std::sort(keys, keys+this->n, offtable_key_cmp);
+      this->ix = keys;
+      return;
+    }
+
+    size_t offset_table::find(unsigned char const* tag) const noexcept {
+      return find(offtable_pack(tag));
+    }
+
+    size_t offset_table::find(uint32 tag) const noexcept {
+      if (!this->ix) {
+        for (size_t i = 0u; i < this->n; ++i) {
+          if (offtable_pack(this->p[i].tag) == tag)
+            return i;
+        }
+        return this->n;
+      }
+      offset_key const key = { tag, 0u };
+      offset_key const* const pos =
+        std::lower_bound(this->ix, this->ix+this->n, key, offtable_key_cmp);
+      return (pos != this->ix+this->n && pos->tag == tag) ? pos->i : this->n;
+    }
     //END   offset_table / public
   };
 };
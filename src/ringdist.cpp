@@ -278,8 +278,9 @@ namespace text_complex {
         /* check proximity to last cache item */{
           uint32 const last = ringdist_retrieve(this->ring, this->i, 1u);
           uint32 const last_min = ((last > 3u) ? last-3u : 1u);
-          uint32 const last_max =
-            ((last < 0xFFffFFfd) ? last+3u : 0xFFffFFff);
+          /* unknown (zero) entries match nothing */
+          uint32 const last_max = (last == 0u) ? 0u
+            : ((last < 0xFFffFFfd) ? last+3u : 0xFFffFFff);
           if (back_dist >= last_min && back_dist < last) {
             extra = 0u;
             ringdist_record(this->ring, this->i, back_dist, norecord);
@@ -301,8 +302,9 @@ namespace text_complex {
         /* check proximity to second cache item */{
           uint32 const second = ringdist_retrieve(this->ring, this->i, 2u);
           uint32 const second_min = ((second > 3u) ? second-3u : 1u);
-          uint32 const second_max =
-            ((second < 0xFFffFFfd) ? second+3u : 0xFFffFFff);
+          /* unknown (zero) entries match nothing */
+          uint32 const second_max = (second == 0u) ? 0u
+            : ((second < 0xFFffFFfd) ? second+3u : 0xFFffFFff);
           if (back_dist >= second_min && back_dist < second) {
             extra = 0u;
             ringdist_record(this->ring, this->i, back_dist, norecord);
@@ -364,12 +366,19 @@ namespace text_complex {
       special_size = special_addend;
       sum_direct = direct+special_addend;
       direct_one = direct+1u;
-      postfix = postfix;
+      this->postfix = postfix;
       bit_adjust = postfix+1u;
       postmask = (1u<<postfix)-1u;
       ae = api_error::Success;
       return;
     }
+
+    void distance_ring::forget(void) noexcept {
+      unsigned int j;
+      for (j = 0u; j < 4u; ++j)
+        ring[j] = 0u;
+      return;
+    }
     //END   distance_ring / public
   };
 };
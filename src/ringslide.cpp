@@ -196,6 +196,12 @@ namespace text_complex {
     uint32 slide_ring::extent(void) const noexcept {
       return n;
     }
+
+    void slide_ring::clear(void) noexcept {
+      pos = 0u;
+      sz = 0u;
+      return;
+    }
     //END   slide_ring / public
   };
 };
@@ -0,0 +1,382 @@
+/**
+ * @file tcmplx-access-plus/segpar_p.hpp
+ * @brief Segmented parallel compression pipeline
+ */
+#ifndef hg_TextComplexAccessP_SegPar_pH_
+#define hg_TextComplexAccessP_SegPar_pH_
+
+#include "text-complex-plus/access/api.hpp"
+#include "text-complex-plus/access/taskpool.hpp"
+#include <new>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Size of the per-task output staging buffer.
+     */
+    static constexpr std::size_t segpar_StageSize = 4096u;
+
+    template <typename codec>
+    struct segpar_core;
+
+    /**
+     * @brief One segment of compression work.
+     * @tparam codec compression policy; see @link segpar_core @endlink
+     */
+    template <typename codec>
+    struct segpar_job {
+      /** @brief Window priming bytes followed by the segment text. */
+      std::vector<unsigned char> text;
+      /** @brief Compressed output. */
+      std::vector<unsigned char> out;
+      /** @brief Shared state, for completion signalling. */
+      segpar_core<codec>* core;
+      /** @brief Number of priming bytes at the start of `text`. */
+      std::size_t prime;
+      /** @brief Number of segment bytes after the priming bytes. */
+      std::size_t length;
+      /** @brief Checksum of the segment bytes. */
+      typename codec::check check;
+      /** @brief Result of compression. */
+      api_error ae;
+      /** @brief Whether this segment begins the stream. */
+      bool first;
+      /** @brief Whether this segment ends the stream. */
+      bool last;
+      /** @brief Completion flag, guarded by the core lock. */
+      bool done;
+    };
+
+    /**
+     * @brief Shared state of a segmented compressor.
+     * @tparam codec compression policy, providing:
+     *   - `state`, the single-threaded compression state;
+     *   - `check`, the running checksum type, and `check_start()`;
+     *   - `cvt_continue`, `cvt_out`, `cvt_flush` and `cvt_unshift`,
+     *     forwarding to the state's free functions;
+     *   - `record(check&, state const&)`, to save a segment's checksum;
+     *   - `combine(check&, job&)`, to fold a finished segment into the
+     *     stream checksum before its output is copied.
+     */
+    template <typename codec>
+    struct segpar_core {
+      uint32 block_size;
+      uint32 n;
+      std::size_t chain_length;
+      uint32 segment_size;
+      /** @brief Maximum number of segments in flight. */
+      std::size_t max_jobs;
+      std::mutex lock;
+      std::condition_variable done_cv;
+      /** @brief Segments in stream order. */
+      std::deque<std::unique_ptr<segpar_job<codec>>> jobs;
+      /** @brief Input not yet dispatched. */
+      std::vector<unsigned char> pending;
+      /** @brief Most recent input, for priming the next segment. */
+      std::vector<unsigned char> tail;
+      /** @brief Read position in the oldest job's output. */
+      std::size_t out_pos;
+      /** @brief Checksum of all segments drained so far. */
+      typename codec::check check;
+      /** @brief Whether the first segment has been dispatched. */
+      bool started;
+      /** @brief Whether the last segment has been dispatched. */
+      bool closed;
+      /** @brief Worker threads; declared last so it drains first. */
+      task_pool pool;
+
+      segpar_core(uint32 block_size, uint32 n, std::size_t chain_length,
+          uint32 segment_size, unsigned int threads)
+        : block_size(block_size), n(n), chain_length(chain_length),
+          segment_size(segment_size), max_jobs(0u), out_pos(0u),
+          check(codec::check_start()), started(false), closed(false),
+          pool(threads)
+      {
+        max_jobs = std::max<std::size_t>(2u, pool.size()*2u);
+        return;
+      }
+    };
+
+    /**
+     * @brief Compress one segment.
+     * @param job segment to compress
+     * @return Success on success, negative code otherwise
+     */
+    template <typename codec>
+    api_error segpar_compress(segpar_job<codec>& job) noexcept {
+      segpar_core<codec> const& core = *job.core;
+      unsigned char stage[segpar_StageSize];
+      api_error ae = api_error::Success;
+      try {
+        typename codec::state cvt(core.block_size, core.n, core.chain_length);
+        unsigned char const* p = job.text.data() + job.prime;
+        unsigned char const* const p_end = job.text.data() + job.text.size();
+        if (!job.first) {
+          codec::cvt_continue(cvt, job.text.data(), job.prime, ae);
+          if (ae != api_error::Success)
+            return ae;
+        }
+        /* compress */for (;;) {
+          unsigned char* to_next = stage;
+          ae = codec::cvt_out(cvt, p, p_end, p,
+            stage, stage+segpar_StageSize, to_next);
+          job.out.insert(job.out.end(), stage, to_next);
+          if (ae < api_error::Success)
+            return ae;
+          else if (ae == api_error::EndOfFile)
+            return api_error::Sanitize;
+          else if (ae == api_error::Partial && p >= p_end)
+            break;
+        }
+        if (job.last) {
+          /* close the stream */do {
+            unsigned char* to_next = stage;
+            ae = codec::cvt_unshift(cvt, stage, stage+segpar_StageSize,
+              to_next);
+            job.out.insert(job.out.end(), stage, to_next);
+          } while (ae == api_error::Success);
+          codec::record(job.check, cvt);
+          return (ae == api_error::EndOfFile) ? api_error::Success : ae;
+        } else {
+          /* end on a byte boundary for the next segment */
+          unsigned char* to_next = stage;
+          unsigned char const* q = p_end;
+          ae = codec::cvt_flush(cvt, stage, stage+segpar_StageSize, to_next);
+          job.out.insert(job.out.end(), stage, to_next);
+          while (ae == api_error::Success) {
+            to_next = stage;
+            ae = codec::cvt_out(cvt, p_end, p_end, q,
+              stage, stage+segpar_StageSize, to_next);
+            job.out.insert(job.out.end(), stage, to_next);
+          }
+          codec::record(job.check, cvt);
+          return (ae == api_error::Partial) ? api_error::Success : ae;
+        }
+      } catch (api_exception const& e) {
+        return e.to_error();
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+    }
+
+    /**
+     * @brief Worker entry point.
+     * @param arg the @link segpar_job @endlink to compress
+     */
+    template <typename codec>
+    void segpar_run(void* arg) noexcept {
+      segpar_job<codec>& job = *static_cast<segpar_job<codec>*>(arg);
+      api_error const ae = segpar_compress(job);
+      /* release the input early */{
+        std::vector<unsigned char>().swap(job.text);
+      }
+      /* signal */{
+        std::lock_guard<std::mutex> guard(job.core->lock);
+        job.ae = ae;
+        job.done = true;
+      }
+      job.core->done_cv.notify_all();
+      return;
+    }
+
+    /**
+     * @brief Hand the pending input to a worker.
+     * @param core shared state
+     * @param last whether the segment ends the stream
+     * @return Success on success, negative code otherwise
+     */
+    template <typename codec>
+    api_error segpar_dispatch(segpar_core<codec>& core, bool last) noexcept {
+      try {
+        std::unique_ptr<segpar_job<codec>> job(new segpar_job<codec>());
+        job->core = &core;
+        job->prime = core.tail.size();
+        job->length = core.pending.size();
+        job->check = codec::check_start();
+        job->ae = api_error::Success;
+        job->first = !core.started;
+        job->last = last;
+        job->done = false;
+        job->text.reserve(core.tail.size() + core.pending.size());
+        job->text.insert(job->text.end(), core.tail.begin(), core.tail.end());
+        job->text.insert(job->text.end(),
+          core.pending.begin(), core.pending.end());
+        /* keep the window for the next segment */{
+          std::size_t const keep =
+            std::min<std::size_t>(core.n, job->text.size());
+          core.tail.assign(job->text.end()-keep, job->text.end());
+        }
+        core.jobs.push_back(std::move(job));
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      api_error ae = api_error::Success;
+      core.pool.post(segpar_run<codec>, core.jobs.back().get(), ae);
+      if (ae != api_error::Success) {
+        core.jobs.pop_back();
+        return ae;
+      }
+      core.pending.clear();
+      core.started = true;
+      if (last)
+        core.closed = true;
+      return api_error::Success;
+    }
+
+    /**
+     * @brief Wait for the oldest segment to finish.
+     * @param core shared state
+     */
+    template <typename codec>
+    void segpar_wait_front(segpar_core<codec>& core) noexcept {
+      segpar_job<codec> const& job = *core.jobs.front();
+      std::unique_lock<std::mutex> guard(core.lock);
+      while (!job.done)
+        core.done_cv.wait(guard);
+      return;
+    }
+
+    /**
+     * @brief Copy finished output in stream order.
+     * @param core shared state
+     * @param[in,out] to_next write position of output buffer
+     * @param to_end end of output buffer
+     * @param block whether to wait for unfinished segments
+     * @return Success on success, negative code from a failed segment
+     */
+    template <typename codec>
+    api_error segpar_drain(segpar_core<codec>& core,
+        unsigned char*& to_next, unsigned char* to_end, bool block) noexcept
+    {
+      while (!core.jobs.empty() && to_next < to_end) {
+        segpar_job<codec>& job = *core.jobs.front();
+        /* check completion */{
+          std::unique_lock<std::mutex> guard(core.lock);
+          if (!job.done) {
+            if (!block)
+              break;
+            while (!job.done)
+              core.done_cv.wait(guard);
+          }
+        }
+        if (job.ae != api_error::Success)
+          return job.ae;
+        else if (core.out_pos == 0u) {
+          api_error const ae = codec::combine(core.check, job);
+          if (ae != api_error::Success)
+            return ae;
+        }
+        std::size_t const count = std::min<std::size_t>(
+            job.out.size() - core.out_pos, to_end - to_next);
+        std::copy(job.out.begin() + core.out_pos,
+          job.out.begin() + core.out_pos + count, to_next);
+        to_next += count;
+        core.out_pos += count;
+        if (core.out_pos >= job.out.size()) {
+          core.jobs.pop_front();
+          core.out_pos = 0u;
+        }
+      }
+      return api_error::Success;
+    }
+
+    /**
+     * @brief Accept input and write finished output.
+     * @param core shared state, or `nullptr`
+     * @see @link zpar_out @endlink
+     */
+    template <typename codec>
+    api_error segpar_out(segpar_core<codec>* core,
+        unsigned char const* from, unsigned char const* from_end,
+        unsigned char const*& from_next,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next) noexcept
+    {
+      api_error ae = api_error::Success;
+      unsigned char const* p = from;
+      unsigned char* to_out = to;
+      if (!core) {
+        ae = api_error::Init;
+      } else if (core->closed) {
+        ae = (from == from_end) ? api_error::Partial : api_error::Sanitize;
+      } else for (;;) {
+        ae = segpar_drain(*core, to_out, to_end, false);
+        if (ae != api_error::Success)
+          break;
+        else if (to_out >= to_end)
+          /* output full */break;
+        if (core->pending.size() >= core->segment_size) {
+          if (core->jobs.size() >= core->max_jobs) {
+            segpar_wait_front(*core);
+            continue;
+          }
+          ae = segpar_dispatch(*core, false);
+          if (ae != api_error::Success)
+            break;
+        }
+        if (p >= from_end) {
+          ae = api_error::Partial;
+          break;
+        }
+        /* accept input */try {
+          std::size_t const count = std::min<std::size_t>(
+              core->segment_size - core->pending.size(), from_end - p);
+          core->pending.insert(core->pending.end(), p, p+count);
+          p += count;
+        } catch (std::bad_alloc const& ) {
+          ae = api_error::Memory;
+          break;
+        }
+      }
+      from_next = p;
+      to_next = to_out;
+      return ae;
+    }
+
+    /**
+     * @brief Close the stream and write the remaining output.
+     * @param core shared state, or `nullptr`
+     * @see @link zpar_unshift @endlink
+     */
+    template <typename codec>
+    api_error segpar_unshift(segpar_core<codec>* core,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next) noexcept
+    {
+      api_error ae = api_error::Success;
+      unsigned char* to_out = to;
+      if (!core) {
+        ae = api_error::Init;
+      } else for (;;) {
+        ae = segpar_drain(*core, to_out, to_end, core->closed);
+        if (ae != api_error::Success)
+          break;
+        else if (core->closed && core->jobs.empty()) {
+          ae = api_error::EndOfFile;
+          break;
+        } else if (to_out >= to_end)
+          /* output full */break;
+        if (core->closed)
+          continue;
+        if (core->jobs.size() >= core->max_jobs) {
+          segpar_wait_front(*core);
+          continue;
+        }
+        ae = segpar_dispatch(*core,
+          core->pending.size() < core->segment_size);
+        if (ae != api_error::Success)
+          break;
+      }
+      to_next = to_out;
+      return ae;
+    }
+  };
+};
+
+#endif //hg_TextComplexAccessP_SegPar_pH_
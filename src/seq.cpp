@@ -9,12 +9,68 @@
 #include <new>
 #include <stdexcept>
 #include <limits>
+#include <cstring>
 
 namespace text_complex {
   namespace access {
+    /**
+     * @brief Default maximum window size for a sequential.
+     */
+    static constexpr size_t seq_window_default = 67108864u;
+
+    /**
+     * @brief Choose an error code for a short read.
+     * @param fh mapping interface of the sequential
+     * @param pos read position
+     * @param n number of bytes wanted
+     * @return api_error::Sanitize if the stream is too short,
+     *   api_error::Memory otherwise
+     */
+    static api_error seq_short_error
+      (mmaptwo::mmaptwo_i const* fh, size_t pos, size_t n) noexcept;
+
+    /**
+     * @brief Give access hints for a freshly mapped window.
+     * @param fh mapping interface of the sequential
+     * @param page the new window
+     * @param next offset of the first byte past the window
+     * @param ahead number of bytes to read ahead past the window
+     * @note Hints are best-effort; failures are ignored.
+     */
+    static void seq_prefetch
+      ( mmaptwo::mmaptwo_i* fh, mmaptwo::page_i* page,
+        size_t next, size_t ahead) noexcept;
+
+    //BEGIN sequential / static
+    api_error seq_short_error
+      (mmaptwo::mmaptwo_i const* fh, size_t pos, size_t n) noexcept
+    {
+      size_t const len = (fh ? fh->length() : 0u);
+      if (pos > len || n > len-pos)
+        return api_error::Sanitize;
+      else return api_error::Memory;
+    }
+
+    void seq_prefetch
+      ( mmaptwo::mmaptwo_i* fh, mmaptwo::page_i* page,
+        size_t next, size_t ahead) noexcept
+    {
+      size_t const len = fh->length();
+      (void)page->advise(mmaptwo::advice_sequential);
+      if (next < len) {
+        /* start reading the next window before it is mapped */
+        size_t const left = len-next;
+        (void)fh->advise(mmaptwo::advice_willneed,
+          (ahead < left ? ahead : left), next);
+      }
+      return;
+    }
+    //END   sequential / static
+
     //BEGIN sequential / rule-of-six
     sequential::sequential(mmaptwo::mmaptwo_i* xfh)
-      : fh(xfh), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr)
+      : fh(xfh), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr),
+        wmode(seq_window::Adaptive), wsize(0u), wcur(0u)
     {
       reset_sync(0u);
       return;
@@ -29,7 +85,8 @@ namespace text_complex {
     }
 
     sequential::sequential(sequential const& other)
-      : fh(nullptr), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr)
+      : fh(nullptr), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr),
+        wmode(seq_window::Adaptive), wsize(0u), wcur(0u)
     {
       duplicate(other);
       return;
@@ -41,7 +98,8 @@ namespace text_complex {
     }
 
     sequential::sequential(sequential&& other) noexcept
-      : fh(nullptr), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr)
+      : fh(nullptr), hpage(nullptr), pos(0u), off(0u), last(0u), hptr(nullptr),
+        wmode(seq_window::Adaptive), wsize(0u), wcur(0u)
     {
       transfer(static_cast<sequential&&>(other));
       return;
@@ -56,6 +114,9 @@ namespace text_complex {
       if (this == &other)
         return;
       fh = other.fh;
+      wmode = other.wmode;
+      wsize = other.wsize;
+      wcur = 0u;
       reset_sync(other.pos);
       return;
     }
@@ -63,12 +124,17 @@ namespace text_complex {
     void sequential::transfer(sequential&& other) noexcept {
       if (this == &other)
         return;
+      if (hpage)
+        delete hpage;
       fh = other.fh; other.fh = nullptr;
       hpage = other.hpage; other.hpage = 0u;
       pos = other.pos; other.pos = 0u;
       off = other.off; other.off = 0u;
       last = other.last; other.last = 0u;
       hptr = other.hptr; other.hptr = nullptr;
+      wmode = other.wmode;
+      wsize = other.wsize;
+      wcur = other.wcur; other.wcur = 0u;
       return;
     }
     //END   sequential / rule-of-six
@@ -114,6 +180,10 @@ namespace text_complex {
       return pos;
     }
 
+    size_t sequential::get_length(void) const noexcept {
+      return fh ? fh->length() : 0u;
+    }
+
     size_t sequential::set_pos(size_t i) noexcept {
       if (i >= off && i < last) {
         pos = i;
@@ -141,6 +211,141 @@ namespace text_complex {
       } else /* end of stream, so */return -1;
     }
 
+    size_t sequential::read(void* buf, size_t n) noexcept {
+      unsigned char* const dst = static_cast<unsigned char*>(buf);
+      size_t done = 0u;
+      while (done < n) {
+        if (pos >= last && !reset_sync(pos))
+          /* acquisition error */break;
+        if (pos >= last)
+          /* end of stream */break;
+        size_t const count = (last-pos < n-done) ? last-pos : n-done;
+        std::memcpy(dst+done, hptr+(pos-off), count);
+        pos += count;
+        done += count;
+      }
+      return done;
+    }
+
+    unsigned char const* sequential::peek_span(size_t n) noexcept {
+      if (pos <= last && n <= last-pos)
+        return hptr ? hptr+(pos-off) : nullptr;
+      else if (!fh)
+        return nullptr;
+      /* remap to hold the whole span */{
+        size_t const len = fh->length();
+        if (pos > len || n > len-pos)
+          return nullptr;
+        else if (!reset_sync(pos, n))
+          return nullptr;
+      }
+      return (n <= last-pos && hptr) ? hptr+(pos-off) : nullptr;
+    }
+
+    unsigned short sequential::read_u16be(api_error& ae) noexcept {
+      unsigned char const* const s = peek_span(2u);
+      if (!s) {
+        ae = seq_short_error(fh, pos, 2u);
+        return 0u;
+      }
+      pos += 2u;
+      ae = api_error::Success;
+      return static_cast<unsigned short>((s[0]<<8)|s[1]);
+    }
+
+    uint32 sequential::read_u32be(api_error& ae) noexcept {
+      unsigned char const* const s = peek_span(4u);
+      if (!s) {
+        ae = seq_short_error(fh, pos, 4u);
+        return 0u;
+      }
+      pos += 4u;
+      ae = api_error::Success;
+      return (static_cast<uint32>(s[0])<<24)
+        |  (static_cast<uint32>(s[1])<<16)
+        |  (static_cast<uint32>(s[2])<<8)
+        |  static_cast<uint32>(s[3]);
+    }
+
+    uint32 sequential::read_uv128(api_error& ae) noexcept {
+      size_t const start = pos;
+      uint32 out = 0u;
+      int i;
+      ae = api_error::Sanitize;
+      for (i = 0; i < 5; ++i) {
+        int const ch = get_byte();
+        if (ch < 0) {
+          if (ch != -1)
+            ae = api_error::Memory;
+          break;
+        } else if (out == 0u && ch == 0x80) {
+          /* no leading zeroes */break;
+        } else if (i == 4 && ((ch&0x80) || (out > 0x1ffFFff))) {
+          /* overflow */break;
+        } else {
+          out = ((out<<7)|static_cast<uint32>(ch&0x7f));
+          if (!(ch&0x80)) {
+            ae = api_error::Success;
+            return out;
+          }
+        }
+      }
+      set_pos(start);
+      return 0u;
+    }
+
+    unsigned short sequential::read_u255(api_error& ae) noexcept {
+      size_t const start = pos;
+      int const code = get_byte();
+      unsigned short out = 0u;
+      switch (code) {
+      case 253: /* wordCode */
+        out = read_u16be(ae);
+        break;
+      case 254: /* oneMoreByteCode2 */
+      case 255: /* oneMoreByteCode1 */
+        {
+          int const ch = get_byte();
+          if (ch < 0) {
+            ae = (ch == -1) ? api_error::Sanitize : api_error::Memory;
+          } else {
+            out = static_cast<unsigned short>(ch + (code == 254 ? 506 : 253));
+            ae = api_error::Success;
+          }
+        } break;
+      case -1:
+        ae = api_error::Sanitize;
+        break;
+      default:
+        if (code < 0)
+          ae = api_error::Memory;
+        else {
+          out = static_cast<unsigned short>(code);
+          ae = api_error::Success;
+        }
+        break;
+      }
+      if (ae != api_error::Success) {
+        set_pos(start);
+        return 0u;
+      } else return out;
+    }
+
+    void sequential::set_window(seq_window mode, size_t size) noexcept {
+      wmode = mode;
+      wsize = size;
+      wcur = 0u;
+      return;
+    }
+
+    seq_window sequential::get_window(void) const noexcept {
+      return wmode;
+    }
+
+    size_t sequential::get_window_size(void) const noexcept {
+      return wsize;
+    }
+
     long int sequential::seek(long int i, seq_whence whence) noexcept {
       long int l_out;
       switch (whence) {
@@ -231,7 +436,7 @@ namespace text_complex {
     //END   sequential / public
 
     //BEGIN sequential / private
-    bool sequential::reset_sync(size_t p) {
+    bool sequential::reset_sync(size_t p, size_t need) {
       bool res = false;
       mmaptwo::page_i* n_hpage = nullptr;
       size_t n_pos = p;
@@ -254,14 +459,19 @@ namespace text_complex {
             size_t const presize = mmaptwo::get_page_size();
             size_t const pagesize = (presize < 256u ? 256u : presize);
             size_t const pagediff = n_pos%pagesize;
-            pagestart = n_pos - pagediff;
+            size_t window = window_for(n_pos, len, pagesize);
+            if (need > window-pagediff)
+              window = pagediff+need;
+            /* map from the start when the window covers the file */
+            pagestart = (window >= len) ? 0u : n_pos - pagediff;
             pagelen =
-              ((len-pagestart<pagesize*2u) ? len-pagestart : pagesize*2u);
+              ((len-pagestart<window) ? len-pagestart : window);
             n_hpage = fh->acquire(pagelen, pagestart);
             if (n_hpage) {
               n_off = pagestart;
               n_last = pagelen+pagestart;
               res = true;
+              seq_prefetch(fh, n_hpage, n_last, pagelen);
             }
           }
         } else {
@@ -285,6 +495,31 @@ namespace text_complex {
       }
       return res;
     }
+
+    size_t sequential::window_for
+        (size_t p, size_t len, size_t pagesize) noexcept
+    {
+      size_t const least = pagesize*2u;
+      size_t const most = (wsize ? wsize : seq_window_default);
+      switch (wmode) {
+      case seq_window::Fixed:
+        return (most > least ? most : least);
+      case seq_window::Adaptive:
+        /* grow only on reads that run off the end of the window */
+        if (wcur == 0u || p != last || hpage == nullptr)
+          wcur = least;
+        else if (wcur < most)
+          wcur = (wcur > most/2u ? most : wcur*2u);
+        return (wcur > least ? wcur : least);
+      case seq_window::Whole:
+        if (wsize == 0u || len <= wsize)
+          return (len > least ? len : least);
+        else return (wsize > least ? wsize : least);
+      case seq_window::Page:
+      default:
+        return least;
+      }
+    }
     //END   sequential / private
   };
 };
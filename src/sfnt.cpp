@@ -0,0 +1,463 @@
+/**
+ * @file tcmplx-access-plus/sfnt.cpp
+ * @brief TrueType and OpenType file utility API
+ * @author Cody Licorish (svgmovement@gmail.com)
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#include "text-complex-plus/access/sfnt.hpp"
+#include "text-complex-plus/access/offtable.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief One font of a plain sfnt file.
+     */
+    struct sfnt_font {
+      /** @brief Start of the table directory in the file. */
+      uint32 directory_offset;
+      /** @brief sfnt version of the font. */
+      uint32 flavor;
+      /** @brief Offset table indices of the font's tables. */
+      std::vector<unsigned short> tables;
+    };
+
+    /**
+     * @brief Mapping and font details for a plain sfnt file.
+     */
+    struct sfnt_core {
+      /** @brief Mapping of the whole file. */
+      std::unique_ptr<mmaptwo::page_i> page;
+      /** @brief First byte of the mapping. */
+      unsigned char const* base;
+      /** @brief sfnt version, or `ttcf` for collections. */
+      uint32 flavor;
+      /** @brief Collection header version, zero for single fonts. */
+      uint32 collection_version;
+      /** @brief Fonts in the file, one for a non-collection. */
+      std::vector<sfnt_font> fonts;
+    };
+
+    /** @brief Collection header tag. */
+    static uint32 const sfnt_ttcf = 0x74746366u;
+
+    /**
+     * @brief Parse out a 16-bit unsigned integer.
+     * @param s from here
+     * @return the integer
+     */
+    static
+    unsigned short sfnt_read_u16be(void const* s);
+    /**
+     * @brief Parse out a 32-bit unsigned integer.
+     * @param s from here
+     * @return the integer
+     */
+    static
+    uint32 sfnt_read_u32be(void const* s);
+    /**
+     * @brief Check for a known sfnt version.
+     * @param flavor the version to check
+     * @return whether the version names TrueType or OpenType outlines
+     */
+    static
+    bool sfnt_flavor_ok(uint32 flavor) noexcept;
+    /**
+     * @brief Read one table directory.
+     * @param base start of the file
+     * @param size length of the file in bytes
+     * @param[in,out] font font with its directory offset set
+     * @param[in,out] lines tables found so far, shared between fonts
+     * @param sane_tf whether to check the directory order
+     * @throw api_exception on a bad directory
+     */
+    static
+    void sfnt_read_directory(unsigned char const* base, size_t size,
+        sfnt_font& font, std::vector<offset_line>& lines, bool sane_tf);
+
+    //BEGIN sfnt static
+    unsigned short sfnt_read_u16be(void const* s) {
+      unsigned char const* c = static_cast<unsigned char const*>(s);
+      return (static_cast<unsigned short>(c[0])<<8)|c[1];
+    }
+
+    uint32 sfnt_read_u32be(void const* s) {
+      unsigned char const* c = static_cast<unsigned char const*>(s);
+      return (static_cast<uint32>(c[0])<<24)
+        |  (static_cast<uint32>(c[1])<<16)
+        |  (static_cast<uint32>(c[2])<<8)
+        |  static_cast<uint32>(c[3]);
+    }
+
+    bool sfnt_flavor_ok(uint32 flavor) noexcept {
+      return flavor == 0x00010000u /* TrueType */
+        ||  flavor == 0x4F54544Fu /* OTTO */
+        ||  flavor == 0x74727565u /* true */
+        ||  flavor == 0x74797031u /* typ1 */;
+    }
+
+    void sfnt_read_directory(unsigned char const* base, size_t size,
+        sfnt_font& font, std::vector<offset_line>& lines, bool sane_tf)
+    {
+      size_t const pos = font.directory_offset;
+      if (pos > size || size-pos < 12u)
+        throw api_exception(api_error::Sanitize);
+      unsigned char const* const header = base+pos;
+      size_t const table_count = sfnt_read_u16be(header+4);
+      if ((size-pos-12u)/16u < table_count)
+        throw api_exception(api_error::Sanitize);
+      font.flavor = sfnt_read_u32be(header);
+      if (sane_tf && !sfnt_flavor_ok(font.flavor))
+        throw api_exception(api_error::Sanitize);
+      /* tables shared with earlier fonts keep their first index */
+      size_t const shared_count = lines.size();
+      font.tables.resize(table_count);
+      for (size_t j = 0u; j < table_count; ++j) {
+        unsigned char const* const record = header+12u+16u*j;
+        offset_line line;
+        std::memcpy(line.tag, record, 4);
+        line.checksum = sfnt_read_u32be(record+4);
+        line.offset = sfnt_read_u32be(record+8);
+        line.length = sfnt_read_u32be(record+12);
+        if (line.offset > size || line.length > size-line.offset)
+          throw api_exception(api_error::Sanitize);
+        else if (sane_tf && j > 0u
+            &&  std::memcmp(record-16, record, 4) >= 0)
+          throw api_exception(api_error::Sanitize);
+        size_t i;
+        for (i = 0u; i < shared_count; ++i) {
+          offset_line const& other = lines[i];
+          if (other.offset == line.offset && other.length == line.length
+          &&  std::memcmp(other.tag, line.tag, 4) == 0)
+          {
+            break;
+          }
+        }
+        if (i == shared_count) {
+          if (lines.size() >= 0xFFFFu)
+            throw api_exception(api_error::Memory);
+          i = lines.size();
+          lines.push_back(line);
+        }
+        font.tables[j] = static_cast<unsigned short>(i);
+      }
+      return;
+    }
+    //END   sfnt static
+
+    //BEGIN sfnt / rule-of-six
+    sfnt::sfnt(mmaptwo::mmaptwo_i* xfh, bool sane_tf)
+      : fh(xfh), offsets(nullptr), core(nullptr)
+    {
+      initparse(sane_tf);
+    }
+
+    sfnt::~sfnt(void) {
+      if (core) {
+        delete core;
+      }
+      if (offsets) {
+        delete offsets;
+      }
+      if (fh) {
+        delete fh;
+      }
+      return;
+    }
+
+    sfnt::sfnt(sfnt&& other) noexcept
+      : fh(nullptr), offsets(nullptr), core(nullptr)
+    {
+      transfer(static_cast<sfnt&&>(other));
+      return;
+    }
+
+    sfnt& sfnt::operator=(sfnt&& other) noexcept {
+      transfer(static_cast<sfnt&&>(other));
+      return *this;
+    }
+
+    void sfnt::transfer(sfnt&& other) noexcept {
+      /* release-reset the font details, which hold a mapped page */{
+        sfnt_core *n_core = other.core;
+        other.core = nullptr;
+        if (this->core) {
+          delete this->core;
+        }
+        this->core = n_core;
+      }
+      /* release-reset the offset table */{
+        offset_table *n_ot = other.offsets;
+        other.offsets = nullptr;
+        if (this->offsets) {
+          delete this->offsets;
+        }
+        this->offsets = n_ot;
+      }
+      /* release-reset the mapping interface */{
+        mmaptwo::mmaptwo_i *n_fh = other.fh;
+        other.fh = nullptr;
+        if (this->fh) {
+          delete this->fh;
+        }
+        this->fh = n_fh;
+      }
+      return;
+    }
+
+    void sfnt::initparse(bool sane_tf) {
+      std::unique_ptr<sfnt_core> core(new sfnt_core());
+      std::unique_ptr<offset_table> offsets;
+      std::vector<offset_line> lines;
+      if (!fh) {
+        throw api_exception(api_error::Init);
+      }
+      size_t const size = fh->length();
+      if (size < 12u) {
+        throw api_exception(api_error::Sanitize);
+      }
+      /* map the whole file once, so table views need no copies */{
+        core->page.reset(fh->acquire(size, 0u));
+        if (!core->page) {
+          throw api_exception(api_error::Memory);
+        }
+        core->base = static_cast<unsigned char const*>(core->page->get());
+      }
+      unsigned char const* const base = core->base;
+      core->flavor = sfnt_read_u32be(base);
+      /* read the collection header */
+      if (core->flavor == sfnt_ttcf) {
+        core->collection_version = sfnt_read_u32be(base+4);
+        uint32 const font_count = sfnt_read_u32be(base+8);
+        if (font_count == 0u || (size-12u)/4u < font_count) {
+          throw api_exception(api_error::Sanitize);
+        }
+        core->fonts.resize(font_count);
+        for (uint32 j = 0u; j < font_count; ++j) {
+          core->fonts[j].directory_offset = sfnt_read_u32be(base+12u+4u*j);
+        }
+      } else {
+        core->collection_version = 0u;
+        core->fonts.resize(1u);
+        core->fonts[0].directory_offset = 0u;
+      }
+      for (sfnt_font& font : core->fonts) {
+        sfnt_read_directory(base, size, font, lines, sane_tf);
+      }
+      if (sane_tf) {
+        /* shared tables are checked once */
+        for (offset_line const& line : lines) {
+          if (sfnt_table_checksum(line.tag, base+line.offset, line.length)
+              != line.checksum)
+          {
+            throw api_exception(api_error::Sanitize);
+          }
+        }
+      }
+      /* fill the offset table */{
+        offsets = offtable_unique(lines.size());
+        if (!offsets) {
+          throw api_exception(api_error::Memory);
+        }
+        for (size_t i = 0u; i < lines.size(); ++i) {
+          (*offsets)[i] = lines[i];
+        }
+        offsets->reindex();
+      }
+      this->offsets = offsets.release();
+      this->core = core.release();
+      return;
+    }
+    //END   sfnt / rule-of-six
+
+    //BEGIN sfnt / allocation
+    void* sfnt::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* sfnt::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void sfnt::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void sfnt::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    sfnt* sfnt_new(mmaptwo::mmaptwo_i* xfh, bool sane_tf) noexcept {
+      try {
+        return new sfnt(xfh,sane_tf);
+      } catch (api_exception const& ) {
+        return nullptr;
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<sfnt> sfnt_unique
+        (mmaptwo::mmaptwo_i* xfh, bool sane_tf) noexcept
+    {
+      return util_unique_ptr<sfnt>(sfnt_new(xfh,sane_tf));
+    }
+
+    void sfnt_destroy(sfnt* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   sfnt / allocation
+
+    //BEGIN sfnt / public
+    offset_table const& sfnt::get_offsets(void) const noexcept {
+      return *(this->offsets);
+    }
+
+    uint32 sfnt::get_flavor(void) const noexcept {
+      return this->core ? this->core->flavor : 0u;
+    }
+
+    size_t sfnt::font_count(void) const noexcept {
+      return this->core ? this->core->fonts.size() : 0u;
+    }
+
+    uint32 sfnt::get_flavor(size_t font) const noexcept {
+      if (!this->core || font >= this->core->fonts.size())
+        return 0u;
+      return this->core->fonts[font].flavor;
+    }
+
+    size_t sfnt::font_table_count(size_t font) const noexcept {
+      if (!this->core || font >= this->core->fonts.size())
+        return 0u;
+      return this->core->fonts[font].tables.size();
+    }
+
+    size_t sfnt::font_table(size_t font, size_t j) const noexcept {
+      size_t const n = this->offsets ? this->offsets->size() : 0u;
+      if (!this->core || font >= this->core->fonts.size()
+      ||  j >= this->core->fonts[font].tables.size())
+      {
+        return n;
+      }
+      return this->core->fonts[font].tables[j];
+    }
+
+    table_span sfnt::table_at(size_t i) const noexcept {
+      table_span out = { nullptr, 0u };
+      if (this->core && this->offsets && i < this->offsets->size()) {
+        offset_line const& line = get_offsets()[i];
+        out.data = this->core->base+line.offset;
+        out.size = line.length;
+      }
+      return out;
+    }
+
+    table_span sfnt::table(unsigned char const* tag, api_error& ae) noexcept {
+      table_span out = { nullptr, 0u };
+      if (!this->core || !this->offsets) {
+        ae = api_error::Init;
+        return out;
+      }
+      size_t const i = this->offsets->find(tag);
+      if (i >= this->offsets->size()) {
+        ae = api_error::OutOfRange;
+        return out;
+      }
+      offset_line const& line = get_offsets()[i];
+      out.data = this->core->base+line.offset;
+      out.size = line.length;
+      ae = api_error::Success;
+      return out;
+    }
+
+    table_span sfnt::table(unsigned char const* tag) {
+      api_error ae;
+      table_span const out = table(tag, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return out;
+    }
+
+    table_span sfnt::table(size_t font, unsigned char const* tag,
+        api_error& ae) noexcept
+    {
+      table_span out = { nullptr, 0u };
+      if (!this->core || !this->offsets) {
+        ae = api_error::Init;
+        return out;
+      } else if (font >= this->core->fonts.size()) {
+        ae = api_error::OutOfRange;
+        return out;
+      } else if (this->core->fonts.size() == 1u) {
+        /* one font owns every table */
+        return table(tag, ae);
+      }
+      for (unsigned short const i : this->core->fonts[font].tables) {
+        offset_line const& line = get_offsets()[i];
+        if (std::memcmp(line.tag, tag, 4) == 0) {
+          out.data = this->core->base+line.offset;
+          out.size = line.length;
+          ae = api_error::Success;
+          return out;
+        }
+      }
+      ae = api_error::OutOfRange;
+      return out;
+    }
+    //END   sfnt / public
+
+    //BEGIN sfnt / checksum
+    uint32 sfnt_checksum
+      (unsigned char const* s, size_t n, size_t pos) noexcept
+    {
+      /* byte sums per position in the word; the final shifts make
+       * any wraparound of the lanes harmless */
+      uint32 lanes[4] = { 0u, 0u, 0u, 0u };
+      size_t i = 0u;
+      for (; i < n && ((pos+i)&3u); ++i) {
+        lanes[(pos+i)&3u] += s[i];
+      }
+      /* sum columns of 16 bytes into narrow counters, which vectorize
+       * well; 256 rows of 255 still fit in 16 bits */
+      while (n-i >= 16u) {
+        size_t const block = std::min<size_t>((n-i)&~size_t(15u), 4096u);
+        unsigned short wide[16] = {0u};
+        for (size_t j = 0u; j < block; j += 16u) {
+          unsigned char const* const row = s+i+j;
+          for (unsigned int k = 0u; k < 16u; ++k) {
+            wide[k] += row[k];
+          }
+        }
+        for (unsigned int k = 0u; k < 16u; ++k) {
+          lanes[k&3u] += wide[k];
+        }
+        i += block;
+      }
+      for (; i < n; ++i) {
+        lanes[(pos+i)&3u] += s[i];
+      }
+      return ((lanes[0]<<24) + (lanes[1]<<16) + (lanes[2]<<8) + lanes[3])
+        & 0xFFffFFffu;
+    }
+
+    uint32 sfnt_table_checksum
+      (unsigned char const* tag, unsigned char const* s, size_t n) noexcept
+    {
+      uint32 sum = sfnt_checksum(s, n);
+      if (n >= 12u && std::memcmp(tag, "head", 4) == 0) {
+        /* checkSumAdjustment counts as zero */
+        sum -= sfnt_read_u32be(s+8);
+      }
+      return sum & 0xFFffFFffu;
+    }
+    //END   sfnt / checksum
+  };
+};
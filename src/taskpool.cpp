@@ -0,0 +1,211 @@
+/**
+ * @file tcmplx-access-plus/taskpool.cpp
+ * @brief Worker thread pool
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#if (defined TextComplexAccessP_NO_EXCEPT)
+#  undef TextComplexAccessP_NO_EXCEPT
+#endif //TextComplexAccessP_NO_EXCEPT
+#include "text-complex-plus/access/taskpool.hpp"
+#include <new>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <system_error>
+#include <utility>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Queued task.
+     */
+    struct taskpool_item {
+      task_callback fn;
+      void* arg;
+    };
+
+    /**
+     * @brief Shared state between a task pool and its workers.
+     */
+    struct taskpool_core {
+      std::mutex lock;
+      /** @brief Signals new work or shutdown to workers. */
+      std::condition_variable work_cv;
+      /** @brief Signals idle pool to waiters. */
+      std::condition_variable idle_cv;
+      std::deque<taskpool_item> queue;
+      std::vector<std::thread> workers;
+      /** @brief Number of tasks currently running. */
+      unsigned int active;
+      bool stop;
+
+      taskpool_core(void) : active(0u), stop(false) {}
+    };
+
+    /**
+     * @brief Worker thread loop.
+     * @param core shared pool state
+     */
+    static void taskpool_work(taskpool_core* core) noexcept;
+    /**
+     * @brief Stop and join all workers of a pool.
+     * @param core shared pool state to release
+     */
+    static void taskpool_shutdown(taskpool_core* core) noexcept;
+
+    //BEGIN task_pool / static
+    void taskpool_work(taskpool_core* core) noexcept {
+      std::unique_lock<std::mutex> guard(core->lock);
+      for (;;) {
+        while (!core->stop && core->queue.empty())
+          core->work_cv.wait(guard);
+        if (core->queue.empty())
+          break;
+        taskpool_item const item = core->queue.front();
+        core->queue.pop_front();
+        core->active += 1u;
+        guard.unlock();
+        item.fn(item.arg);
+        guard.lock();
+        core->active -= 1u;
+        if (core->active == 0u && core->queue.empty())
+          core->idle_cv.notify_all();
+      }
+      return;
+    }
+
+    void taskpool_shutdown(taskpool_core* core) noexcept {
+      if (!core)
+        return;
+      /* signal */{
+        std::lock_guard<std::mutex> guard(core->lock);
+        core->stop = true;
+      }
+      core->work_cv.notify_all();
+      for (std::thread& t : core->workers) {
+        if (t.joinable())
+          t.join();
+      }
+      delete core;
+      return;
+    }
+    //END   task_pool / static
+
+    //BEGIN task_pool / rule-of-six
+    task_pool::task_pool(unsigned int threads)
+      : core(new taskpool_core())
+    {
+      if (threads == 0u)
+        threads = std::thread::hardware_concurrency();
+      if (threads == 0u)
+        threads = 1u;
+      try {
+        core->workers.reserve(threads);
+        for (unsigned int i = 0u; i < threads; ++i)
+          core->workers.emplace_back(taskpool_work, core);
+      } catch (std::system_error const& ) {
+        taskpool_shutdown(util_exchange(core, nullptr));
+        throw api_exception(api_error::Init);
+      } catch (std::bad_alloc const& ) {
+        taskpool_shutdown(util_exchange(core, nullptr));
+        throw;
+      }
+      return;
+    }
+
+    task_pool::~task_pool(void) {
+      taskpool_shutdown(util_exchange(core, nullptr));
+      return;
+    }
+
+    task_pool::task_pool(task_pool&& other) noexcept
+      : core(util_exchange(other.core, nullptr))
+    {
+      return;
+    }
+
+    task_pool& task_pool::operator=(task_pool&& other) noexcept {
+      taskpool_core* const new_core = util_exchange(other.core, nullptr);
+      taskpool_shutdown(util_exchange(core, new_core));
+      return *this;
+    }
+    //END   task_pool / rule-of-six
+
+    //BEGIN task_pool / allocation
+    void* task_pool::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* task_pool::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void task_pool::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void task_pool::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+    //END   task_pool / allocation
+
+    //BEGIN task_pool / public
+    unsigned int task_pool::size(void) const noexcept {
+      return core ? static_cast<unsigned int>(core->workers.size()) : 0u;
+    }
+
+    void task_pool::post(task_callback fn, void* arg, api_error& ae) noexcept {
+      if (!core) {
+        ae = api_error::Init;
+        return;
+      } else if (!fn) {
+        ae = api_error::Param;
+        return;
+      }
+      try {
+        std::lock_guard<std::mutex> guard(core->lock);
+        core->queue.push_back(taskpool_item{fn, arg});
+      } catch (std::bad_alloc const& ) {
+        ae = api_error::Memory;
+        return;
+      }
+      core->work_cv.notify_one();
+      ae = api_error::Success;
+      return;
+    }
+
+    void task_pool::wait(void) noexcept {
+      if (!core)
+        return;
+      std::unique_lock<std::mutex> guard(core->lock);
+      while (core->active > 0u || !core->queue.empty())
+        core->idle_cv.wait(guard);
+      return;
+    }
+    //END   task_pool / public
+
+    //BEGIN task_pool / namespace local
+    task_pool* taskpool_new(unsigned int threads) noexcept {
+      try {
+        return new task_pool(threads);
+      } catch (api_exception const& ) {
+        return nullptr;
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<task_pool> taskpool_unique(unsigned int threads) noexcept {
+      return util_unique_ptr<task_pool>(taskpool_new(threads));
+    }
+
+    void taskpool_destroy(task_pool* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   task_pool / namespace local
+  };
+};
@@ -5,14 +5,21 @@
  */
 #define TCMPLX_AP_WIN32_DLL_INTERNAL
 #include "text-complex-plus/access/woff2.hpp"
+#include "woff2_p.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
 #include "text-complex-plus/access/seq.hpp"
 #include "text-complex-plus/access/offtable.hpp"
+#include "text-complex-plus/access/brcvt.hpp"
+#include "text-complex-plus/access/taskpool.hpp"
 #include "mmaptwo-plus/mmaptwo.hpp"
 #include <new>
 #include <stdexcept>
 #include <memory>
 #include <limits>
 #include <algorithm>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
 #include <cstring>
 
 namespace text_complex {
@@ -56,41 +63,335 @@ namespace text_complex {
 
     struct woff2_tag {
       unsigned int n;
-      unsigned char tag[5];
+      /** @brief Tag packed big-endian, so integer order is tag order. */
+      uint32 key;
     };
-    static struct woff2_tag woff2_tag_table[64] = {
-      {25,/*BASE*/{0x42,0x41,0x53,0x45}}, {32,/*CBDT*/{0x43,0x42,0x44,0x54}},
-      {33,/*CBLC*/{0x43,0x42,0x4c,0x43}}, {13,/*CFF */{0x43,0x46,0x46,0x20}},
-      {34,/*COLR*/{0x43,0x4f,0x4c,0x52}}, {35,/*CPAL*/{0x43,0x50,0x41,0x4c}},
-      {15,/*EBDT*/{0x45,0x42,0x44,0x54}}, {16,/*EBLC*/{0x45,0x42,0x4c,0x43}},
-      {29,/*EBSC*/{0x45,0x42,0x53,0x43}}, {61,/*Feat*/{0x46,0x65,0x61,0x74}},
-      {26,/*GDEF*/{0x47,0x44,0x45,0x46}}, {27,/*GPOS*/{0x47,0x50,0x4f,0x53}},
-      {28,/*GSUB*/{0x47,0x53,0x55,0x42}}, {59,/*Glat*/{0x47,0x6c,0x61,0x74}},
-      {60,/*Gloc*/{0x47,0x6c,0x6f,0x63}}, {30,/*JSTF*/{0x4a,0x53,0x54,0x46}},
-      {20,/*LTSH*/{0x4c,0x54,0x53,0x48}}, {31,/*MATH*/{0x4d,0x41,0x54,0x48}},
-      { 6,/*OS/2*/{0x4f,0x53,0x2f,0x32}}, {21,/*PCLT*/{0x50,0x43,0x4c,0x54}},
-      {36,/*SVG */{0x53,0x56,0x47,0x20}}, {58,/*Silf*/{0x53,0x69,0x6c,0x66}},
-      {62,/*Sill*/{0x53,0x69,0x6c,0x6c}}, {22,/*VDMX*/{0x56,0x44,0x4d,0x58}},
-      {14,/*VORG*/{0x56,0x4f,0x52,0x47}}, {57,/*Zapf*/{0x5a,0x61,0x70,0x66}},
-      {38,/*acnt*/{0x61,0x63,0x6e,0x74}}, {39,/*avar*/{0x61,0x76,0x61,0x72}},
-      {40,/*bdat*/{0x62,0x64,0x61,0x74}}, {41,/*bloc*/{0x62,0x6c,0x6f,0x63}},
-      {42,/*bsln*/{0x62,0x73,0x6c,0x6e}}, { 0,/*cmap*/{0x63,0x6d,0x61,0x70}},
-      {43,/*cvar*/{0x63,0x76,0x61,0x72}}, { 8,/*cvt */{0x63,0x76,0x74,0x20}},
-      {44,/*fdsc*/{0x66,0x64,0x73,0x63}}, {45,/*feat*/{0x66,0x65,0x61,0x74}},
-      {46,/*fmtx*/{0x66,0x6d,0x74,0x78}}, { 9,/*fpgm*/{0x66,0x70,0x67,0x6d}},
-      {47,/*fvar*/{0x66,0x76,0x61,0x72}}, {17,/*gasp*/{0x67,0x61,0x73,0x70}},
-      {10,/*glyf*/{0x67,0x6c,0x79,0x66}}, {48,/*gvar*/{0x67,0x76,0x61,0x72}},
-      {18,/*hdmx*/{0x68,0x64,0x6d,0x78}}, { 1,/*head*/{0x68,0x65,0x61,0x64}},
-      { 2,/*hhea*/{0x68,0x68,0x65,0x61}}, { 3,/*hmtx*/{0x68,0x6d,0x74,0x78}},
-      {49,/*hsty*/{0x68,0x73,0x74,0x79}}, {50,/*just*/{0x6a,0x75,0x73,0x74}},
-      {19,/*kern*/{0x6b,0x65,0x72,0x6e}}, {51,/*lcar*/{0x6c,0x63,0x61,0x72}},
-      {11,/*loca*/{0x6c,0x6f,0x63,0x61}}, { 4,/*maxp*/{0x6d,0x61,0x78,0x70}},
-      {52,/*mort*/{0x6d,0x6f,0x72,0x74}}, {53,/*morx*/{0x6d,0x6f,0x72,0x78}},
-      { 5,/*name*/{0x6e,0x61,0x6d,0x65}}, {54,/*opbd*/{0x6f,0x70,0x62,0x64}},
-      { 7,/*post*/{0x70,0x6f,0x73,0x74}}, {12,/*prep*/{0x70,0x72,0x65,0x70}},
-      {55,/*prop*/{0x70,0x72,0x6f,0x70}}, {37,/*sbix*/{0x73,0x62,0x69,0x78}},
-      {56,/*trak*/{0x74,0x72,0x61,0x6b}}, {23,/*vhea*/{0x76,0x68,0x65,0x61}},
-      {24,/*vmtx*/{0x76,0x6d,0x74,0x78}}, {63,{0}},
+
+    namespace {
+      /**
+       * @brief Substreams of a transformed `glyf` table.
+       */
+      enum woff2_glyf_stream {
+        Woff2_NContour = 0,
+        Woff2_NPoints = 1,
+        Woff2_Flag = 2,
+        Woff2_Glyph = 3,
+        Woff2_Composite = 4,
+        Woff2_BBox = 5,
+        Woff2_Instruction = 6,
+        Woff2_StreamCount = 7
+      };
+    };
+
+    /**
+     * @brief Table directory details beyond the offset table.
+     */
+    struct woff2_entry {
+      /**
+       * @brief Length of the table in the decoded sfnt.
+       * @note For a transformed `glyf` or `hmtx` table, this starts as
+       *   the length before transformation and changes to the
+       *   reconstructed length.
+       */
+      uint32 orig_length;
+      /** @brief Offset of the table in the decoded sfnt. */
+      uint32 sfnt_offset;
+      /** @brief Checksum of the table in the decoded sfnt. */
+      uint32 checksum;
+      /** @brief Transform version from the table directory. */
+      unsigned char version;
+      /** @brief Whether the table needs reconstruction. */
+      bool transformed;
+    };
+
+    /**
+     * @brief Font described by the table directory or
+     *   the collection directory.
+     */
+    struct woff2_font {
+      /** @brief Offset of the font's table directory in the sfnt. */
+      uint32 directory_offset;
+      /** @brief sfnt version of the font. */
+      uint32 flavor;
+      /** @brief Table directory indices, sorted by tag. */
+      std::vector<unsigned short> tables;
+    };
+
+    /**
+     * @brief Table stream decoded on demand.
+     */
+    struct woff2_lazy {
+      /** @brief Mapping of the compressed table stream. */
+      std::unique_ptr<mmaptwo::page_i> page;
+      /** @brief Decoder, paused at the end of the decoded prefix. */
+      std::unique_ptr<brcvt_state> state;
+      /**
+       * @brief Decoded table stream, allocated in full up front so that
+       *   earlier views stay valid.
+       */
+      std::unique_ptr<unsigned char[]> stream;
+      /** @brief Bytes of the table stream decoded so far. */
+      size_t decoded;
+      /** @brief Compressed bytes consumed so far. */
+      size_t consumed;
+      /** @brief First decoder failure, kept for later requests. */
+      api_error failure;
+      /** @brief Reconstructed tables, indexed by table. */
+      std::vector<std::vector<unsigned char>> rebuilt;
+      /** @brief Whether each reconstructed table is ready. */
+      std::vector<bool> ready;
+    };
+
+    /**
+     * @brief Decoding details for a WOFF2 file.
+     */
+    struct woff2_core {
+      /** @brief `flavor` field of the header. */
+      uint32 flavor;
+      /** @brief `totalSfntSize` field of the header. */
+      uint32 total_sfnt_size;
+      /** @brief Version of the collection header, or zero. */
+      uint32 collection_version;
+      /** @brief Offset of the compressed table stream in the file. */
+      size_t stream_offset;
+      /** @brief Length of the compressed table stream in bytes. */
+      size_t stream_length;
+      /** @brief Space needed for the directories and plain tables. */
+      size_t layout_size;
+      /** @brief Space expected for the reconstructed tables. */
+      size_t transform_size;
+      /** @brief Exact space needed for the decoded sfnt, once known. */
+      size_t decoded_size;
+      /** @brief Per-table details, parallel to the offset table. */
+      std::vector<woff2_entry> entries;
+      /** @brief Fonts to write, one for a non-collection. */
+      std::vector<woff2_font> fonts;
+      /** @brief Prefix of the table stream decoded for table access. */
+      std::unique_ptr<woff2_lazy> lazy;
+    };
+
+    /** @brief `ttcf` tag of a font collection. */
+    static constexpr uint32 woff2_ttcf = 0x74746366u;
+    /** @brief `head` tag. */
+    static constexpr unsigned char woff2_head[4] = {0x68,0x65,0x61,0x64};
+    /** @brief `glyf` tag. */
+    static constexpr unsigned char woff2_glyf[4] = {0x67,0x6c,0x79,0x66};
+    /** @brief `loca` tag. */
+    static constexpr unsigned char woff2_loca[4] = {0x6c,0x6f,0x63,0x61};
+    /** @brief `hmtx` tag. */
+    static constexpr unsigned char woff2_hmtx[4] = {0x68,0x6d,0x74,0x78};
+    /** @brief `hhea` tag. */
+    static constexpr unsigned char woff2_hhea[4] = {0x68,0x68,0x65,0x61};
+    /** @brief `maxp` tag. */
+    static constexpr unsigned char woff2_maxp[4] = {0x6d,0x61,0x78,0x70};
+    /** @brief Length of the transformed `glyf` table header. */
+    static constexpr size_t woff2_glyf_header = 36u;
+    /** @brief Fewest glyphs worth a reconstruction task of their own. */
+    static constexpr size_t woff2_glyf_task_min = 256u;
+
+    /**
+     * @brief Substreams of a transformed `glyf` table.
+     */
+    struct woff2_glyf_source {
+      /** @brief Start of each substream. */
+      unsigned char const* stream[Woff2_StreamCount];
+      /** @brief Length of each substream in bytes. */
+      size_t length[Woff2_StreamCount];
+      /** @brief Bitmap of glyphs with an explicit bounding box. */
+      unsigned char const* bbox_bitmap;
+      /** @brief Bitmap of glyphs with overlapping contours, or `nullptr`. */
+      unsigned char const* overlap_bitmap;
+      /** @brief Number of glyphs in the table. */
+      unsigned int glyph_count;
+      /** @brief `indexFormat` of the reconstructed `loca` table. */
+      unsigned int index_format;
+    };
+
+    /**
+     * @brief Read positions in the substreams of a transformed `glyf` table.
+     */
+    struct woff2_glyf_cursor {
+      size_t pos[Woff2_StreamCount];
+    };
+
+    /**
+     * @brief Decoded point of a simple glyph.
+     */
+    struct woff2_point {
+      int x;
+      int y;
+      bool on_curve;
+    };
+
+    /**
+     * @brief Countdown for a batch of posted tasks.
+     */
+    struct woff2_latch {
+      std::mutex lock;
+      std::condition_variable done_cv;
+      /** @brief Tasks not yet finished, guarded by the lock. */
+      size_t pending;
+    };
+
+    /**
+     * @brief Run of consecutive glyphs to reconstruct.
+     */
+    struct woff2_glyf_job {
+      /** @brief Substreams to read. */
+      woff2_glyf_source const* source;
+      /** @brief Substream positions of the first glyph. */
+      woff2_glyf_cursor start;
+      /** @brief Index of the first glyph. */
+      unsigned int first;
+      /** @brief Index past the last glyph. */
+      unsigned int last;
+      /**
+       * @brief `loca` values to fill in, indexed by glyph; relative to
+       *   the start of the run until placed.
+       */
+      uint32* loca;
+      /** @brief Reconstructed glyphs, each padded to four bytes. */
+      std::vector<unsigned char> out;
+      /** @brief Checksum of the reconstructed glyphs. */
+      uint32 sum;
+      /** @brief (nullable) Completion countdown. */
+      woff2_latch* latch;
+      /** @brief Result of reconstruction. */
+      api_error ae;
+    };
+
+    /**
+     * @brief Reconstructed `glyf` table and its `loca` table.
+     */
+    struct woff2_glyf_table {
+      /** @brief Table directory index of the `glyf` table. */
+      unsigned short glyf_index;
+      /** @brief Table directory index of the `loca` table. */
+      unsigned short loca_index;
+      /** @brief `indexFormat` of the `loca` table. */
+      unsigned int index_format;
+      /** @brief Glyph offsets, one more than the glyph count. */
+      std::vector<uint32> loca;
+      /** @brief Reconstructed glyphs in glyph order. */
+      std::vector<woff2_glyf_job> runs;
+    };
+
+    /**
+     * @brief Reconstructed `hmtx` table.
+     */
+    struct woff2_hmtx_table {
+      /** @brief Table directory index of the `hmtx` table. */
+      unsigned short index;
+      /** @brief Table data. */
+      std::vector<unsigned char> data;
+    };
+
+    /**
+     * @brief Tables reconstructed during a decode.
+     */
+    struct woff2_rebuilt {
+      std::vector<woff2_glyf_table> glyfs;
+      std::vector<woff2_hmtx_table> hmtxs;
+    };
+
+    /**
+     * @brief Substreams of a `glyf` table being transformed.
+     */
+    struct woff2_glyf_sink {
+      /** @brief Substreams, with the bounding box bitmap kept apart. */
+      std::vector<unsigned char> stream[Woff2_StreamCount];
+      /** @brief Bitmap of glyphs with an explicit bounding box. */
+      std::vector<unsigned char> bbox_bitmap;
+      /** @brief Bitmap of glyphs with overlapping contours. */
+      std::vector<unsigned char> overlap_bitmap;
+      /** @brief Whether any glyph has overlapping contours. */
+      bool overlap;
+    };
+
+    /**
+     * @brief Table on its way into a WOFF2 file.
+     */
+    struct woff2_enc_table {
+      /** @brief Contents for the table stream. */
+      table_span data;
+      /** @brief Storage for transformed or adjusted contents. */
+      std::vector<unsigned char> store;
+      /** @brief Length of the table once decoded. */
+      uint32 orig_length;
+      /** @brief Whether the contents are a transform of the table. */
+      bool transformed;
+    };
+
+    /**
+     * @brief Table transform to run as a task.
+     */
+    struct woff2_enc_job {
+      /** @brief Table to transform, `glyf` or `hmtx`. */
+      woff2_enc_table* table;
+      /** @brief (nullable) For `hmtx`, the transform of the font's glyphs. */
+      woff2_enc_table const* outlines;
+      /** @brief `glyf` table of the font. */
+      table_span glyf;
+      /** @brief `loca` table of the font. */
+      table_span loca;
+      /** @brief Number of glyphs from `maxp`. */
+      unsigned int glyph_count;
+      /** @brief `indexToLocFormat` from `head`. */
+      unsigned int index_format;
+      /** @brief `numberOfHMetrics` from `hhea`, or zero for `glyf`. */
+      unsigned int metric_count;
+      /** @brief (nullable) Completion countdown. */
+      woff2_latch* latch;
+      /** @brief Result of the transform. */
+      api_error ae;
+    };
+
+    /**
+     * @brief Settings and output of a WOFF2 encoder.
+     */
+    struct woff2_encoder_core {
+      /** @brief Amount of table data to compress at once. */
+      uint32 block_size;
+      /** @brief Maximum sliding window size. */
+      uint32 window_size;
+      /** @brief Hash chain length limit. */
+      size_t chain_length;
+      /** @brief Last encoded file. */
+      std::vector<unsigned char> out;
+    };
+    static struct woff2_tag const woff2_tag_table[64] = {
+      {25,/*BASE*/0x42415345u}, {32,/*CBDT*/0x43424454u},
+      {33,/*CBLC*/0x43424c43u}, {13,/*CFF */0x43464620u},
+      {34,/*COLR*/0x434f4c52u}, {35,/*CPAL*/0x4350414cu},
+      {15,/*EBDT*/0x45424454u}, {16,/*EBLC*/0x45424c43u},
+      {29,/*EBSC*/0x45425343u}, {61,/*Feat*/0x46656174u},
+      {26,/*GDEF*/0x47444546u}, {27,/*GPOS*/0x47504f53u},
+      {28,/*GSUB*/0x47535542u}, {59,/*Glat*/0x476c6174u},
+      {60,/*Gloc*/0x476c6f63u}, {30,/*JSTF*/0x4a535446u},
+      {20,/*LTSH*/0x4c545348u}, {31,/*MATH*/0x4d415448u},
+      { 6,/*OS/2*/0x4f532f32u}, {21,/*PCLT*/0x50434c54u},
+      {36,/*SVG */0x53564720u}, {58,/*Silf*/0x53696c66u},
+      {62,/*Sill*/0x53696c6cu}, {22,/*VDMX*/0x56444d58u},
+      {14,/*VORG*/0x564f5247u}, {57,/*Zapf*/0x5a617066u},
+      {38,/*acnt*/0x61636e74u}, {39,/*avar*/0x61766172u},
+      {40,/*bdat*/0x62646174u}, {41,/*bloc*/0x626c6f63u},
+      {42,/*bsln*/0x62736c6eu}, { 0,/*cmap*/0x636d6170u},
+      {43,/*cvar*/0x63766172u}, { 8,/*cvt */0x63767420u},
+      {44,/*fdsc*/0x66647363u}, {45,/*feat*/0x66656174u},
+      {46,/*fmtx*/0x666d7478u}, { 9,/*fpgm*/0x6670676du},
+      {47,/*fvar*/0x66766172u}, {17,/*gasp*/0x67617370u},
+      {10,/*glyf*/0x676c7966u}, {48,/*gvar*/0x67766172u},
+      {18,/*hdmx*/0x68646d78u}, { 1,/*head*/0x68656164u},
+      { 2,/*hhea*/0x68686561u}, { 3,/*hmtx*/0x686d7478u},
+      {49,/*hsty*/0x68737479u}, {50,/*just*/0x6a757374u},
+      {19,/*kern*/0x6b65726eu}, {51,/*lcar*/0x6c636172u},
+      {11,/*loca*/0x6c6f6361u}, { 4,/*maxp*/0x6d617870u},
+      {52,/*mort*/0x6d6f7274u}, {53,/*morx*/0x6d6f7278u},
+      { 5,/*name*/0x6e616d65u}, {54,/*opbd*/0x6f706264u},
+      { 7,/*post*/0x706f7374u}, {12,/*prep*/0x70726570u},
+      {55,/*prop*/0x70726f70u}, {37,/*sbix*/0x73626978u},
+      {56,/*trak*/0x7472616bu}, {23,/*vhea*/0x76686561u},
+      {24,/*vmtx*/0x766d7478u}, {63,0u},
     };
 
     /**
@@ -100,6 +401,295 @@ namespace text_complex {
      */
     static
     unsigned short woff2_read_u16be(void const* s);
+    /**
+     * @brief Parse out a 32-bit unsigned integer.
+     * @param s from here
+     * @return the integer
+     */
+    static
+    uint32 woff2_read_u32be(void const* s);
+    /**
+     * @brief Write a 16-bit unsigned integer.
+     * @param s to here
+     * @param x the integer
+     */
+    static
+    void woff2_write_u16be(unsigned char* s, unsigned int x);
+    /**
+     * @brief Write a 32-bit unsigned integer.
+     * @param s to here
+     * @param x the integer
+     */
+    static
+    void woff2_write_u32be(unsigned char* s, uint32 x);
+    /**
+     * @brief Round a table length up to the next four-byte boundary.
+     * @param n the length
+     * @return the padded length
+     */
+    static
+    size_t woff2_pad4(size_t n);
+    /**
+     * @brief Lay out the tables of the decoded sfnt.
+     * @param core decoding details to update
+     * @param offsets the table directory
+     * @throw api_exception on sanitize check failure
+     */
+    static
+    void woff2_layout(woff2_core& core, offset_table const& offsets);
+    /**
+     * @brief Decompress the next part of a table stream.
+     * @param state Brotli decoder state
+     * @param[in,out] from start of remaining compressed data
+     * @param from_end end of compressed data
+     * @param to output range
+     * @param to_end end of the output range
+     * @param[in,out] sum (nullable) checksum to add the output to,
+     *   counting from `to` as the start of a table
+     * @return api_error::Success or api_error::Partial once the output
+     *   range is full, api_error::EndOfFile if the stream also ended,
+     *   other value on failure
+     */
+    static
+    api_error woff2_inflate(brcvt_state& state,
+        unsigned char const*& from, unsigned char const* from_end,
+        unsigned char* to, unsigned char* to_end, uint32* sum) noexcept;
+    /**
+     * @brief Write an sfnt table directory.
+     * @param core decoding details
+     * @param offsets the table directory
+     * @param font the font to write
+     * @param dst start of the sfnt
+     * @return the checksum of the table directory
+     */
+    static
+    uint32 woff2_write_directory(woff2_core const& core,
+        offset_table const& offsets, woff2_font const& font,
+        unsigned char* dst) noexcept;
+    /**
+     * @brief Take bytes from a `glyf` substream.
+     * @param src substreams
+     * @param at read positions to advance
+     * @param s substream to read
+     * @param n number of bytes to take
+     * @param[out] p start of the bytes taken
+     * @return false if the substream is too short
+     */
+    static
+    bool woff2_glyf_take(woff2_glyf_source const& src, woff2_glyf_cursor& at,
+        unsigned int s, size_t n, unsigned char const*& p) noexcept;
+    /**
+     * @brief Take a `255UInt16` from a `glyf` substream.
+     * @param src substreams
+     * @param at read positions to advance
+     * @param s substream to read
+     * @param[out] x the integer
+     * @return false if the substream is too short
+     */
+    static
+    bool woff2_glyf_u255(woff2_glyf_source const& src, woff2_glyf_cursor& at,
+        unsigned int s, unsigned int& x) noexcept;
+    /**
+     * @brief Check a glyph's bit in a glyph bitmap.
+     * @param bitmap the bitmap, most significant bit first
+     * @param i glyph index
+     * @return whether the bit is set
+     */
+    static
+    bool woff2_glyf_bit(unsigned char const* bitmap, unsigned int i) noexcept;
+    /**
+     * @brief Size of a flag's point coordinates in the glyph stream.
+     * @param flag triplet flag without the on-curve bit
+     * @return a size in bytes
+     */
+    static
+    size_t woff2_triplet_size(unsigned int flag) noexcept;
+    /**
+     * @brief Decode a point coordinate triplet.
+     * @param flag triplet flag without the on-curve bit
+     * @param s coordinate bytes from the glyph stream
+     * @param[out] dx horizontal offset from the previous point
+     * @param[out] dy vertical offset from the previous point
+     */
+    static
+    void woff2_triplet_decode(unsigned int flag, unsigned char const* s,
+        int& dx, int& dy) noexcept;
+    /**
+     * @brief Split a transformed `glyf` table into its substreams.
+     * @param data transformed table
+     * @param size length of the transformed table in bytes
+     * @param[out] src substreams
+     * @return Success on success, Sanitize on a malformed header
+     */
+    static
+    api_error woff2_glyf_parse(unsigned char const* data, size_t size,
+        woff2_glyf_source& src) noexcept;
+    /**
+     * @brief Scan the component records of a composite glyph.
+     * @param src substreams
+     * @param at read positions to advance past the records
+     * @param[out] instructions whether the glyph has instructions
+     * @return false if the substream is too short
+     */
+    static
+    bool woff2_glyf_components(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, bool& instructions) noexcept;
+    /**
+     * @brief Move the read positions past a glyph without rebuilding it.
+     * @param src substreams
+     * @param at read positions to advance
+     * @param i glyph index
+     * @return Success on success, Sanitize on a malformed glyph
+     */
+    static
+    api_error woff2_glyf_skip(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, unsigned int i) noexcept;
+    /**
+     * @brief Reconstruct a glyph.
+     * @param src substreams
+     * @param at read positions to advance
+     * @param i glyph index
+     * @param out buffer to append the glyph to, padded to four bytes
+     * @param points scratch space for decoded points
+     * @param flags scratch space for encoded flags
+     * @return Success on success, Sanitize on a malformed glyph
+     * @throw std::bad_alloc on allocation failure
+     */
+    static
+    api_error woff2_glyf_glyph(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, unsigned int i, std::vector<unsigned char>& out,
+        std::vector<woff2_point>& points, std::vector<unsigned char>& flags);
+    /**
+     * @brief Reconstruct a run of glyphs.
+     * @param job the run to reconstruct
+     * @return Success on success, other value on failure
+     */
+    static
+    api_error woff2_glyf_build(woff2_glyf_job& job) noexcept;
+    /**
+     * @brief Task entry point for glyph reconstruction.
+     * @param arg the @link woff2_glyf_job @endlink to reconstruct
+     */
+    static
+    void woff2_glyf_run(void* arg) noexcept;
+    /**
+     * @brief Reconstruct a `glyf` table and its `loca` offsets.
+     * @param data transformed table
+     * @param size length of the transformed table in bytes
+     * @param pool (nullable) worker threads to rebuild glyphs with
+     * @param[out] table reconstructed glyphs and offsets
+     * @return Success on success, other value on failure
+     * @note Glyphs are split into runs. A sequential scan finds where
+     *   each run starts in the substreams; the runs then rebuild in
+     *   parallel, and a prefix sum over their sizes places them.
+     */
+    static
+    api_error woff2_glyf_rebuild(unsigned char const* data, size_t size,
+        task_pool* pool, woff2_glyf_table& table) noexcept;
+    /**
+     * @brief Find a table in a font.
+     * @param font the font to search
+     * @param offsets the table directory
+     * @param tag tag to find
+     * @return a table directory index, or the table count if not found
+     */
+    static
+    size_t woff2_font_find(woff2_font const& font,
+        offset_table const& offsets, unsigned char const* tag) noexcept;
+    /**
+     * @brief Collect glyph `xMin` values from a reconstructed `glyf` table.
+     * @param table reconstructed glyphs and offsets
+     * @param[out] x_mins big-endian `xMin` per glyph, zero for empty glyphs
+     */
+    static
+    void woff2_glyf_xmins(woff2_glyf_table const& table,
+        std::vector<unsigned char>& x_mins);
+    /**
+     * @brief Collect glyph `xMin` values from a decoded `glyf` table.
+     * @param glyf the `glyf` table
+     * @param glyf_len length of the `glyf` table in bytes
+     * @param loca the `loca` table
+     * @param loca_len length of the `loca` table in bytes
+     * @param long_loca whether `loca` holds 32-bit offsets
+     * @param glyph_count number of glyphs from `maxp`
+     * @param[out] x_mins big-endian `xMin` per glyph, zero for empty glyphs
+     * @return Success on success, Sanitize on a bad `loca` or `glyf`
+     */
+    static
+    api_error woff2_loca_xmins(unsigned char const* glyf, size_t glyf_len,
+        unsigned char const* loca, size_t loca_len, bool long_loca,
+        size_t glyph_count, std::vector<unsigned char>& x_mins);
+    /**
+     * @brief Find the `loca` table paired with a transformed `glyf` table.
+     * @param core decoding details
+     * @param offsets the table directory
+     * @param glyf_i table directory index of the `glyf` table
+     * @return a table directory index, or the table count if none fits
+     */
+    static
+    size_t woff2_glyf_pair(woff2_core const& core,
+        offset_table const& offsets, size_t glyf_i) noexcept;
+    /**
+     * @brief Reconstruct an `hmtx` table.
+     * @param data transformed table
+     * @param size length of the transformed table in bytes
+     * @param metric_count `numberOfHMetrics` from `hhea`
+     * @param x_mins big-endian `xMin` per glyph
+     * @param[out] out reconstructed table
+     * @return Success on success, Sanitize on a malformed table
+     */
+    static
+    api_error woff2_hmtx_rebuild(unsigned char const* data, size_t size,
+        size_t metric_count, std::vector<unsigned char> const& x_mins,
+        std::vector<unsigned char>& out);
+    /**
+     * @brief Reconstruct the transformed tables and place them after
+     *   the plain tables.
+     * @param core decoding details to update
+     * @param offsets the table directory
+     * @param scratch transformed table data, indexed by table
+     * @param dst start of the sfnt, with plain tables already in place
+     * @param pool (nullable) worker threads
+     * @param[out] rebuilt reconstructed tables
+     * @return Success on success, other value on failure
+     */
+    static
+    api_error woff2_reconstruct(woff2_core& core, offset_table const& offsets,
+        std::vector<std::vector<unsigned char>> const& scratch,
+        unsigned char const* dst, task_pool* pool,
+        woff2_rebuilt& rebuilt) noexcept;
+    /**
+     * @brief Write a reconstructed `glyf` table and its `loca` table.
+     * @param table reconstructed glyphs and offsets
+     * @param glyf space for the `glyf` table
+     * @param loca space for the `loca` table
+     */
+    static
+    void woff2_glyf_store(woff2_glyf_table const& table,
+        unsigned char* glyf, unsigned char* loca) noexcept;
+    /**
+     * @brief Decode the table stream up to a given position.
+     * @param core decoding details
+     * @param offsets the table directory
+     * @param fh file holding the compressed stream
+     * @param end position in the table stream to decode up to
+     * @return Success on success, other value on failure
+     */
+    static
+    api_error woff2_lazy_fill(woff2_core& core, offset_table const& offsets,
+        mmaptwo::mmaptwo_i* fh, size_t end) noexcept;
+    /**
+     * @brief Access a table through the decoded stream prefix.
+     * @param core decoding details
+     * @param offsets the table directory
+     * @param fh file holding the compressed stream
+     * @param i table directory index
+     * @param[out] out view of the table data
+     * @return Success on success, other value on failure
+     */
+    static
+    api_error woff2_lazy_table(woff2_core& core, offset_table const& offsets,
+        mmaptwo::mmaptwo_i* fh, size_t i, table_span& out) noexcept;
     /**
      * @brief Parse out a tag from a WOFF2 tag table.
      * @param seq for this sequential
@@ -110,14 +700,6 @@ namespace text_complex {
     static
     void woff2_read_tag
         (sequential* seq, unsigned char *tag_text, unsigned int &enc_path);
-    /**
-     * @brief Parse out a variable-length-encoding 32-bit unsigned integer.
-     * @param s from here
-     * @param[out] v to here
-     * @throw api_exception on sanitize check failure
-     */
-    static
-    void woff2_read_uv128(sequential* seq, uint32& v);
 
     /**
      * @brief Check if a WOFF2 table/encoding combination requires
@@ -137,10 +719,99 @@ namespace text_complex {
      */
     static
     bool woff2_tag_cmp(struct woff2_tag const& v, struct woff2_tag const& w);
+    /**
+     * @brief Append a 16-bit unsigned integer.
+     * @param out to here
+     * @param x the integer
+     */
+    static
+    void woff2_put_u16be(std::vector<unsigned char>& out, unsigned int x);
+    /**
+     * @brief Append a 32-bit unsigned integer.
+     * @param out to here
+     * @param x the integer
+     */
+    static
+    void woff2_put_u32be(std::vector<unsigned char>& out, uint32 x);
+    /**
+     * @brief Append a `255UInt16` value.
+     * @param out to here
+     * @param x the value, less than 65536
+     */
+    static
+    void woff2_put_u255(std::vector<unsigned char>& out, unsigned int x);
+    /**
+     * @brief Append a `UIntBase128` value.
+     * @param out to here
+     * @param x the value
+     */
+    static
+    void woff2_put_v128(std::vector<unsigned char>& out, uint32 x);
+    /**
+     * @brief Encode a point as a flag byte and a coordinate triplet.
+     * @param dx horizontal offset from the previous point
+     * @param dy vertical offset from the previous point
+     * @param on_curve whether the point lies on the curve
+     * @param[out] sink substreams to append to
+     */
+    static
+    void woff2_triplet_encode(int dx, int dy, bool on_curve,
+        woff2_glyf_sink& sink);
+    /**
+     * @brief Split one glyph into the substreams of a transformed table.
+     * @param g the glyph
+     * @param len length of the glyph in bytes, with any padding
+     * @param i glyph index
+     * @param[out] sink substreams to append to
+     * @param points scratch space for the points of a simple glyph
+     * @param flags scratch space for the flags of a simple glyph
+     * @return whether the glyph parsed
+     */
+    static
+    bool woff2_glyf_split(unsigned char const* g, size_t len, unsigned int i,
+        woff2_glyf_sink& sink, std::vector<woff2_point>& points,
+        std::vector<unsigned char>& flags);
+    /**
+     * @brief Transform a `glyf` table.
+     * @param job the table and its font details
+     * @return Success on success, Sanitize if the glyphs do not
+     *   survive the transform, other value on failure
+     * @note The transformed table is rebuilt once as a check; the
+     *   rebuild also measures the decoded table.
+     */
+    static
+    api_error woff2_glyf_transform(woff2_enc_job& job) noexcept;
+    /**
+     * @brief Transform an `hmtx` table.
+     * @param job the table and its font details
+     * @return Success on success, Sanitize on a malformed table,
+     *   other value on failure
+     * @note The table stays plain if neither side bearing array
+     *   matches the glyph `xMin` values.
+     */
+    static
+    api_error woff2_hmtx_transform(woff2_enc_job& job) noexcept;
+    /**
+     * @brief Task entry point for table transforms.
+     * @param arg the @link woff2_enc_job @endlink to run
+     */
+    static
+    void woff2_enc_run(void* arg) noexcept;
+    /**
+     * @brief Encode a font into a WOFF2 file.
+     * @param core encoder settings and output
+     * @param src font to encode
+     * @param pool (nullable) worker threads for the table transforms
+     * @throw api_exception on failure
+     * @throw std::bad_alloc on allocation failure
+     */
+    static
+    void woff2_encode_sfnt
+        (woff2_encoder_core& core, sfnt const& src, task_pool* pool);
 
     //BEGIN woff2 static
     bool woff2_tag_cmp(struct woff2_tag const& v, struct woff2_tag const& w) {
-      return std::memcmp(v.tag, w.tag, 4)<0;
+      return v.key < w.key;
     }
 
     unsigned short woff2_read_u16be(void const* s) {
@@ -148,6 +819,1073 @@ namespace text_complex {
       return (static_cast<unsigned short>(c[0])<<8)|c[1];
     }
 
+    uint32 woff2_read_u32be(void const* s) {
+      unsigned char const* c = static_cast<unsigned char const*>(s);
+      return (static_cast<uint32>(c[0])<<24)
+        |  (static_cast<uint32>(c[1])<<16)
+        |  (static_cast<uint32>(c[2])<<8)
+        |  static_cast<uint32>(c[3]);
+    }
+
+    void woff2_write_u16be(unsigned char* s, unsigned int x) {
+      s[0] = static_cast<unsigned char>((x>>8)&255u);
+      s[1] = static_cast<unsigned char>(x&255u);
+      return;
+    }
+
+    void woff2_write_u32be(unsigned char* s, uint32 x) {
+      s[0] = static_cast<unsigned char>((x>>24)&255u);
+      s[1] = static_cast<unsigned char>((x>>16)&255u);
+      s[2] = static_cast<unsigned char>((x>>8)&255u);
+      s[3] = static_cast<unsigned char>(x&255u);
+      return;
+    }
+
+    size_t woff2_pad4(size_t n) {
+      return (n+3u)&~static_cast<size_t>(3u);
+    }
+
+    void woff2_layout(woff2_core& core, offset_table const& offsets) {
+      size_t pos = 0u;
+      size_t const font_count = core.fonts.size();
+      if (core.flavor == woff2_ttcf) {
+        pos = 12u + 4u*font_count
+          + (core.collection_version >= 0x20000u ? 12u : 0u);
+      }
+      for (woff2_font& font : core.fonts) {
+        size_t const n = font.tables.size();
+        if (pos > 0xFFffFFffu || n > (0xFFffFFffu-pos-12u)/16u)
+          throw api_exception(api_error::Sanitize);
+        font.directory_offset = static_cast<uint32>(pos);
+        pos += 12u + 16u*n;
+        std::sort(font.tables.begin(), font.tables.end(),
+          [&offsets](unsigned short a, unsigned short b) {
+            return std::memcmp(offsets[a].tag, offsets[b].tag, 4) < 0;
+          });
+        /* tags must be unique within a font */
+        for (size_t j = 1u; j < n; ++j) {
+          if (std::memcmp(offsets[font.tables[j-1u]].tag,
+              offsets[font.tables[j]].tag, 4) == 0)
+          {
+            throw api_exception(api_error::Sanitize);
+          }
+        }
+      }
+      /* tables in stream order */
+      core.transform_size = 0u;
+      for (woff2_entry& entry : core.entries) {
+        if (entry.orig_length > 0xFFffFFfcu-pos)
+          throw api_exception(api_error::Sanitize);
+        if (entry.transformed) {
+          /* placed after reconstruction */
+          entry.sfnt_offset = 0u;
+          core.transform_size += woff2_pad4(entry.orig_length);
+          continue;
+        }
+        entry.sfnt_offset = static_cast<uint32>(pos);
+        pos += woff2_pad4(entry.orig_length);
+      }
+      core.layout_size = pos;
+      core.decoded_size = core.transform_size ? 0u : pos;
+      return;
+    }
+
+    api_error woff2_inflate(brcvt_state& state,
+        unsigned char const*& from, unsigned char const* from_end,
+        unsigned char* to, unsigned char* to_end, uint32* sum) noexcept
+    {
+      unsigned char* to_next = to;
+      api_error res = api_error::Success;
+      while (to_next < to_end) {
+        unsigned char const* const from_last = from;
+        unsigned char* const to_last = to_next;
+        res = brcvt_in(state, from, from_end, from, to_next, to_end, to_next);
+        if (res < api_error::Success)
+          return res;
+        if (sum) {
+          /* sum each piece while it is still in cache */
+          *sum = (*sum + sfnt_checksum(to_last,
+              static_cast<size_t>(to_next-to_last),
+              static_cast<size_t>(to_last-to))) & 0xFFffFFffu;
+        }
+        if (to_next >= to_end)
+          break;
+        else if (res == api_error::EndOfFile || from >= from_end
+            ||  (from == from_last && to_next == to_last))
+        {
+          /* stream ended early */
+          return api_error::Sanitize;
+        }
+      }
+      return res;
+    }
+
+    uint32 woff2_write_directory(woff2_core const& core,
+        offset_table const& offsets, woff2_font const& font,
+        unsigned char* dst) noexcept
+    {
+      size_t const n = font.tables.size();
+      unsigned char* const out = dst+font.directory_offset;
+      unsigned int selector = 0u;
+      while ((2u<<selector) <= n)
+        selector += 1u;
+      unsigned int const range = n ? (16u<<selector) : 0u;
+      woff2_write_u32be(out, font.flavor);
+      woff2_write_u16be(out+4, static_cast<unsigned int>(n));
+      woff2_write_u16be(out+6, range);
+      woff2_write_u16be(out+8, n ? selector : 0u);
+      woff2_write_u16be(out+10, static_cast<unsigned int>(n*16u-range));
+      for (size_t j = 0u; j < n; ++j) {
+        unsigned short const i = font.tables[j];
+        woff2_entry const& entry = core.entries[i];
+        unsigned char* const record = out+12u+16u*j;
+        std::memcpy(record, offsets[i].tag, 4);
+        woff2_write_u32be(record+4, entry.checksum);
+        woff2_write_u32be(record+8, entry.sfnt_offset);
+        woff2_write_u32be(record+12, entry.orig_length);
+      }
+      return sfnt_checksum(out, 12u+16u*n);
+    }
+
+    bool woff2_glyf_take(woff2_glyf_source const& src, woff2_glyf_cursor& at,
+        unsigned int s, size_t n, unsigned char const*& p) noexcept
+    {
+      if (n > src.length[s]-at.pos[s])
+        return false;
+      p = src.stream[s]+at.pos[s];
+      at.pos[s] += n;
+      return true;
+    }
+
+    bool woff2_glyf_u255(woff2_glyf_source const& src, woff2_glyf_cursor& at,
+        unsigned int s, unsigned int& x) noexcept
+    {
+      unsigned char const* p;
+      if (!woff2_glyf_take(src, at, s, 1u, p))
+        return false;
+      switch (*p) {
+      case 253: /* wordCode */
+        if (!woff2_glyf_take(src, at, s, 2u, p))
+          return false;
+        x = woff2_read_u16be(p);
+        break;
+      case 254: /* oneMoreByteCode2 */
+      case 255: /* oneMoreByteCode1 */
+        {
+          unsigned int const base = (*p == 254) ? 506u : 253u;
+          if (!woff2_glyf_take(src, at, s, 1u, p))
+            return false;
+          x = *p + base;
+        } break;
+      default:
+        x = *p;
+        break;
+      }
+      return true;
+    }
+
+    bool woff2_glyf_bit(unsigned char const* bitmap, unsigned int i) noexcept {
+      return (bitmap[i>>3]>>(7u-(i&7u)))&1u;
+    }
+
+    size_t woff2_triplet_size(unsigned int flag) noexcept {
+      if (flag < 84u)
+        return 1u;
+      else if (flag < 120u)
+        return 2u;
+      else if (flag < 124u)
+        return 3u;
+      else return 4u;
+    }
+
+    void woff2_triplet_decode(unsigned int flag, unsigned char const* s,
+        int& dx, int& dy) noexcept
+    {
+      int const x_sign = (flag&1u) ? 1 : -1;
+      int const y_sign = (flag&2u) ? 1 : -1;
+      if (flag < 10u) {
+        dx = 0;
+        dy = x_sign*static_cast<int>(((flag&14u)<<7)+s[0]);
+      } else if (flag < 20u) {
+        dx = x_sign*static_cast<int>((((flag-10u)&14u)<<7)+s[0]);
+        dy = 0;
+      } else if (flag < 84u) {
+        unsigned int const b0 = flag-20u;
+        dx = x_sign*static_cast<int>(1u+(b0&0x30u)+(s[0]>>4));
+        dy = y_sign*static_cast<int>(1u+((b0&0x0cu)<<2)+(s[0]&0x0fu));
+      } else if (flag < 120u) {
+        unsigned int const b0 = flag-84u;
+        dx = x_sign*static_cast<int>(1u+((b0/12u)<<8)+s[0]);
+        dy = y_sign*static_cast<int>(1u+(((b0%12u)>>2)<<8)+s[1]);
+      } else if (flag < 124u) {
+        dx = x_sign*static_cast<int>((s[0]<<4)+(s[1]>>4));
+        dy = y_sign*static_cast<int>(((s[1]&0x0fu)<<8)+s[2]);
+      } else {
+        dx = x_sign*static_cast<int>((s[0]<<8)+s[1]);
+        dy = y_sign*static_cast<int>((s[2]<<8)+s[3]);
+      }
+      return;
+    }
+
+    api_error woff2_glyf_parse(unsigned char const* data, size_t size,
+        woff2_glyf_source& src) noexcept
+    {
+      if (size < woff2_glyf_header)
+        return api_error::Sanitize;
+      unsigned int const options = woff2_read_u16be(data+2);
+      src.glyph_count = woff2_read_u16be(data+4);
+      src.index_format = woff2_read_u16be(data+6);
+      if (src.index_format > 1u)
+        return api_error::Sanitize;
+      size_t pos = woff2_glyf_header;
+      for (unsigned int s = 0u; s < Woff2_StreamCount; ++s) {
+        uint32 const len = woff2_read_u32be(data+8u+4u*s);
+        if (len > size-pos)
+          return api_error::Sanitize;
+        src.stream[s] = data+pos;
+        src.length[s] = len;
+        pos += len;
+      }
+      /* the bounding box stream starts with its bitmap */{
+        size_t const bitmap_len = ((src.glyph_count+31u)>>5)*4u;
+        if (src.length[Woff2_BBox] < bitmap_len)
+          return api_error::Sanitize;
+        src.bbox_bitmap = src.stream[Woff2_BBox];
+        src.stream[Woff2_BBox] += bitmap_len;
+        src.length[Woff2_BBox] -= bitmap_len;
+      }
+      if (options&1u) {
+        size_t const bitmap_len = (src.glyph_count+7u)>>3;
+        if (bitmap_len > size-pos)
+          return api_error::Sanitize;
+        src.overlap_bitmap = data+pos;
+      } else src.overlap_bitmap = nullptr;
+      return api_error::Success;
+    }
+
+    bool woff2_glyf_components(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, bool& instructions) noexcept
+    {
+      unsigned int flags;
+      instructions = false;
+      do {
+        unsigned char const* p;
+        size_t arg_size = 2u;
+        if (!woff2_glyf_take(src, at, Woff2_Composite, 2u, p))
+          return false;
+        flags = woff2_read_u16be(p);
+        if (flags&0x0100u) /* WE_HAVE_INSTRUCTIONS */
+          instructions = true;
+        arg_size += (flags&0x0001u) ? 4u : 2u; /* ARG_1_AND_2_ARE_WORDS */
+        if (flags&0x0008u) /* WE_HAVE_A_SCALE */
+          arg_size += 2u;
+        else if (flags&0x0040u) /* WE_HAVE_AN_X_AND_Y_SCALE */
+          arg_size += 4u;
+        else if (flags&0x0080u) /* WE_HAVE_A_TWO_BY_TWO */
+          arg_size += 8u;
+        if (!woff2_glyf_take(src, at, Woff2_Composite, arg_size, p))
+          return false;
+      } while (flags&0x0020u); /* MORE_COMPONENTS */
+      return true;
+    }
+
+    api_error woff2_glyf_skip(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, unsigned int i) noexcept
+    {
+      unsigned char const* p;
+      unsigned int instruction_len = 0u;
+      if (!woff2_glyf_take(src, at, Woff2_NContour, 2u, p))
+        return api_error::Sanitize;
+      unsigned int const n_contours = woff2_read_u16be(p);
+      bool const has_bbox = woff2_glyf_bit(src.bbox_bitmap, i);
+      if (n_contours == 0u) {
+        return has_bbox ? api_error::Sanitize : api_error::Success;
+      } else if (n_contours == 0xFFFFu) {
+        bool instructions;
+        if (!has_bbox || !woff2_glyf_components(src, at, instructions))
+          return api_error::Sanitize;
+        if (instructions
+        &&  !woff2_glyf_u255(src, at, Woff2_Glyph, instruction_len))
+          return api_error::Sanitize;
+      } else if (n_contours >= 0x8000u) {
+        return api_error::Sanitize;
+      } else {
+        size_t point_count = 0u;
+        for (unsigned int c = 0u; c < n_contours; ++c) {
+          unsigned int n;
+          if (!woff2_glyf_u255(src, at, Woff2_NPoints, n))
+            return api_error::Sanitize;
+          point_count += n;
+        }
+        if (point_count > 0x10000u
+        ||  !woff2_glyf_take(src, at, Woff2_Flag, point_count, p))
+          return api_error::Sanitize;
+        size_t data_len = 0u;
+        for (size_t k = 0u; k < point_count; ++k)
+          data_len += woff2_triplet_size(p[k]&0x7fu);
+        unsigned char const* q;
+        if (!woff2_glyf_take(src, at, Woff2_Glyph, data_len, q)
+        ||  !woff2_glyf_u255(src, at, Woff2_Glyph, instruction_len))
+          return api_error::Sanitize;
+      }
+      if (!woff2_glyf_take(src, at, Woff2_Instruction, instruction_len, p))
+        return api_error::Sanitize;
+      if (has_bbox && !woff2_glyf_take(src, at, Woff2_BBox, 8u, p))
+        return api_error::Sanitize;
+      return api_error::Success;
+    }
+
+    api_error woff2_glyf_glyph(woff2_glyf_source const& src,
+        woff2_glyf_cursor& at, unsigned int i, std::vector<unsigned char>& out,
+        std::vector<woff2_point>& points, std::vector<unsigned char>& flags)
+    {
+      unsigned char const* p;
+      unsigned char const* bbox = nullptr;
+      unsigned char const* instructions;
+      unsigned int instruction_len = 0u;
+      if (!woff2_glyf_take(src, at, Woff2_NContour, 2u, p))
+        return api_error::Sanitize;
+      unsigned int const n_contours = woff2_read_u16be(p);
+      bool const has_bbox = woff2_glyf_bit(src.bbox_bitmap, i);
+      if (n_contours == 0u) {
+        /* empty glyphs take no space */
+        return has_bbox ? api_error::Sanitize : api_error::Success;
+      } else if (n_contours >= 0x8000u && n_contours != 0xFFFFu) {
+        return api_error::Sanitize;
+      }
+      if (has_bbox && !woff2_glyf_take(src, at, Woff2_BBox, 8u, bbox))
+        return api_error::Sanitize;
+      size_t const start = out.size();
+      if (n_contours == 0xFFFFu) {
+        /* composite glyph */
+        bool has_instructions;
+        size_t const components = at.pos[Woff2_Composite];
+        if (!bbox || !woff2_glyf_components(src, at, has_instructions))
+          return api_error::Sanitize;
+        size_t const components_len = at.pos[Woff2_Composite]-components;
+        if (has_instructions
+        &&  !woff2_glyf_u255(src, at, Woff2_Glyph, instruction_len))
+          return api_error::Sanitize;
+        if (!woff2_glyf_take(src, at, Woff2_Instruction,
+            instruction_len, instructions))
+          return api_error::Sanitize;
+        size_t const len = 10u + components_len
+          + (has_instructions ? 2u+instruction_len : 0u);
+        out.resize(start+woff2_pad4(len), 0u);
+        unsigned char* q = &out[start];
+        woff2_write_u16be(q, n_contours);
+        std::memcpy(q+2, bbox, 8u);
+        std::memcpy(q+10, src.stream[Woff2_Composite]+components,
+          components_len);
+        q += 10u+components_len;
+        if (has_instructions) {
+          woff2_write_u16be(q, instruction_len);
+          if (instruction_len)
+            std::memcpy(q+2, instructions, instruction_len);
+        }
+        return api_error::Success;
+      }
+      /* simple glyph: contour end points go straight to the output */
+      out.resize(start+10u+2u*n_contours);
+      size_t point_count = 0u;
+      for (unsigned int c = 0u; c < n_contours; ++c) {
+        unsigned int n;
+        if (!woff2_glyf_u255(src, at, Woff2_NPoints, n))
+          return api_error::Sanitize;
+        point_count += n;
+        if (point_count > 0x10000u)
+          return api_error::Sanitize;
+        woff2_write_u16be(&out[start+10u+2u*c],
+          static_cast<unsigned int>(point_count-1u)&0xFFFFu);
+      }
+      /* decode the points */{
+        unsigned char const* flag_bytes;
+        int x = 0;
+        int y = 0;
+        if (!woff2_glyf_take(src, at, Woff2_Flag, point_count, flag_bytes))
+          return api_error::Sanitize;
+        points.resize(point_count);
+        for (size_t k = 0u; k < point_count; ++k) {
+          unsigned int const flag = flag_bytes[k]&0x7fu;
+          int dx, dy;
+          if (!woff2_glyf_take(src, at, Woff2_Glyph,
+              woff2_triplet_size(flag), p))
+            return api_error::Sanitize;
+          woff2_triplet_decode(flag, p, dx, dy);
+          x += dx;
+          y += dy;
+          points[k].x = x;
+          points[k].y = y;
+          points[k].on_curve = !(flag_bytes[k]&0x80u);
+        }
+      }
+      if (!woff2_glyf_u255(src, at, Woff2_Glyph, instruction_len)
+      ||  !woff2_glyf_take(src, at, Woff2_Instruction,
+            instruction_len, instructions))
+        return api_error::Sanitize;
+      /* encode the flags */
+      size_t x_len = 0u;
+      size_t y_len = 0u;
+      flags.clear();
+      /* flags */{
+        int last_x = 0;
+        int last_y = 0;
+        unsigned int last_flag = 0x100u;
+        unsigned int repeat = 0u;
+        bool const overlap = src.overlap_bitmap
+          && woff2_glyf_bit(src.overlap_bitmap, i);
+        for (size_t k = 0u; k < point_count; ++k) {
+          woff2_point const& pt = points[k];
+          int const dx = pt.x-last_x;
+          int const dy = pt.y-last_y;
+          unsigned int flag = pt.on_curve ? 0x01u : 0u;
+          if (k == 0u && overlap)
+            flag |= 0x40u; /* OVERLAP_SIMPLE */
+          if (dx == 0)
+            flag |= 0x10u; /* X_IS_SAME */
+          else if (dx > -256 && dx < 256) {
+            flag |= 0x02u|(dx > 0 ? 0x10u : 0u); /* X_SHORT_VECTOR */
+            x_len += 1u;
+          } else x_len += 2u;
+          if (dy == 0)
+            flag |= 0x20u; /* Y_IS_SAME */
+          else if (dy > -256 && dy < 256) {
+            flag |= 0x04u|(dy > 0 ? 0x20u : 0u); /* Y_SHORT_VECTOR */
+            y_len += 1u;
+          } else y_len += 2u;
+          if (flag == last_flag && repeat != 255u) {
+            flags.back() |= 0x08u; /* REPEAT_FLAG */
+            repeat += 1u;
+          } else {
+            if (repeat != 0u)
+              flags.push_back(static_cast<unsigned char>(repeat));
+            flags.push_back(static_cast<unsigned char>(flag));
+            repeat = 0u;
+          }
+          last_x = pt.x;
+          last_y = pt.y;
+          last_flag = flag;
+        }
+        if (repeat != 0u)
+          flags.push_back(static_cast<unsigned char>(repeat));
+      }
+      size_t const header_len = 10u+2u*n_contours;
+      size_t const len = header_len + 2u + instruction_len
+        + flags.size() + x_len + y_len;
+      out.resize(start+woff2_pad4(len), 0u);
+      unsigned char* const q = &out[start];
+      woff2_write_u16be(q, n_contours);
+      if (bbox) {
+        std::memcpy(q+2, bbox, 8u);
+      } else {
+        int x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+        if (point_count > 0u) {
+          x_min = x_max = points[0].x;
+          y_min = y_max = points[0].y;
+        }
+        for (woff2_point const& pt : points) {
+          x_min = std::min(x_min, pt.x);
+          x_max = std::max(x_max, pt.x);
+          y_min = std::min(y_min, pt.y);
+          y_max = std::max(y_max, pt.y);
+        }
+        woff2_write_u16be(q+2, static_cast<unsigned int>(x_min)&0xFFFFu);
+        woff2_write_u16be(q+4, static_cast<unsigned int>(y_min)&0xFFFFu);
+        woff2_write_u16be(q+6, static_cast<unsigned int>(x_max)&0xFFFFu);
+        woff2_write_u16be(q+8, static_cast<unsigned int>(y_max)&0xFFFFu);
+      }
+      unsigned char* r = q+header_len;
+      woff2_write_u16be(r, instruction_len);
+      r += 2;
+      if (instruction_len) {
+        std::memcpy(r, instructions, instruction_len);
+        r += instruction_len;
+      }
+      if (!flags.empty()) {
+        std::memcpy(r, flags.data(), flags.size());
+        r += flags.size();
+      }
+      /* coordinates */{
+        unsigned char* xs = r;
+        unsigned char* ys = r+x_len;
+        int last_x = 0;
+        int last_y = 0;
+        for (woff2_point const& pt : points) {
+          int const dx = pt.x-last_x;
+          int const dy = pt.y-last_y;
+          if (dx == 0) {
+            /* same */
+          } else if (dx > -256 && dx < 256) {
+            *(xs++) = static_cast<unsigned char>(dx < 0 ? -dx : dx);
+          } else {
+            woff2_write_u16be(xs, static_cast<unsigned int>(dx)&0xFFFFu);
+            xs += 2;
+          }
+          if (dy == 0) {
+            /* same */
+          } else if (dy > -256 && dy < 256) {
+            *(ys++) = static_cast<unsigned char>(dy < 0 ? -dy : dy);
+          } else {
+            woff2_write_u16be(ys, static_cast<unsigned int>(dy)&0xFFFFu);
+            ys += 2;
+          }
+          last_x = pt.x;
+          last_y = pt.y;
+        }
+      }
+      return api_error::Success;
+    }
+
+    api_error woff2_glyf_build(woff2_glyf_job& job) noexcept {
+      try {
+        std::vector<woff2_point> points;
+        std::vector<unsigned char> flags;
+        woff2_glyf_cursor at = job.start;
+        for (unsigned int i = job.first; i < job.last; ++i) {
+          if (job.out.size() > 0xFFffFFfcu)
+            return api_error::Sanitize;
+          size_t const start = job.out.size();
+          job.loca[i] = static_cast<uint32>(start);
+          api_error const ae = woff2_glyf_glyph
+            (*job.source, at, i, job.out, points, flags);
+          if (ae != api_error::Success)
+            return ae;
+          /* glyphs start on word boundaries */
+          job.sum += sfnt_checksum(job.out.data()+start,
+            job.out.size()-start);
+        }
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      return api_error::Success;
+    }
+
+    void woff2_glyf_run(void* arg) noexcept {
+      woff2_glyf_job& job = *static_cast<woff2_glyf_job*>(arg);
+      api_error const ae = woff2_glyf_build(job);
+      if (job.latch) {
+        /* notify under the lock; the latch dies with the waiter */
+        std::lock_guard<std::mutex> guard(job.latch->lock);
+        job.ae = ae;
+        job.latch->pending -= 1u;
+        job.latch->done_cv.notify_all();
+      } else job.ae = ae;
+      return;
+    }
+
+    api_error woff2_glyf_rebuild(unsigned char const* data, size_t size,
+        task_pool* pool, woff2_glyf_table& table) noexcept
+    {
+      woff2_glyf_source src;
+      api_error ae = woff2_glyf_parse(data, size, src);
+      if (ae != api_error::Success)
+        return ae;
+      unsigned int const n = src.glyph_count;
+      size_t const run_count = pool
+        ? std::max<size_t>(1u, std::min<size_t>(pool->size()*4u,
+            (n+woff2_glyf_task_min-1u)/woff2_glyf_task_min))
+        : 1u;
+      table.index_format = src.index_format;
+      try {
+        table.loca.assign(n+1u, 0u);
+        table.runs.resize(run_count);
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      /* find where each run starts */{
+        woff2_glyf_cursor at = {};
+        for (size_t j = 0u; j < run_count; ++j) {
+          woff2_glyf_job& job = table.runs[j];
+          job.source = &src;
+          job.start = at;
+          job.first = static_cast<unsigned int>(n*j/run_count);
+          job.last = static_cast<unsigned int>(n*(j+1u)/run_count);
+          job.loca = table.loca.data();
+          job.sum = 0u;
+          job.latch = nullptr;
+          job.ae = api_error::Success;
+          if (j+1u < run_count) {
+            for (unsigned int i = job.first; i < job.last; ++i) {
+              ae = woff2_glyf_skip(src, at, i);
+              if (ae != api_error::Success)
+                return ae;
+            }
+          }
+        }
+      }
+      /* rebuild the runs */
+      if (run_count > 1u) {
+        woff2_latch latch;
+        latch.pending = run_count;
+        for (woff2_glyf_job& job : table.runs) {
+          api_error post_ae;
+          job.latch = &latch;
+          pool->post(woff2_glyf_run, &job, post_ae);
+          if (post_ae != api_error::Success)
+            woff2_glyf_run(&job);
+        }
+        std::unique_lock<std::mutex> guard(latch.lock);
+        while (latch.pending > 0u)
+          latch.done_cv.wait(guard);
+        for (woff2_glyf_job& job : table.runs)
+          job.latch = nullptr;
+      } else woff2_glyf_run(&table.runs[0]);
+      /* place the runs */{
+        size_t pos = 0u;
+        for (woff2_glyf_job& job : table.runs) {
+          if (job.ae != api_error::Success)
+            return job.ae;
+          if (job.out.size() > 0xFFffFFfcu-pos)
+            return api_error::Sanitize;
+          for (unsigned int i = job.first; i < job.last; ++i)
+            table.loca[i] += static_cast<uint32>(pos);
+          pos += job.out.size();
+          job.source = nullptr;
+        }
+        /* short offsets count 16-bit words */
+        if (table.index_format == 0u && pos > 0x1FFFEu)
+          return api_error::Sanitize;
+        table.loca[n] = static_cast<uint32>(pos);
+      }
+      return api_error::Success;
+    }
+
+    size_t woff2_font_find(woff2_font const& font,
+        offset_table const& offsets, unsigned char const* tag) noexcept
+    {
+      for (unsigned short const i : font.tables) {
+        if (std::memcmp(offsets[i].tag, tag, 4) == 0)
+          return i;
+      }
+      return offsets.size();
+    }
+
+    void woff2_glyf_xmins(woff2_glyf_table const& table,
+        std::vector<unsigned char>& x_mins)
+    {
+      x_mins.assign(2u*(table.loca.size()-1u), 0u);
+      for (woff2_glyf_job const& job : table.runs) {
+        uint32 const base = table.loca[job.first];
+        for (unsigned int i = job.first; i < job.last; ++i) {
+          if (table.loca[i+1u] > table.loca[i]) {
+            unsigned char const* const glyph =
+              job.out.data()+(table.loca[i]-base);
+            x_mins[2u*i] = glyph[2];
+            x_mins[2u*i+1u] = glyph[3];
+          }
+        }
+      }
+      return;
+    }
+
+    api_error woff2_loca_xmins(unsigned char const* glyf, size_t glyf_len,
+        unsigned char const* loca, size_t loca_len, bool long_loca,
+        size_t glyph_count, std::vector<unsigned char>& x_mins)
+    {
+      if (loca_len/(long_loca ? 4u : 2u) <= glyph_count)
+        return api_error::Sanitize;
+      x_mins.assign(2u*glyph_count, 0u);
+      for (size_t i = 0u; i < glyph_count; ++i) {
+        size_t const start = long_loca
+          ? woff2_read_u32be(loca+4u*i) : 2u*woff2_read_u16be(loca+2u*i);
+        size_t const end = long_loca
+          ? woff2_read_u32be(loca+4u*i+4u) : 2u*woff2_read_u16be(loca+2u*i+2u);
+        if (end <= start)
+          continue;
+        else if (end > glyf_len || end-start < 10u)
+          return api_error::Sanitize;
+        x_mins[2u*i] = glyf[start+2u];
+        x_mins[2u*i+1u] = glyf[start+3u];
+      }
+      return api_error::Success;
+    }
+
+    api_error woff2_hmtx_rebuild(unsigned char const* data, size_t size,
+        size_t metric_count, std::vector<unsigned char> const& x_mins,
+        std::vector<unsigned char>& out)
+    {
+      size_t const glyph_count = x_mins.size()/2u;
+      if (size < 1u || metric_count == 0u || metric_count > glyph_count)
+        return api_error::Sanitize;
+      unsigned int const flags = data[0];
+      bool const has_lsbs = !(flags&1u);
+      bool const has_mono_lsbs = !(flags&2u);
+      if ((flags&0xFCu) || (has_lsbs && has_mono_lsbs))
+        return api_error::Sanitize;
+      size_t const mono_count = glyph_count-metric_count;
+      size_t const need = 1u + 2u*metric_count
+        + (has_lsbs ? 2u*metric_count : 0u)
+        + (has_mono_lsbs ? 2u*mono_count : 0u);
+      if (size < need)
+        return api_error::Sanitize;
+      unsigned char const* const advances = data+1u;
+      /* all values stay big-endian, so the fill is plain word copies */
+      unsigned char const* const lsbs = has_lsbs
+        ? advances+2u*metric_count : x_mins.data();
+      unsigned char const* const mono_lsbs = has_mono_lsbs
+        ? advances+2u*metric_count*(has_lsbs ? 2u : 1u)
+        : x_mins.data()+2u*metric_count;
+      out.resize(4u*metric_count + 2u*mono_count);
+      unsigned char* const q = out.data();
+      for (size_t k = 0u; k < metric_count; ++k) {
+        q[4u*k] = advances[2u*k];
+        q[4u*k+1u] = advances[2u*k+1u];
+        q[4u*k+2u] = lsbs[2u*k];
+        q[4u*k+3u] = lsbs[2u*k+1u];
+      }
+      if (mono_count)
+        std::memcpy(q+4u*metric_count, mono_lsbs, 2u*mono_count);
+      return api_error::Success;
+    }
+
+    size_t woff2_glyf_pair(woff2_core const& core,
+        offset_table const& offsets, size_t glyf_i) noexcept
+    {
+      size_t const table_count = offsets.size();
+      size_t loca_i = glyf_i+1u;
+      /* the `loca` table should follow */
+      if (loca_i >= table_count
+      ||  std::memcmp(offsets[loca_i].tag, woff2_loca, 4) != 0)
+      {
+        if (core.flavor == woff2_ttcf)
+          return table_count;
+        for (loca_i = 0u; loca_i < table_count; ++loca_i) {
+          if (std::memcmp(offsets[loca_i].tag, woff2_loca, 4) == 0)
+            break;
+        }
+      }
+      if (loca_i >= table_count || !core.entries[loca_i].transformed
+      ||  offsets[loca_i].length != 0u)
+      {
+        return table_count;
+      }
+      return loca_i;
+    }
+
+    api_error woff2_reconstruct(woff2_core& core, offset_table const& offsets,
+        std::vector<std::vector<unsigned char>> const& scratch,
+        unsigned char const* dst, task_pool* pool,
+        woff2_rebuilt& rebuilt) noexcept
+    {
+      std::vector<woff2_glyf_table>& glyfs = rebuilt.glyfs;
+      size_t const table_count = core.entries.size();
+      size_t pos = core.layout_size;
+      std::vector<bool> placed;
+      try {
+        placed.assign(table_count, false);
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      for (size_t i = 0u; i < table_count; ++i) {
+        woff2_entry& entry = core.entries[i];
+        if (!entry.transformed)
+          continue;
+        else if (std::memcmp(offsets[i].tag, woff2_loca, 4) == 0
+            ||  std::memcmp(offsets[i].tag, woff2_hmtx, 4) == 0)
+          continue;
+        else if (std::memcmp(offsets[i].tag, woff2_glyf, 4) != 0)
+          return api_error::Sanitize;
+        size_t const loca_i = woff2_glyf_pair(core, offsets, i);
+        if (loca_i >= table_count || placed[loca_i])
+          return api_error::Sanitize;
+        try {
+          glyfs.emplace_back();
+        } catch (std::bad_alloc const& ) {
+          return api_error::Memory;
+        }
+        woff2_glyf_table& table = glyfs.back();
+        std::vector<unsigned char> const& data = scratch[i];
+        table.glyf_index = static_cast<unsigned short>(i);
+        table.loca_index = static_cast<unsigned short>(loca_i);
+        api_error const ae = woff2_glyf_rebuild
+          (data.data(), data.size(), pool, table);
+        if (ae != api_error::Success)
+          return ae;
+        /* place both tables */{
+          woff2_entry& loca = core.entries[loca_i];
+          size_t const glyf_len = table.loca.back();
+          size_t const loca_len =
+            table.loca.size()*(table.index_format ? 4u : 2u);
+          if (loca.orig_length != loca_len)
+            return api_error::Sanitize;
+          entry.orig_length = static_cast<uint32>(glyf_len);
+          if (pos > 0xFFffFFfcu-woff2_pad4(glyf_len))
+            return api_error::Sanitize;
+          entry.sfnt_offset = static_cast<uint32>(pos);
+          pos += woff2_pad4(glyf_len);
+          if (pos > 0xFFffFFfcu-woff2_pad4(loca_len))
+            return api_error::Sanitize;
+          loca.sfnt_offset = static_cast<uint32>(pos);
+          pos += woff2_pad4(loca_len);
+        }
+        placed[i] = true;
+        placed[loca_i] = true;
+      }
+      /* horizontal metrics need the glyphs of their own font */
+      for (woff2_font const& font : core.fonts) {
+        size_t const hmtx_i = woff2_font_find(font, offsets, woff2_hmtx);
+        if (hmtx_i >= table_count || !core.entries[hmtx_i].transformed
+        ||  placed[hmtx_i])
+        {
+          continue;
+        }
+        size_t const glyf_i = woff2_font_find(font, offsets, woff2_glyf);
+        size_t const hhea_i = woff2_font_find(font, offsets, woff2_hhea);
+        if (glyf_i >= table_count || hhea_i >= table_count
+        ||  core.entries[hhea_i].orig_length < 36u)
+        {
+          return api_error::Sanitize;
+        }
+        size_t const metric_count = woff2_read_u16be
+          (dst+core.entries[hhea_i].sfnt_offset+34u);
+        woff2_entry& entry = core.entries[hmtx_i];
+        std::vector<unsigned char> const& data = scratch[hmtx_i];
+        try {
+          std::vector<unsigned char> x_mins;
+          if (core.entries[glyf_i].transformed) {
+            woff2_glyf_table const* glyf = nullptr;
+            for (woff2_glyf_table const& table : glyfs) {
+              if (table.glyf_index == glyf_i)
+                glyf = &table;
+            }
+            if (!glyf)
+              return api_error::Sanitize;
+            woff2_glyf_xmins(*glyf, x_mins);
+          } else {
+            size_t const maxp_i = woff2_font_find(font, offsets, woff2_maxp);
+            size_t const head_i = woff2_font_find(font, offsets, woff2_head);
+            size_t const loca_i = woff2_font_find(font, offsets, woff2_loca);
+            if (maxp_i >= table_count || head_i >= table_count
+            ||  loca_i >= table_count || core.entries[loca_i].transformed
+            ||  core.entries[maxp_i].orig_length < 6u
+            ||  core.entries[head_i].orig_length < 54u)
+            {
+              return api_error::Sanitize;
+            }
+            woff2_entry const& glyf = core.entries[glyf_i];
+            woff2_entry const& loca = core.entries[loca_i];
+            api_error const ae = woff2_loca_xmins(
+              dst+glyf.sfnt_offset, glyf.orig_length,
+              dst+loca.sfnt_offset, loca.orig_length,
+              woff2_read_u16be(dst+core.entries[head_i].sfnt_offset+50u) != 0u,
+              woff2_read_u16be(dst+core.entries[maxp_i].sfnt_offset+4u),
+              x_mins);
+            if (ae != api_error::Success)
+              return ae;
+          }
+          rebuilt.hmtxs.emplace_back();
+          woff2_hmtx_table& table = rebuilt.hmtxs.back();
+          table.index = static_cast<unsigned short>(hmtx_i);
+          api_error const ae = woff2_hmtx_rebuild(data.data(), data.size(),
+            metric_count, x_mins, table.data);
+          if (ae != api_error::Success)
+            return ae;
+        } catch (std::bad_alloc const& ) {
+          return api_error::Memory;
+        }
+        size_t const hmtx_len = rebuilt.hmtxs.back().data.size();
+        if (pos > 0xFFffFFfcu-woff2_pad4(hmtx_len))
+          return api_error::Sanitize;
+        entry.orig_length = static_cast<uint32>(hmtx_len);
+        entry.sfnt_offset = static_cast<uint32>(pos);
+        pos += woff2_pad4(hmtx_len);
+        placed[hmtx_i] = true;
+      }
+      for (size_t i = 0u; i < table_count; ++i) {
+        if (core.entries[i].transformed && !placed[i])
+          return api_error::Sanitize;
+      }
+      core.decoded_size = pos;
+      return api_error::Success;
+    }
+
+    void woff2_glyf_store(woff2_glyf_table const& table,
+        unsigned char* glyf, unsigned char* loca) noexcept
+    {
+      for (woff2_glyf_job const& job : table.runs) {
+        if (!job.out.empty()) {
+          std::memcpy(glyf+table.loca[job.first],
+            job.out.data(), job.out.size());
+        }
+      }
+      if (table.index_format) {
+        for (size_t i = 0u; i < table.loca.size(); ++i)
+          woff2_write_u32be(loca+4u*i, table.loca[i]);
+      } else {
+        for (size_t i = 0u; i < table.loca.size(); ++i)
+          woff2_write_u16be(loca+2u*i, table.loca[i]>>1);
+      }
+      return;
+    }
+
+    api_error woff2_lazy_fill(woff2_core& core, offset_table const& offsets,
+        mmaptwo::mmaptwo_i* fh, size_t end) noexcept
+    {
+      if (!core.lazy) {
+        size_t const table_count = offsets.size();
+        size_t const total = table_count
+          ? offsets[table_count-1u].offset+offsets[table_count-1u].length
+          : 0u;
+        try {
+          std::unique_ptr<woff2_lazy> lazy(new woff2_lazy());
+          lazy->stream.reset(new unsigned char[total ? total : 1u]);
+          lazy->rebuilt.resize(table_count);
+          lazy->ready.assign(table_count, false);
+          if (core.stream_length) {
+            lazy->page.reset(fh->acquire
+              (core.stream_length, core.stream_offset));
+            if (!lazy->page)
+              return api_error::Memory;
+          } else if (total)
+            return api_error::Sanitize;
+          lazy->state = brcvt_unique(4096u, 16777200u, 1u);
+          if (!lazy->state)
+            return api_error::Memory;
+          lazy->decoded = 0u;
+          lazy->consumed = 0u;
+          lazy->failure = api_error::Success;
+          core.lazy = std::move(lazy);
+        } catch (std::bad_alloc const& ) {
+          return api_error::Memory;
+        }
+      }
+      woff2_lazy& lazy = *core.lazy;
+      if (lazy.failure != api_error::Success)
+        return lazy.failure;
+      else if (end <= lazy.decoded)
+        return api_error::Success;
+      unsigned char const* const base =
+        static_cast<unsigned char const*>(lazy.page->get());
+      unsigned char const* from = base+lazy.consumed;
+      api_error const res = woff2_inflate(*lazy.state, from,
+        base+core.stream_length, lazy.stream.get()+lazy.decoded,
+        lazy.stream.get()+end, nullptr);
+      lazy.consumed = static_cast<size_t>(from-base);
+      if (res < api_error::Success) {
+        lazy.failure = res;
+        return res;
+      }
+      lazy.decoded = end;
+      return api_error::Success;
+    }
+
+    api_error woff2_lazy_table(woff2_core& core, offset_table const& offsets,
+        mmaptwo::mmaptwo_i* fh, size_t i, table_span& out) noexcept
+    {
+      size_t const table_count = offsets.size();
+      offset_line const& line = offsets[i];
+      api_error ae = woff2_lazy_fill(core, offsets, fh, 0u);
+      if (ae != api_error::Success)
+        return ae;
+      woff2_lazy& lazy = *core.lazy;
+      if (!core.entries[i].transformed) {
+        ae = woff2_lazy_fill(core, offsets, fh, line.offset+line.length);
+        if (ae != api_error::Success)
+          return ae;
+        out.data = lazy.stream.get()+line.offset;
+        out.size = line.length;
+        return api_error::Success;
+      } else if (lazy.ready[i]) {
+        out.data = lazy.rebuilt[i].data();
+        out.size = lazy.rebuilt[i].size();
+        return api_error::Success;
+      }
+      if (std::memcmp(line.tag, woff2_glyf, 4) == 0
+      ||  std::memcmp(line.tag, woff2_loca, 4) == 0)
+      {
+        /* rebuild the pair together */
+        size_t glyf_i = i;
+        if (std::memcmp(line.tag, woff2_loca, 4) == 0) {
+          for (glyf_i = 0u; glyf_i < table_count; ++glyf_i) {
+            if (std::memcmp(offsets[glyf_i].tag, woff2_glyf, 4) == 0
+            &&  core.entries[glyf_i].transformed
+            &&  woff2_glyf_pair(core, offsets, glyf_i) == i)
+            {
+              break;
+            }
+          }
+          if (glyf_i >= table_count)
+            return api_error::Sanitize;
+        }
+        size_t const loca_i = woff2_glyf_pair(core, offsets, glyf_i);
+        if (loca_i >= table_count)
+          return api_error::Sanitize;
+        offset_line const& glyf_line = offsets[glyf_i];
+        ae = woff2_lazy_fill(core, offsets, fh,
+          glyf_line.offset+glyf_line.length);
+        if (ae != api_error::Success)
+          return ae;
+        woff2_glyf_table table;
+        ae = woff2_glyf_rebuild(lazy.stream.get()+glyf_line.offset,
+          glyf_line.length, nullptr, table);
+        if (ae != api_error::Success)
+          return ae;
+        size_t const glyf_len = table.loca.back();
+        size_t const loca_len =
+          table.loca.size()*(table.index_format ? 4u : 2u);
+        if (core.entries[loca_i].orig_length != loca_len)
+          return api_error::Sanitize;
+        try {
+          lazy.rebuilt[glyf_i].resize(glyf_len);
+          lazy.rebuilt[loca_i].resize(loca_len);
+        } catch (std::bad_alloc const& ) {
+          return api_error::Memory;
+        }
+        woff2_glyf_store(table,
+          lazy.rebuilt[glyf_i].data(), lazy.rebuilt[loca_i].data());
+        lazy.ready[glyf_i] = true;
+        lazy.ready[loca_i] = true;
+      } else if (std::memcmp(line.tag, woff2_hmtx, 4) == 0) {
+        woff2_font const* font = nullptr;
+        for (woff2_font const& f : core.fonts) {
+          if (std::find(f.tables.begin(), f.tables.end(), i)
+              != f.tables.end())
+          {
+            font = &f;
+            break;
+          }
+        }
+        if (!font)
+          return api_error::Sanitize;
+        /* metrics depend on the glyphs and counts of the same font */
+        unsigned char const* const deps[5] =
+          { woff2_head, woff2_hhea, woff2_maxp, woff2_glyf, woff2_loca };
+        table_span spans[5];
+        for (unsigned int k = 0u; k < 5u; ++k) {
+          size_t const dep_i = woff2_font_find(*font, offsets, deps[k]);
+          if (dep_i >= table_count)
+            return api_error::Sanitize;
+          ae = woff2_lazy_table(core, offsets, fh, dep_i, spans[k]);
+          if (ae != api_error::Success)
+            return ae;
+        }
+        if (spans[0].size < 54u || spans[1].size < 36u || spans[2].size < 6u)
+          return api_error::Sanitize;
+        ae = woff2_lazy_fill(core, offsets, fh, line.offset+line.length);
+        if (ae != api_error::Success)
+          return ae;
+        try {
+          std::vector<unsigned char> x_mins;
+          ae = woff2_loca_xmins(spans[3].data, spans[3].size,
+            spans[4].data, spans[4].size,
+            woff2_read_u16be(spans[0].data+50u) != 0u,
+            woff2_read_u16be(spans[2].data+4u), x_mins);
+          if (ae != api_error::Success)
+            return ae;
+          ae = woff2_hmtx_rebuild(lazy.stream.get()+line.offset, line.length,
+            woff2_read_u16be(spans[1].data+34u), x_mins, lazy.rebuilt[i]);
+          if (ae != api_error::Success)
+            return ae;
+        } catch (std::bad_alloc const& ) {
+          return api_error::Memory;
+        }
+        lazy.ready[i] = true;
+      } else return api_error::Sanitize;
+      out.data = lazy.rebuilt[i].data();
+      out.size = lazy.rebuilt[i].size();
+      return api_error::Success;
+    }
+
     void woff2_read_tag
         (sequential* seq, unsigned char *tag_text, unsigned int &enc_path)
     {
@@ -155,13 +1893,8 @@ namespace text_complex {
       if (q_tag < 0)
         throw api_exception(api_error::Sanitize);
       if ((q_tag&63) == 63) {
-        int i;
-        for (i = 0; i < 4; ++i) {
-          int const ch = seq->get_byte();
-          if (ch < 0)
-            throw api_exception(api_error::Sanitize);
-          else tag_text[i] = (unsigned char)(ch&255);
-        }
+        if (seq->read(tag_text, 4u) != 4u)
+          throw api_exception(api_error::Sanitize);
       } else {
         std::memcpy(tag_text, woff2_tag_fromi(q_tag&63), 4);
       }
@@ -169,27 +1902,6 @@ namespace text_complex {
       return;
     }
 
-    void woff2_read_uv128(sequential* seq, uint32& v) {
-      uint32 out = 0u;
-      int i;
-      for (i = 0; i < 5; ++i) {
-        int const ch = seq->get_byte();
-        if (ch < 0)
-          throw api_exception(api_error::Sanitize);
-        else if (out == 0u && ch == 0x80)
-          throw api_exception(api_error::Sanitize);
-        else if (i == 4 && ((ch&0x80) || (out > 0x1ffFFff))) {
-          throw api_exception(api_error::Sanitize);
-        } else {
-          out = ((out<<7)|static_cast<uint32>(ch&0x7f));
-          if (!(ch&0x80))
-            break;
-        }
-      }
-      v = out;
-      return;
-    }
-
     bool woff2_req_twolen
         (unsigned char const* tag_text, unsigned int enc_path)
     {
@@ -207,19 +1919,629 @@ namespace text_complex {
         return true;
       } else return false;
     }
+
+    void woff2_put_u16be(std::vector<unsigned char>& out, unsigned int x) {
+      out.push_back(static_cast<unsigned char>((x>>8)&255u));
+      out.push_back(static_cast<unsigned char>(x&255u));
+      return;
+    }
+
+    void woff2_put_u32be(std::vector<unsigned char>& out, uint32 x) {
+      woff2_put_u16be(out, (x>>16)&0xFFFFu);
+      woff2_put_u16be(out, x&0xFFFFu);
+      return;
+    }
+
+    void woff2_put_u255(std::vector<unsigned char>& out, unsigned int x) {
+      if (x < 253u) {
+        out.push_back(static_cast<unsigned char>(x));
+      } else if (x < 506u) {
+        out.push_back(255u); /* oneMoreByteCode1 */
+        out.push_back(static_cast<unsigned char>(x-253u));
+      } else if (x < 762u) {
+        out.push_back(254u); /* oneMoreByteCode2 */
+        out.push_back(static_cast<unsigned char>(x-506u));
+      } else {
+        out.push_back(253u); /* wordCode */
+        woff2_put_u16be(out, x);
+      }
+      return;
+    }
+
+    void woff2_put_v128(std::vector<unsigned char>& out, uint32 x) {
+      unsigned int shift = 28u;
+      /* no leading zeros */
+      while (shift > 0u && !(x>>shift))
+        shift -= 7u;
+      for (; shift > 0u; shift -= 7u)
+        out.push_back(static_cast<unsigned char>(((x>>shift)&127u)|128u));
+      out.push_back(static_cast<unsigned char>(x&127u));
+      return;
+    }
+
+    void woff2_triplet_encode(int dx, int dy, bool on_curve,
+        woff2_glyf_sink& sink)
+    {
+      std::vector<unsigned char>& glyph = sink.stream[Woff2_Glyph];
+      unsigned int const ax = static_cast<unsigned int>(dx < 0 ? -dx : dx);
+      unsigned int const ay = static_cast<unsigned int>(dy < 0 ? -dy : dy);
+      unsigned int const x_sign = dx < 0 ? 0u : 1u;
+      unsigned int const y_sign = dy < 0 ? 0u : 2u;
+      unsigned int flag = on_curve ? 0u : 128u;
+      if (dx == 0 && ay < 1280u) {
+        /* the one sign bit goes with the vertical offset */
+        flag += ((ay&0xF00u)>>7)+(y_sign>>1);
+        glyph.push_back(static_cast<unsigned char>(ay&255u));
+      } else if (dy == 0 && ax < 1280u) {
+        flag += 10u+((ax&0xF00u)>>7)+x_sign;
+        glyph.push_back(static_cast<unsigned char>(ax&255u));
+      } else if (ax < 65u && ay < 65u) {
+        flag += 20u+((ax-1u)&0x30u)+(((ay-1u)&0x30u)>>2)+x_sign+y_sign;
+        glyph.push_back(static_cast<unsigned char>
+          ((((ax-1u)&15u)<<4)|((ay-1u)&15u)));
+      } else if (ax < 769u && ay < 769u) {
+        flag += 84u+12u*(((ax-1u)&0x300u)>>8)+(((ay-1u)&0x300u)>>6)
+          +x_sign+y_sign;
+        glyph.push_back(static_cast<unsigned char>((ax-1u)&255u));
+        glyph.push_back(static_cast<unsigned char>((ay-1u)&255u));
+      } else if (ax < 4096u && ay < 4096u) {
+        flag += 120u+x_sign+y_sign;
+        glyph.push_back(static_cast<unsigned char>(ax>>4));
+        glyph.push_back(static_cast<unsigned char>(((ax&15u)<<4)|(ay>>8)));
+        glyph.push_back(static_cast<unsigned char>(ay&255u));
+      } else {
+        flag += 124u+x_sign+y_sign;
+        woff2_put_u16be(glyph, ax);
+        woff2_put_u16be(glyph, ay);
+      }
+      sink.stream[Woff2_Flag].push_back(static_cast<unsigned char>(flag));
+      return;
+    }
+
+    bool woff2_glyf_split(unsigned char const* g, size_t len, unsigned int i,
+        woff2_glyf_sink& sink, std::vector<woff2_point>& points,
+        std::vector<unsigned char>& flags)
+    {
+      unsigned char const bit = static_cast<unsigned char>(0x80u>>(i&7u));
+      if (len == 0u) {
+        /* empty glyphs take no space */
+        woff2_put_u16be(sink.stream[Woff2_NContour], 0u);
+        return true;
+      } else if (len < 10u)
+        return false;
+      unsigned int const n_contours = woff2_read_u16be(g);
+      /* outline-free glyphs with a header would rebuild as empty */
+      if (n_contours == 0u
+      ||  (n_contours >= 0x8000u && n_contours != 0xFFFFu))
+        return false;
+      woff2_put_u16be(sink.stream[Woff2_NContour], n_contours);
+      if (n_contours == 0xFFFFu) {
+        /* composite glyph: components stay as they are */
+        size_t pos = 10u;
+        unsigned int component_flags;
+        bool has_instructions = false;
+        do {
+          size_t arg_size = 4u;
+          if (len-pos < 2u)
+            return false;
+          component_flags = woff2_read_u16be(g+pos);
+          if (component_flags&0x0100u) /* WE_HAVE_INSTRUCTIONS */
+            has_instructions = true;
+          arg_size += (component_flags&0x0001u) ? 4u : 2u;
+          if (component_flags&0x0008u)
+            arg_size += 2u;
+          else if (component_flags&0x0040u)
+            arg_size += 4u;
+          else if (component_flags&0x0080u)
+            arg_size += 8u;
+          if (len-pos < arg_size)
+            return false;
+          pos += arg_size;
+        } while (component_flags&0x0020u); /* MORE_COMPONENTS */
+        std::vector<unsigned char>& composite = sink.stream[Woff2_Composite];
+        composite.insert(composite.end(), g+10, g+pos);
+        if (has_instructions) {
+          if (len-pos < 2u)
+            return false;
+          unsigned int const instruction_len = woff2_read_u16be(g+pos);
+          if (len-pos-2u < instruction_len)
+            return false;
+          woff2_put_u255(sink.stream[Woff2_Glyph], instruction_len);
+          std::vector<unsigned char>& instructions =
+            sink.stream[Woff2_Instruction];
+          instructions.insert(instructions.end(),
+            g+pos+2, g+pos+2+instruction_len);
+        }
+        /* composite glyphs always keep their bounding box */
+        sink.bbox_bitmap[i>>3] |= bit;
+        sink.stream[Woff2_BBox].insert(sink.stream[Woff2_BBox].end(),
+          g+2, g+10);
+        return true;
+      }
+      /* simple glyph: point counts per contour */
+      size_t const header_len = 10u+2u*n_contours;
+      size_t point_count = 0u;
+      if (len < header_len+2u)
+        return false;
+      for (unsigned int c = 0u; c < n_contours; ++c) {
+        size_t const next = woff2_read_u16be(g+10u+2u*c)+1u;
+        if (next < point_count)
+          return false;
+        woff2_put_u255(sink.stream[Woff2_NPoints],
+          static_cast<unsigned int>(next-point_count));
+        point_count = next;
+      }
+      unsigned int const instruction_len = woff2_read_u16be(g+header_len);
+      size_t pos = header_len+2u;
+      if (len-pos < instruction_len)
+        return false;
+      unsigned char const* const instructions = g+pos;
+      pos += instruction_len;
+      /* expand the flags */
+      flags.clear();
+      while (flags.size() < point_count) {
+        if (pos >= len)
+          return false;
+        unsigned char const flag = g[pos++];
+        flags.push_back(flag);
+        if (flag&0x08u) { /* REPEAT_FLAG */
+          if (pos >= len || g[pos] > point_count-flags.size())
+            return false;
+          flags.insert(flags.end(), static_cast<size_t>(g[pos++]), flag);
+        }
+      }
+      /* read the coordinates */
+      points.resize(point_count);
+      for (unsigned int axis = 0u; axis < 2u; ++axis) {
+        unsigned int const short_bit = axis ? 0x04u : 0x02u;
+        unsigned int const same_bit = axis ? 0x20u : 0x10u;
+        int v = 0;
+        for (size_t k = 0u; k < point_count; ++k) {
+          unsigned int const flag = flags[k];
+          if (flag&short_bit) {
+            if (pos >= len)
+              return false;
+            int const d = g[pos++];
+            v += (flag&same_bit) ? d : -d;
+          } else if (!(flag&same_bit)) {
+            if (len-pos < 2u)
+              return false;
+            unsigned int const d = woff2_read_u16be(g+pos);
+            pos += 2u;
+            v += static_cast<int>(d)-((d&0x8000u) ? 0x10000 : 0);
+          }
+          if (axis)
+            points[k].y = v;
+          else points[k].x = v;
+        }
+      }
+      /* write the triplets and find the bounding box */
+      int x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+      /* points */{
+        int last_x = 0;
+        int last_y = 0;
+        if (point_count > 0u) {
+          x_min = x_max = points[0].x;
+          y_min = y_max = points[0].y;
+        }
+        for (size_t k = 0u; k < point_count; ++k) {
+          woff2_point const& pt = points[k];
+          woff2_triplet_encode(pt.x-last_x, pt.y-last_y,
+            (flags[k]&0x01u) != 0u, sink);
+          last_x = pt.x;
+          last_y = pt.y;
+          x_min = std::min(x_min, pt.x);
+          x_max = std::max(x_max, pt.x);
+          y_min = std::min(y_min, pt.y);
+          y_max = std::max(y_max, pt.y);
+        }
+      }
+      woff2_put_u255(sink.stream[Woff2_Glyph], instruction_len);
+      sink.stream[Woff2_Instruction].insert(
+        sink.stream[Woff2_Instruction].end(),
+        instructions, instructions+instruction_len);
+      if (point_count > 0u && (flags[0]&0x40u)) { /* OVERLAP_SIMPLE */
+        sink.overlap_bitmap[i>>3] |= bit;
+        sink.overlap = true;
+      }
+      /* keep a bounding box that the points do not give back */
+      if (woff2_read_u16be(g+2) != (static_cast<unsigned int>(x_min)&0xFFFFu)
+      ||  woff2_read_u16be(g+4) != (static_cast<unsigned int>(y_min)&0xFFFFu)
+      ||  woff2_read_u16be(g+6) != (static_cast<unsigned int>(x_max)&0xFFFFu)
+      ||  woff2_read_u16be(g+8) != (static_cast<unsigned int>(y_max)&0xFFFFu))
+      {
+        sink.bbox_bitmap[i>>3] |= bit;
+        sink.stream[Woff2_BBox].insert(sink.stream[Woff2_BBox].end(),
+          g+2, g+10);
+      }
+      return true;
+    }
+
+    api_error woff2_glyf_transform(woff2_enc_job& job) noexcept {
+      unsigned int const n = job.glyph_count;
+      bool const long_loca = job.index_format != 0u;
+      unsigned char const* const glyf = job.glyf.data;
+      unsigned char const* const loca = job.loca.data;
+      if (job.loca.size != (n+1u)*(long_loca ? 4u : 2u))
+        return api_error::Sanitize;
+      try {
+        woff2_glyf_sink sink;
+        std::vector<woff2_point> points;
+        std::vector<unsigned char> flags;
+        sink.bbox_bitmap.assign(((n+31u)>>5)*4u, 0u);
+        sink.overlap_bitmap.assign((n+7u)>>3, 0u);
+        sink.overlap = false;
+        for (unsigned int i = 0u; i < n; ++i) {
+          size_t const start = long_loca
+            ? woff2_read_u32be(loca+4u*i) : 2u*woff2_read_u16be(loca+2u*i);
+          size_t const end = long_loca
+            ? woff2_read_u32be(loca+4u*i+4u)
+            : 2u*woff2_read_u16be(loca+2u*i+2u);
+          if (end < start || end > job.glyf.size)
+            return api_error::Sanitize;
+          if (!woff2_glyf_split(glyf+start, end-start, i,
+              sink, points, flags))
+            return api_error::Sanitize;
+        }
+        /* header, then the substreams */
+        std::vector<unsigned char>& out = job.table->store;
+        size_t total = woff2_glyf_header+sink.bbox_bitmap.size()
+          + (sink.overlap ? sink.overlap_bitmap.size() : 0u);
+        for (std::vector<unsigned char> const& s : sink.stream) {
+          if (s.size() > 0xFFffFFf0u-total)
+            return api_error::Sanitize;
+          total += s.size();
+        }
+        out.clear();
+        out.reserve(total);
+        woff2_put_u16be(out, 0u);
+        woff2_put_u16be(out, sink.overlap ? 1u : 0u);
+        woff2_put_u16be(out, n);
+        woff2_put_u16be(out, job.index_format);
+        for (unsigned int s = 0u; s < Woff2_StreamCount; ++s) {
+          size_t const len = sink.stream[s].size()
+            + (s == Woff2_BBox ? sink.bbox_bitmap.size() : 0u);
+          woff2_put_u32be(out, static_cast<uint32>(len));
+        }
+        for (unsigned int s = 0u; s < Woff2_StreamCount; ++s) {
+          if (s == Woff2_BBox)
+            out.insert(out.end(),
+              sink.bbox_bitmap.begin(), sink.bbox_bitmap.end());
+          out.insert(out.end(), sink.stream[s].begin(), sink.stream[s].end());
+        }
+        if (sink.overlap)
+          out.insert(out.end(),
+            sink.overlap_bitmap.begin(), sink.overlap_bitmap.end());
+        /* rebuild here, in this task, to measure the decoded table */
+        woff2_glyf_table check;
+        api_error const ae = woff2_glyf_rebuild
+          (out.data(), out.size(), nullptr, check);
+        if (ae != api_error::Success)
+          return ae;
+        job.table->orig_length = check.loca.back();
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      job.table->data.data = job.table->store.data();
+      job.table->data.size = job.table->store.size();
+      job.table->transformed = true;
+      return api_error::Success;
+    }
+
+    api_error woff2_hmtx_transform(woff2_enc_job& job) noexcept {
+      size_t const n = job.glyph_count;
+      size_t const m = job.metric_count;
+      unsigned char const* const hmtx = job.table->data.data;
+      if (m == 0u || m > n || job.table->data.size != 2u*(m+n))
+        return api_error::Sanitize;
+      try {
+        std::vector<unsigned char> x_mins;
+        api_error const ae = woff2_loca_xmins(job.glyf.data, job.glyf.size,
+          job.loca.data, job.loca.size, job.index_format != 0u, n, x_mins);
+        if (ae != api_error::Success)
+          return ae;
+        bool lsb_same = true;
+        for (size_t k = 0u; k < m && lsb_same; ++k) {
+          lsb_same = std::memcmp(hmtx+4u*k+2u, &x_mins[2u*k], 2u) == 0;
+        }
+        bool const mono_same = std::memcmp(hmtx+4u*m,
+          x_mins.data()+2u*m, 2u*(n-m)) == 0;
+        if (!lsb_same && !mono_same)
+          return api_error::Success;
+        std::vector<unsigned char>& out = job.table->store;
+        out.clear();
+        out.reserve(1u+2u*m+(lsb_same ? 0u : 2u*m)+(mono_same ? 0u : 2u*(n-m)));
+        out.push_back(static_cast<unsigned char>
+          ((lsb_same ? 1u : 0u)|(mono_same ? 2u : 0u)));
+        for (size_t k = 0u; k < m; ++k)
+          out.insert(out.end(), hmtx+4u*k, hmtx+4u*k+2u);
+        if (!lsb_same) {
+          for (size_t k = 0u; k < m; ++k)
+            out.insert(out.end(), hmtx+4u*k+2u, hmtx+4u*k+4u);
+        }
+        if (!mono_same)
+          out.insert(out.end(), hmtx+4u*m, hmtx+2u*(m+n));
+      } catch (std::bad_alloc const& ) {
+        return api_error::Memory;
+      }
+      job.table->data.data = job.table->store.data();
+      job.table->data.size = job.table->store.size();
+      job.table->transformed = true;
+      return api_error::Success;
+    }
+
+    void woff2_enc_run(void* arg) noexcept {
+      woff2_enc_job& job = *static_cast<woff2_enc_job*>(arg);
+      api_error const ae = job.metric_count
+        ? woff2_hmtx_transform(job) : woff2_glyf_transform(job);
+      if (job.latch) {
+        /* notify under the lock; the latch dies with the waiter */
+        std::lock_guard<std::mutex> guard(job.latch->lock);
+        job.ae = ae;
+        job.latch->pending -= 1u;
+        job.latch->done_cv.notify_all();
+      } else job.ae = ae;
+      return;
+    }
+
+    void woff2_encode_sfnt
+        (woff2_encoder_core& core, sfnt const& src, task_pool* pool)
+    {
+      offset_table const& offsets = src.get_offsets();
+      size_t const table_count = offsets.size();
+      size_t const font_count = src.font_count();
+      bool const collection = src.get_flavor() == woff2_ttcf;
+      std::vector<woff2_enc_table> tables(table_count);
+      /* `loca` paired with each `glyf`, for the directory order */
+      std::vector<size_t> pairs(table_count, table_count);
+      std::vector<bool> claimed(table_count, false);
+      std::vector<woff2_enc_job> jobs;
+      for (size_t i = 0u; i < table_count; ++i) {
+        woff2_enc_table& table = tables[i];
+        table.data = src.table_at(i);
+        table.orig_length = static_cast<uint32>(table.data.size);
+        table.transformed = false;
+      }
+      /* plan the transforms */
+      jobs.reserve(2u*font_count);
+      for (size_t f = 0u; f < font_count; ++f) {
+        size_t const n = src.font_table_count(f);
+        size_t glyf_i = table_count, loca_i = table_count;
+        size_t head_i = table_count, maxp_i = table_count;
+        size_t hhea_i = table_count, hmtx_i = table_count;
+        for (size_t j = 0u; j < n; ++j) {
+          size_t const i = src.font_table(f, j);
+          unsigned char const* const tag = offsets[i].tag;
+          if (std::memcmp(tag, woff2_glyf, 4) == 0)
+            glyf_i = i;
+          else if (std::memcmp(tag, woff2_loca, 4) == 0)
+            loca_i = i;
+          else if (std::memcmp(tag, woff2_head, 4) == 0)
+            head_i = i;
+          else if (std::memcmp(tag, woff2_maxp, 4) == 0)
+            maxp_i = i;
+          else if (std::memcmp(tag, woff2_hhea, 4) == 0)
+            hhea_i = i;
+          else if (std::memcmp(tag, woff2_hmtx, 4) == 0)
+            hmtx_i = i;
+        }
+        if (glyf_i >= table_count || loca_i >= table_count)
+          continue;
+        else if (!claimed[glyf_i] && !claimed[loca_i]) {
+          claimed[glyf_i] = true;
+          claimed[loca_i] = true;
+          pairs[glyf_i] = loca_i;
+          if (head_i < table_count && tables[head_i].data.size >= 54u
+          &&  maxp_i < table_count && tables[maxp_i].data.size >= 6u)
+          {
+            woff2_enc_job job = {};
+            job.table = &tables[glyf_i];
+            job.outlines = nullptr;
+            job.glyf = tables[glyf_i].data;
+            job.loca = tables[loca_i].data;
+            job.glyph_count = woff2_read_u16be(tables[maxp_i].data.data+4);
+            job.index_format = woff2_read_u16be(tables[head_i].data.data+50);
+            job.metric_count = 0u;
+            job.latch = nullptr;
+            job.ae = api_error::Success;
+            if (job.index_format <= 1u)
+              jobs.push_back(job);
+          }
+        }
+        /* the decoder takes glyph extents from the first font with
+         * the `hmtx` table */
+        if (hmtx_i >= table_count || claimed[hmtx_i])
+          continue;
+        claimed[hmtx_i] = true;
+        if (hhea_i >= table_count || tables[hhea_i].data.size < 36u)
+          continue;
+        for (woff2_enc_job const& glyf_job : jobs) {
+          if (glyf_job.table != &tables[glyf_i] || glyf_job.metric_count)
+            continue;
+          woff2_enc_job job = glyf_job;
+          job.table = &tables[hmtx_i];
+          job.outlines = glyf_job.table;
+          job.metric_count = woff2_read_u16be(tables[hhea_i].data.data+34);
+          if (job.metric_count)
+            jobs.push_back(job);
+          break;
+        }
+      }
+      /* run the transforms */
+      if (pool && jobs.size() > 1u) {
+        woff2_latch latch;
+        latch.pending = jobs.size();
+        for (woff2_enc_job& job : jobs) {
+          api_error post_ae;
+          job.latch = &latch;
+          pool->post(woff2_enc_run, &job, post_ae);
+          if (post_ae != api_error::Success)
+            woff2_enc_run(&job);
+        }
+        std::unique_lock<std::mutex> guard(latch.lock);
+        while (latch.pending > 0u)
+          latch.done_cv.wait(guard);
+      } else {
+        for (woff2_enc_job& job : jobs)
+          woff2_enc_run(&job);
+      }
+      /* tables that failed to transform go in as they are */
+      for (woff2_enc_job const& job : jobs) {
+        woff2_enc_table& table = *job.table;
+        if (job.ae == api_error::Memory)
+          throw std::bad_alloc();
+        else if (job.ae == api_error::Success
+            &&  (!job.outlines || job.outlines->transformed))
+          continue;
+        table.data = src.table_at(static_cast<size_t>(&table-tables.data()));
+        table.orig_length = static_cast<uint32>(table.data.size);
+        table.transformed = false;
+        std::vector<unsigned char>().swap(table.store);
+      }
+      bool modified = false;
+      for (size_t i = 0u; i < table_count; ++i) {
+        if (pairs[i] < table_count && tables[i].transformed) {
+          /* transformed `loca` tables are rebuilt from the glyphs */
+          tables[pairs[i]].data = table_span{ nullptr, 0u };
+          tables[pairs[i]].transformed = true;
+          modified = true;
+        }
+      }
+      for (size_t i = 0u; i < table_count && modified; ++i) {
+        table_span const& head = tables[i].data;
+        if (std::memcmp(offsets[i].tag, woff2_head, 4) == 0
+        &&  head.size >= 18u && !(head.data[16]&0x08u))
+        {
+          /* flag the font as losslessly modified */
+          tables[i].store.assign(head.data, head.data+head.size);
+          tables[i].store[16] |= 0x08u;
+          tables[i].data.data = tables[i].store.data();
+        }
+      }
+      /* each `loca` table follows its `glyf` table */
+      std::vector<size_t> order;
+      std::vector<size_t> positions(table_count, table_count);
+      std::vector<bool> follows(table_count, false);
+      for (size_t i = 0u; i < table_count; ++i) {
+        if (pairs[i] < table_count)
+          follows[pairs[i]] = true;
+      }
+      order.reserve(table_count);
+      for (size_t i = 0u; i < table_count; ++i) {
+        if (follows[i])
+          continue;
+        positions[i] = order.size();
+        order.push_back(i);
+        if (pairs[i] < table_count) {
+          positions[pairs[i]] = order.size();
+          order.push_back(pairs[i]);
+        }
+      }
+      std::vector<unsigned char>& out = core.out;
+      out.clear();
+      out.resize(48u, 0u);
+      /* table directory */
+      size_t sfnt_size = collection ? 12u+4u*font_count : 0u;
+      for (size_t const i : order) {
+        woff2_enc_table const& table = tables[i];
+        unsigned char const* const tag = offsets[i].tag;
+        unsigned int const known = woff2_tag_toi(tag);
+        unsigned int version = 0u;
+        if (std::memcmp(tag, woff2_glyf, 4) == 0
+        ||  std::memcmp(tag, woff2_loca, 4) == 0)
+        {
+          version = table.transformed ? 0u : 3u;
+        } else if (table.transformed)
+          version = 1u;
+        out.push_back(static_cast<unsigned char>(known|(version<<6)));
+        if (known == 63u)
+          out.insert(out.end(), tag, tag+4);
+        woff2_put_v128(out, table.orig_length);
+        if (table.transformed)
+          woff2_put_v128(out, static_cast<uint32>(table.data.size));
+        sfnt_size += woff2_pad4(table.orig_length);
+      }
+      for (size_t f = 0u; f < font_count; ++f)
+        sfnt_size += 12u+16u*src.font_table_count(f);
+      if (sfnt_size > 0xFFffFFffu)
+        throw api_exception(api_error::Sanitize);
+      /* collection directory */
+      if (collection) {
+        woff2_put_u32be(out, 0x00010000u);
+        woff2_put_u255(out, static_cast<unsigned int>(font_count));
+        for (size_t f = 0u; f < font_count; ++f) {
+          size_t const n = src.font_table_count(f);
+          woff2_put_u255(out, static_cast<unsigned int>(n));
+          woff2_put_u32be(out, src.get_flavor(f));
+          for (size_t j = 0u; j < n; ++j) {
+            woff2_put_u255(out,
+              static_cast<unsigned int>(positions[src.font_table(f, j)]));
+          }
+        }
+      }
+      /* compressed table stream */
+      size_t const stream_offset = out.size();
+      /* stream */{
+        util_unique_ptr<brcvt_state> const state = brcvt_unique
+          (core.block_size, core.window_size, core.chain_length);
+        unsigned char buffer[4096];
+        api_error ae;
+        if (!state)
+          throw std::bad_alloc();
+        for (size_t const i : order) {
+          unsigned char const* p = tables[i].data.data;
+          unsigned char const* const end = p+tables[i].data.size;
+          while (p != end) {
+            unsigned char* q;
+            ae = brcvt_out(*state, p, end, p, buffer, buffer+4096, q);
+            out.insert(out.end(), buffer, q);
+            if (ae != api_error::Success && ae != api_error::Partial)
+              throw api_exception(ae);
+          }
+        }
+        do {
+          unsigned char* q;
+          ae = brcvt_unshift(*state, buffer, buffer+4096, q);
+          out.insert(out.end(), buffer, q);
+          if (ae != api_error::Success && ae != api_error::EndOfFile)
+            throw api_exception(ae);
+        } while (ae != api_error::EndOfFile);
+      }
+      size_t const stream_length = out.size()-stream_offset;
+      out.resize(woff2_pad4(out.size()), 0u);
+      if (out.size() > 0xFFffFFffu || table_count > 0xFFFFu)
+        throw api_exception(api_error::Sanitize);
+      /* header */{
+        static unsigned char const signature[4] = {0x77,0x4F,0x46,0x32};
+        size_t const head_i = offsets.find(woff2_head);
+        unsigned char* const header = out.data();
+        std::memcpy(header, signature, 4);
+        woff2_write_u32be(header+4, src.get_flavor());
+        woff2_write_u32be(header+8, static_cast<uint32>(out.size()));
+        woff2_write_u16be(header+12, static_cast<unsigned int>(table_count));
+        woff2_write_u32be(header+16, static_cast<uint32>(sfnt_size));
+        woff2_write_u32be(header+20, static_cast<uint32>(stream_length));
+        /* font version from `fontRevision` */
+        if (head_i < table_count && tables[head_i].data.size >= 8u) {
+          unsigned char const* const revision = tables[head_i].data.data+4;
+          woff2_write_u16be(header+24, woff2_read_u16be(revision));
+          woff2_write_u16be(header+26, woff2_read_u16be(revision+2));
+        }
+      }
+      return;
+    }
     //END   woff2 static
 
     //BEGIN woff2 tools
     unsigned int woff2_tag_toi(unsigned char const* s) {
-      unsigned int i;
-      struct woff2_tag* value;
+      struct woff2_tag const* value;
       struct woff2_tag key;
-      std::memcpy(key.tag, s, 4);
+      key.key = woff2_read_u32be(s);
       value = std::lower_bound(
           woff2_tag_table, woff2_tag_table+63, key,
           woff2_tag_cmp
         );
-      return (std::memcmp(key.tag,value->tag,4)==0) ? value->n : 63u;
+      return (value->key == key.key) ? value->n : 63u;
     }
 
     unsigned char const* woff2_tag_fromi(unsigned int x) {
@@ -232,7 +2554,7 @@ namespace text_complex {
 
     //BEGIN woff2 / rule-of-six
     woff2::woff2(mmaptwo::mmaptwo_i* xfh, bool sane_tf)
-      : fh(xfh), offsets(nullptr)
+      : fh(xfh), offsets(nullptr), core(nullptr)
     {
       initparse(sane_tf);
     }
@@ -244,11 +2566,14 @@ namespace text_complex {
       if (offsets) {
         delete offsets;
       }
+      if (core) {
+        delete core;
+      }
       return;
     }
 
     woff2::woff2(woff2&& other) noexcept
-      : fh(nullptr), offsets(nullptr)
+      : fh(nullptr), offsets(nullptr), core(nullptr)
     {
       transfer(static_cast<woff2&&>(other));
       return;
@@ -276,25 +2601,28 @@ namespace text_complex {
         }
         this->offsets = n_ot;
       }
+      /* release-reset the decoding details */{
+        woff2_core *n_core = other.core;
+        other.core = nullptr;
+        if (this->core) {
+          delete this->core;
+        }
+        this->core = n_core;
+      }
       return;
     }
 
     void woff2::initparse(bool sane_tf) {
       std::unique_ptr<sequential> seq = seq_unique(fh);
       std::unique_ptr<offset_table> offsets;
+      std::unique_ptr<woff2_core> core(new woff2_core());
+      unsigned short table_count;
       if (!seq) {
         throw api_exception(api_error::Init);
       }
       /* acquire the header */{
-        unsigned char wheader[48];
-        int i;
-        for (i = 0; i < 48; ++i) {
-          int ch = seq->get_byte();
-          if (ch < 0)
-            break;
-          else wheader[i] = static_cast<unsigned char>(ch&255);
-        }
-        if (i < 48) {
+        unsigned char const* const wheader = seq->peek_span(48u);
+        if (!wheader) {
           throw api_exception(api_error::Sanitize);
         }
         /* inspect the signature */{
@@ -303,7 +2631,9 @@ namespace text_complex {
             throw api_exception(api_error::Sanitize);
           }
         }
-        unsigned short table_count;
+        core->flavor = woff2_read_u32be(wheader+4);
+        core->total_sfnt_size = woff2_read_u32be(wheader+16);
+        core->stream_length = woff2_read_u32be(wheader+20);
         /* parse out the table count */{
           table_count = woff2_read_u16be(wheader+12);
           if (table_count > std::numeric_limits<size_t>::max()) {
@@ -313,7 +2643,9 @@ namespace text_complex {
             if (!offsets)
               throw api_exception(api_error::Memory);
           }
+          core->entries.resize(table_count);
         }
+        seq->set_pos(48u);
         /* iterate through the table directory */{
           unsigned short table_i;
           uint32 next_offset = 0u;
@@ -323,11 +2655,12 @@ namespace text_complex {
             uint32 len, use_len;
             woff2_read_tag(seq.get(), tag_text, enc_path);
             /* read the original length */{
-              woff2_read_uv128(seq.get(), len);
+              len = seq->read_uv128();
             }
             /* read the transform length */
-            if (woff2_req_twolen(tag_text,enc_path)) {
-              woff2_read_uv128(seq.get(), use_len);
+            bool const transformed = woff2_req_twolen(tag_text,enc_path);
+            if (transformed) {
+              use_len = seq->read_uv128();
             } else use_len = len;
             /* add entry to offset table */{
               struct offset_line& line = (*offsets)[table_i];
@@ -340,16 +2673,83 @@ namespace text_complex {
               }
               next_offset += use_len;
             }
+            /* keep the details for decoding */{
+              woff2_entry& entry = core->entries[table_i];
+              entry.orig_length = len;
+              entry.sfnt_offset = 0u;
+              entry.checksum = 0u;
+              entry.version = static_cast<unsigned char>(enc_path);
+              entry.transformed = transformed;
+            }
+          }
+        }
+      }
+      /* read the collection directory */
+      if (core->flavor == woff2_ttcf) {
+        unsigned short font_count;
+        core->collection_version = seq->read_u32be();
+        font_count = seq->read_u255();
+        if (font_count == 0u) {
+          throw api_exception(api_error::Sanitize);
+        }
+        core->fonts.resize(font_count);
+        for (woff2_font& font : core->fonts) {
+          unsigned short const font_table_count = seq->read_u255();
+          font.directory_offset = 0u;
+          font.flavor = seq->read_u32be();
+          font.tables.resize(font_table_count);
+          for (unsigned short& index : font.tables) {
+            index = seq->read_u255();
+            if (index >= table_count) {
+              throw api_exception(api_error::Sanitize);
+            }
           }
         }
+      } else {
+        core->collection_version = 0u;
+        core->fonts.resize(1u);
+        woff2_font& font = core->fonts[0];
+        font.directory_offset = 0u;
+        font.flavor = core->flavor;
+        font.tables.resize(table_count);
+        for (unsigned short i = 0u; i < table_count; ++i) {
+          font.tables[i] = i;
+        }
+      }
+      /* locate the compressed table stream */{
+        core->stream_offset = seq->get_pos();
+        if (core->stream_length > seq->get_length()-core->stream_offset) {
+          throw api_exception(api_error::Sanitize);
+        }
       }
+      woff2_layout(*core, *offsets);
       if (sane_tf) {
-        /* TODO sanitize the rest */
-        if (false) {
+        /* WOFF2 stores no checksums to verify; decoding computes them
+         * as the tables come out, so only the structure is checked */
+        size_t glyf_count = 0u;
+        size_t loca_count = 0u;
+        for (unsigned short i = 0u; i < table_count; ++i) {
+          offset_line const& line = (*offsets)[i];
+          if (!core->entries[i].transformed)
+            continue;
+          else if (std::memcmp(line.tag, woff2_glyf, 4) == 0) {
+            if (woff2_glyf_pair(*core, *offsets, i) >= table_count)
+              throw api_exception(api_error::Sanitize);
+            glyf_count += 1u;
+          } else if (std::memcmp(line.tag, woff2_loca, 4) == 0) {
+            if (line.length != 0u)
+              throw api_exception(api_error::Sanitize);
+            loca_count += 1u;
+          }
+        }
+        /* transformed `glyf` and `loca` tables come in pairs */
+        if (glyf_count != loca_count) {
           throw api_exception(api_error::Sanitize);
         }
       }
+      offsets->reindex();
       this->offsets = offsets.release();
+      this->core = core.release();
       return;
     }
     //END   woff2 / rule-of-six
@@ -398,6 +2798,430 @@ namespace text_complex {
     offset_table const& woff2::get_offsets(void) const noexcept {
       return *(this->offsets);
     }
+
+    uint32 woff2::get_flavor(void) const noexcept {
+      return this->core ? this->core->flavor : 0u;
+    }
+
+    size_t woff2::sfnt_size(void) const noexcept {
+      if (!this->core)
+        return 0u;
+      else if (this->core->decoded_size)
+        return this->core->decoded_size;
+      return std::max<size_t>
+        ( this->core->layout_size+this->core->transform_size,
+          this->core->total_sfnt_size);
+    }
+
+    size_t woff2::decode_sfnt
+        (unsigned char* dst, size_t dst_size, api_error& ae) noexcept
+    {
+      return decode_sfnt(dst, dst_size, nullptr, ae);
+    }
+
+    size_t woff2::decode_sfnt(unsigned char* dst, size_t dst_size,
+        task_pool* pool, api_error& ae) noexcept
+    {
+      std::unique_ptr<brcvt_state> const state =
+        brcvt_unique(4096u, 16777200u, 1u);
+      if (!state) {
+        ae = api_error::Memory;
+        return 0u;
+      }
+      return decode_sfnt(dst, dst_size, *state, pool, ae);
+    }
+
+    size_t woff2::decode_sfnt(unsigned char* dst, size_t dst_size,
+        brcvt_state& state, task_pool* pool, api_error& ae) noexcept
+    {
+      if (!this->core || !this->offsets || !this->fh) {
+        ae = api_error::Init;
+        return 0u;
+      }
+      woff2_core& core = *this->core;
+      offset_table const& offsets = *this->offsets;
+      size_t const table_count = core.entries.size();
+      std::vector<std::vector<unsigned char>> scratch;
+      woff2_rebuilt rebuilt;
+      if (dst_size < core.layout_size
+      ||  (core.decoded_size && dst_size < core.decoded_size))
+      {
+        ae = api_error::BlockOverflow;
+        return 0u;
+      } else if (core.transform_size) {
+        try {
+          scratch.resize(table_count);
+        } catch (std::bad_alloc const& ) {
+          ae = api_error::Memory;
+          return 0u;
+        }
+      }
+      /* decompress the table stream into place */{
+        std::unique_ptr<mmaptwo::page_i> const page(core.stream_length
+          ? fh->acquire(core.stream_length, core.stream_offset)
+          : nullptr);
+        api_error res = api_error::Success;
+        if (!page) {
+          ae = core.stream_length ? api_error::Memory : api_error::Sanitize;
+          return 0u;
+        }
+        unsigned char const* from =
+          static_cast<unsigned char const*>(page->get());
+        unsigned char const* const from_end = from+core.stream_length;
+        for (size_t i = 0u; i < table_count; ++i) {
+          woff2_entry& entry = core.entries[i];
+          offset_line const& line = offsets[i];
+          if (entry.transformed) {
+            /* transformed tables go aside for reconstruction */
+            entry.checksum = 0u;
+            if (line.length == 0u)
+              continue;
+            try {
+              scratch[i].resize(line.length);
+            } catch (std::bad_alloc const& ) {
+              ae = api_error::Memory;
+              return 0u;
+            }
+            unsigned char* const to = scratch[i].data();
+            res = woff2_inflate(state, from, from_end, to, to+line.length,
+              nullptr);
+            if (res < api_error::Success) {
+              ae = res;
+              return 0u;
+            }
+          } else if (line.length > 0u) {
+            unsigned char* const to = dst+entry.sfnt_offset;
+            uint32 sum = 0u;
+            res = woff2_inflate(state, from, from_end, to, to+line.length,
+              &sum);
+            if (res < api_error::Success) {
+              ae = res;
+              return 0u;
+            }
+            entry.checksum = sum;
+          } else entry.checksum = 0u;
+        }
+        /* the stream must end with the last table */
+        if (res != api_error::EndOfFile) {
+          unsigned char extra;
+          unsigned char* extra_next = &extra;
+          res = brcvt_in(state, from, from_end, from,
+            &extra, &extra+1, extra_next);
+          if (res != api_error::EndOfFile || extra_next != &extra) {
+            ae = api_error::Sanitize;
+            return 0u;
+          }
+        }
+      }
+      if (core.transform_size) {
+        api_error const res =
+          woff2_reconstruct(core, offsets, scratch, dst, pool, rebuilt);
+        if (res != api_error::Success) {
+          ae = res;
+          return 0u;
+        } else if (dst_size < core.decoded_size) {
+          ae = api_error::BlockOverflow;
+          return 0u;
+        }
+        std::vector<std::vector<unsigned char>>().swap(scratch);
+        for (woff2_glyf_table const& table : rebuilt.glyfs) {
+          woff2_entry& glyf = core.entries[table.glyf_index];
+          woff2_entry& loca = core.entries[table.loca_index];
+          woff2_glyf_store(table, dst+glyf.sfnt_offset, dst+loca.sfnt_offset);
+          glyf.checksum = 0u;
+          for (woff2_glyf_job const& job : table.runs)
+            glyf.checksum += job.sum;
+          glyf.checksum &= 0xFFffFFffu;
+          loca.checksum = sfnt_checksum(dst+loca.sfnt_offset,
+            loca.orig_length);
+        }
+        for (woff2_hmtx_table const& table : rebuilt.hmtxs) {
+          woff2_entry& hmtx = core.entries[table.index];
+          std::memcpy(dst+hmtx.sfnt_offset,
+            table.data.data(), table.data.size());
+          hmtx.checksum = sfnt_checksum(table.data.data(), table.data.size());
+        }
+      }
+      /* pad the tables; checksums came with the data */
+      for (size_t i = 0u; i < table_count; ++i) {
+        woff2_entry& entry = core.entries[i];
+        unsigned char* const table = dst+entry.sfnt_offset;
+        size_t const padded = woff2_pad4(entry.orig_length);
+        std::memset(table+entry.orig_length, 0, padded-entry.orig_length);
+        if (std::memcmp(offsets[i].tag, woff2_head, 4) == 0
+        &&  entry.orig_length >= 12u)
+        {
+          /* sum without `checkSumAdjustment` */
+          entry.checksum = (entry.checksum - woff2_read_u32be(table+8))
+            & 0xFFffFFffu;
+          std::memset(table+8, 0, 4);
+        }
+      }
+      /* write the table directories */{
+        size_t const font_count = core.fonts.size();
+        if (core.flavor == woff2_ttcf) {
+          woff2_write_u32be(dst, woff2_ttcf);
+          woff2_write_u32be(dst+4, core.collection_version);
+          woff2_write_u32be(dst+8, static_cast<uint32>(font_count));
+          for (size_t j = 0u; j < font_count; ++j) {
+            woff2_write_u32be(dst+12u+4u*j, core.fonts[j].directory_offset);
+          }
+          if (core.collection_version >= 0x20000u) {
+            /* no digital signature */
+            std::memset(dst+12u+4u*font_count, 0, 12u);
+          }
+        }
+        for (woff2_font const& font : core.fonts) {
+          uint32 sum = woff2_write_directory(core, offsets, font, dst);
+          unsigned short head_index = 0xFFFFu;
+          for (unsigned short const i : font.tables) {
+            sum += core.entries[i].checksum;
+            if (std::memcmp(offsets[i].tag, woff2_head, 4) == 0)
+              head_index = i;
+          }
+          if (head_index != 0xFFFFu
+          &&  core.entries[head_index].orig_length >= 12u)
+          {
+            woff2_write_u32be(dst+core.entries[head_index].sfnt_offset+8,
+              (0xB1B0AFBAu-sum)&0xFFffFFffu);
+          }
+        }
+      }
+      ae = api_error::Success;
+      return core.decoded_size;
+    }
+
+    table_span woff2::table(unsigned char const* tag, api_error& ae) noexcept
+    {
+      table_span out = { nullptr, 0u };
+      if (!this->core || !this->offsets || !this->fh) {
+        ae = api_error::Init;
+        return out;
+      }
+      offset_table const& offsets = *this->offsets;
+      size_t const i = offsets.find(tag);
+      if (i >= offsets.size()) {
+        ae = api_error::OutOfRange;
+        return out;
+      }
+      ae = woff2_lazy_table(*this->core, offsets, this->fh, i, out);
+      if (ae != api_error::Success)
+        out = table_span{ nullptr, 0u };
+      return out;
+    }
+
+    table_span woff2::table(unsigned char const* tag) {
+      api_error ae;
+      table_span const out = table(tag, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return out;
+    }
+
+    size_t woff2::decode_sfnt(unsigned char* dst, size_t dst_size) {
+      return decode_sfnt(dst, dst_size, nullptr);
+    }
+
+    size_t woff2::decode_sfnt
+        (unsigned char* dst, size_t dst_size, task_pool* pool)
+    {
+      api_error ae;
+      size_t const out = decode_sfnt(dst, dst_size, pool, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return out;
+    }
     //END   woff2 / public
+
+    //BEGIN woff2 / growable
+    size_t woff2_decode_grow(woff2& src, std::vector<unsigned char>& arena,
+        brcvt_state* state, task_pool* pool, api_error& ae) noexcept
+    {
+      std::unique_ptr<brcvt_state> own_state;
+      if (!state) {
+        own_state = brcvt_unique(4096u, 16777200u, 1u);
+        if (!own_state) {
+          ae = api_error::Memory;
+          return 0u;
+        }
+        state = own_state.get();
+      }
+      size_t len = 0u;
+      /* a first decode may only measure the reconstructed tables */
+      for (int attempt = 0; attempt < 2; ++attempt) {
+        size_t const n = src.sfnt_size();
+        if (arena.size() < n) {
+          /* the old contents are not needed, so skip the copy */
+          try {
+            std::vector<unsigned char>(n).swap(arena);
+          } catch (std::bad_alloc const& ) {
+            ae = api_error::Memory;
+            return 0u;
+          }
+        }
+        if (attempt > 0) {
+          brcvt_reset(*state, ae);
+          if (ae != api_error::Success)
+            return 0u;
+        }
+        len = src.decode_sfnt(arena.data(), arena.size(), *state, pool, ae);
+        if (ae != api_error::BlockOverflow)
+          break;
+      }
+      return len;
+    }
+
+    size_t woff2_decode_file(mmaptwo::mmaptwo_i* xfh,
+        std::vector<unsigned char>& arena, brcvt_state* state,
+        task_pool* pool, api_error& ae) noexcept
+    {
+      if (!xfh) {
+        ae = api_error::Param;
+        return 0u;
+      }
+      size_t const length = xfh->length();
+      std::unique_ptr<mmaptwo::page_i> const page(xfh->acquire(length, 0u));
+      if (!page) {
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+      mmaptwo::mmaptwo_i* const m2i =
+        mmaptwo::memopen(page->get(), length, false);
+      if (!m2i) {
+        ae = api_error::Memory;
+        return 0u;
+      }
+      util_unique_ptr<woff2> const src = woff2_unique(m2i);
+      if (!src) {
+        delete m2i;
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+      return woff2_decode_grow(*src, arena, state, pool, ae);
+    }
+    //END   woff2 / growable
+
+    //BEGIN woff2 encoder / rule-of-six
+    woff2_encoder::woff2_encoder
+        (uint32 block_size, uint32 n, size_t chain_length)
+      : core(new woff2_encoder_core())
+    {
+      core->block_size = block_size;
+      core->window_size = n;
+      core->chain_length = chain_length;
+    }
+
+    woff2_encoder::~woff2_encoder(void) {
+      if (core) {
+        delete core;
+      }
+      return;
+    }
+
+    woff2_encoder::woff2_encoder(woff2_encoder&& other) noexcept
+      : core(nullptr)
+    {
+      transfer(static_cast<woff2_encoder&&>(other));
+      return;
+    }
+
+    woff2_encoder& woff2_encoder::operator=(woff2_encoder&& other) noexcept {
+      transfer(static_cast<woff2_encoder&&>(other));
+      return *this;
+    }
+
+    void woff2_encoder::transfer(woff2_encoder&& other) noexcept {
+      woff2_encoder_core *n_core = other.core;
+      other.core = nullptr;
+      if (this->core) {
+        delete this->core;
+      }
+      this->core = n_core;
+      return;
+    }
+    //END   woff2 encoder / rule-of-six
+
+    //BEGIN woff2 encoder / allocation
+    void* woff2_encoder::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* woff2_encoder::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void woff2_encoder::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void woff2_encoder::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    woff2_encoder* woff2_encoder_new
+        (uint32 block_size, uint32 n, size_t chain_length) noexcept
+    {
+      try {
+        return new woff2_encoder(block_size, n, chain_length);
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<woff2_encoder> woff2_encoder_unique
+        (uint32 block_size, uint32 n, size_t chain_length) noexcept
+    {
+      return util_unique_ptr<woff2_encoder>
+        (woff2_encoder_new(block_size, n, chain_length));
+    }
+
+    void woff2_encoder_destroy(woff2_encoder* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   woff2 encoder / allocation
+
+    //BEGIN woff2 encoder / public
+    size_t woff2_encoder::encode
+        (sfnt const& src, task_pool* pool, api_error& ae) noexcept
+    {
+      if (!this->core) {
+        ae = api_error::Init;
+        return 0u;
+      }
+      try {
+        woff2_encode_sfnt(*this->core, src, pool);
+      } catch (api_exception const& e) {
+        this->core->out.clear();
+        ae = e.to_error();
+        return 0u;
+      } catch (std::bad_alloc const& ) {
+        this->core->out.clear();
+        ae = api_error::Memory;
+        return 0u;
+      }
+      ae = api_error::Success;
+      return this->core->out.size();
+    }
+
+    size_t woff2_encoder::encode(sfnt const& src, task_pool* pool) {
+      api_error ae;
+      size_t const out = encode(src, pool, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return out;
+    }
+
+    unsigned char const* woff2_encoder::get_data(void) const noexcept {
+      if (!this->core || this->core->out.empty())
+        return nullptr;
+      return this->core->out.data();
+    }
+
+    size_t woff2_encoder::size(void) const noexcept {
+      return this->core ? this->core->out.size() : 0u;
+    }
+    //END   woff2 encoder / public
   };
 };
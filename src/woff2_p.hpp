@@ -0,0 +1,50 @@
+/**
+ * @file tcmplx-access-plus/woff2_p.hpp
+ * @brief WOFF2 decoding into growable buffers
+ */
+#ifndef hg_TextComplexAccessP_Woff2_pH_
+#define hg_TextComplexAccessP_Woff2_pH_
+
+#include "text-complex-plus/access/woff2.hpp"
+#include <vector>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Decode a font into a buffer that grows as needed.
+     * @param src the font to decode
+     * @param[in,out] arena output buffer; grown to fit the image
+     * @param state (nullable) decompressor for the table stream, either
+     *   new or reset by @link brcvt_reset @endlink
+     * @param pool (nullable) worker threads for rebuilding glyphs
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   api_error::Sanitize on a bad table stream,
+     *   other value on failure
+     * @return the number of bytes written to the start of the arena
+     * @note A first decode may only measure the reconstructed tables.
+     *   If it reports api_error::BlockOverflow, the arena grows to the
+     *   measured size and the decode runs once more.
+     */
+    size_t woff2_decode_grow(woff2& src, std::vector<unsigned char>& arena,
+        brcvt_state* state, task_pool* pool, api_error& ae) noexcept;
+
+    /**
+     * @brief Decode a WOFF2 file into a buffer that grows as needed.
+     * @param xfh source file; not owned
+     * @param[in,out] arena output buffer; grown to fit the image
+     * @param state (nullable) decompressor for the table stream, either
+     *   new or reset by @link brcvt_reset @endlink
+     * @param pool (nullable) worker threads for rebuilding glyphs
+     * @param[out] ae @em error-code api_error::Success on success,
+     *   api_error::Sanitize on a bad file,
+     *   other value on failure
+     * @return the number of bytes written to the start of the arena
+     * @note The file is mapped whole for the length of the call.
+     */
+    size_t woff2_decode_file(mmaptwo::mmaptwo_i* xfh,
+        std::vector<unsigned char>& arena, brcvt_state* state,
+        task_pool* pool, api_error& ae) noexcept;
+  };
+};
+
+#endif //hg_TextComplexAccessP_Woff2_pH_
@@ -0,0 +1,339 @@
+/**
+ * @file tcmplx-access-plus/woff2batch.cpp
+ * @brief Batch decoding of WOFF2 files
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#include "text-complex-plus/access/woff2batch.hpp"
+#include "text-complex-plus/access/woff2.hpp"
+#include "woff2_p.hpp"
+#include "text-complex-plus/access/brcvt.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include <new>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <system_error>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief Per-worker state kept across files and batches.
+     */
+    struct woff2batch_worker {
+      std::mutex lock;
+      /** @brief Files waiting for this worker, taken from the front. */
+      std::deque<size_t> queue;
+      /** @brief Brotli state for table streams. */
+      util_unique_ptr<brcvt_state> state;
+      /** @brief Whether the Brotli state needs a reset before use. */
+      bool dirty;
+      /** @brief Scratch arena for decoded images. */
+      std::vector<unsigned char> arena;
+
+      woff2batch_worker(void) : dirty(false) {}
+    };
+
+    /**
+     * @brief Workers of a batch decoder.
+     */
+    struct woff2batch_core {
+      std::vector<std::unique_ptr<woff2batch_worker>> workers;
+    };
+
+    /**
+     * @brief Parameters of one batch run, shared by its workers.
+     */
+    struct woff2batch_run {
+      woff2batch_core* core;
+      mmaptwo::mmaptwo_i* const* sources;
+      woff2batch_callback fn;
+      void* arg;
+    };
+
+    /**
+     * @brief Take the next file for a worker, stealing if need be.
+     * @param run the batch run
+     * @param self index of the worker
+     * @param[out] index the file to decode
+     * @return whether a file was found
+     */
+    static
+    bool woff2batch_next
+      (woff2batch_run const& run, unsigned int self, size_t& index) noexcept;
+    /**
+     * @brief Move half of another worker's queue to this worker.
+     * @param run the batch run
+     * @param self index of the thief
+     * @return whether anything was stolen
+     */
+    static
+    bool woff2batch_steal(woff2batch_run const& run, unsigned int self)
+      noexcept;
+    /**
+     * @brief Prepare a worker's Brotli state for a new stream.
+     * @param worker the worker
+     * @return api_error::Success on success, other value on failure
+     */
+    static
+    api_error woff2batch_prepare(woff2batch_worker& worker) noexcept;
+    /**
+     * @brief Decode one file into a worker's arena.
+     * @param worker the worker
+     * @param xfh (nullable) the file
+     * @param[out] result outcome of the decode
+     */
+    static
+    void woff2batch_decode(woff2batch_worker& worker,
+        mmaptwo::mmaptwo_i* xfh, woff2batch_result& result) noexcept;
+    /**
+     * @brief Worker loop.
+     * @param run the batch run
+     * @param self index of the worker
+     */
+    static
+    void woff2batch_work(woff2batch_run const* run, unsigned int self)
+      noexcept;
+
+    //BEGIN woff2 batch / static
+    bool woff2batch_next
+      (woff2batch_run const& run, unsigned int self, size_t& index) noexcept
+    {
+      woff2batch_worker& worker = *run.core->workers[self];
+      do {
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if (!worker.queue.empty()) {
+          index = worker.queue.front();
+          worker.queue.pop_front();
+          return true;
+        }
+      } while (woff2batch_steal(run, self));
+      return false;
+    }
+
+    bool woff2batch_steal(woff2batch_run const& run, unsigned int self)
+      noexcept
+    {
+      size_t const n = run.core->workers.size();
+      std::deque<size_t> loot;
+      for (size_t k = 1u; k < n; ++k) {
+        woff2batch_worker& victim = *run.core->workers[(self+k)%n];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        size_t const total = victim.queue.size();
+        if (total == 0u)
+          continue;
+        /* the back half, which the victim would reach last */
+        size_t const take = (total+1u)/2u;
+        try {
+          loot.assign(victim.queue.end()-take, victim.queue.end());
+        } catch (std::bad_alloc const& ) {
+          return false;
+        }
+        victim.queue.erase(victim.queue.end()-take, victim.queue.end());
+        break;
+      }
+      if (loot.empty())
+        return false;
+      woff2batch_worker& worker = *run.core->workers[self];
+      std::lock_guard<std::mutex> guard(worker.lock);
+      worker.queue.swap(loot);
+      return true;
+    }
+
+    api_error woff2batch_prepare(woff2batch_worker& worker) noexcept {
+      api_error ae = api_error::Success;
+      if (!worker.state) {
+        worker.state = brcvt_unique(4096u, 16777200u, 1u);
+        if (!worker.state)
+          return api_error::Memory;
+      } else if (worker.dirty) {
+        brcvt_reset(*worker.state, ae);
+        if (ae != api_error::Success)
+          return ae;
+      }
+      worker.dirty = true;
+      return ae;
+    }
+
+    void woff2batch_decode(woff2batch_worker& worker,
+        mmaptwo::mmaptwo_i* xfh, woff2batch_result& result) noexcept
+    {
+      result.data = nullptr;
+      result.size = 0u;
+      if (!xfh) {
+        result.status = api_error::Param;
+        return;
+      }
+      api_error ae = woff2batch_prepare(worker);
+      size_t len = 0u;
+      if (ae == api_error::Success) {
+        len = woff2_decode_file(xfh, worker.arena, worker.state.get(),
+          nullptr, ae);
+      }
+      result.status = ae;
+      if (ae == api_error::Success) {
+        result.data = worker.arena.data();
+        result.size = len;
+      }
+      return;
+    }
+
+    void woff2batch_work(woff2batch_run const* run, unsigned int self)
+      noexcept
+    {
+      woff2batch_worker& worker = *run->core->workers[self];
+      size_t index;
+      while (woff2batch_next(*run, self, index)) {
+        woff2batch_result result;
+        result.index = index;
+        result.worker = self;
+        woff2batch_decode(worker, run->sources[index], result);
+        run->fn(run->arg, result);
+      }
+      return;
+    }
+    //END   woff2 batch / static
+
+    //BEGIN woff2 batch / rule-of-six
+    woff2_batch::woff2_batch(unsigned int threads)
+      : core(nullptr)
+    {
+      if (threads == 0u)
+        threads = std::thread::hardware_concurrency();
+      if (threads == 0u)
+        threads = 1u;
+      std::unique_ptr<woff2batch_core> n_core(new woff2batch_core());
+      n_core->workers.reserve(threads);
+      for (unsigned int i = 0u; i < threads; ++i)
+        n_core->workers.emplace_back(new woff2batch_worker());
+      core = n_core.release();
+      return;
+    }
+
+    woff2_batch::~woff2_batch(void) {
+      delete util_exchange(core, nullptr);
+      return;
+    }
+
+    woff2_batch::woff2_batch(woff2_batch&& other) noexcept
+      : core(util_exchange(other.core, nullptr))
+    {
+      return;
+    }
+
+    woff2_batch& woff2_batch::operator=(woff2_batch&& other) noexcept {
+      transfer(static_cast<woff2_batch&&>(other));
+      return *this;
+    }
+
+    void woff2_batch::transfer(woff2_batch&& other) noexcept {
+      woff2batch_core* const n_core = util_exchange(other.core, nullptr);
+      delete util_exchange(core, n_core);
+      return;
+    }
+    //END   woff2 batch / rule-of-six
+
+    //BEGIN woff2 batch / allocation
+    void* woff2_batch::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* woff2_batch::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void woff2_batch::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void woff2_batch::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+    //END   woff2 batch / allocation
+
+    //BEGIN woff2 batch / public
+    unsigned int woff2_batch::size(void) const noexcept {
+      return core ? static_cast<unsigned int>(core->workers.size()) : 0u;
+    }
+
+    void woff2_batch::decode(mmaptwo::mmaptwo_i* const* sources,
+        size_t count, woff2batch_callback fn, void* arg,
+        api_error& ae) noexcept
+    {
+      if (!core) {
+        ae = api_error::Init;
+        return;
+      } else if (!fn || (count && !sources)) {
+        ae = api_error::Param;
+        return;
+      }
+      size_t const n = core->workers.size();
+      /* split the files evenly, in order */
+      try {
+        for (size_t w = 0u; w < n; ++w) {
+          woff2batch_worker& worker = *core->workers[w];
+          size_t const start = (count/n)*w + std::min(w, count%n);
+          size_t const stop = start + count/n + (w < count%n ? 1u : 0u);
+          worker.queue.clear();
+          for (size_t i = start; i < stop; ++i)
+            worker.queue.push_back(i);
+        }
+      } catch (std::bad_alloc const& ) {
+        for (std::unique_ptr<woff2batch_worker>& worker : core->workers)
+          worker->queue.clear();
+        ae = api_error::Memory;
+        return;
+      }
+      woff2batch_run const run = { core, sources, fn, arg };
+      std::vector<std::thread> threads;
+      /* helpers that fail to start leave their files to be stolen */
+      try {
+        threads.reserve(n-1u);
+        for (unsigned int w = 1u; w < n; ++w)
+          threads.emplace_back(woff2batch_work, &run, w);
+      } catch (std::system_error const& ) {
+      } catch (std::bad_alloc const& ) {
+      }
+      woff2batch_work(&run, 0u);
+      for (std::thread& t : threads)
+        t.join();
+      ae = api_error::Success;
+      return;
+    }
+
+    void woff2_batch::decode(mmaptwo::mmaptwo_i* const* sources,
+        size_t count, woff2batch_callback fn, void* arg)
+    {
+      api_error ae;
+      decode(sources, count, fn, arg, ae);
+      if (ae != api_error::Success)
+        throw api_exception(ae);
+      return;
+    }
+    //END   woff2 batch / public
+
+    //BEGIN woff2 batch / namespace local
+    woff2_batch* woff2batch_new(unsigned int threads) noexcept {
+      try {
+        return new woff2_batch(threads);
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<woff2_batch> woff2batch_unique(unsigned int threads)
+      noexcept
+    {
+      return util_unique_ptr<woff2_batch>(woff2batch_new(threads));
+    }
+
+    void woff2batch_destroy(woff2_batch* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   woff2 batch / namespace local
+  };
+};
@@ -5,6 +5,7 @@
 #define TCMPLX_AP_WIN32_DLL_INTERNAL
 #include "text-complex-plus/access/zcvt.hpp"
 #include "text-complex-plus/access/zutil.hpp"
+#include "cvtstats_p.hpp"
 #include <limits>
 #include <new>
 #include <algorithm>
@@ -621,7 +622,10 @@ namespace text_complex {
           std::size_t const from_count = from_end - p;
           std::size_t const min_count = (input_space < from_count)
             ? static_cast<std::size_t>(input_space) : from_count;
-          state.buffer.write(p, min_count, ae);
+          /* */{
+            cvtstats_timer const timer(state.stats.window_ns);
+            state.buffer.write(p, min_count, ae);
+          }
           if (ae != api_error::Success)
             break;
           state.checksum = zutil_adler32(min_count, p, state.checksum);
@@ -634,15 +638,25 @@ namespace text_complex {
           }
           /* try compress the data */if (state.count == 0u) {
             bool dynamic = false;
+            bool const sync_flush =
+              (state.buffer.input_size() == 0u && state.h_end == 4u);
             if (state.buffer.input_size() == 0u && (!state.h_end)) {
               /* stash the current byte to the side */
               ae = api_error::Partial;
               break;
             } else {
               state.buffer.clear_output();
-              state.buffer.try_block(ae);
+              if (!sync_flush) {
+                cvtstats_timer const timer(state.stats.match_ns);
+                state.buffer.try_block(state.stats, ae);
+              }
             }
-            if (ae == api_error::Success) {
+            if (sync_flush) {
+              /* empty stored block */
+              state.h_end = 0u;
+              state.bits = 0u;
+              cvtstats_add(state.stats.stored_blocks, 1u);
+            } else if (ae == api_error::Success) {
               /* histogram */
               block_string const& buffer_str = state.buffer.str();
               uint32 const buffer_size = buffer_str.size();
@@ -661,6 +675,7 @@ namespace text_complex {
                   break;
               }
               /* calculate histogram */{
+                cvtstats_timer histogram_timer(state.stats.histogram_ns);
                 for (uint32 buffer_pos = 0u; buffer_pos < buffer_size; ++buffer_pos) {
                   unsigned char const byt = buffer_str[buffer_pos];
                   bool const insert_flag = ((byt&128u)==0u);
@@ -713,7 +728,7 @@ namespace text_complex {
                       unsigned int const dist_code =
                         state.try_ring.encode(distance+1, extra, 0, ae);
                       if (ae == api_error::Success) {
-                        bit_count += extra;
+                        bit_count += state.try_ring.bit_count(dist_code);
                         state.dist_histogram[dist_code] += 1u;
                       } else break;
                     } else break;
@@ -723,9 +738,11 @@ namespace text_complex {
                 }
                 // Ensure the stop code.
                 state.lit_histogram[256] = 1;
+                histogram_timer.stop();
                 if (ae != api_error::Success)
                   break;
                 else/* plant two trees */{
+                  cvtstats_timer const tree_timer(state.stats.tree_ns);
                   /* dynamic Huffman codes */{
                     for (unsigned j = 0u; j < 288u; ++j) {
                       state.literals[j].value = j;
@@ -741,9 +758,11 @@ namespace text_complex {
                     api_error lit_ae;
                     api_error dist_ae;
                     fixlist_gen_lengths
-                      (state.literals, state.lit_histogram, 15u, lit_ae);
+                      ( state.literals, state.lit_histogram, 15u,
+                        state.length_scratch, lit_ae);
                     fixlist_gen_lengths
-                      (state.distances, state.dist_histogram, 15u, dist_ae);
+                      ( state.distances, state.dist_histogram, 15u,
+                        state.length_scratch, dist_ae);
                     ae = zcvt_nonzero(lit_ae, dist_ae);
                     if (ae != api_error::Success)
                       break;
@@ -774,7 +793,8 @@ namespace text_complex {
                   }
                   /* length lengths */{
                     fixlist_gen_lengths
-                      (state.sequence, state.seq_histogram, 7u, ae);
+                      ( state.sequence, state.seq_histogram, 7u,
+                        state.length_scratch, ae);
                     if (ae != api_error::Success)
                       break;
                   }
@@ -809,6 +829,8 @@ namespace text_complex {
               if (ae == api_error::Success) {
                 state.bits = (state.h_end&1u) | (dynamic?4u:0u);
                 state.buffer.clear_input();
+                cvtstats_add(dynamic
+                  ? state.stats.dynamic_blocks : state.stats.stored_blocks, 1u);
               }
             } else break;
           }
@@ -835,6 +857,7 @@ namespace text_complex {
           break;
         case 19: /* generate code trees */
           /* */{
+            cvtstats_timer const timer(state.stats.tree_ns);
             api_error lit_ae;
             api_error dist_ae;
             fixlist_gen_codes(state.literals, lit_ae);
@@ -1147,13 +1170,15 @@ namespace text_complex {
         literals(288u), distances(32u), sequence(19u), values(286u),
         ring(false,4,0), try_ring(false,4,0),
         lit_histogram(288u), dist_histogram(32u), seq_histogram(19u),
+        length_scratch(288u*2u),
         bits(0u), extra_length(0u), h_end(0u), bit_length(0u), state(0u), bit_index(0u),
-        backward(0u), count(0u), index(0u), checksum(0u),
-        bit_cap(0u), write_scratch(0)
+        backward(0u), count(0u), index(0u), checksum(1u),
+        bit_cap(0u), write_scratch(0), stats()
     {
       inscopy_preset(values, insert_copy_preset::Deflate);
       inscopy_codesort(values);
       sequence_list.reserve(286u+30u);
+      /* DEFLATE copies top out at 258 bytes */buffer.set_copy_limit(258u);
       return;
     }
     //END   zcvt_state / rule-of-zero
@@ -1231,8 +1256,9 @@ namespace text_complex {
               ae = api_error::Success;
               state.state = 1;
               state.count = 0;
+              /* keep the checksum of any dictionary given up front */
               state.backward = state.checksum;
-              state.checksum = 1u;
+              state.checksum = 0u;
             } else {
               state.count = 0u;
               state.state = 3;
@@ -1247,7 +1273,11 @@ namespace text_complex {
           }
           if (state.count >= 4u) {
             state.state = 2;
-            ae = api_error::ZDictionary;
+            if (state.buffer.ring_size() == 0u
+            ||  state.backward != state.checksum)
+            {
+              ae = api_error::ZDictionary;
+            }
           } break;
         case 2: /* check dictionary checksum */
         case 3: /* block start */
@@ -1274,6 +1304,11 @@ namespace text_complex {
             unsigned int const nlen = (~state.backward>>16)&65535u;
             if (len != nlen) {
               ae = api_error::Sanitize;
+            } else if (len == 0u) {
+              /* empty block: next byte belongs to the next block */
+              state.state = (state.h_end ? 6 : 3);
+              state.count = 0u;
+              state.backward = 0u;
             } else {
               state.backward = len;
               state.state = 5;
@@ -1334,6 +1369,9 @@ namespace text_complex {
         if (ae > api_error::Success)
           /* */break;
       }
+      cvtstats_add(state.stats.bytes_in, static_cast<std::size_t>(p-from));
+      cvtstats_add(state.stats.bytes_out,
+        static_cast<std::size_t>(to_out-to));
       from_next = p;
       to_next = to_out;
       return ae;
@@ -1343,10 +1381,11 @@ namespace text_complex {
       (zcvt_state& state, unsigned char const* buf, size_t sz, api_error& ae)
       noexcept
     {
-      if (state.state >= 2u) {
+      if (state.state > 2u) {
         ae = api_error::Sanitize;
         return 0u;
       } else {
+        cvtstats_timer const timer(state.stats.window_ns);
         size_t const n = state.buffer.bypass(buf, sz, ae);
         if (state.state == 0u) {
           /* output direction */
@@ -1359,6 +1398,67 @@ namespace text_complex {
       }
     }
 
+    size_t zcvt_set_dictionary
+      (zcvt_state& state, unsigned char const* buf, size_t sz, api_error& ae)
+      noexcept
+    {
+      if (state.state == 0u && state.count == 0u) {
+        /* before the stream header, in either direction */
+        if (state.buffer.ring_size() != 0u) {
+          ae = api_error::Sanitize;
+          return 0u;
+        }
+        ae = api_error::Success;
+        size_t const n = state.buffer.bypass(buf, sz, ae);
+        state.checksum = zutil_adler32(n, buf, 1u);
+        return n;
+      } else if (state.state == 2u) {
+        /* input direction, after api_error::ZDictionary */
+        if (state.buffer.ring_size() != 0u) {
+          ae = api_error::Sanitize;
+          return 0u;
+        } else if (zutil_adler32(sz, buf, 1u) != state.checksum) {
+          /* leave the window alone, so the caller can try again */
+          ae = api_error::ZDictionary;
+          return 0u;
+        }
+        ae = api_error::Success;
+        size_t const n = state.buffer.bypass(buf, sz, ae);
+        if (ae != api_error::Success)
+          return n;
+        state.state = 3u;
+        state.count = 0u;
+        state.bits = 0u;
+        state.checksum = 1u;
+        return n;
+      } else {
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+    }
+
+    size_t zcvt_continue
+      (zcvt_state& state, unsigned char const* buf, size_t sz, api_error& ae)
+      noexcept
+    {
+      if (state.state != 0u || state.count != 0u) {
+        ae = api_error::Sanitize;
+        return 0u;
+      }
+      ae = api_error::Success;
+      size_t const n = state.buffer.bypass(buf, sz, ae);
+      if (ae != api_error::Success)
+        return n;
+      inscopy_lengthsort(state.values, ae);
+      if (ae != api_error::Success)
+        return n;
+      /* skip the stream header */
+      state.state = 3u;
+      state.checksum = 1u;
+      state.backward = 0u;
+      return n;
+    }
+
     api_error zcvt_out(zcvt_state& state,
         unsigned char const* from, unsigned char const* from_end,
         unsigned char const*& from_next,
@@ -1368,6 +1468,7 @@ namespace text_complex {
       api_error ae = api_error::Success;
       unsigned char* to_out;
       unsigned char const* p = from;
+      cvtstats_call call(state.stats);
       for (to_out = to; to_out < to_end && ae == api_error::Success;
           ++to_out)
       {
@@ -1412,7 +1513,7 @@ namespace text_complex {
         case 1: /* dictionary checksum */
           if (state.count < 4u) {
             *to_out = static_cast<unsigned char>(
-                  (state.checksum>>(32u-state.count*8u))&255u
+                  (state.checksum>>(24u-state.count*8u))&255u
                 );
             state.count += 1u;
           }
@@ -1487,6 +1588,8 @@ namespace text_complex {
         if (ae >= api_error::Partial)
           break;
       }
+      call.done(static_cast<std::size_t>(p-from),
+        static_cast<std::size_t>(to_out-to));
       from_next = p;
       to_next = to_out;
       return ae;
@@ -1501,6 +1604,17 @@ namespace text_complex {
       /* set the end flag: */state.h_end |= 2u;
       return zcvt_out(state, &tmp[0], &tmp[0], tmp_next, to, to_end, to_next);
     }
+
+    api_error zcvt_flush(zcvt_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next)
+    {
+      unsigned char const tmp[1] = {0u};
+      unsigned char const* tmp_next = &tmp[0];
+      /* set the flush flag: */if (!(state.h_end&2u))
+        state.h_end |= 4u;
+      return zcvt_out(state, &tmp[0], &tmp[0], tmp_next, to, to_end, to_next);
+    }
     //END   zcvt / namespace local
   };
 };
@@ -0,0 +1,186 @@
+/**
+ * @file tcmplx-access-plus/zpar.cpp
+ * @brief Parallel zlib compression state
+ */
+#define TCMPLX_AP_WIN32_DLL_INTERNAL
+#if (defined TextComplexAccessP_NO_EXCEPT)
+#  undef TextComplexAccessP_NO_EXCEPT
+#endif //TextComplexAccessP_NO_EXCEPT
+#include "text-complex-plus/access/zpar.hpp"
+#include "text-complex-plus/access/zcvt.hpp"
+#include "text-complex-plus/access/zutil.hpp"
+#include "segpar_p.hpp"
+#include <algorithm>
+
+namespace text_complex {
+  namespace access {
+    /**
+     * @brief zlib policy for the segment pipeline.
+     */
+    struct zpar_codec {
+      typedef zcvt_state state;
+      /** @brief Adler-32 checksum. */
+      typedef uint32 check;
+
+      static check check_start(void) noexcept {
+        return 1u;
+      }
+      static void cvt_continue(zcvt_state& cvt,
+          unsigned char const* buf, std::size_t size, api_error& ae)
+      {
+        zcvt_continue(cvt, buf, size, ae);
+      }
+      static api_error cvt_out(zcvt_state& cvt,
+          unsigned char const* from, unsigned char const* from_end,
+          unsigned char const*& from_next,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return zcvt_out(cvt, from, from_end, from_next, to, to_end, to_next);
+      }
+      static api_error cvt_flush(zcvt_state& cvt,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return zcvt_flush(cvt, to, to_end, to_next);
+      }
+      static api_error cvt_unshift(zcvt_state& cvt,
+          unsigned char* to, unsigned char* to_end, unsigned char*& to_next)
+      {
+        return zcvt_unshift(cvt, to, to_end, to_next);
+      }
+      static void record(check& c, zcvt_state const& cvt) noexcept {
+        c = cvt.checksum;
+      }
+      static api_error combine
+          (check& c, segpar_job<zpar_codec>& job) noexcept
+      {
+        c = zutil_adler32_combine(c, job.check, job.length);
+        if (job.last) {
+          /* replace the last segment's trailer with the full checksum */
+          std::size_t const sz = job.out.size();
+          if (sz < 4u)
+            return api_error::Sanitize;
+          for (std::size_t i = 0u; i < 4u; ++i) {
+            job.out[sz-4u+i] = static_cast<unsigned char>(
+                (c>>(24u-8u*i))&255u);
+          }
+        }
+        return api_error::Success;
+      }
+    };
+
+    struct zpar_core : segpar_core<zpar_codec> {
+      using segpar_core<zpar_codec>::segpar_core;
+    };
+
+    struct zpar_access {
+      static zpar_core* get(zpar_state& s) noexcept {
+        return s.core;
+      }
+    };
+
+    //BEGIN zpar_state / rule-of-six
+    zpar_state::zpar_state(uint32 block_size, uint32 n,
+        size_t chain_length, uint32 segment_size, unsigned int threads)
+      : core(nullptr)
+    {
+      if (segment_size == 0u)
+        throw api_exception(api_error::Param);
+      core = new zpar_core(block_size, std::min<uint32>(n, 32768u),
+        chain_length, segment_size, threads);
+      return;
+    }
+
+    zpar_state::~zpar_state(void) {
+      if (core)
+        delete core;
+      core = nullptr;
+      return;
+    }
+
+    zpar_state::zpar_state(zpar_state&& other) noexcept
+      : core(util_exchange(other.core, nullptr))
+    {
+      return;
+    }
+
+    zpar_state& zpar_state::operator=(zpar_state&& other) noexcept {
+      zpar_core* const old_core =
+        util_exchange(core, util_exchange(other.core, nullptr));
+      if (old_core)
+        delete old_core;
+      return *this;
+    }
+    //END   zpar_state / rule-of-six
+
+    //BEGIN zpar_state / allocation
+    void* zpar_state::operator new(std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void* zpar_state::operator new[](std::size_t sz) {
+      return ::operator new(sz);
+    }
+
+    void zpar_state::operator delete(void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    void zpar_state::operator delete[](void* p, std::size_t sz) noexcept {
+      return ::operator delete(p);
+    }
+
+    zpar_state* zpar_new
+        ( uint32 block_size, uint32 n, size_t chain_length,
+          uint32 segment_size, unsigned int threads) noexcept
+    {
+      try {
+        return new zpar_state(block_size,n,chain_length,segment_size,threads);
+      } catch (api_exception const& ) {
+        return nullptr;
+      } catch (std::bad_alloc const& ) {
+        return nullptr;
+      }
+    }
+
+    util_unique_ptr<zpar_state> zpar_unique
+        ( uint32 block_size, uint32 n, size_t chain_length,
+          uint32 segment_size, unsigned int threads) noexcept
+    {
+      return util_unique_ptr<zpar_state>(
+        zpar_new(block_size,n,chain_length,segment_size,threads));
+    }
+
+    void zpar_destroy(zpar_state* x) noexcept {
+      if (x) {
+        delete x;
+      }
+    }
+    //END   zpar_state / allocation
+
+    //BEGIN zpar_state / public
+    unsigned int zpar_state::threads(void) const noexcept {
+      return core ? core->pool.size() : 0u;
+    }
+    //END   zpar_state / public
+
+    //BEGIN zpar / namespace local
+    api_error zpar_out(zpar_state& state,
+        unsigned char const* from, unsigned char const* from_end,
+        unsigned char const*& from_next,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next)
+    {
+      return segpar_out<zpar_codec>(zpar_access::get(state),
+        from, from_end, from_next, to, to_end, to_next);
+    }
+
+    api_error zpar_unshift(zpar_state& state,
+        unsigned char* to, unsigned char* to_end,
+        unsigned char*& to_next)
+    {
+      return segpar_unshift<zpar_codec>(zpar_access::get(state),
+        to, to_end, to_next);
+    }
+    //END   zpar / namespace local
+  };
+};
@@ -29,6 +29,28 @@ namespace text_complex {
       } 
       return s1|(s2<<16);
     }
+
+    uint32 zutil_adler32_combine
+      (uint32 chk1, uint32 chk2, size_t len2) noexcept
+    {
+      constexpr uint32 base = 65521u;
+      uint32 const rem = static_cast<uint32>(len2 % base);
+      uint32 s1 = chk1&0xFFff;
+      uint32 s2 = static_cast<uint32>(
+          (static_cast<unsigned long long>(rem) * s1) % base);
+      /* the second sum already counts one (1) for each byte */
+      s1 += (chk2&0xFFff) + base - 1u;
+      s2 += (chk1>>16) + (chk2>>16) + base - rem;
+      if (s1 >= base)
+        s1 -= base;
+      if (s1 >= base)
+        s1 -= base;
+      if (s2 >= base*2u)
+        s2 -= base*2u;
+      if (s2 >= base)
+        s2 -= base;
+      return s1|(s2<<16);
+    }
     //END   zutil / namespace local
   };
 };
@@ -5,6 +5,7 @@
 #include "text-complex-plus/access/blockbuf.hpp"
 #include "munit-plus/munit.hpp"
 #include <vector>
+#include <algorithm>
 #include <memory>
 #include <cstdio>
 #include <cstdlib>
@@ -23,6 +24,14 @@ static MunitPlusResult test_blockbuf_bypass
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_blockbuf_add
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_blockbuf_long_copy
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_blockbuf_copy_limit
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_blockbuf_short_block
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_blockbuf_window
+    (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_blockbuf_str_cycle
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_blockbuf_str_item
@@ -51,6 +60,18 @@ static MunitPlusTest tests_blockbuf[] = {
   {(char*)"add", test_blockbuf_add,
       test_blockbuf_setup,test_blockbuf_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"long_copy", test_blockbuf_long_copy,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"copy_limit", test_blockbuf_copy_limit,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"short_block", test_blockbuf_short_block,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"window", test_blockbuf_window,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {(char*)"string/cycle", test_blockbuf_str_cycle,
       nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
@@ -382,6 +403,161 @@ MunitPlusResult test_blockbuf_add
 
 
 
+MunitPlusResult test_blockbuf_long_copy
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const count = munit_plus_rand_int_range(320,4096);
+  std::vector<unsigned char> buf(count, 0u);
+  (void)params;
+  (void)data;
+  text_complex::access::block_buffer p(4096, 32768, 16, false);
+  p.write(buf.data(), count);
+  p.flush();
+  /* expand the commands and compare */{
+    text_complex::access::block_string const& str = p.str();
+    std::size_t total = 0u;
+    std::size_t i = 0u;
+    while (i < str.size()) {
+      unsigned char const x = str[i++];
+      std::size_t len = x&63u;
+      if (x&64u)
+        len = (len<<8) + str[i++] + 64u;
+      if (x&128u) {
+        /* copy: skip the distance */
+        i += (str[i] >= 192u) ? 4u : 2u;
+      } else i += len;
+      total += len;
+    }
+    munit_plus_assert_size(i,==,str.size());
+    munit_plus_assert_size(total,==,count);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_blockbuf_copy_limit
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const count = munit_plus_rand_int_range(320,4096);
+  uint32_t const limit = munit_plus_rand_int_range(3,300);
+  std::vector<unsigned char> buf(count, 0u);
+  (void)params;
+  (void)data;
+  text_complex::access::block_buffer p(4096, 32768, 16, false);
+  p.set_copy_limit(limit);
+  munit_plus_assert_uint32(p.copy_limit(),==,limit);
+  p.write(buf.data(), count);
+  p.flush();
+  /* check each copy length */{
+    text_complex::access::block_string const& str = p.str();
+    std::size_t total = 0u;
+    std::size_t i = 0u;
+    while (i < str.size()) {
+      unsigned char const x = str[i++];
+      std::size_t len = x&63u;
+      if (x&64u)
+        len = (len<<8) + str[i++] + 64u;
+      if (x&128u) {
+        munit_plus_assert_size(len,<=,limit);
+        i += (str[i] >= 192u) ? 4u : 2u;
+      } else i += len;
+      total += len;
+    }
+    munit_plus_assert_size(total,==,count);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_blockbuf_short_block
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const tail = testfont_rand_size_range(1,3);
+  unsigned char buf[64];
+  (void)params;
+  (void)data;
+  text_complex::access::block_buffer p(64, 128, 16, false);
+  for (std::size_t i = 0u; i < sizeof(buf); ++i)
+    buf[i] = "abc"[i%3];
+  /* fill the window, leaving "bc" in the input buffer after "a" */{
+    p.write(buf, sizeof(buf));
+    p.flush();
+    p.clear_output();
+  }
+  /* the commands must cover the block and nothing past it */{
+    p.write(buf, tail);
+    p.flush();
+    text_complex::access::block_string const& str = p.str();
+    std::size_t total = 0u;
+    std::size_t i = 0u;
+    while (i < str.size()) {
+      unsigned char const x = str[i++];
+      std::size_t len = x&63u;
+      if (x&64u)
+        len = (len<<8) + str[i++] + 64u;
+      if (x&128u)
+        i += (str[i] >= 192u) ? 4u : 2u;
+      else i += len;
+      total += len;
+    }
+    munit_plus_assert_size(total,==,tail);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_blockbuf_window
+  (const MunitPlusParameter params[], void* data)
+{
+  uint32_t const window_size = 128u;
+  std::size_t const count = testfont_rand_size_range(8192,16384);
+  std::vector<unsigned char> buf(count);
+  std::vector<unsigned char> inflated_buf;
+  (void)params;
+  (void)data;
+  text_complex::access::block_buffer p(64, window_size, 16, false);
+  /* build the text */{
+    munit_plus_rand_memory(count, static_cast<munit_plus_uint8_t*>(buf.data()));
+    for (std::size_t i = 0; i < count; ++i)
+      buf[i] = (buf[i]&3u)|80u;
+  }
+  /* compress block by block, long after the window fills */
+  for (std::size_t pos = 0u; pos < count; ) {
+    std::size_t const piece = std::min<std::size_t>(p.capacity(), count-pos);
+    p.write(buf.data()+pos, piece);
+    p.flush();
+    pos += piece;
+    /* expand the commands */{
+      text_complex::access::block_string const& str = p.str();
+      std::size_t i = 0u;
+      while (i < str.size()) {
+        unsigned char const x = str[i++];
+        std::size_t len = x&63u;
+        if (x&64u)
+          len = (len<<8) + str[i++] + 64u;
+        if (x&128u) {
+          std::size_t backward;
+          munit_plus_assert_uchar(str[i]&0xC0, ==, 0x80)
+            /* short distance */;
+          backward = (str[i]&0x3f)*256 + str[i+1] + 1;
+          i += 2u;
+          /* every copy must come from inside the window */
+          munit_plus_assert_size(backward, <=, window_size);
+          munit_plus_assert_size(backward, <=, inflated_buf.size());
+          for (std::size_t k = 0u; k < len; ++k) {
+            inflated_buf.push_back
+              (inflated_buf[inflated_buf.size()-backward]);
+          }
+        } else {
+          inflated_buf.insert(inflated_buf.end(), &str[i], &str[i]+len);
+          i += len;
+        }
+      }
+    }
+    p.clear_output();
+  }
+  munit_plus_assert_size(inflated_buf.size(), ==, count);
+  munit_plus_assert_memory_equal(count, inflated_buf.data(), buf.data());
+  return MUNIT_PLUS_OK;
+}
+
 MunitPlusResult test_blockbuf_str_cycle
   (const MunitPlusParameter params[], void* data)
 {
@@ -5,6 +5,7 @@
 #include "text-complex-plus/access/brcvt.hpp"
 #include "text-complex-plus/access/brmeta.hpp"
 #include "text-complex-plus/access/blockbuf.hpp"
+#include "text-complex-plus/access/hashchain.hpp"
 #include "text-complex-plus/access/zutil.hpp"
 #include "munit-plus/munit.hpp"
 #include <memory>
@@ -12,6 +13,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 namespace tca = text_complex::access;
 
@@ -25,8 +27,44 @@ static MunitPlusResult test_brcvt_metadata_cycle
   (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_brcvt_zsrtostr_none
   (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_zsrtostr_implicit
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_zsrtostr_context
+  (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_brcvt_flush
   (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_prefix
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_stats
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_reset
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_narrow
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_meta_aligned
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_meta_resume
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_meta_short
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_literal_switch
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_context_simple
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_single_clen
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_blocktype_alpha
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_blockcount_alpha
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_single_tree
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_block_types
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_in_blockcount_range
+  (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brcvt_far_match
+  (const MunitPlusParameter params[], void* data);
 static void* test_brcvt_setup
     (const MunitPlusParameter params[], void* user_data);
 static void test_brcvt_teardown(void* fixture);
@@ -44,8 +82,44 @@ static MunitPlusTest tests_brcvt[] = {
     test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
   {(char*)"in/none", test_brcvt_zsrtostr_none,
     test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/implicit", test_brcvt_zsrtostr_implicit,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/context", test_brcvt_zsrtostr_context,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
   {(char*)"flush", test_brcvt_flush,
     test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"prefix", test_brcvt_prefix,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"stats", test_brcvt_stats,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"reset", test_brcvt_reset,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"in/narrow", test_brcvt_in_narrow,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"in/meta_aligned", test_brcvt_in_meta_aligned,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/meta_resume", test_brcvt_in_meta_resume,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/meta_short", test_brcvt_in_meta_short,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/literal_switch", test_brcvt_in_literal_switch,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"in/context_simple", test_brcvt_in_context_simple,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"in/single_clen", test_brcvt_in_single_clen,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/blocktype_alpha", test_brcvt_in_blocktype_alpha,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/blockcount_alpha", test_brcvt_in_blockcount_alpha,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"in/single_tree", test_brcvt_in_single_tree,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"block_types", test_brcvt_block_types,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"in/blockcount_range", test_brcvt_in_blockcount_range,
+    test_brcvt_setup,test_brcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,NULL},
+  {(char*)"far_match", test_brcvt_far_match,
+    nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -203,6 +277,78 @@ MunitPlusResult test_brcvt_zsrtostr_none
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_brcvt_zsrtostr_implicit
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * Two insert and two distance block types, all switched with zero-bit
+   * codes. The middle commands reuse the last distance implicitly, so
+   * only the last command may switch distance blocks; the insert block
+   * switch follows a copy with an implicit distance.
+   */
+  static unsigned char const buf[] = {
+      0x62, 0x02, 0x40, 0x44, 0x01, 0x8a, 0x28, 0x00,
+      0x00, 0x54, 0x98, 0x58, 0x45, 0x10, 0x49, 0x45,
+      0x10, 0x49, 0x40, 0xad, 0x38, 0x02
+    };
+  static char const text[] = "abababababababababab";
+  std::size_t const len = sizeof(text)-1;
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,32> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(len, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brcvt_zsrtostr_context
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * An uncompressed meta-block "ab", then two meta-blocks of one literal
+   * each. Both literal context maps send the contexts of 'b' and 'y'
+   * to a tree for 'y' and every other context to a tree for 'x'.
+   */
+  static unsigned char const buf[] = {
+      0x10, 0x00, 0x10, 0x61, 0x62, 0x00, 0x00, 0x00,
+      0x80, 0x50, 0x02, 0x00, 0x00, 0x00, 0x10, 0x00,
+      0x00, 0x08, 0x10, 0x78, 0x91, 0x17, 0x08, 0x04,
+      0x00, 0x00, 0x00, 0x00, 0x08, 0x25, 0x00, 0x00,
+      0x00, 0x00, 0x01, 0x00, 0x80, 0x00, 0x81, 0x17,
+      0x79, 0x81, 0x40, 0x00, 0x03
+    };
+  static char const text[] = "abyy";
+  std::size_t const len = sizeof(text)-1;
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,32> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(len, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
 
 MunitPlusResult test_brcvt_flush
   (const MunitPlusParameter params[], void* data)
@@ -254,6 +400,740 @@ MunitPlusResult test_brcvt_flush
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_brcvt_prefix
+  (const MunitPlusParameter params[], void* data)
+{
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,4096,16);
+  std::unique_ptr<tca::brcvt_state> const q =
+    tca::brcvt_unique(4096,4096,16);
+  unsigned char prefix[64];
+  unsigned char text[256];
+  unsigned char buf[512] = {0};
+  unsigned char* buf_end = buf;
+  tca::api_error ae;
+  munit_plus_rand_memory(sizeof(prefix), &prefix[0]);
+  if (!p || !q) {
+    return MUNIT_PLUS_SKIP;
+  }
+  (void)params;
+  (void)data;
+  /* build text out of prefix pieces */
+  for (size_t i = 0u; i < sizeof(text); i += 16u) {
+    int const start = munit_plus_rand_int_range(0,48);
+    std::memcpy(text+i, prefix+start, 16u);
+  }
+  /* encode */
+  {
+    unsigned char const *text_p = text;
+    size_t const n = tca::brcvt_set_prefix(*p, prefix, sizeof(prefix), ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+    munit_plus_assert(n == sizeof(prefix));
+    tca::api_error res = tca::brcvt_out(*p,
+      text, text+sizeof(text), text_p,
+      buf, buf+sizeof(buf), buf_end);
+    munit_plus_assert(res == tca::api_error::Partial);
+    res = tca::brcvt_unshift(*p, buf_end, buf+sizeof(buf), buf_end);
+    munit_plus_assert(res >= tca::api_error::EndOfFile);
+    munit_plus_assert(buf_end <= buf+sizeof(buf));
+    /* too late for another prefix */
+    tca::brcvt_set_prefix(*p, prefix, sizeof(prefix), ae);
+    munit_plus_assert(ae == tca::api_error::Sanitize);
+  }
+  /* decode with a prebuilt window */
+  {
+    tca::hash_chain window(4096,16);
+    for (size_t i = 0u; i < sizeof(prefix); ++i)
+      window.push_front(prefix[i]);
+    tca::brcvt_set_prefix(*q, window, ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+    unsigned char dummy[sizeof(text)] = {0};
+    unsigned char* dummy_ptr = dummy;
+    unsigned char const* buf_ptr = buf;
+    tca::api_error res = tca::brcvt_in(*q, buf, buf_end, buf_ptr,
+      dummy, dummy+sizeof(dummy), dummy_ptr);
+    munit_plus_assert(res >= tca::api_error::Success);
+    munit_plus_assert(dummy_ptr-dummy == sizeof(text));
+    munit_plus_assert_memory_equal(sizeof(text), dummy, text);
+  }
+  /* windows of a different size do not fit */
+  {
+    tca::hash_chain window(256,16);
+    std::unique_ptr<tca::brcvt_state> const r =
+      tca::brcvt_unique(4096,4096,16);
+    tca::brcvt_set_prefix(*r, window, ae);
+    munit_plus_assert(ae == tca::api_error::Param);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_stats
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> text;
+  std::vector<unsigned char> packed;
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,32768,256);
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* make repetitive text */{
+    unsigned char piece[32];
+    std::size_t const len = munit_plus_rand_int_range(256,8192);
+    munit_plus_rand_memory(sizeof(piece), piece);
+    while (text.size() < len) {
+      std::size_t const span = munit_plus_rand_int_range(4,sizeof(piece));
+      text.insert(text.end(), piece, piece+span);
+    }
+    text.resize(len);
+  }
+  /* compress */{
+    tca::api_error ae;
+    unsigned char buf[64];
+    unsigned char const* from_next = text.data();
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_out(*p, from_next, text.data()+text.size(), from_next,
+        buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert(ae == tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+  }
+  tca::cvt_stats const& stats = p->stats;
+  if (!tca::cvt_stats_enabled()) {
+    munit_plus_assert_ullong(stats.bytes_in, ==, 0u);
+    munit_plus_assert_ullong(stats.matches, ==, 0u);
+    return MUNIT_PLUS_OK;
+  }
+  munit_plus_assert_ullong(stats.bytes_in, ==, text.size());
+  munit_plus_assert_ullong(stats.bytes_out, ==, packed.size());
+  munit_plus_assert_ullong(stats.copy_bytes+stats.literal_bytes,
+    ==, text.size());
+  munit_plus_assert_ullong(stats.matches, >, 0u);
+  munit_plus_assert_ullong(stats.searches, >=, stats.matches);
+  munit_plus_assert_ullong(stats.dynamic_blocks+stats.stored_blocks,
+    >=, (text.size()+4095u)/4096u);
+  munit_plus_assert_ullong(stats.fixed_blocks, ==, 0u);
+  munit_plus_assert_double(stats.average_match_length(), >=, 2.0);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brcvt_reset
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> text[2];
+  std::vector<unsigned char> packed[2];
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,32768,16);
+  std::unique_ptr<tca::brcvt_state> const q =
+    tca::brcvt_unique(4096,32768,16);
+  (void)params;
+  (void)data;
+  if (!p || !q)
+    return MUNIT_PLUS_SKIP;
+  /* make two texts; the second reuses pieces of the first */{
+    text[0].resize(munit_plus_rand_int_range(1,6000));
+    for (unsigned char& ch : text[0])
+      ch = static_cast<unsigned char>(munit_plus_rand_int_range(97,100));
+    text[1].resize(munit_plus_rand_int_range(1,6000));
+    for (size_t i = 0u; i < text[1].size(); ++i)
+      text[1][i] = text[0][(i*7u)%text[0].size()];
+  }
+  /* encode both with one state */
+  for (int k = 0; k < 2; ++k) {
+    unsigned char buf[1024];
+    unsigned char const* from = text[k].data();
+    unsigned char const* const from_end = from+text[k].size();
+    tca::api_error res;
+    do {
+      unsigned char* buf_end = buf;
+      res = tca::brcvt_out(*p, from, from_end, from,
+        buf, buf+sizeof(buf), buf_end);
+      munit_plus_assert(res >= tca::api_error::Success);
+      packed[k].insert(packed[k].end(), buf, buf_end);
+    } while (from < from_end);
+    do {
+      unsigned char* buf_end = buf;
+      res = tca::brcvt_unshift(*p, buf, buf+sizeof(buf), buf_end);
+      munit_plus_assert(res >= tca::api_error::Success);
+      packed[k].insert(packed[k].end(), buf, buf_end);
+    } while (res != tca::api_error::EndOfFile);
+    tca::brcvt_reset(*p);
+  }
+  /* decode both with one state */
+  for (int k = 0; k < 2; ++k) {
+    std::vector<unsigned char> out(text[k].size()+1u);
+    unsigned char const* from = packed[k].data();
+    unsigned char* to = out.data();
+    tca::api_error const res = tca::brcvt_in(*q,
+      from, from+packed[k].size(), from, to, to+out.size(), to);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert_size(to-out.data(), ==, text[k].size());
+    munit_plus_assert_memory_equal(text[k].size(), out.data(), text[k].data());
+    tca::api_error ae;
+    tca::brcvt_reset(*q, ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brcvt_in_narrow
+  (const MunitPlusParameter params[], void* data)
+{
+  unsigned char const* const packed =
+    tcmplxAtest_woff2_real+tcmplxAtest_woff2_real_stream;
+  std::size_t total = 0u;
+  std::unique_ptr<tca::brcvt_state> const q =
+    tca::brcvt_unique(4096,16777200,1);
+  (void)params;
+  (void)data;
+  if (!q)
+    return MUNIT_PLUS_SKIP;
+  for (std::size_t i = 0u; i < tcmplxAtest_woff2_real_count; ++i)
+    total += tcmplxAtest_woff2_real_tables[i].length;
+  std::vector<unsigned char> out(total);
+  /* decode through small output and input windows */{
+    unsigned char const* from = packed;
+    unsigned char const* const from_end =
+      packed+tcmplxAtest_woff2_real_stream_size;
+    unsigned char* to = out.data();
+    unsigned char* const to_end = to+out.size();
+    tca::api_error res = tca::api_error::Success;
+    while (res != tca::api_error::EndOfFile) {
+      unsigned char const* const from_last = from;
+      unsigned char* const to_last = to;
+      std::size_t const in_span = testfont_rand_size_range(1u,
+        std::min<std::size_t>(4u, from_end-from));
+      std::size_t const out_span = testfont_rand_size_range(0u,
+        std::min<std::size_t>(8u, to_end-to));
+      res = tca::brcvt_in(*q, from, from+in_span, from,
+        to, to+out_span, to);
+      munit_plus_assert(res >= tca::api_error::Success);
+      munit_plus_assert(from > from_last || to > to_last
+        || out_span == 0u || res == tca::api_error::EndOfFile);
+    }
+    munit_plus_assert_size(to-out.data(), ==, total);
+  }
+  /* compare against the source tables */{
+    std::size_t pos = 0u;
+    for (std::size_t i = 0u; i < tcmplxAtest_woff2_real_count; ++i) {
+      tcmplxAtest_sfnt_table const& line = tcmplxAtest_woff2_real_tables[i];
+      munit_plus_assert_int(tcmplxAtest_woff2_real_check(
+          reinterpret_cast<unsigned char const*>(line.tag),
+          out.data()+pos, line.length), ==, 0);
+      pos += line.length;
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brcvt_in_meta_aligned
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * A flush from the reference encoder: a meta-block with the first
+   * twenty bytes, an empty metadata block whose header ends on the last
+   * bit of a byte, an uncompressed meta-block "xyz" and an empty last
+   * meta-block. No padding follows the metadata header; the next byte
+   * starts the next meta-block.
+   */
+  static unsigned char const buf[] = {
+      0x21, 0x4c, 0x00, 0x00, 0x00, 0x2a, 0x1c, 0x03,
+      0xe2, 0xe5, 0x23, 0x80, 0x0a, 0x05, 0xa0, 0x9c,
+      0xce, 0xde, 0x1b, 0x10, 0x00, 0x08, 0x78, 0x79,
+      0x7a, 0x03
+    };
+  static char const text[] = "abcdefghijabcdefghijxyz";
+  std::size_t const len = sizeof(text)-1;
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,32> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(len, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_meta_resume
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * A metadata block "AB" with a one-byte skip length, an uncompressed
+   * meta-block "xyz" and an empty last meta-block.
+   */
+  static unsigned char const buf[] = {
+      0xac, 0x00, 0x41, 0x42, 0x10, 0x00, 0x08, 0x78,
+      0x79, 0x7a, 0x03
+    };
+  static char const text[] = "xyz";
+  std::size_t const len = sizeof(text)-1;
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,32> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(len, to_buf.data(), text);
+  }
+  /* inspect */{
+    tca::brotli_meta const& meta = p->get_metadata();
+    munit_plus_assert(meta.size() == 1);
+    munit_plus_assert(meta.at(0).size() == 2);
+    munit_plus_assert_memory_equal(2, &meta.at(0)[0], "AB");
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_meta_short
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  std::unique_ptr<tca::brcvt_state> const q =
+    tca::brcvt_unique(64,128,16);
+  /*
+   * A metadata block "A" with a one-byte skip length of zero, then an
+   * empty last meta-block. Only lengths of two or more bytes need a
+   * nonzero last byte.
+   */
+  static unsigned char const buf[] = {0x2c, 0x00, 0x41, 0x03};
+  /* The same length stretched over two bytes. */
+  static unsigned char const bad_buf[] = {0x4c, 0x00, 0x00, 0x41, 0x03};
+  if (p == NULL || q == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(ret == to_buf.data());
+    munit_plus_assert(src == buf+sizeof(buf));
+    tca::brotli_meta const& meta = p->get_metadata();
+    munit_plus_assert(meta.size() == 1);
+    munit_plus_assert(meta.at(0).size() == 1);
+    munit_plus_assert(meta.at(0)[0] == 0x41);
+  }
+  /* reject the padded length */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = bad_buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*q, bad_buf, bad_buf+sizeof(bad_buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::Sanitize);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_literal_switch
+  (const MunitPlusParameter params[], void* data)
+{
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,4096,16);
+  /*
+   * 675 bytes of a GSUB table from the reference encoder (quality 10,
+   * 1 KiB window). The literals use two block types, and the stream
+   * switches between them partway through its commands.
+   */
+  static unsigned char const buf[] = {
+      0xa1, 0x10, 0x15, 0x88, 0xa2, 0x52, 0x10, 0xf1,
+      0x7f, 0x9d, 0x40, 0xb7, 0xe9, 0xa0, 0xdd, 0xac,
+      0xd2, 0x66, 0x8b, 0x11, 0x66, 0xd0, 0xe1, 0x60,
+      0xc4, 0x2b, 0x87, 0x17, 0xdf, 0xe7, 0x3d, 0x2e,
+      0xe8, 0xbf, 0x5b, 0xbb, 0xef, 0x97, 0x48, 0xc0,
+      0x18, 0x81, 0x7a, 0x21, 0x9f, 0x09, 0x6b, 0xdb,
+      0x76, 0xc3, 0x1b, 0x1e, 0x32, 0xd4, 0xf0, 0xad,
+      0x7e, 0x46, 0x42, 0xd6, 0x44, 0x09, 0xa2, 0xa1,
+      0xbf, 0x18, 0xee, 0x14, 0x3b, 0xaf, 0x6f, 0x90,
+      0x05, 0x40, 0x01, 0x04, 0xc4, 0x40, 0x04, 0x8c,
+      0x6c, 0x13, 0xba, 0x99, 0x5d, 0xb4, 0x91, 0x6f,
+      0xa9, 0xff, 0xa5, 0xdc, 0x43, 0x23, 0x32, 0x62,
+      0x60, 0xe8, 0xe4, 0xf4, 0xdf, 0x81, 0x0e, 0x48,
+      0x07, 0xce, 0x34, 0xb3, 0x94, 0x52, 0x8d, 0x54,
+      0x83, 0x1d, 0xb0, 0x64, 0xd8, 0xd3, 0xfb, 0xa6,
+      0x38, 0x0e, 0x78, 0x1e, 0x04, 0x2b, 0xd8, 0x6c,
+      0x60, 0xb7, 0x83, 0x83, 0x03, 0x38, 0x3a, 0x62,
+      0x27, 0x27, 0x70, 0x71, 0x01, 0x37, 0x37, 0xf0,
+      0xf0, 0x00, 0xef, 0x31, 0xc2, 0x24, 0x38, 0x41,
+      0x98, 0x14, 0xa7, 0xe8, 0x00, 0x02, 0x21, 0x00,
+      0x01, 0x11, 0x00, 0x8b, 0x21, 0x12, 0xa8, 0x14,
+      0x26, 0x83, 0xcb, 0x11, 0x0a, 0xa4, 0x12, 0xa5,
+      0x42, 0xab, 0x31, 0x1a, 0xac, 0x16, 0xa7, 0xc3,
+      0xeb, 0x09, 0x06, 0xa2, 0x91, 0x64, 0x22, 0x9b,
+      0x29, 0x16, 0xaa, 0x95, 0x66, 0x63, 0x71, 0x61,
+      0x75, 0x6d, 0x7b, 0x6b, 0x7f, 0xef, 0xf8, 0xa8,
+      0xdb, 0x39, 0x3d, 0xb9, 0xbc, 0xb8, 0xbd, 0xb9,
+      0x7f, 0x78, 0x7e, 0x7a, 0xff, 0xfa, 0xff, 0xeb,
+      0xf7, 0x86, 0x83, 0xf1, 0x68, 0x3a, 0x99, 0xcf,
+      0x64, 0x0e, 0x73, 0x80, 0xb9, 0xcc, 0x05, 0xca,
+      0x48, 0x86, 0xb8, 0x4a, 0x97, 0x19, 0x31, 0xb0,
+      0x7e, 0x03, 0xd2, 0xa8, 0x29, 0x6d, 0x91, 0x47,
+      0x5b, 0xb5, 0xa5, 0xed, 0xba, 0x92, 0x6e, 0xdd,
+      0x68, 0xf7, 0xee, 0xa4, 0x47, 0x2f, 0xda, 0xbb,
+      0x2f, 0xe9, 0xd7, 0x5f, 0x97, 0x21, 0x24, 0x0b,
+      0x80, 0x74, 0x15, 0x4a, 0xb2, 0xe6, 0x9a, 0xdc,
+      0xf5, 0xae, 0xf1, 0x6e, 0x77, 0x8b, 0x5f, 0xf9,
+      0x35, 0xb9, 0xea, 0x3d, 0xde, 0xe4, 0x26, 0xf8,
+      0xd7, 0x7e, 0x53, 0xbe, 0xf5, 0x6d, 0x0c, 0x92,
+      0x8a, 0x07, 0xc4, 0x04, 0x23, 0x26, 0x48, 0x68,
+      0x89, 0x2c, 0xb7, 0x20, 0x9a, 0x23, 0x54, 0x54,
+      0xe7, 0x26, 0xb2, 0x7d, 0xef, 0x42, 0x7c, 0x7f,
+      0x70, 0xad, 0x7a, 0xb0, 0x42, 0x72, 0xd9, 0x62,
+      0xed, 0x7a, 0x82, 0x29, 0x42, 0x8c, 0x31, 0x62,
+      0x01
+    };
+  std::size_t const len = 675u;
+  std::uint32_t const checksum = 0xad545595u;
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* extract some data */{
+    std::vector<unsigned char> to_buf(len+1u);
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+to_buf.size(), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_uint32(tca::zutil_adler32(len, to_buf.data()),==,
+      checksum);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_context_simple
+  (const MunitPlusParameter params[], void* data)
+{
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,4096,16);
+  /*
+   * 100 bytes of a cmap table from the reference encoder (quality 10,
+   * 1 KiB window). A context map here uses a simple prefix code, whose
+   * symbols take as many bits as the largest symbol needs.
+   */
+  static unsigned char const buf[] = {
+      0xa1, 0x18, 0x03, 0xc0, 0x7f, 0xa4, 0x1e, 0x6b,
+      0x60, 0xe1, 0x4c, 0x05, 0x10, 0x00, 0x13, 0x39,
+      0x50, 0x0f, 0x5b, 0x74, 0x81, 0x27, 0x07, 0x5a,
+      0x78, 0x15, 0x08, 0xac, 0x03, 0x05, 0x80, 0x83,
+      0x57, 0x23, 0x00
+    };
+  std::size_t const len = 100u;
+  std::uint32_t const checksum = 0x9b4302aeu;
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* extract some data */{
+    std::vector<unsigned char> to_buf(len+1u);
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+to_buf.size(), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(static_cast<std::size_t>(ret-to_buf.data()) == len);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_uint32(tca::zutil_adler32(len, to_buf.data()),==,
+      checksum);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_single_clen
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * "hello" with a complex literal code whose only nonzero code length
+   * code is 8, so every literal is eight bits long. The code lengths
+   * read after the 8 are all zero.
+   */
+  static unsigned char const buf[] = {
+      0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07,
+      0x00, 0x04, 0x0a, 0x01, 0x58, 0x98, 0xda, 0xd8,
+      0xd8, 0x03
+    };
+  static unsigned char const text[] = "hello";
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(ret == to_buf.data()+5);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(5, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_blocktype_alpha
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * "abba" with three literal block types. The block type code is a
+   * complex code over all NBLTYPESL+2 = 5 symbols, and the stream
+   * switches with symbol 4 (block type 2).
+   */
+  static unsigned char const buf[] = {
+      0x62, 0x00, 0x60, 0xc0, 0x1d, 0x0e, 0x10, 0x00,
+      0x40, 0x85, 0x89, 0x05, 0x08, 0x01, 0xf8, 0x02
+    };
+  static unsigned char const text[] = "abba";
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(ret == to_buf.data()+4);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(4, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_blockcount_alpha
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * "abba" with two literal block types and a complex block count
+   * code, read right after a simple block type code. The count code
+   * has its own 26-symbol alphabet.
+   */
+  static unsigned char const buf[] = {
+      0x62, 0x00, 0x20, 0x22, 0x0e, 0xb8, 0x50, 0x00,
+      0x40, 0x85, 0x89, 0x05, 0x08, 0x01, 0x18, 0x01
+    };
+  static unsigned char const text[] = "abba";
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(ret == to_buf.data()+4);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(4, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_single_tree
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * "aaaxaax" with two literal trees and two distance trees. The first
+   * tree of each forest has one symbol and takes no bits; the second
+   * has two. Each literal and distance must use its own tree.
+   */
+  static unsigned char const buf[] = {
+      0xc2, 0x00, 0x00, 0x00, 0xa1, 0xf4, 0xff, 0xff,
+      0xff, 0xff, 0xff, 0xff, 0xff, 0x17, 0x4a, 0x17,
+      0x61, 0x85, 0x97, 0x57, 0x88, 0x24, 0x12, 0x50,
+      0x41, 0x11, 0x05
+    };
+  static unsigned char const text[] = "aaaxaax";
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(ret == to_buf.data()+7);
+    munit_plus_assert(src == buf+sizeof(buf));
+    munit_plus_assert_memory_equal(7, to_buf.data(), text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_block_types
+  (const MunitPlusParameter params[], void* data)
+{
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,32768,16);
+  std::unique_ptr<tca::brcvt_state> const q =
+    tca::brcvt_unique(4096,32768,16);
+  /*
+   * The first 80 bytes of a cmap table. The encoder gives its literals
+   * more than one block type, and the block type code does not list
+   * the types in order of their code words.
+   */
+  static unsigned char const text[] = {
+      0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x03,
+      0x00, 0x00, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x04,
+      0x00, 0x00, 0x0c, 0x4a, 0x00, 0x01, 0x00, 0x00,
+      0x00, 0x00, 0x19, 0x86, 0x00, 0x03, 0x00, 0x01,
+      0x00, 0x00, 0x00, 0x2c, 0x00, 0x03, 0x00, 0x0a,
+      0x00, 0x00, 0x0c, 0x4a, 0x00, 0x04, 0x0c, 0x1e,
+      0x00, 0x00, 0x01, 0x82, 0x01, 0x00, 0x00, 0x07,
+      0x00, 0x82, 0x00, 0x00, 0x00, 0x7e, 0x02, 0xe9,
+      0x02, 0xee, 0x02, 0xf7, 0x03, 0x4f, 0x03, 0x5a,
+      0x03, 0x62, 0x03, 0x77, 0x03, 0x7f, 0x03, 0x8a
+    };
+  unsigned char buf[256] = {0};
+  unsigned char* buf_end = buf;
+  (void)params;
+  (void)data;
+  if (!p || !q)
+    return MUNIT_PLUS_SKIP;
+  /* encode */{
+    unsigned char const* text_p = text;
+    tca::api_error res = tca::brcvt_out(*p,
+      text, text+sizeof(text), text_p,
+      buf, buf+sizeof(buf), buf_end);
+    munit_plus_assert(res == tca::api_error::Partial);
+    res = tca::brcvt_unshift(*p, buf_end, buf+sizeof(buf), buf_end);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+  }
+  /* decode */{
+    unsigned char out[sizeof(text)+1u] = {0};
+    unsigned char* out_ptr = out;
+    unsigned char const* buf_ptr = buf;
+    tca::api_error const res = tca::brcvt_in(*q, buf, buf_end, buf_ptr,
+      out, out+sizeof(out), out_ptr);
+    munit_plus_assert(res == tca::api_error::EndOfFile);
+    munit_plus_assert(out_ptr-out == sizeof(text));
+    munit_plus_assert_memory_equal(sizeof(text), out, text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_in_blockcount_range
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brcvt_state* const p = static_cast<tca::brcvt_state*>(data);
+  /*
+   * "abba" again, but with a simple block count code whose only
+   * symbol is 31. Block count codes stop at 25.
+   */
+  static unsigned char const buf[] = {
+      0x62, 0x00, 0x20, 0xa2, 0xf8, 0x00, 0x40, 0x85,
+      0x89, 0x05, 0x08, 0x01, 0x18
+    };
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* reject the symbol */{
+    std::array<unsigned char,8> to_buf = {};
+    unsigned char* ret = nullptr;
+    unsigned char const* src = buf;
+    tca::api_error res;
+    res = tca::brcvt_in(*p, buf, buf+sizeof(buf), src,
+      to_buf.data(), to_buf.data()+sizeof(to_buf), ret);
+    munit_plus_assert(res == tca::api_error::Sanitize);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_brcvt_far_match
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> text(16384u);
+  std::vector<unsigned char> packed;
+  std::unique_ptr<tca::brcvt_state> const p =
+    tca::brcvt_unique(4096,32768,256);
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* noise, then pieces of that noise from far back */{
+    munit_plus_rand_memory(text.size(), text.data());
+    while (text.size() < 32768u) {
+      std::size_t const start = munit_plus_rand_int_range(0,255)*64u;
+      text.insert(text.end(), text.begin()+start, text.begin()+start+64u);
+    }
+  }
+  /* compress */{
+    tca::api_error ae;
+    unsigned char buf[64];
+    unsigned char const* from_next = text.data();
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_out(*p, from_next, text.data()+text.size(), from_next,
+        buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert(ae == tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+  }
+  /* the copies should win over uncompressed blocks */
+  munit_plus_assert_size(packed.size(), <, text.size()*3u/4u);
+  return MUNIT_PLUS_OK;
+}
+
 
 int main(int argc, char **argv) {
   return munit_plus_suite_main(&suite_brcvt, nullptr, argc, argv);
@@ -0,0 +1,225 @@
+/**
+ * @brief Test program for parallel Brotli compression.
+ */
+#include "testfont.hpp"
+#include "text-complex-plus/access/brpar.hpp"
+#include "text-complex-plus/access/brcvt.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+static MunitPlusResult test_brpar_cycle
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brpar_roundtrip
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brpar_threads
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_brpar_window
+    (const MunitPlusParameter params[], void* data);
+static std::vector<unsigned char> test_brpar_text(std::size_t len);
+static std::vector<unsigned char> test_brpar_encode
+    (std::vector<unsigned char> const& text, unsigned int segment_size,
+      unsigned int threads);
+
+
+static MunitPlusTest tests_brpar[] = {
+  {(char*)"cycle", test_brpar_cycle,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,nullptr},
+  {(char*)"roundtrip", test_brpar_roundtrip,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"threads", test_brpar_threads,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"window", test_brpar_window,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_brpar = {
+  (char*)"access/brpar/", tests_brpar, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+
+MunitPlusResult test_brpar_cycle
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::brpar_state* ptr[2];
+  (void)params;
+  (void)data;
+  ptr[0] = tca::brpar_new(256,1024,16,4096,2);
+  ptr[1] = new tca::brpar_state(256,1024,16,4096,1);
+  std::unique_ptr<tca::brpar_state> ptr2 = tca::brpar_unique();
+  munit_plus_assert_not_null(ptr[0]);
+  munit_plus_assert_not_null(ptr[1]);
+  munit_plus_assert_not_null(ptr2.get());
+  munit_plus_assert_uint(ptr[0]->threads(),==,2u);
+  munit_plus_assert_null(tca::brpar_new(256,1024,16,0,1));
+  tca::brpar_destroy(ptr[0]);
+  delete ptr[1];
+  return MUNIT_PLUS_OK;
+}
+
+std::vector<unsigned char> test_brpar_text(std::size_t len) {
+  static char const words[][8] = {
+    "glyf", "loca", "hmtx", "cmap", "head", "name", "post", "OS/2"
+  };
+  std::vector<unsigned char> out;
+  out.reserve(len);
+  while (out.size() < len) {
+    int const pick = munit_plus_rand_int_range(0,9);
+    if (pick < 8) {
+      char const* const w = words[pick];
+      out.insert(out.end(), w, w+std::strlen(w));
+    } else out.push_back(static_cast<unsigned char>(
+        munit_plus_rand_int_range(0,255)));
+  }
+  out.resize(len);
+  return out;
+}
+
+std::vector<unsigned char> test_brpar_encode
+  ( std::vector<unsigned char> const& text, unsigned int segment_size,
+    unsigned int threads)
+{
+  std::vector<unsigned char> out;
+  tca::brpar_state state(256, 1024, 16, segment_size, threads);
+  unsigned char buf[97];
+  unsigned char const* p = text.data();
+  unsigned char const* const p_end = text.data()+text.size();
+  tca::api_error ae;
+  /* feed in uneven pieces */do {
+    std::size_t const piece = munit_plus_rand_int_range(1,700);
+    unsigned char const* const q_end =
+      (p_end - p < static_cast<std::ptrdiff_t>(piece)) ? p_end : p+piece;
+    unsigned char* to_next = buf;
+    ae = tca::brpar_out(state, p, q_end, p, buf, buf+sizeof(buf), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    out.insert(out.end(), buf, to_next);
+  } while (p < p_end);
+  do {
+    unsigned char* to_next = buf;
+    ae = tca::brpar_unshift(state, buf, buf+sizeof(buf), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    out.insert(out.end(), buf, to_next);
+  } while (ae == tca::api_error::Success);
+  munit_plus_assert(ae == tca::api_error::EndOfFile);
+  return out;
+}
+
+MunitPlusResult test_brpar_roundtrip
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const len = munit_plus_rand_int_range(0,20000);
+  unsigned int const segment_size = munit_plus_rand_int_range(512,8192);
+  std::vector<unsigned char> const text = test_brpar_text(len);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const packed =
+    test_brpar_encode(text, segment_size, munit_plus_rand_int_range(1,4));
+  /* decode */{
+    std::unique_ptr<tca::brcvt_state> q = tca::brcvt_unique(4096,4096,4096);
+    std::vector<unsigned char> unpacked(len+1u);
+    unsigned char const* p = packed.data();
+    unsigned char* to_next = unpacked.data();
+    if (!q)
+      return MUNIT_PLUS_SKIP;
+    tca::api_error const ae = tca::brcvt_in(*q,
+      packed.data(), packed.data()+packed.size(), p,
+      unpacked.data(), unpacked.data()+unpacked.size(), to_next);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+    munit_plus_assert_size(to_next-unpacked.data(),==,len);
+    munit_plus_assert_memory_equal(len, unpacked.data(), text.data());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brpar_threads
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const len = munit_plus_rand_int_range(1,20000);
+  unsigned int const segment_size = munit_plus_rand_int_range(512,8192);
+  std::vector<unsigned char> const text = test_brpar_text(len);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const one = test_brpar_encode(text, segment_size, 1);
+  std::vector<unsigned char> const many = test_brpar_encode(text, segment_size,
+    munit_plus_rand_int_range(2,8));
+  munit_plus_assert_size(one.size(),==,many.size());
+  munit_plus_assert_memory_equal(one.size(), one.data(), many.data());
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_brpar_window
+  (const MunitPlusParameter params[], void* data)
+{
+  /* 1100 bytes asks for a 2032-byte Brotli window */
+  static char const words[][8] = {
+    "time ", "work ", "life ", "back ", "name ", "page ", "home ", "data "
+  };
+  std::size_t const len = munit_plus_rand_int_range(6000,12000);
+  unsigned int const segment_size = munit_plus_rand_int_range(2100,4000);
+  std::vector<unsigned char> text;
+  std::vector<unsigned char> packed;
+  (void)params;
+  (void)data;
+  /* static dictionary words between runs of noise */{
+    text.reserve(len);
+    while (text.size() < len) {
+      char const* const w = words[munit_plus_rand_int_range(0,7)];
+      int i;
+      text.insert(text.end(), w, w+std::strlen(w));
+      for (i = munit_plus_rand_int_range(32,256); i > 0; --i) {
+        text.push_back(static_cast<unsigned char>(
+            munit_plus_rand_int_range(0,255)));
+      }
+    }
+    text.resize(len);
+  }
+  /* encode */{
+    tca::brpar_state state(256, 1100, 16, segment_size, 2);
+    unsigned char buf[256];
+    unsigned char const* p = text.data();
+    tca::api_error ae;
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brpar_out(state, p, text.data()+text.size(), p,
+        buf, buf+sizeof(buf), to_next);
+      munit_plus_assert(ae >= tca::api_error::Success);
+      packed.insert(packed.end(), buf, to_next);
+    } while (p < text.data()+text.size());
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brpar_unshift(state, buf, buf+sizeof(buf), to_next);
+      munit_plus_assert(ae >= tca::api_error::Success);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+  }
+  /* decode */{
+    std::unique_ptr<tca::brcvt_state> q = tca::brcvt_unique(4096,4096,4096);
+    std::vector<unsigned char> unpacked(len+1u);
+    unsigned char const* p = packed.data();
+    unsigned char* to_next = unpacked.data();
+    if (!q)
+      return MUNIT_PLUS_SKIP;
+    tca::api_error const ae = tca::brcvt_in(*q,
+      packed.data(), packed.data()+packed.size(), p,
+      unpacked.data(), unpacked.data()+unpacked.size(), to_next);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+    munit_plus_assert_size(to_next-unpacked.data(),==,len);
+    munit_plus_assert_memory_equal(len, unpacked.data(), text.data());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  return munit_plus_suite_main(&suite_brpar, nullptr, argc, argv);
+}
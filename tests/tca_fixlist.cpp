@@ -8,6 +8,9 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 
 
 static MunitPlusResult test_fixlist_cycle
@@ -18,6 +21,10 @@ static MunitPlusResult test_fixlist_gen_codes
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_fixlist_gen_lengths
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fixlist_gen_limited
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fixlist_gen_optimal
+    (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_fixlist_preset
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_fixlist_hist_cycle
@@ -36,6 +43,8 @@ static void test_fixlist_teardown(void* fixture);
 static void* test_fixlist_hist_setup
     (const MunitPlusParameter params[], void* user_data);
 static void test_fixlist_hist_teardown(void* fixture);
+static unsigned long long test_fixlist_pm_cost
+    (std::vector<unsigned long> const& freqs, unsigned int max_bits);
 
 
 static MunitPlusParameterEnum test_fixlist_gen_params[] = {
@@ -63,6 +72,12 @@ static MunitPlusTest tests_fixlist[] = {
   {(char*)"gen_lengths", test_fixlist_gen_lengths,
       test_fixlist_len_setup,test_fixlist_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       test_fixlist_len_params},
+  {(char*)"gen_lengths/limited", test_fixlist_gen_limited,
+      test_fixlist_len_setup,test_fixlist_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"gen_lengths/optimal", test_fixlist_gen_optimal,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {(char*)"preset", test_fixlist_preset,
       test_fixlist_setup,test_fixlist_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
@@ -387,6 +402,149 @@ MunitPlusResult test_fixlist_gen_lengths
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_fixlist_gen_limited
+  (const MunitPlusParameter params[], void* data)
+{
+  text_complex::access::prefix_list* const p =
+    static_cast<text_complex::access::prefix_list*>(data);
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  std::size_t const sz = p->size();
+  unsigned int const max_bits = 9u;
+  text_complex::access::prefix_histogram ph(sz);
+  text_complex::access::prefix_histogram scratch;
+  (void)params;
+  /* skewed frequencies, to force the length limit */{
+    std::size_t i;
+    for (i = 0; i < sz; ++i) {
+      ph[i] = (i%5u == 4u) ? 0u : 1u+(munit_plus_rand_uint32()>>(i%32u));
+    }
+  }
+#if !(defined TextComplexAccessP_NO_EXCEPT)
+  text_complex::access::fixlist_gen_lengths(*p, ph, max_bits, scratch);
+#else
+  text_complex::access::api_error ae;
+  text_complex::access::fixlist_gen_lengths(*p, ph, max_bits, scratch, ae);
+  munit_plus_assert_op(ae,==,text_complex::access::api_error::Success);
+#endif /*TextComplexAccessP_NO_EXCEPT*/
+  munit_plus_assert_size(scratch.size(), >=, sz*2u);
+  /* inspect the new code lengths */{
+    size_t i;
+    size_t nonzero_count = 0u;
+    unsigned long int sum = 0u;
+    for (i = 0; i < sz; ++i) {
+      struct text_complex::access::prefix_line const& line = (*p)[i];
+      if (ph[i] > 0) {
+        munit_plus_assert_uint(line.len, >, 0u);
+        munit_plus_assert_uint(line.len, <=, max_bits);
+        sum += (32768u>>line.len);
+        nonzero_count += 1u;
+      } else {
+        munit_plus_assert_uint(line.len, ==, 0u);
+      }
+    }
+    if (nonzero_count == 1) {
+      munit_plus_assert_ulong(sum, ==, 16384);
+    } else munit_plus_assert_ulong(sum, ==, 32768);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+MunitPlusResult test_fixlist_gen_optimal
+  (const MunitPlusParameter params[], void* data)
+{
+  int round;
+  (void)params;
+  (void)data;
+  for (round = 0; round < 16; ++round) {
+    std::size_t const sz = munit_plus_rand_int_range(3,64);
+    unsigned int max_bits = munit_plus_rand_int_range(1,3);
+    std::vector<unsigned long> freqs(sz);
+    text_complex::access::prefix_histogram ph(sz);
+    text_complex::access::prefix_list p(sz);
+    /* a few bits above the shortest possible limit */
+    for (std::size_t m = 2u; m < sz; m *= 2u)
+      max_bits += 1u;
+    /* skewed frequencies, deep enough to pass most limits */{
+      std::size_t i;
+      for (i = 0; i < sz; ++i) {
+        unsigned int const shift = munit_plus_rand_int_range(0,24);
+        freqs[i] = 1u + (munit_plus_rand_uint32()>>(8u+shift));
+        ph[i] = static_cast<text_complex::access::uint32>(freqs[i]);
+      }
+    }
+#if !(defined TextComplexAccessP_NO_EXCEPT)
+    text_complex::access::fixlist_gen_lengths(p, ph, max_bits);
+#else
+    text_complex::access::api_error ae;
+    text_complex::access::fixlist_gen_lengths(p, ph, max_bits, ae);
+    munit_plus_assert_op(ae,==,text_complex::access::api_error::Success);
+#endif /*TextComplexAccessP_NO_EXCEPT*/
+    /* compare against a plain package-merge */{
+      std::size_t i;
+      unsigned long long cost = 0u;
+      unsigned long int sum = 0u;
+      for (i = 0; i < sz; ++i) {
+        munit_plus_assert_uint(p[i].len, >, 0u);
+        munit_plus_assert_uint(p[i].len, <=, max_bits);
+        cost += freqs[i]*static_cast<unsigned long long>(p[i].len);
+        sum += (32768u>>p[i].len);
+      }
+      munit_plus_assert_ulong(sum, ==, 32768);
+      munit_plus_assert_ullong
+        (cost, ==, test_fixlist_pm_cost(freqs, max_bits));
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+unsigned long long test_fixlist_pm_cost
+    (std::vector<unsigned long> const& freqs, unsigned int max_bits)
+{
+  struct item {
+    unsigned long long weight;
+    /* times each symbol appears in the item */
+    std::vector<unsigned int> uses;
+  };
+  std::vector<unsigned long> w(freqs);
+  std::sort(w.begin(), w.end());
+  std::size_t const n = w.size();
+  std::vector<item> level;
+  unsigned int j;
+  for (j = 0u; j < max_bits; ++j) {
+    std::vector<item> leaves;
+    std::vector<item> packages;
+    std::size_t i;
+    for (i = 0u; i < n; ++i) {
+      item x = { w[i], std::vector<unsigned int>(n, 0u) };
+      x.uses[i] = 1u;
+      leaves.push_back(x);
+    }
+    for (i = 0u; i+1u < level.size(); i += 2u) {
+      item x = level[i];
+      std::size_t k;
+      x.weight += level[i+1u].weight;
+      for (k = 0u; k < n; ++k)
+        x.uses[k] += level[i+1u].uses[k];
+      packages.push_back(x);
+    }
+    level.clear();
+    std::merge(leaves.begin(), leaves.end(),
+      packages.begin(), packages.end(), std::back_inserter(level),
+      [](item const& a, item const& b) { return a.weight < b.weight; });
+  }
+  unsigned long long cost = 0u;
+  /* the first 2n-2 items of the top level hold every code bit */{
+    std::size_t i;
+    for (i = 0u; i < 2u*n-2u; ++i) {
+      std::size_t k;
+      for (k = 0u; k < n; ++k)
+        cost += w[k]*static_cast<unsigned long long>(level[i].uses[k]);
+    }
+  }
+  return cost;
+}
 
 
 
@@ -0,0 +1,380 @@
+/**
+ * @brief Test program for the cache of decoded fonts
+ */
+#include "text-complex-plus/access/fontcache.hpp"
+#include "text-complex-plus/access/woff2.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
+#include "text-complex-plus/access/seq.hpp"
+#include "text-complex-plus/access/offtable.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <vector>
+#include <thread>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+struct test_fontcache_font {
+  /** @brief Tables of the plain font, sorted by tag. */
+  std::vector<std::vector<unsigned char> > tables;
+  /** @brief The font as WOFF2. */
+  std::vector<unsigned char> woff2;
+};
+
+static void test_fontcache_put32(std::vector<unsigned char>& out,
+    unsigned long x);
+static test_fontcache_font test_fontcache_make(void);
+static tca::font_view test_fontcache_fetch
+    (tca::font_cache& cache, std::vector<unsigned char> const& file);
+static bool test_fontcache_match
+    (tca::font_view const& view, test_fontcache_font const& font);
+
+static MunitPlusResult test_fontcache_cycle
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fontcache_hash
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fontcache_fetch
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fontcache_collide
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fontcache_evict
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_fontcache_threads
+    (const MunitPlusParameter params[], void* data);
+
+
+static MunitPlusTest tests_fontcache[] = {
+  {(char*)"cycle", test_fontcache_cycle,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,nullptr},
+  {(char*)"hash", test_fontcache_hash,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"fetch", test_fontcache_fetch,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"collide", test_fontcache_collide,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"evict", test_fontcache_evict,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"threads", test_fontcache_threads,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_fontcache = {
+  (char*)"access/fontcache/", tests_fontcache, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+void test_fontcache_put32(std::vector<unsigned char>& out, unsigned long x) {
+  out.push_back(static_cast<unsigned char>((x>>24)&255u));
+  out.push_back(static_cast<unsigned char>((x>>16)&255u));
+  out.push_back(static_cast<unsigned char>((x>>8)&255u));
+  out.push_back(static_cast<unsigned char>(x&255u));
+  return;
+}
+
+test_fontcache_font test_fontcache_make(void) {
+  static unsigned char const tags[3][4] = {
+    {0x68,0x65,0x61,0x64} /* head */,
+    {0x6e,0x61,0x6d,0x65} /* name */,
+    {0x70,0x6f,0x73,0x74} /* post */
+  };
+  test_fontcache_font out;
+  out.tables.resize(3u);
+  out.tables[0].resize(54u, 0u);
+  out.tables[0][4] = 1u;
+  /* random contents tell the fonts apart */
+  for (std::size_t i = 1u; i < 3u; ++i) {
+    out.tables[i].resize(munit_plus_rand_int_range(1,2000));
+    munit_plus_rand_memory(out.tables[i].size(), out.tables[i].data());
+  }
+  std::vector<unsigned char> file;
+  test_fontcache_put32(file, 0x00010000u);
+  file.push_back(0u);
+  file.push_back(3u);
+  file.resize(12u, 0u);
+  unsigned long offset = 12u + 16u*3u;
+  for (std::size_t i = 0u; i < 3u; ++i) {
+    std::vector<unsigned char> const& t = out.tables[i];
+    file.insert(file.end(), tags[i], tags[i]+4);
+    test_fontcache_put32(file, tca::sfnt_table_checksum
+      (tags[i], t.data(), t.size()));
+    test_fontcache_put32(file, offset);
+    test_fontcache_put32(file, t.size());
+    offset += (t.size()+3u)&~3u;
+  }
+  for (std::vector<unsigned char> const& t : out.tables) {
+    file.insert(file.end(), t.begin(), t.end());
+    file.resize((file.size()+3u)&~3u, 0u);
+  }
+  std::unique_ptr<tca::sfnt> const src =
+    tca::sfnt_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(src.get());
+  tca::woff2_encoder enc;
+  std::size_t const len = enc.encode(*src);
+  out.woff2.assign(enc.get_data(), enc.get_data()+len);
+  return out;
+}
+
+tca::font_view test_fontcache_fetch
+  (tca::font_cache& cache, std::vector<unsigned char> const& file)
+{
+  std::unique_ptr<mmaptwo::mmaptwo_i> const xfh(
+    mmaptwo::memopen(const_cast<unsigned char*>(file.data()),
+      file.size(), false));
+  munit_plus_assert_not_null(xfh.get());
+  return cache.fetch(xfh.get());
+}
+
+bool test_fontcache_match
+  (tca::font_view const& view, test_fontcache_font const& font)
+{
+  tca::offset_table const* const offsets = view.get_offsets();
+  if (!offsets || offsets->size() != font.tables.size())
+    return false;
+  for (std::size_t i = 0u; i < offsets->size(); ++i) {
+    tca::offset_line const& line = (*offsets)[i];
+    std::vector<unsigned char> const& t = font.tables[i];
+    if (line.length != t.size() || line.offset+t.size() > view.size())
+      return false;
+    /* skip the `checkSumAdjustment` of `head` */
+    std::size_t const skip = (i == 0u) ? 12u : 0u;
+    if (std::memcmp(view.get_data()+line.offset+skip,
+        t.data()+skip, t.size()-skip) != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+MunitPlusResult test_fontcache_cycle
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::font_cache* ptr[2];
+  (void)params;
+  (void)data;
+  ptr[0] = tca::fontcache_new();
+  ptr[1] = new tca::font_cache(4096u);
+  std::unique_ptr<tca::font_cache> ptr2 = tca::fontcache_unique(1u);
+  munit_plus_assert_not_null(ptr[0]);
+  munit_plus_assert_not_null(ptr[1]);
+  munit_plus_assert_not_null(ptr2.get());
+  munit_plus_assert_size(ptr[1]->get_stats().capacity,==,4096u);
+  munit_plus_assert_size(ptr2->get_stats().entries,==,0u);
+  munit_plus_assert_true(ptr2->find(0u).empty());
+  /* move */{
+    tca::font_cache moved(std::move(*ptr[1]));
+    munit_plus_assert_size(moved.get_stats().capacity,==,4096u);
+    munit_plus_assert_size(ptr[1]->get_stats().capacity,==,0u);
+  }
+  tca::fontcache_destroy(ptr[0]);
+  delete ptr[1];
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_fontcache_hash
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  /* reference values */{
+    static unsigned char const abc[3] = {0x61,0x62,0x63};
+    munit_plus_assert_ullong(tca::fontcache_hash(abc, 0u),==,
+      0xEF46DB3751D8E999ull);
+    munit_plus_assert_ullong(tca::fontcache_hash(abc, 3u),==,
+      0x44BC2CF5AD770999ull);
+  }
+  std::vector<unsigned char> buf(munit_plus_rand_int_range(0,200000));
+  munit_plus_rand_memory(buf.size(), buf.data());
+  tca::uint64 const expected = tca::fontcache_hash(buf.data(), buf.size());
+  /* stream */{
+    std::unique_ptr<mmaptwo::mmaptwo_i> const xfh(
+      mmaptwo::memopen(buf.data(), buf.size(), false));
+    munit_plus_assert_not_null(xfh.get());
+    std::unique_ptr<tca::sequential> seq = tca::seq_unique(xfh.get());
+    munit_plus_assert_not_null(seq.get());
+    tca::api_error ae;
+    munit_plus_assert_ullong(tca::fontcache_hash(*seq, ae),==,expected);
+    munit_plus_assert(ae == tca::api_error::Success);
+    munit_plus_assert_size(seq->get_pos(),==,buf.size());
+  }
+  /* any change shows */
+  if (!buf.empty()) {
+    buf[munit_plus_rand_int_range(0,static_cast<int>(buf.size()-1u))] ^= 1u;
+    munit_plus_assert_ullong
+      (tca::fontcache_hash(buf.data(), buf.size()),!=,expected);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_fontcache_fetch
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  test_fontcache_font const font = test_fontcache_make();
+  tca::font_cache cache;
+  tca::font_view const first = test_fontcache_fetch(cache, font.woff2);
+  munit_plus_assert_false(first.empty());
+  munit_plus_assert_ullong(first.get_key(),==,
+    tca::fontcache_hash(font.woff2.data(), font.woff2.size()));
+  munit_plus_assert_true(test_fontcache_match(first, font));
+  /* the second fetch hands out the same font */{
+    tca::font_view const second = test_fontcache_fetch(cache, font.woff2);
+    munit_plus_assert_ptr_equal(second.get_data(), first.get_data());
+    tca::font_view const found = cache.find(first.get_key());
+    munit_plus_assert_ptr_equal(found.get_data(), first.get_data());
+  }
+  tca::fontcache_stats stats = cache.get_stats();
+  munit_plus_assert_size(stats.misses,==,1u);
+  munit_plus_assert_size(stats.hits,==,2u);
+  munit_plus_assert_size(stats.entries,==,1u);
+  munit_plus_assert_size(stats.bytes,>=,first.size());
+  /* insert from an open woff2 */{
+    test_fontcache_font const other = test_fontcache_make();
+    std::unique_ptr<tca::woff2> w = tca::woff2_unique(mmaptwo::memopen(
+      const_cast<unsigned char*>(other.woff2.data()), other.woff2.size(),
+      false));
+    munit_plus_assert_not_null(w.get());
+    tca::api_error ae;
+    tca::font_view const view = cache.insert(12345u, *w, nullptr, ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+    munit_plus_assert_true(test_fontcache_match(view, other));
+    munit_plus_assert_ptr_equal(cache.find(12345u).get_data(),
+      view.get_data());
+  }
+  /* not a WOFF2 file */{
+    std::vector<unsigned char> junk(64u, 0u);
+    std::unique_ptr<mmaptwo::mmaptwo_i> const xfh(
+      mmaptwo::memopen(junk.data(), junk.size(), false));
+    tca::api_error ae;
+    munit_plus_assert_true(cache.fetch(xfh.get(), nullptr, ae).empty());
+    munit_plus_assert(ae != tca::api_error::Success);
+  }
+  cache.clear();
+  stats = cache.get_stats();
+  munit_plus_assert_size(stats.entries,==,0u);
+  munit_plus_assert_size(stats.bytes,==,0u);
+  munit_plus_assert_size(stats.evictions,==,0u);
+  munit_plus_assert_true(test_fontcache_match(first, font));
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_fontcache_collide
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  test_fontcache_font const planted = test_fontcache_make();
+  test_fontcache_font const font = test_fontcache_make();
+  tca::uint64 const key =
+    tca::fontcache_hash(font.woff2.data(), font.woff2.size());
+  tca::font_cache cache;
+  /* store one font under the content hash of another */{
+    std::unique_ptr<tca::woff2> w = tca::woff2_unique(mmaptwo::memopen(
+      const_cast<unsigned char*>(planted.woff2.data()), planted.woff2.size(),
+      false));
+    munit_plus_assert_not_null(w.get());
+    tca::api_error ae;
+    tca::font_view const view = cache.insert(key, *w, nullptr, ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+    munit_plus_assert_true(test_fontcache_match(view, planted));
+  }
+  /* the fetch decodes its own file and takes over the key */
+  tca::font_view const first = test_fontcache_fetch(cache, font.woff2);
+  munit_plus_assert_true(test_fontcache_match(first, font));
+  munit_plus_assert_ptr_equal(cache.find(key).get_data(), first.get_data());
+  tca::fontcache_stats stats = cache.get_stats();
+  munit_plus_assert_size(stats.entries,==,1u);
+  munit_plus_assert_size(stats.evictions,==,1u);
+  /* and later fetches of that file hit */
+  tca::font_view const second = test_fontcache_fetch(cache, font.woff2);
+  munit_plus_assert_ptr_equal(second.get_data(), first.get_data());
+  stats = cache.get_stats();
+  munit_plus_assert_size(stats.hits,==,2u);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_fontcache_evict
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  test_fontcache_font const fonts[3] = {
+    test_fontcache_make(), test_fontcache_make(), test_fontcache_make()
+  };
+  tca::font_cache cache;
+  tca::font_view const a = test_fontcache_fetch(cache, fonts[0].woff2);
+  tca::font_view const b = test_fontcache_fetch(cache, fonts[1].woff2);
+  /* touch the first font, so the second is least recently used */
+  test_fontcache_fetch(cache, fonts[0].woff2);
+  cache.set_capacity(cache.get_stats().bytes-1u);
+  tca::fontcache_stats stats = cache.get_stats();
+  munit_plus_assert_size(stats.evictions,==,1u);
+  munit_plus_assert_size(stats.entries,==,1u);
+  munit_plus_assert_false(cache.find(a.get_key()).empty());
+  munit_plus_assert_true(cache.find(b.get_key()).empty());
+  /* the evicted font outlives its entry */
+  munit_plus_assert_true(test_fontcache_match(b, fonts[1]));
+  /* a font larger than the cap is decoded but not kept */
+  cache.set_capacity(0u);
+  tca::font_view const c = test_fontcache_fetch(cache, fonts[2].woff2);
+  munit_plus_assert_true(test_fontcache_match(c, fonts[2]));
+  stats = cache.get_stats();
+  munit_plus_assert_size(stats.evictions,==,2u);
+  munit_plus_assert_size(stats.entries,==,0u);
+  munit_plus_assert_size(stats.bytes,==,0u);
+  munit_plus_assert_true(test_fontcache_match(a, fonts[0]));
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_fontcache_threads
+  (const MunitPlusParameter params[], void* data)
+{
+  unsigned int const thread_count = munit_plus_rand_int_range(2,4);
+  unsigned int const rounds = 8u;
+  (void)params;
+  (void)data;
+  std::vector<test_fontcache_font> fonts(3u);
+  for (test_fontcache_font& f : fonts)
+    f = test_fontcache_make();
+  tca::font_cache cache;
+  std::vector<unsigned int> good(thread_count, 0u);
+  /* fetch */{
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0u; t < thread_count; ++t) {
+      threads.emplace_back([&cache,&fonts,&good,t,rounds]() {
+        for (unsigned int r = 0u; r < rounds; ++r) {
+          test_fontcache_font const& f = fonts[(t+r)%fonts.size()];
+          std::unique_ptr<mmaptwo::mmaptwo_i> const xfh(mmaptwo::memopen(
+            const_cast<unsigned char*>(f.woff2.data()), f.woff2.size(),
+            false));
+          tca::api_error ae;
+          tca::font_view const view = cache.fetch(xfh.get(), nullptr, ae);
+          if (ae == tca::api_error::Success && test_fontcache_match(view, f))
+            good[t] += 1u;
+        }
+      });
+    }
+    for (std::thread& th : threads)
+      th.join();
+  }
+  for (unsigned int t = 0u; t < thread_count; ++t)
+    munit_plus_assert_uint(good[t],==,rounds);
+  tca::fontcache_stats const stats = cache.get_stats();
+  munit_plus_assert_size(stats.hits+stats.misses,==,thread_count*rounds);
+  munit_plus_assert_size(stats.misses,>=,fonts.size());
+  munit_plus_assert_size(stats.entries,==,fonts.size());
+  munit_plus_assert_size(stats.evictions,==,0u);
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  return munit_plus_suite_main(&suite_fontcache, nullptr, argc, argv);
+}
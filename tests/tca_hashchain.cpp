@@ -20,6 +20,8 @@ static MunitPlusResult test_hashchain_addring
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_hashchain_find
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_hashchain_copy
+    (const MunitPlusParameter params[], void* data);
 static void* test_hashchain_setupsmall
     (const MunitPlusParameter params[], void* user_data);
 static void* test_hashchain_setup
@@ -46,6 +48,10 @@ static MunitPlusTest tests_hashchain[] = {
       test_hashchain_setupsmall,test_hashchain_teardown,
       MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"copy", test_hashchain_copy,
+      test_hashchain_setupsmall,test_hashchain_teardown,
+      MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -269,6 +275,45 @@ MunitPlusResult test_hashchain_find
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_hashchain_copy
+  (const MunitPlusParameter params[], void* data)
+{
+  text_complex::access::hash_chain* const p =
+    static_cast<text_complex::access::hash_chain*>(data);
+  int const add_count = munit_plus_rand_int_range(3,600);
+  unsigned char buf[600];
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  munit_plus_rand_memory(add_count, buf);
+  /* add the items */{
+    int i;
+    for (i = 0; i < add_count; ++i) {
+      text_complex::access::api_error ae;
+      p->push_front(buf[i], ae);
+      munit_plus_assert(ae == text_complex::access::api_error::Success);
+    }
+  }
+  /* compare the copy */{
+    text_complex::access::hash_chain const q(*p);
+    text_complex::access::hash_chain r(16u, 1u);
+    std::uint32_t i;
+    int j;
+    r = q;
+    munit_plus_assert_uint32(q.size(), ==, p->size());
+    munit_plus_assert_uint32(r.extent(), ==, p->extent());
+    for (i = 0u; i < p->size(); ++i) {
+      munit_plus_assert_uint8(q[i], ==, (*p)[i]);
+      munit_plus_assert_uint8(r[i], ==, (*p)[i]);
+    }
+    for (j = 0; j < add_count-2; ++j) {
+      munit_plus_assert_uint32(q.find(buf+j), ==, p->find(buf+j));
+      munit_plus_assert_uint32(r.find(buf+j), ==, p->find(buf+j));
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
 
 int main(int argc, char **argv) {
   return munit_plus_suite_main(&suite_hashchain, nullptr, argc, argv);
@@ -20,6 +20,10 @@ static MunitPlusResult test_offtable_cycle
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_offtable_item
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_offtable_find
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_offtable_transfer
+    (const MunitPlusParameter params[], void* data);
 static void* test_offtable_setup
     (const MunitPlusParameter params[], void* user_data);
 static void test_offtable_teardown(void* fixture);
@@ -32,6 +36,12 @@ static MunitPlusTest tests_offtable[] = {
   {(char*)"item", test_offtable_item,
       test_offtable_setup,test_offtable_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"find", test_offtable_find,
+      test_offtable_setup,test_offtable_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"transfer", test_offtable_transfer,
+      test_offtable_setup,test_offtable_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -104,6 +114,98 @@ MunitPlusResult test_offtable_item
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_offtable_find
+  (const MunitPlusParameter params[], void* data)
+{
+  text_complex::access::offset_table* const offtable =
+    (text_complex::access::offset_table*)data;
+  text_complex::access::offset_table const* const offtable_c = offtable;
+  if (offtable == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  std::size_t const sz = offtable->size();
+  /* few distinct tags, so some repeat */
+  for (text_complex::access::offset_line& line : *offtable) {
+    unsigned int const x =
+      static_cast<unsigned int>(munit_plus_rand_int_range(0,63));
+    line.tag[0] = 0x61u;
+    line.tag[1] = static_cast<unsigned char>(0x61u+(x>>4));
+    line.tag[2] = static_cast<unsigned char>(0x61u+(x&15u));
+    line.tag[3] = 0x20u;
+  }
+  for (int round = 0; round < 3; ++round) {
+    if (round == 1) {
+      offtable->reindex();
+    } else if (round == 2) {
+      /* writing a line drops the index, so no stale line comes back */
+      std::size_t const j = static_cast<std::size_t>(
+            munit_plus_rand_int_range(0,static_cast<int>(sz)-1)
+          );
+      text_complex::access::offset_line& line = (*offtable)[j];
+      line.tag[1] = 0x60u;
+      line.tag[2] = 0x61u;
+      munit_plus_assert_size(offtable_c->find(line.tag), ==, j);
+    }
+    for (unsigned int x = 0u; x < 64u; ++x) {
+      unsigned char const tag[4] = {
+          0x61u, static_cast<unsigned char>(0x61u+(x>>4)),
+          static_cast<unsigned char>(0x61u+(x&15u)), 0x20u
+        };
+      std::size_t first;
+      for (first = 0u; first < sz; ++first) {
+        if (std::memcmp((*offtable_c)[first].tag, tag, 4) == 0)
+          break;
+      }
+      munit_plus_assert_size(offtable->find(tag), ==, first);
+      unsigned long const packed = (0x61ul<<24)|((0x61ul+(x>>4))<<16)
+        | ((0x61ul+(x&15u))<<8) | 0x20ul;
+      munit_plus_assert_size(offtable->find(
+          static_cast<text_complex::access::uint32>(packed)), ==, first);
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_offtable_transfer
+  (const MunitPlusParameter params[], void* data)
+{
+  text_complex::access::offset_table* const offtable =
+    (text_complex::access::offset_table*)data;
+  if (offtable == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  std::size_t const sz = offtable->size();
+  std::size_t i = 0u;
+  for (text_complex::access::offset_line& line : *offtable) {
+    line.tag[0] = 0x61u;
+    line.tag[1] = static_cast<unsigned char>(0x61u+((i>>8)&15u));
+    line.tag[2] = static_cast<unsigned char>(0x61u+((i>>4)&15u));
+    line.tag[3] = static_cast<unsigned char>(0x61u+(i&15u));
+    i += 1u;
+  }
+  offtable->reindex();
+  /* the lines and the index move together */{
+    text_complex::access::offset_table moved(std::move(*offtable));
+    text_complex::access::offset_table const& moved_c = moved;
+    munit_plus_assert_size(offtable->size(), ==, 0u);
+    munit_plus_assert_size(moved.size(), ==, sz);
+    for (i = 0u; i < sz; ++i)
+      munit_plus_assert_size(moved_c.find(moved_c[i].tag), ==, i);
+    text_complex::access::offset_table copied(moved);
+    munit_plus_assert_size(copied.find(moved_c[0].tag), ==, 0u);
+    /* assignment frees the old lines and leaves the source empty */
+    copied = std::move(moved);
+    munit_plus_assert_size(moved.size(), ==, 0u);
+    munit_plus_assert_size(copied.size(), ==, sz);
+    *offtable = std::move(copied);
+    munit_plus_assert_size(copied.size(), ==, 0u);
+  }
+  munit_plus_assert_size(offtable->size(), ==, sz);
+  munit_plus_assert_size(offtable->find(
+      static_cast<text_complex::access::uint32>(0x61616161ul)), ==, 0u);
+  return MUNIT_PLUS_OK;
+}
+
 
 int main(int argc, char **argv) {
   return munit_plus_suite_main(&suite_offtable, nullptr, argc, argv);
@@ -46,6 +46,8 @@ static MunitPlusResult test_ringdist_encode
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_ringdist_reconfigure
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_ringdist_forget
+    (const MunitPlusParameter params[], void* data);
 static void* test_ringdist_1951_setup
     (const MunitPlusParameter params[], void* user_data);
 static void* test_ringdist_7932_setup
@@ -86,6 +88,9 @@ static MunitPlusTest tests_ringdist[] = {
   {(char*)"7932/reconfigure", test_ringdist_reconfigure,
       test_ringdist_7932_setup,test_ringdist_teardown,
       MUNIT_PLUS_TEST_OPTION_NONE,test_ringdist_params},
+  {(char*)"7932/forget", test_ringdist_forget,
+      test_ringdist_7932_setup,test_ringdist_teardown,
+      MUNIT_PLUS_TEST_OPTION_NONE,test_ringdist_params},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -371,14 +376,53 @@ MunitPlusResult test_ringdist_reconfigure
   unsigned int decomposed_code = p->encode(back_dist, decomposed_extra, 32768u);
   munit_plus_assert(decomposed_code != UINT_MAX);
   text_complex::access::api_error res;
-  p->reconfigure(1, testfont_rand_uint_range(0,120), fixt->postfix_size, res);
+  unsigned int const direct = testfont_rand_uint_range(0,120);
+  /* differ from the current NPOSTFIX so a dropped update shows */
+  unsigned int const postfix =
+    (fixt->postfix_size + testfont_rand_uint_range(1,3)) % 4u;
+  p->reconfigure(1, direct, postfix, res);
   munit_plus_assert(res == text_complex::access::api_error::Success);
+  munit_plus_assert_uint(p->get_direct(),==,direct);
+  munit_plus_assert_uint(p->get_postfix(),==,postfix);
   decomposed_code = p->encode(back_dist, decomposed_extra, 32768u);
   munit_plus_assert(decomposed_code == 0);
   return MUNIT_PLUS_OK;
 }
 
 
+MunitPlusResult test_ringdist_forget
+  (const MunitPlusParameter params[], void* data)
+{
+  test_ringdist_fixture *const fixt = static_cast<test_ringdist_fixture*>(data);
+  text_complex::access::distance_ring* const p = (fixt ? fixt->rd.get() : nullptr);
+  if (p == NULL)
+    return MUNIT_PLUS_SKIP;
+  static_cast<void>(params);
+  text_complex::access::distance_ring q
+    (fixt->special_tf, fixt->direct_count, fixt->postfix_size);
+  /* give the decoder a history unknown to the encoder */{
+    text_complex::access::distance_ring r = q;
+    int j;
+    for (j = 0; j < 4; ++j) {
+      unsigned int const back_dist = testfont_rand_uint_range(1u,64u);
+      text_complex::access::uint32 extra = 0;
+      unsigned int const code = r.encode(back_dist, extra, 32768u);
+      munit_plus_assert_uint32(q.decode(code, extra, 32768u),==,back_dist);
+    }
+  }
+  p->forget();
+  /* round-trip test */{
+    int j;
+    for (j = 0; j < 100; ++j) {
+      unsigned int const back_dist = testfont_rand_uint_range(1u,64u);
+      text_complex::access::uint32 extra = 0;
+      unsigned int const code = p->encode(back_dist, extra, 32768u);
+      munit_plus_assert_uint32(q.decode(code, extra, 32768u),==,back_dist);
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
 
 int main(int argc, char **argv) {
   return munit_plus_suite_main(&suite_ringdist, nullptr, argc, argv);
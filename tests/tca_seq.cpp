@@ -44,6 +44,16 @@ static MunitPlusResult test_seq_seek
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_seq_whence
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seq_window
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seq_read
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seq_typed
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seq_cache
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seq_memory
+    (const MunitPlusParameter params[], void* data);
 #if  (!(defined TextComplexAccessP_NO_IOSTREAM)) \
   && (!(defined TextComplexAccessP_NO_LOCALE))
 static MunitPlusResult test_seqbuf_cycle
@@ -64,6 +74,12 @@ static MunitPlusResult test_seqstream_whence
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_seqstream_setbuf
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seqstream_read
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seqbuf_transfer
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_seqbuf_move_one
+    (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_seqwstream_eof
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_seqwstream_eof_const
@@ -119,6 +135,21 @@ static MunitPlusTest tests_seq[] = {
   {(char*)"null_whence", test_seq_whence,
       test_seq_null_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"window", test_seq_window,
+      test_seq_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"read", test_seq_read,
+      test_seq_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"typed", test_seq_typed,
+      test_seq_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"cache", test_seq_cache,
+      test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"memory", test_seq_memory,
+      test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
 #if  (!(defined TextComplexAccessP_NO_IOSTREAM)) \
   && (!(defined TextComplexAccessP_NO_LOCALE))
   {(char*)"buf/cycle", test_seqbuf_cycle,
@@ -154,6 +185,15 @@ static MunitPlusTest tests_seq[] = {
   {(char*)"stream/setbuf", test_seqstream_setbuf,
       test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"stream/read", test_seqstream_read,
+      test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"buf/transfer", test_seqbuf_transfer,
+      test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"buf/move_one", test_seqbuf_move_one,
+      test_seq_mapper_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {(char*)"wstream/null_eof", test_seqwstream_eof,
       test_seq_null_setup,test_seq_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
@@ -407,6 +447,310 @@ MunitPlusResult test_seq_seek
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_seq_window
+  (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  text_complex::access::sequential* const p = fixt->seq;
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  text_complex::access::seq_window const mode =
+    static_cast<text_complex::access::seq_window>(
+        munit_plus_rand_int_range(0,3));
+  std::size_t const size =
+    static_cast<std::size_t>(munit_plus_rand_int_range(0,16384));
+  munit_plus_logf(MUNIT_PLUS_LOG_INFO,
+    "mode %i, size %" MUNIT_PLUS_SIZE_MODIFIER "u",
+    static_cast<int>(mode), size);
+  p->set_window(mode, size);
+  munit_plus_assert(p->get_window() == mode);
+  munit_plus_assert_size(p->get_window_size(),==,size);
+  /* read forward */{
+    size_t i;
+    for (i = 0u; i < fixt->len; ++i) {
+      int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+      munit_plus_assert_int(p->get_byte(),==,d);
+    }
+    munit_plus_assert_int(p->get_byte(),==,-1);
+  }
+  /* then jump around */{
+    int j;
+    for (j = 0; j < 20 && fixt->len > 0u; ++j) {
+      std::size_t const i = (std::size_t)munit_plus_rand_int_range(
+          0, static_cast<int>(fixt->len-1u));
+      int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+      munit_plus_assert_size(i,==,p->set_pos(i));
+      munit_plus_assert_int(p->get_byte(),==,d);
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seq_read
+  (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  text_complex::access::sequential* const p = fixt->seq;
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  std::vector<unsigned char> buf;
+  /* read in chunks */{
+    size_t i = 0u;
+    while (i < fixt->len) {
+      size_t const n = (size_t)munit_plus_rand_int_range(1,9000);
+      size_t const expect = (n < fixt->len-i) ? n : fixt->len-i;
+      buf.resize(n);
+      munit_plus_assert_size(p->read(buf.data(), n),==,expect);
+      for (size_t j = 0u; j < expect; ++j) {
+        int const d = tcmplxAtest_gen_datum(fixt->gen, i+j, fixt->seed);
+        munit_plus_assert_int(buf[j],==,d);
+      }
+      i += expect;
+      munit_plus_assert_size(p->get_pos(),==,i);
+    }
+    munit_plus_assert_size(p->read(buf.data(), buf.size()),==,0u);
+  }
+  /* peek at spans */{
+    int j;
+    for (j = 0; j < 20; ++j) {
+      size_t const i = testfont_rand_size_range(0u, fixt->len);
+      size_t const n = (size_t)munit_plus_rand_int_range(0,9000);
+      munit_plus_assert_size(p->set_pos(i),==,i);
+      unsigned char const* const span = p->peek_span(n);
+      munit_plus_assert_size(p->get_pos(),==,i);
+      if (n > fixt->len-i) {
+        munit_plus_assert_ptr_null(span);
+        continue;
+      } else if (n == 0u)
+        continue;
+      munit_plus_assert_ptr_not_null(span);
+      for (size_t k = 0u; k < n; ++k) {
+        int const d = tcmplxAtest_gen_datum(fixt->gen, i+k, fixt->seed);
+        munit_plus_assert_int(span[k],==,d);
+      }
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seq_typed
+  (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  text_complex::access::sequential* const p = fixt->seq;
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  int j;
+  for (j = 0; j < 40; ++j) {
+    size_t const i = testfont_rand_size_range(0u, fixt->len);
+    size_t const left = fixt->len - i;
+    unsigned long x[5] = {0u};
+    text_complex::access::api_error ae;
+    for (size_t k = 0u; k < 5u && k < left; ++k)
+      x[k] = (unsigned long)tcmplxAtest_gen_datum(fixt->gen, i+k, fixt->seed);
+    munit_plus_assert_size(p->set_pos(i),==,i);
+    switch (j%4) {
+    case 0:
+      {
+        unsigned short const v = p->read_u16be(ae);
+        if (left < 2u) {
+          munit_plus_assert(ae == text_complex::access::api_error::Sanitize);
+          munit_plus_assert_size(p->get_pos(),==,i);
+        } else {
+          munit_plus_assert(ae == text_complex::access::api_error::Success);
+          munit_plus_assert_ulong(v,==,(x[0]<<8)|x[1]);
+          munit_plus_assert_size(p->get_pos(),==,i+2u);
+        }
+      } break;
+    case 1:
+      {
+        unsigned long const v = p->read_u32be(ae);
+        if (left < 4u) {
+          munit_plus_assert(ae == text_complex::access::api_error::Sanitize);
+          munit_plus_assert_size(p->get_pos(),==,i);
+        } else {
+          munit_plus_assert(ae == text_complex::access::api_error::Success);
+          munit_plus_assert_ulong(v,==,(x[0]<<24)|(x[1]<<16)|(x[2]<<8)|x[3]);
+          munit_plus_assert_size(p->get_pos(),==,i+4u);
+        }
+      } break;
+    case 2:
+      {
+        /* decode by hand */
+        unsigned long expect = 0u;
+        size_t k;
+        bool ok = false;
+        for (k = 0u; k < 5u && k < left; ++k) {
+          if (k == 0u && x[k] == 0x80)
+            break;
+          else if (k == 4u && ((x[k]&0x80) || expect > 0x1ffFFffu))
+            break;
+          expect = (expect<<7)|(x[k]&0x7f);
+          if (!(x[k]&0x80)) {
+            ok = true;
+            break;
+          }
+        }
+        unsigned long const v = p->read_uv128(ae);
+        if (!ok) {
+          munit_plus_assert(ae == text_complex::access::api_error::Sanitize);
+          munit_plus_assert_size(p->get_pos(),==,i);
+        } else {
+          munit_plus_assert(ae == text_complex::access::api_error::Success);
+          munit_plus_assert_ulong(v,==,expect);
+          munit_plus_assert_size(p->get_pos(),==,i+k+1u);
+        }
+      } break;
+    case 3:
+      {
+        size_t need;
+        unsigned long expect;
+        switch (x[0]) {
+        case 253: need = 3u; expect = (x[1]<<8)|x[2]; break;
+        case 254: need = 2u; expect = x[1]+506u; break;
+        case 255: need = 2u; expect = x[1]+253u; break;
+        default: need = 1u; expect = x[0]; break;
+        }
+        unsigned long const v = p->read_u255(ae);
+        if (left < need) {
+          munit_plus_assert(ae == text_complex::access::api_error::Sanitize);
+          munit_plus_assert_size(p->get_pos(),==,i);
+        } else {
+          munit_plus_assert(ae == text_complex::access::api_error::Success);
+          munit_plus_assert_ulong(v,==,expect);
+          munit_plus_assert_size(p->get_pos(),==,i+need);
+        }
+      } break;
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seq_cache
+  (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  mmaptwo::mmaptwo_i* const m = fixt->mapper;
+  if (m == nullptr || fixt->len == 0u)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  std::size_t const count = testfont_rand_size_range(0u, 4u);
+  std::unique_ptr<mmaptwo::cache_i> c(mmaptwo::cache(m, count, false));
+  munit_plus_assert_not_null(c.get());
+  munit_plus_assert_size(c->capacity(),==,count);
+  munit_plus_assert_size(c->length(),==,m->length());
+  /* pages in use are shared */{
+    std::size_t const off = testfont_rand_size_range(0u, fixt->len-1u);
+    std::size_t const sz = testfont_rand_size_range(1u, fixt->len-off);
+    std::unique_ptr<mmaptwo::page_i> a(c->acquire(sz, off));
+    munit_plus_assert_not_null(a.get());
+    std::unique_ptr<mmaptwo::page_i> b(c->acquire(sz, off));
+    munit_plus_assert_not_null(b.get());
+    munit_plus_assert_size(c->misses(),==,1u);
+    munit_plus_assert_size(c->hits(),==,1u);
+    munit_plus_assert_ptr_equal(a->get(), b->get());
+    munit_plus_assert_size(b->length(),==,sz);
+    munit_plus_assert_size(b->offset(),==,off);
+    unsigned char const* const bytes =
+      static_cast<unsigned char const*>(b->get());
+    for (std::size_t i = 0u; i < sz; ++i) {
+      int const d = tcmplxAtest_gen_datum(fixt->gen, off+i, fixt->seed);
+      munit_plus_assert_int(bytes[i],==,d);
+    }
+    munit_plus_assert_null(c->acquire(1u, fixt->len));
+  }
+  /* jump between a few spots */{
+    std::size_t const base_misses = c->misses();
+    std::size_t spots[3];
+    int j;
+    text_complex::access::sequential p(c.get());
+    p.set_window(text_complex::access::seq_window::Page);
+    for (j = 0; j < 3; ++j)
+      spots[j] = testfont_rand_size_range(0u, fixt->len-1u);
+    for (j = 0; j < 30; ++j) {
+      std::size_t const i = spots[munit_plus_rand_int_range(0,2)];
+      int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+      munit_plus_assert_size(i,==,p.set_pos(i));
+      munit_plus_assert_int(p.get_byte(),==,d);
+    }
+    /* at most one window per spot and one for the start */
+    if (count >= 3u)
+      munit_plus_assert_size(c->misses()-base_misses,<=,4u);
+  }
+  /* pages outlive the cache */{
+    std::unique_ptr<mmaptwo::page_i> a(c->acquire(1u, 0u));
+    munit_plus_assert_not_null(a.get());
+    c.reset();
+    munit_plus_assert_int(
+        static_cast<unsigned char const*>(a->get())[0],==,
+        tcmplxAtest_gen_datum(fixt->gen, 0u, fixt->seed));
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seq_memory
+  (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  (void)params;
+  std::shared_ptr<unsigned char> buf(
+      new unsigned char[fixt->len+1u], std::default_delete<unsigned char[]>());
+  for (std::size_t i = 0u; i < fixt->len; ++i) {
+    buf.get()[i] = static_cast<unsigned char>(
+        tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed));
+  }
+  /* caller-owned buffer */{
+    std::unique_ptr<mmaptwo::mmaptwo_i> m(
+        mmaptwo::memopen(buf.get(), fixt->len, false));
+    munit_plus_assert_not_null(m.get());
+    munit_plus_assert_size(m->length(),==,fixt->len);
+    munit_plus_assert_null(m->acquire(1u, fixt->len));
+    if (fixt->len > 0u) {
+      std::size_t const off = testfont_rand_size_range(0u, fixt->len-1u);
+      std::size_t const sz = testfont_rand_size_range(1u, fixt->len-off);
+      std::unique_ptr<mmaptwo::page_i> pg(m->acquire(sz, off));
+      munit_plus_assert_not_null(pg.get());
+      /* views, not copies */
+      munit_plus_assert_ptr_equal(pg->get(), buf.get()+off);
+      munit_plus_assert_size(pg->length(),==,sz);
+      munit_plus_assert_size(pg->offset(),==,off);
+    }
+    text_complex::access::sequential p(m.get());
+    for (std::size_t i = 0u; i < fixt->len; ++i) {
+      int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+      munit_plus_assert_int(p.get_byte(),==,d);
+    }
+    munit_plus_assert_int(p.get_byte(),==,-1);
+  }
+  /* shared buffer outlives its owners */{
+    std::unique_ptr<mmaptwo::mmaptwo_i> m(
+        mmaptwo::memopen(std::shared_ptr<void const>(buf), fixt->len, false));
+    munit_plus_assert_not_null(m.get());
+    if (fixt->len > 0u) {
+      std::unique_ptr<mmaptwo::page_i> pg(m->acquire(fixt->len, 0u));
+      munit_plus_assert_not_null(pg.get());
+      m.reset();
+      buf.reset();
+      unsigned char const* const bytes =
+        static_cast<unsigned char const*>(pg->get());
+      for (std::size_t i = 0u; i < fixt->len; ++i) {
+        int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+        munit_plus_assert_int(bytes[i],==,d);
+      }
+    }
+  }
+  munit_plus_assert_null(mmaptwo::memopen(nullptr, 1u, false));
+  return MUNIT_PLUS_OK;
+}
+
 MunitPlusResult test_seq_whence
   (const MunitPlusParameter params[], void* data)
 {
@@ -894,6 +1238,131 @@ MunitPlusResult test_seqstream_setbuf
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_seqstream_read
+    (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  mmaptwo::mmaptwo_i* const m = fixt->mapper;
+  text_complex::access::isequentialstream v(m);
+  std::vector<char> buf(fixt->len+1u);
+  (void)params;
+  munit_plus_logf(MUNIT_PLUS_LOG_INFO,
+    "inspecting until %" MUNIT_PLUS_SIZE_MODIFIER "u", fixt->len);
+  /* */{
+    std::size_t i = 0u;
+    if (fixt->len > 0u)
+      munit_plus_assert_llong(v.rdbuf()->in_avail(),>,0);
+    while (i < fixt->len) {
+      /* mix short buffered reads with long direct reads */
+      std::size_t const left = fixt->len-i;
+      std::size_t const n = munit_plus_rand_int_range(0,1)
+        ? testfont_rand_size_range(1u,(left < 16u) ? left : 16u)
+        : testfont_rand_size_range(1u,left);
+      munit_plus_assert_llong(v.tellg(),==,i);
+      v.read(buf.data(), static_cast<std::streamsize>(n));
+      munit_plus_assert_true(static_cast<bool>(v));
+      munit_plus_assert_llong(v.gcount(),==,n);
+      for (std::size_t j = 0u; j < n; ++j) {
+        int const d = tcmplxAtest_gen_datum(fixt->gen, i+j, fixt->seed);
+        munit_plus_assert_int(static_cast<unsigned char>(buf[j])&255,==,d);
+      }
+      i += n;
+    }
+    munit_plus_assert_llong(v.tellg(),==,i);
+    munit_plus_assert_llong(v.rdbuf()->in_avail(),==,-1);
+    /* reading past the end comes up short */
+    v.seekg(0, std::ios_base::beg);
+    v.read(buf.data(), static_cast<std::streamsize>(fixt->len+1u));
+    munit_plus_assert_llong(v.gcount(),==,fixt->len);
+    munit_plus_assert_true(v.eof());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seqbuf_transfer
+    (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  mmaptwo::mmaptwo_i* const m = fixt->mapper;
+  text_complex::access::sequentialbuf v, w;
+  (void)params;
+  if (fixt->len == 0u)
+    return MUNIT_PLUS_SKIP;
+  munit_plus_assert_not_null(v.set_mapping(m));
+  munit_plus_assert_not_null(w.set_mapping(m));
+  /* */{
+    std::size_t const v_pos = testfont_rand_size_range(1u,fixt->len);
+    std::size_t const w_pos = testfont_rand_size_range(1u,fixt->len);
+    std::size_t i;
+    for (i = 0u; i < v_pos; ++i)
+      v.sbumpc();
+    for (i = 0u; i < w_pos; ++i)
+      w.sbumpc();
+    munit_plus_logf(MUNIT_PLUS_LOG_INFO,
+      "swapping at %" MUNIT_PLUS_SIZE_MODIFIER "u and "
+      "%" MUNIT_PLUS_SIZE_MODIFIER "u", v_pos, w_pos);
+    /* relative seeks start from the buffered read position */
+    v.swap(w);
+    munit_plus_assert_llong
+      (v.pubseekoff(-1, std::ios_base::cur),==,w_pos-1u);
+    munit_plus_assert_int(v.sbumpc(),==,
+      tcmplxAtest_gen_datum(fixt->gen, w_pos-1u, fixt->seed));
+    munit_plus_assert_llong
+      (w.pubseekoff(-1, std::ios_base::cur),==,v_pos-1u);
+    munit_plus_assert_int(w.sbumpc(),==,
+      tcmplxAtest_gen_datum(fixt->gen, v_pos-1u, fixt->seed));
+    /* move assignment onto a buffer of its own */
+    v = std::move(w);
+    munit_plus_assert_llong
+      (v.pubseekoff(-1, std::ios_base::cur),==,v_pos-1u);
+    munit_plus_assert_int(v.sbumpc(),==,
+      tcmplxAtest_gen_datum(fixt->gen, v_pos-1u, fixt->seed));
+    /* move construction */{
+      text_complex::access::sequentialbuf u(std::move(v));
+      munit_plus_assert_llong
+        (u.pubseekoff(-1, std::ios_base::cur),==,v_pos-1u);
+      munit_plus_assert_int(u.sbumpc(),==,
+        tcmplxAtest_gen_datum(fixt->gen, v_pos-1u, fixt->seed));
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_seqbuf_move_one
+    (const MunitPlusParameter params[], void* data)
+{
+  struct test_seq_fixture* const fixt =
+    static_cast<struct test_seq_fixture*>(data);
+  mmaptwo::mmaptwo_i* const m = fixt->mapper;
+  text_complex::access::sequentialbuf v;
+  (void)params;
+  munit_plus_assert_not_null(v.set_mapping(m));
+  munit_plus_assert_not_null(v.pubsetbuf(nullptr, 0));
+  /* */{
+    std::size_t const start = testfont_rand_size_range(0u,fixt->len);
+    std::size_t i;
+    for (i = 0u; i < start; ++i)
+      v.sbumpc();
+    munit_plus_logf(MUNIT_PLUS_LOG_INFO,
+      "moving at %" MUNIT_PLUS_SIZE_MODIFIER "u", start);
+    text_complex::access::sequentialbuf w(std::move(v));
+    /* the source reuses its own one-unit buffer */
+    munit_plus_assert_not_null(v.set_mapping(m));
+    munit_plus_assert_not_null(v.pubsetbuf(nullptr, 0));
+    for (i = start; i < fixt->len; ++i) {
+      int const d = tcmplxAtest_gen_datum(fixt->gen, i, fixt->seed);
+      munit_plus_assert_int(w.sgetc(),==,d);
+      if (v.sbumpc() == -1)
+        v.pubseekpos(0);
+      munit_plus_assert_int(w.sbumpc(),==,d);
+    }
+    munit_plus_assert_int(w.sgetc(),==,-1);
+  }
+  return MUNIT_PLUS_OK;
+}
+
 MunitPlusResult test_seqwstream_eof
     (const MunitPlusParameter params[], void* data)
 {
@@ -0,0 +1,383 @@
+/**
+ * @brief Test program for sfnt
+ */
+#include "testfont.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
+#include "text-complex-plus/access/offtable.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+struct test_sfnt_table {
+  unsigned char tag[4];
+  std::vector<unsigned char> data;
+};
+
+static unsigned char const test_sfnt_tags[10][4] = {
+  {0x4f,0x53,0x2f,0x32}/* OS/2 */, {0x63,0x6d,0x61,0x70}/* cmap */,
+  {0x67,0x6c,0x79,0x66}/* glyf */, {0x68,0x65,0x61,0x64}/* head */,
+  {0x68,0x68,0x65,0x61}/* hhea */, {0x68,0x6d,0x74,0x78}/* hmtx */,
+  {0x6c,0x6f,0x63,0x61}/* loca */, {0x6d,0x61,0x78,0x70}/* maxp */,
+  {0x6e,0x61,0x6d,0x65}/* name */, {0x70,0x6f,0x73,0x74}/* post */
+};
+
+static void test_sfnt_put16(std::vector<unsigned char>& out, unsigned x);
+static void test_sfnt_put32(std::vector<unsigned char>& out,
+    unsigned long x);
+static void test_sfnt_set32(unsigned char* s, unsigned long x);
+static unsigned long test_sfnt_get32(unsigned char const* s);
+static unsigned long test_sfnt_sum
+    (unsigned char const* tag, std::vector<unsigned char> const& data);
+static std::vector<unsigned char> test_sfnt_build
+    ( std::vector<test_sfnt_table> const& pool,
+      std::vector<std::vector<std::size_t>> const& fonts, bool collection,
+      std::vector<unsigned long>* places = nullptr);
+static std::unique_ptr<tca::sfnt> test_sfnt_open
+    (std::vector<unsigned char> const& file, std::size_t size,
+      bool sane_tf = true);
+
+static MunitPlusResult test_sfnt_fonts
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_sfnt_sanitize
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_sfnt_checksum
+    (const MunitPlusParameter params[], void* data);
+
+
+static MunitPlusTest tests_sfnt[] = {
+  {(char*)"fonts", test_sfnt_fonts,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"sanitize", test_sfnt_sanitize,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"checksum", test_sfnt_checksum,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_sfnt = {
+  (char*)"access/sfnt/", tests_sfnt, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+void test_sfnt_put16(std::vector<unsigned char>& out, unsigned x) {
+  out.push_back(static_cast<unsigned char>((x>>8)&255u));
+  out.push_back(static_cast<unsigned char>(x&255u));
+}
+
+void test_sfnt_put32(std::vector<unsigned char>& out, unsigned long x) {
+  test_sfnt_put16(out, static_cast<unsigned>((x>>16)&0xFFFFu));
+  test_sfnt_put16(out, static_cast<unsigned>(x&0xFFFFu));
+}
+
+void test_sfnt_set32(unsigned char* s, unsigned long x) {
+  s[0] = static_cast<unsigned char>((x>>24)&255u);
+  s[1] = static_cast<unsigned char>((x>>16)&255u);
+  s[2] = static_cast<unsigned char>((x>>8)&255u);
+  s[3] = static_cast<unsigned char>(x&255u);
+}
+
+unsigned long test_sfnt_get32(unsigned char const* s) {
+  return (static_cast<unsigned long>(s[0])<<24)
+    |  (static_cast<unsigned long>(s[1])<<16)
+    |  (static_cast<unsigned long>(s[2])<<8)
+    |  static_cast<unsigned long>(s[3]);
+}
+
+unsigned long test_sfnt_sum
+  (unsigned char const* tag, std::vector<unsigned char> const& data)
+{
+  unsigned long sum = 0u;
+  for (std::size_t i = 0u; i < data.size(); i += 4u) {
+    unsigned char word[4] = {0u,0u,0u,0u};
+    std::memcpy(word, &data[i], std::min<std::size_t>(4u, data.size()-i));
+    if (i == 8u && std::memcmp(tag, "head", 4) == 0
+    &&  data.size() >= 12u)
+      continue;
+    sum = (sum + test_sfnt_get32(word))&0xFFffFFffu;
+  }
+  return sum;
+}
+
+std::vector<unsigned char> test_sfnt_build
+  ( std::vector<test_sfnt_table> const& pool,
+    std::vector<std::vector<std::size_t>> const& fonts, bool collection,
+    std::vector<unsigned long>* places)
+{
+  std::vector<unsigned char> out;
+  std::vector<std::size_t> directories;
+  std::vector<unsigned long> offsets(pool.size(), 0u);
+  if (collection) {
+    test_sfnt_put32(out, 0x74746366u);
+    test_sfnt_put32(out, 0x00010000u);
+    test_sfnt_put32(out, fonts.size());
+    out.resize(out.size()+4u*fonts.size(), 0u);
+  }
+  for (std::size_t f = 0u; f < fonts.size(); ++f) {
+    std::size_t const n = fonts[f].size();
+    if (collection)
+      test_sfnt_set32(&out[12u+4u*f], out.size());
+    directories.push_back(out.size());
+    test_sfnt_put32(out, 0x00010000u);
+    test_sfnt_put16(out, static_cast<unsigned>(n));
+    /* search fields go unchecked */
+    out.resize(out.size()+6u+16u*n, 0u);
+  }
+  for (std::size_t i = 0u; i < pool.size(); ++i) {
+    offsets[i] = out.size();
+    out.insert(out.end(), pool[i].data.begin(), pool[i].data.end());
+    out.resize((out.size()+3u)&~static_cast<std::size_t>(3u), 0u);
+  }
+  for (std::size_t f = 0u; f < fonts.size(); ++f) {
+    for (std::size_t j = 0u; j < fonts[f].size(); ++j) {
+      std::size_t const i = fonts[f][j];
+      unsigned char* const record = &out[directories[f]+12u+16u*j];
+      std::memcpy(record, pool[i].tag, 4);
+      test_sfnt_set32(record+4, test_sfnt_sum(pool[i].tag, pool[i].data));
+      test_sfnt_set32(record+8, offsets[i]);
+      test_sfnt_set32(record+12, pool[i].data.size());
+    }
+  }
+  if (places)
+    *places = offsets;
+  return out;
+}
+
+std::unique_ptr<tca::sfnt> test_sfnt_open
+  (std::vector<unsigned char> const& file, std::size_t size, bool sane_tf)
+{
+  mmaptwo::mmaptwo_i* const m2i = mmaptwo::memopen(file.data(), size, false);
+  std::unique_ptr<tca::sfnt> out = tca::sfnt_unique(m2i, sane_tf);
+  if (!out) {
+    delete m2i;
+  }
+  return out;
+}
+
+MunitPlusResult test_sfnt_fonts
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<test_sfnt_table> pool;
+  std::vector<std::vector<std::size_t>> fonts;
+  std::vector<bool> used;
+  std::vector<unsigned long> places;
+  std::size_t const font_count = testfont_rand_size_range(1u,4u);
+  bool const collection = font_count > 1u
+    || (munit_plus_rand_uint32()&1u) != 0u;
+  (void)params;
+  (void)data;
+  /* two variants of each table for fonts to share */
+  for (std::size_t i = 0u; i < 20u; ++i) {
+    test_sfnt_table t;
+    std::memcpy(t.tag, test_sfnt_tags[i/2u], 4);
+    t.data.resize(testfont_rand_size_range(0u,200u));
+    for (unsigned char& c : t.data)
+      c = static_cast<unsigned char>(munit_plus_rand_uint32());
+    pool.push_back(t);
+  }
+  used.assign(pool.size(), false);
+  for (std::size_t f = 0u; f < font_count; ++f) {
+    std::vector<std::size_t> font;
+    for (std::size_t k = 0u; k < 10u; ++k) {
+      if (munit_plus_rand_uint32()&1u)
+        continue;
+      std::size_t const i = 2u*k+(munit_plus_rand_uint32()&1u);
+      font.push_back(i);
+      used[i] = true;
+    }
+    fonts.push_back(font);
+  }
+  std::vector<unsigned char> const file =
+    test_sfnt_build(pool, fonts, collection, &places);
+  std::unique_ptr<tca::sfnt> const s =
+    test_sfnt_open(file, file.size());
+  munit_plus_assert_not_null(s.get());
+  munit_plus_assert_ulong(s->get_flavor(), ==,
+    collection ? 0x74746366u : 0x00010000u);
+  munit_plus_assert_size(s->font_count(), ==, font_count);
+  /* shared tables appear once */{
+    std::size_t use_count = 0u;
+    for (bool const u : used)
+      use_count += u ? 1u : 0u;
+    munit_plus_assert_size(s->get_offsets().size(), ==, use_count);
+    for (tca::offset_line const& line : s->get_offsets()) {
+      std::size_t i;
+      /* empty tables share an offset with the next table */
+      for (i = 0u; i < pool.size(); ++i) {
+        if (places[i] == line.offset
+        &&  pool[i].data.size() == line.length
+        &&  std::memcmp(pool[i].tag, line.tag, 4) == 0)
+          break;
+      }
+      munit_plus_assert_size(i, <, pool.size());
+      munit_plus_assert_ulong(line.checksum, ==,
+        test_sfnt_sum(pool[i].tag, pool[i].data));
+      munit_plus_assert_memory_equal(4, line.tag, pool[i].tag);
+      munit_plus_assert_ulong(line.length, ==, pool[i].data.size());
+    }
+  }
+  for (std::size_t f = 0u; f < font_count; ++f) {
+    for (std::size_t k = 0u; k < 10u; ++k) {
+      std::size_t i;
+      tca::api_error ae;
+      tca::table_span const span = s->table(f, test_sfnt_tags[k], ae);
+      for (i = 2u*k; i < 2u*k+2u; ++i) {
+        if (std::find(fonts[f].begin(), fonts[f].end(), i)
+            != fonts[f].end())
+          break;
+      }
+      if (i == 2u*k+2u) {
+        munit_plus_assert(ae == tca::api_error::OutOfRange);
+        munit_plus_assert_ptr_null(span.data);
+        continue;
+      }
+      munit_plus_assert(ae == tca::api_error::Success);
+      munit_plus_assert_size(span.size, ==, pool[i].data.size());
+      /* straight from the mapping */
+      munit_plus_assert_ptr_equal(span.data, file.data()+places[i]);
+      if (span.size > 0u) {
+        munit_plus_assert_memory_equal(span.size, span.data,
+          pool[i].data.data());
+      }
+    }
+  }
+  /* the first font with a tag answers for the file */
+  for (std::size_t k = 0u; k < 10u; ++k) {
+    tca::api_error ae;
+    tca::table_span const span = s->table(test_sfnt_tags[k], ae);
+    std::size_t f;
+    for (f = 0u; f < font_count; ++f) {
+      tca::api_error font_ae;
+      tca::table_span const font_span =
+        s->table(f, test_sfnt_tags[k], font_ae);
+      if (font_ae == tca::api_error::Success) {
+        munit_plus_assert(ae == tca::api_error::Success);
+        munit_plus_assert_ptr_equal(span.data, font_span.data);
+        break;
+      }
+    }
+    if (f == font_count)
+      munit_plus_assert(ae == tca::api_error::OutOfRange);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_sfnt_sanitize
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<test_sfnt_table> pool;
+  std::vector<std::vector<std::size_t>> fonts(1u);
+  (void)params;
+  (void)data;
+  for (std::size_t k = 0u; k < 3u; ++k) {
+    test_sfnt_table t;
+    std::memcpy(t.tag, test_sfnt_tags[k], 4);
+    t.data.assign(testfont_rand_size_range(1u,40u), 7u);
+    pool.push_back(t);
+    fonts[0].push_back(k);
+  }
+  std::vector<unsigned char> const file = test_sfnt_build(pool, fonts, false);
+  /* good file */{
+    std::unique_ptr<tca::sfnt> const s =
+      test_sfnt_open(file, file.size());
+    munit_plus_assert_not_null(s.get());
+    munit_plus_assert_size(s->get_offsets().size(), ==, 3u);
+  }
+  /* too short for a header */{
+    std::unique_ptr<tca::sfnt> const s = test_sfnt_open(file, 11u);
+    munit_plus_assert_null(s.get());
+  }
+  /* table past the end of the file */{
+    std::vector<unsigned char> bad = file;
+    unsigned char* const record = &bad[12u+16u*2u];
+    test_sfnt_set32(record+12, bad.size()-test_sfnt_get32(record+8)+1u);
+    std::unique_ptr<tca::sfnt> const s =
+      test_sfnt_open(bad, bad.size());
+    munit_plus_assert_null(s.get());
+  }
+  /* unsorted directory */{
+    std::vector<unsigned char> bad = file;
+    unsigned char record[16];
+    std::memcpy(record, &bad[12], 16);
+    std::memcpy(&bad[12], &bad[28], 16);
+    std::memcpy(&bad[28], record, 16);
+    std::unique_ptr<tca::sfnt> const s =
+      test_sfnt_open(bad, bad.size());
+    munit_plus_assert_null(s.get());
+    std::unique_ptr<tca::sfnt> const lax =
+      test_sfnt_open(bad, bad.size(), false);
+    munit_plus_assert_not_null(lax.get());
+  }
+  /* unknown flavor */{
+    std::vector<unsigned char> bad = file;
+    test_sfnt_set32(&bad[0], 0x77774F46u);
+    std::unique_ptr<tca::sfnt> const s =
+      test_sfnt_open(bad, bad.size());
+    munit_plus_assert_null(s.get());
+  }
+  /* table changed after summing */{
+    std::vector<unsigned char> bad = file;
+    unsigned char* const record = &bad[12u+16u*1u];
+    bad[test_sfnt_get32(record+8)] ^= 1u;
+    std::unique_ptr<tca::sfnt> const s =
+      test_sfnt_open(bad, bad.size());
+    munit_plus_assert_null(s.get());
+    std::unique_ptr<tca::sfnt> const lax =
+      test_sfnt_open(bad, bad.size(), false);
+    munit_plus_assert_not_null(lax.get());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_sfnt_checksum
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> text(testfont_rand_size_range(0u,20000u));
+  bool const head = (munit_plus_rand_uint32()&1u) != 0u;
+  unsigned char const* const tag = test_sfnt_tags[head ? 3 : 1];
+  (void)params;
+  (void)data;
+  for (unsigned char& c : text)
+    c = static_cast<unsigned char>(munit_plus_rand_uint32());
+  unsigned long const expected = test_sfnt_sum(tag, text);
+  munit_plus_assert_ulong(
+    tca::sfnt_table_checksum(tag, text.data(), text.size()), ==, expected);
+  /* pieces at any split add up */{
+    unsigned long sum = 0u;
+    std::size_t pos = 0u;
+    while (pos < text.size()) {
+      std::size_t const n =
+        testfont_rand_size_range(1u, std::min<std::size_t>(text.size()-pos,
+          5000u));
+      sum += tca::sfnt_checksum(text.data()+pos, n, pos);
+      pos += n;
+    }
+    if (head && text.size() >= 12u)
+      sum -= test_sfnt_get32(text.data()+8);
+    munit_plus_assert_ulong(sum&0xFFffFFffu, ==, expected);
+  }
+  /* all ones stress the narrow counters */{
+    std::vector<unsigned char> const ones(65536u+5u, 255u);
+    munit_plus_assert_ulong(tca::sfnt_checksum(ones.data(), ones.size()),
+      ==, test_sfnt_sum(test_sfnt_tags[1], ones));
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  struct tcmplxAtest_arg tfa;
+  return munit_plus_suite_main_custom
+    (&suite_sfnt, &tfa, argc, argv, tcmplxAtest_get_args());
+}
@@ -0,0 +1,102 @@
+/**
+ * @brief Test program for worker thread pool
+ */
+#include "text-complex-plus/access/taskpool.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+namespace tca = text_complex::access;
+
+static MunitPlusResult test_taskpool_cycle
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_taskpool_wait
+    (const MunitPlusParameter params[], void* data);
+static void* test_taskpool_setup
+    (const MunitPlusParameter params[], void* user_data);
+static void test_taskpool_teardown(void* fixture);
+static void test_taskpool_add(void* arg);
+
+
+static MunitPlusTest tests_taskpool[] = {
+  {(char*)"cycle", test_taskpool_cycle,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,nullptr},
+  {(char*)"wait", test_taskpool_wait,
+      test_taskpool_setup,test_taskpool_teardown,
+      MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_taskpool = {
+  (char*)"access/taskpool/", tests_taskpool, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+MunitPlusResult test_taskpool_cycle
+  (const MunitPlusParameter params[], void* data)
+{
+  unsigned int const threads = munit_plus_rand_int_range(1,4);
+  tca::task_pool* ptr[2];
+  (void)params;
+  (void)data;
+  ptr[0] = tca::taskpool_new(threads);
+  ptr[1] = new tca::task_pool(threads);
+  std::unique_ptr<tca::task_pool> ptr2 = tca::taskpool_unique();
+  munit_plus_assert_not_null(ptr[0]);
+  munit_plus_assert_not_null(ptr[1]);
+  munit_plus_assert_not_null(ptr2.get());
+  munit_plus_assert_uint(ptr[0]->size(),==,threads);
+  munit_plus_assert_uint(ptr2->size(),>,0u);
+  /* move */{
+    tca::task_pool moved(std::move(*ptr[1]));
+    munit_plus_assert_uint(moved.size(),==,threads);
+    munit_plus_assert_uint(ptr[1]->size(),==,0u);
+  }
+  tca::taskpool_destroy(ptr[0]);
+  delete ptr[1];
+  return MUNIT_PLUS_OK;
+}
+
+void* test_taskpool_setup(const MunitPlusParameter params[], void* user_data) {
+  (void)params;
+  (void)user_data;
+  return tca::taskpool_new(munit_plus_rand_int_range(1,4));
+}
+
+void test_taskpool_teardown(void* fixture) {
+  tca::taskpool_destroy(static_cast<tca::task_pool*>(fixture));
+  return;
+}
+
+void test_taskpool_add(void* arg) {
+  static_cast<std::atomic<unsigned int>*>(arg)->fetch_add(1u);
+  return;
+}
+
+MunitPlusResult test_taskpool_wait
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::task_pool* const p = static_cast<tca::task_pool*>(data);
+  std::atomic<unsigned int> counter(0u);
+  unsigned int const count = munit_plus_rand_int_range(1,256);
+  (void)params;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  for (unsigned int i = 0u; i < count; ++i) {
+    tca::api_error ae = tca::api_error::Success;
+    p->post(test_taskpool_add, &counter, ae);
+    munit_plus_assert(ae == tca::api_error::Success);
+  }
+  p->wait();
+  munit_plus_assert_uint(counter.load(),==,count);
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  return munit_plus_suite_main(&suite_taskpool, nullptr, argc, argv);
+}
@@ -3,20 +3,78 @@
  */
 #include "testfont.hpp"
 #include "text-complex-plus/access/woff2.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
 #include "text-complex-plus/access/offtable.hpp"
+#include "text-complex-plus/access/brcvt.hpp"
+#include "text-complex-plus/access/taskpool.hpp"
 #include "mmaptwo-plus/mmaptwo.hpp"
 #include "munit-plus/munit.hpp"
 #include <memory>
+#include <algorithm>
+#include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 
+namespace tca = text_complex::access;
+
+struct test_woff2_table {
+  unsigned char tag[4];
+  std::vector<unsigned char> data;
+  /** @brief Whether `data` holds the transformed table. */
+  bool transformed = false;
+  /** @brief Length before transformation. */
+  std::size_t orig_length = 0u;
+};
+
+struct test_woff2_glyf {
+  /** @brief Glyph data as reconstruction should produce it. */
+  std::vector<unsigned char> glyf;
+  std::vector<unsigned char> loca;
+  std::vector<unsigned char> transformed;
+};
+
+static void test_woff2_put16(std::vector<unsigned char>& out, unsigned x);
+static void test_woff2_put32(std::vector<unsigned char>& out,
+    unsigned long x);
+static unsigned long test_woff2_get32(unsigned char const* s);
+static void test_woff2_putv128(std::vector<unsigned char>& out,
+    unsigned long x);
+static unsigned long test_woff2_checksum(unsigned char const* s,
+    std::size_t n);
+static std::vector<unsigned char> test_woff2_build
+    (std::vector<test_woff2_table> const& tables);
+static void test_woff2_putu255(std::vector<unsigned char>& out, unsigned x);
+static void test_woff2_triplet(std::vector<unsigned char>& flags,
+    std::vector<unsigned char>& glyph, bool on_curve, int dx, int dy);
+static int test_woff2_rand_delta(int pos);
+static std::vector<test_woff2_table> test_woff2_make_hmtx
+  (std::vector<unsigned char>& hmtx);
+static test_woff2_glyf test_woff2_make_glyf
+    (unsigned int glyph_count, unsigned int index_format);
+static std::vector<unsigned char> test_woff2_make_sfnt
+    (std::vector<test_woff2_table> const& tables);
+
 static MunitPlusResult test_woff2_cycle
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_woff2_item
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_woff2_tag_toi
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_decode_sfnt
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_decode_glyf
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_decode_hmtx
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_decode_real
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_lazy_table
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_lazy_real
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2_encode
+    (const MunitPlusParameter params[], void* data);
 static void* test_woff2_null_setup
     (const MunitPlusParameter params[], void* user_data);
 static void* test_woff2_setup
@@ -37,6 +95,27 @@ static MunitPlusTest tests_woff2[] = {
   {(char*)"tag_toi", test_woff2_tag_toi,
       nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"decode_sfnt", test_woff2_decode_sfnt,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"decode_glyf", test_woff2_decode_glyf,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"decode_hmtx", test_woff2_decode_hmtx,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"decode_real", test_woff2_decode_real,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,
+      nullptr},
+  {(char*)"table", test_woff2_lazy_table,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"table_real", test_woff2_lazy_real,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"encode", test_woff2_encode,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -45,8 +124,479 @@ static MunitPlusSuite const suite_woff2 = {
       1, MUNIT_PLUS_SUITE_OPTION_NONE
 };
 
+void test_woff2_put16(std::vector<unsigned char>& out, unsigned x) {
+  out.push_back(static_cast<unsigned char>((x>>8)&255u));
+  out.push_back(static_cast<unsigned char>(x&255u));
+}
+
+std::vector<test_woff2_table> test_woff2_make_hmtx
+  (std::vector<unsigned char>& hmtx)
+{
+  std::vector<test_woff2_table> tables;
+  unsigned int const glyph_count = testfont_rand_uint_range(1u,300u);
+  unsigned int const metric_count = testfont_rand_uint_range(1u,glyph_count);
+  unsigned int const flags = testfont_rand_uint_range(1u,3u);
+  bool const transform_glyf = (munit_plus_rand_uint32()&1u) != 0u;
+  test_woff2_glyf const glyf = test_woff2_make_glyf(glyph_count, 1u);
+  hmtx.clear();
+  /* fixed tables */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(1u), 4);
+    t.data.resize(54u, 0u);
+    t.data[51] = 1u;
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(2u), 4);
+    t.data.assign(36u, 0u);
+    t.data[34] = static_cast<unsigned char>(metric_count>>8);
+    t.data[35] = static_cast<unsigned char>(metric_count&255u);
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(4u), 4);
+    t.data.assign(6u, 0u);
+    t.data[4] = static_cast<unsigned char>(glyph_count>>8);
+    t.data[5] = static_cast<unsigned char>(glyph_count&255u);
+    tables.push_back(t);
+  }
+  /* glyphs, with or without their transform */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(10u), 4);
+    t.data = transform_glyf ? glyf.transformed : glyf.glyf;
+    t.transformed = transform_glyf;
+    t.orig_length = glyf.glyf.size();
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(11u), 4);
+    if (transform_glyf)
+      t.data.clear();
+    else t.data = glyf.loca;
+    t.orig_length = glyf.loca.size();
+    tables.push_back(t);
+  }
+  /* metrics, with left side bearings left to the glyphs */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(3u), 4);
+    t.transformed = true;
+    t.data.push_back(static_cast<unsigned char>(flags));
+    for (unsigned int i = 0u; i < glyph_count; ++i) {
+      unsigned long const start = test_woff2_get32(&glyf.loca[4u*i]);
+      unsigned long const end = test_woff2_get32(&glyf.loca[4u*i+4u]);
+      unsigned int const advance = testfont_rand_uint_range(0u,0xFFFFu);
+      unsigned int const x_min = (end > start)
+        ? glyf.glyf[start+2u]*256u+glyf.glyf[start+3u] : 0u;
+      if (i < metric_count) {
+        test_woff2_put16(hmtx, advance);
+        test_woff2_put16(t.data, advance);
+      }
+      test_woff2_put16(hmtx, x_min);
+    }
+    /* bearings that the flags keep come after the advances */
+    for (unsigned int i = 0u; i < glyph_count; ++i) {
+      unsigned int const x_min = (i < metric_count)
+        ? hmtx[4u*i+2u]*256u+hmtx[4u*i+3u]
+        : hmtx[2u*i+2u*metric_count]*256u+hmtx[2u*i+2u*metric_count+1u];
+      if ((i < metric_count) ? !(flags&1u) : !(flags&2u))
+        test_woff2_put16(t.data, x_min);
+    }
+    t.orig_length = hmtx.size();
+    tables.push_back(t);
+  }
+  return tables;
+}
+
+void test_woff2_put32(std::vector<unsigned char>& out, unsigned long x) {
+  test_woff2_put16(out, static_cast<unsigned>((x>>16)&0xFFFFu));
+  test_woff2_put16(out, static_cast<unsigned>(x&0xFFFFu));
+}
+
+unsigned long test_woff2_get32(unsigned char const* s) {
+  return (static_cast<unsigned long>(s[0])<<24)
+    | (static_cast<unsigned long>(s[1])<<16)
+    | (static_cast<unsigned long>(s[2])<<8) | s[3];
+}
+
+void test_woff2_putv128(std::vector<unsigned char>& out, unsigned long x) {
+  unsigned char buf[5];
+  int n = 0;
+  do {
+    buf[n++] = static_cast<unsigned char>(x&127u);
+    x >>= 7;
+  } while (x);
+  while (n > 1) {
+    out.push_back(buf[--n]|128u);
+  }
+  out.push_back(buf[0]);
+}
+
+unsigned long test_woff2_checksum(unsigned char const* s, std::size_t n) {
+  unsigned long sum = 0u;
+  std::size_t i;
+  for (i = 0u; i < n; i += 4u) {
+    unsigned char word[4] = {0u,0u,0u,0u};
+    std::memcpy(word, s+i, n-i < 4u ? n-i : 4u);
+    sum = (sum + test_woff2_get32(word))&0xFFffFFffu;
+  }
+  return sum;
+}
 
+std::vector<unsigned char> test_woff2_build
+    (std::vector<test_woff2_table> const& tables)
+{
+  std::vector<unsigned char> stream;
+  std::vector<unsigned char> packed;
+  std::vector<unsigned char> out;
+  unsigned long sfnt_size = 12u + 16u*tables.size();
+  for (test_woff2_table const& t : tables) {
+    stream.insert(stream.end(), t.data.begin(), t.data.end());
+    sfnt_size += ((t.transformed ? t.orig_length : t.data.size())+3u)&~3u;
+  }
+  /* compress */{
+    std::unique_ptr<tca::brcvt_state> const p =
+      tca::brcvt_unique(4096,4096,16);
+    tca::api_error ae;
+    unsigned char buf[256];
+    unsigned char const* from_next = stream.data();
+    munit_plus_assert_not_null(p.get());
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_out(*p, from_next, stream.data()+stream.size(),
+        from_next, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert(ae == tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::brcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert(ae == tca::api_error::EndOfFile);
+  }
+  /* header */{
+    static unsigned char const sig[4] = {0x77,0x4F,0x46,0x32};
+    out.insert(out.end(), sig, sig+4);
+    test_woff2_put32(out, 0x00010000u);
+    test_woff2_put32(out, 0u);
+    test_woff2_put16(out, static_cast<unsigned>(tables.size()));
+    test_woff2_put16(out, 0u);
+    test_woff2_put32(out, sfnt_size);
+    test_woff2_put32(out, packed.size());
+    test_woff2_put16(out, 1u);
+    test_woff2_put16(out, 0u);
+    out.resize(48u, 0u);
+  }
+  for (test_woff2_table const& t : tables) {
+    unsigned int const known = tca::woff2_tag_toi(t.tag);
+    /* glyf and loca need transform version 3 to stay untransformed */
+    unsigned int const version = (known == 10u || known == 11u)
+      ? (t.transformed ? 0u : 3u)
+      : (t.transformed ? 1u : 0u);
+    out.push_back(static_cast<unsigned char>(known|(version<<6)));
+    if (known == 63u)
+      out.insert(out.end(), t.tag, t.tag+4);
+    if (t.transformed)
+      test_woff2_putv128(out, t.orig_length);
+    test_woff2_putv128(out, t.data.size());
+  }
+  out.insert(out.end(), packed.begin(), packed.end());
+  out.resize((out.size()+3u)&~3u, 0u);
+  /* total length */{
+    unsigned long const len = out.size();
+    out[8] = static_cast<unsigned char>((len>>24)&255u);
+    out[9] = static_cast<unsigned char>((len>>16)&255u);
+    out[10] = static_cast<unsigned char>((len>>8)&255u);
+    out[11] = static_cast<unsigned char>(len&255u);
+  }
+  return out;
+}
 
+std::vector<unsigned char> test_woff2_make_sfnt
+    (std::vector<test_woff2_table> const& tables)
+{
+  std::vector<test_woff2_table const*> sorted;
+  std::vector<unsigned char> out;
+  for (test_woff2_table const& t : tables)
+    sorted.push_back(&t);
+  std::sort(sorted.begin(), sorted.end(),
+    [](test_woff2_table const* a, test_woff2_table const* b) {
+      return std::memcmp(a->tag, b->tag, 4) < 0;
+    });
+  test_woff2_put32(out, 0x00010000u);
+  test_woff2_put16(out, static_cast<unsigned>(sorted.size()));
+  out.resize(12u, 0u);
+  unsigned long offset = 12u + 16u*sorted.size();
+  for (test_woff2_table const* t : sorted) {
+    out.insert(out.end(), t->tag, t->tag+4);
+    /* `checkSumAdjustment` stays zero */
+    test_woff2_put32(out, test_woff2_checksum(t->data.data(), t->data.size()));
+    test_woff2_put32(out, offset);
+    test_woff2_put32(out, t->data.size());
+    offset += (t->data.size()+3u)&~3u;
+  }
+  for (test_woff2_table const* t : sorted) {
+    out.insert(out.end(), t->data.begin(), t->data.end());
+    out.resize((out.size()+3u)&~3u, 0u);
+  }
+  return out;
+}
+
+void test_woff2_putu255(std::vector<unsigned char>& out, unsigned x) {
+  if (x < 253u) {
+    out.push_back(static_cast<unsigned char>(x));
+  } else if (x < 506u) {
+    out.push_back(255u);
+    out.push_back(static_cast<unsigned char>(x-253u));
+  } else if (x < 762u) {
+    out.push_back(254u);
+    out.push_back(static_cast<unsigned char>(x-506u));
+  } else {
+    out.push_back(253u);
+    test_woff2_put16(out, x);
+  }
+}
+
+void test_woff2_triplet(std::vector<unsigned char>& flags,
+    std::vector<unsigned char>& glyph, bool on_curve, int dx, int dy)
+{
+  unsigned int const ax = static_cast<unsigned int>(dx < 0 ? -dx : dx);
+  unsigned int const ay = static_cast<unsigned int>(dy < 0 ? -dy : dy);
+  unsigned int const on_bit = on_curve ? 0u : 128u;
+  unsigned int const x_sign = (dx < 0) ? 0u : 1u;
+  unsigned int const y_sign = (dy < 0) ? 0u : 1u;
+  unsigned int const xy_sign = x_sign + 2u*y_sign;
+  if (dx == 0 && ay < 1280u) {
+    flags.push_back(static_cast<unsigned char>
+      (on_bit + ((ay&0xf00u)>>7) + y_sign));
+    glyph.push_back(static_cast<unsigned char>(ay&255u));
+  } else if (dy == 0 && ax < 1280u) {
+    flags.push_back(static_cast<unsigned char>
+      (on_bit + 10u + ((ax&0xf00u)>>7) + x_sign));
+    glyph.push_back(static_cast<unsigned char>(ax&255u));
+  } else if (ax < 65u && ay < 65u) {
+    flags.push_back(static_cast<unsigned char>(on_bit + 20u
+      + ((ax-1u)&0x30u) + (((ay-1u)&0x30u)>>2) + xy_sign));
+    glyph.push_back(static_cast<unsigned char>
+      ((((ax-1u)&0xfu)<<4) | ((ay-1u)&0xfu)));
+  } else if (ax < 769u && ay < 769u) {
+    flags.push_back(static_cast<unsigned char>(on_bit + 84u
+      + 12u*(((ax-1u)&0x300u)>>8) + (((ay-1u)&0x300u)>>6) + xy_sign));
+    glyph.push_back(static_cast<unsigned char>((ax-1u)&255u));
+    glyph.push_back(static_cast<unsigned char>((ay-1u)&255u));
+  } else if (ax < 4096u && ay < 4096u) {
+    flags.push_back(static_cast<unsigned char>(on_bit + 120u + xy_sign));
+    glyph.push_back(static_cast<unsigned char>(ax>>4));
+    glyph.push_back(static_cast<unsigned char>(((ax&0xfu)<<4) | (ay>>8)));
+    glyph.push_back(static_cast<unsigned char>(ay&255u));
+  } else {
+    flags.push_back(static_cast<unsigned char>(on_bit + 124u + xy_sign));
+    test_woff2_put16(glyph, ax);
+    test_woff2_put16(glyph, ay);
+  }
+}
+
+int test_woff2_rand_delta(int pos) {
+  static int const limits[5] = {0, 64, 768, 4095, 12000};
+  unsigned int const k = testfont_rand_uint_range(0u,4u);
+  int const d = k
+    ? testfont_rand_int_range(limits[k-1]+1, limits[k])
+    : 0;
+  /* stay well inside 16-bit coordinates */
+  if (pos > 8000)
+    return -d;
+  else if (pos < -8000)
+    return d;
+  else return (munit_plus_rand_uint32()&1u) ? d : -d;
+}
+
+test_woff2_glyf test_woff2_make_glyf
+    (unsigned int glyph_count, unsigned int index_format)
+{
+  test_woff2_glyf out;
+  std::vector<unsigned char> streams[7];
+  std::vector<unsigned char> bbox_bitmap(((glyph_count+31u)>>5)*4u, 0u);
+  std::vector<unsigned char> overlap_bitmap((glyph_count+7u)>>3, 0u);
+  bool const overlaps = (munit_plus_rand_uint32()&1u) != 0u;
+  unsigned int i;
+  for (i = 0u; i < glyph_count; ++i) {
+    unsigned int const kind = testfont_rand_uint_range(0u,5u);
+    std::size_t const start = out.glyf.size();
+    if (index_format)
+      test_woff2_put32(out.loca, start);
+    else test_woff2_put16(out.loca, static_cast<unsigned>(start/2u));
+    if (kind == 0u) {
+      /* empty */
+      test_woff2_put16(streams[0], 0u);
+      continue;
+    } else if (kind == 1u) {
+      /* composite */
+      unsigned int const count = testfont_rand_uint_range(1u,3u);
+      bool const instructions = (munit_plus_rand_uint32()&1u) != 0u;
+      test_woff2_put16(streams[0], 0xFFFFu);
+      test_woff2_put16(out.glyf, 0xFFFFu);
+      for (unsigned int k = 0u; k < 4u; ++k) {
+        unsigned const v = testfont_rand_uint_range(0u,0xFFFFu);
+        test_woff2_put16(streams[5], v);
+        test_woff2_put16(out.glyf, v);
+      }
+      bbox_bitmap[i>>3] |= static_cast<unsigned char>(0x80u>>(i&7u));
+      for (unsigned int c = 0u; c < count; ++c) {
+        static unsigned const scales[4] = {0u, 0x8u, 0x40u, 0x80u};
+        static std::size_t const scale_sizes[4] = {0u, 2u, 4u, 8u};
+        unsigned int const scale = testfont_rand_uint_range(0u,3u);
+        unsigned const words = munit_plus_rand_uint32()&1u;
+        unsigned const flags = words | 0x2u | scales[scale]
+          | (c+1u < count ? 0x20u : 0u)
+          | (c+1u == count && instructions ? 0x100u : 0u);
+        std::size_t const arg_size = 2u + (words ? 4u : 2u)
+          + scale_sizes[scale];
+        test_woff2_put16(streams[4], flags);
+        test_woff2_put16(out.glyf, flags);
+        for (std::size_t k = 0u; k < arg_size; ++k) {
+          unsigned char const v = static_cast<unsigned char>
+            (munit_plus_rand_uint32()&255u);
+          streams[4].push_back(v);
+          out.glyf.push_back(v);
+        }
+      }
+      if (instructions) {
+        unsigned int const len = testfont_rand_uint_range(0u,4u);
+        test_woff2_putu255(streams[3], len);
+        test_woff2_put16(out.glyf, len);
+        for (unsigned int k = 0u; k < len; ++k) {
+          unsigned char const v = static_cast<unsigned char>(k*7u+1u);
+          streams[6].push_back(v);
+          out.glyf.push_back(v);
+        }
+      }
+    } else {
+      /* simple */
+      unsigned int const contours = testfont_rand_uint_range(1u,3u);
+      std::vector<unsigned int> ends;
+      std::vector<int> xs, ys;
+      std::vector<bool> on;
+      unsigned int points = 0u;
+      test_woff2_put16(streams[0], contours);
+      for (unsigned int c = 0u; c < contours; ++c) {
+        /* sometimes long enough for the wider `255UInt16` codes */
+        unsigned int const n = (testfont_rand_uint_range(0u,15u) == 0u)
+          ? testfont_rand_uint_range(250u,520u)
+          : testfont_rand_uint_range(1u,8u);
+        test_woff2_putu255(streams[1], n);
+        points += n;
+        ends.push_back(points-1u);
+      }
+      int x = 0, y = 0;
+      int x_min = 0, y_min = 0, x_max = 0, y_max = 0;
+      for (unsigned int k = 0u; k < points; ++k) {
+        int const dx = test_woff2_rand_delta(x);
+        int const dy = test_woff2_rand_delta(y);
+        bool const on_curve = (munit_plus_rand_uint32()&1u) != 0u;
+        test_woff2_triplet(streams[2], streams[3], on_curve, dx, dy);
+        x += dx;
+        y += dy;
+        if (k == 0u) {
+          x_min = x_max = x;
+          y_min = y_max = y;
+        }
+        x_min = std::min(x_min, x);
+        x_max = std::max(x_max, x);
+        y_min = std::min(y_min, y);
+        y_max = std::max(y_max, y);
+        xs.push_back(x);
+        ys.push_back(y);
+        on.push_back(on_curve);
+      }
+      unsigned int const instruction_len =
+        (testfont_rand_uint_range(0u,15u) == 0u)
+        ? testfont_rand_uint_range(253u,800u)
+        : testfont_rand_uint_range(0u,5u);
+      test_woff2_putu255(streams[3], instruction_len);
+      bool const overlap = overlaps && (munit_plus_rand_uint32()&1u);
+      if (overlap)
+        overlap_bitmap[i>>3] |= static_cast<unsigned char>(0x80u>>(i&7u));
+      /* header, sometimes with a box bigger than the points */
+      test_woff2_put16(out.glyf, contours);
+      if (munit_plus_rand_uint32()&1u) {
+        x_min -= 1;
+        y_max += 1;
+        bbox_bitmap[i>>3] |= static_cast<unsigned char>(0x80u>>(i&7u));
+        test_woff2_put16(streams[5], static_cast<unsigned>(x_min)&0xFFFFu);
+        test_woff2_put16(streams[5], static_cast<unsigned>(y_min)&0xFFFFu);
+        test_woff2_put16(streams[5], static_cast<unsigned>(x_max)&0xFFFFu);
+        test_woff2_put16(streams[5], static_cast<unsigned>(y_max)&0xFFFFu);
+      }
+      test_woff2_put16(out.glyf, static_cast<unsigned>(x_min)&0xFFFFu);
+      test_woff2_put16(out.glyf, static_cast<unsigned>(y_min)&0xFFFFu);
+      test_woff2_put16(out.glyf, static_cast<unsigned>(x_max)&0xFFFFu);
+      test_woff2_put16(out.glyf, static_cast<unsigned>(y_max)&0xFFFFu);
+      for (unsigned int const e : ends)
+        test_woff2_put16(out.glyf, e);
+      test_woff2_put16(out.glyf, instruction_len);
+      for (unsigned int k = 0u; k < instruction_len; ++k) {
+        unsigned char const v = static_cast<unsigned char>(k*5u+3u);
+        streams[6].push_back(v);
+        out.glyf.push_back(v);
+      }
+      /* flags with repeats, then coordinates */{
+        std::vector<unsigned char> xb, yb;
+        int last_x = 0, last_y = 0;
+        unsigned last_flag = 0x100u;
+        unsigned repeat = 0u;
+        for (unsigned int k = 0u; k < points; ++k) {
+          int const dx = xs[k]-last_x;
+          int const dy = ys[k]-last_y;
+          unsigned flag = on[k] ? 1u : 0u;
+          if (k == 0u && overlap)
+            flag |= 0x40u;
+          if (dx == 0)
+            flag |= 0x10u;
+          else if (dx > -256 && dx < 256) {
+            flag |= 0x02u | (dx > 0 ? 0x10u : 0u);
+            xb.push_back(static_cast<unsigned char>(dx < 0 ? -dx : dx));
+          } else test_woff2_put16(xb, static_cast<unsigned>(dx)&0xFFFFu);
+          if (dy == 0)
+            flag |= 0x20u;
+          else if (dy > -256 && dy < 256) {
+            flag |= 0x04u | (dy > 0 ? 0x20u : 0u);
+            yb.push_back(static_cast<unsigned char>(dy < 0 ? -dy : dy));
+          } else test_woff2_put16(yb, static_cast<unsigned>(dy)&0xFFFFu);
+          if (flag == last_flag && repeat != 255u) {
+            out.glyf.back() |= 0x08u;
+            repeat += 1u;
+          } else {
+            if (repeat)
+              out.glyf.push_back(static_cast<unsigned char>(repeat));
+            out.glyf.push_back(static_cast<unsigned char>(flag));
+            repeat = 0u;
+          }
+          last_x = xs[k];
+          last_y = ys[k];
+          last_flag = flag;
+        }
+        if (repeat)
+          out.glyf.push_back(static_cast<unsigned char>(repeat));
+        out.glyf.insert(out.glyf.end(), xb.begin(), xb.end());
+        out.glyf.insert(out.glyf.end(), yb.begin(), yb.end());
+      }
+    }
+    out.glyf.resize((out.glyf.size()+3u)&~static_cast<std::size_t>(3u), 0u);
+  }
+  if (index_format)
+    test_woff2_put32(out.loca, out.glyf.size());
+  else test_woff2_put16(out.loca, static_cast<unsigned>(out.glyf.size()/2u));
+  /* transformed table */{
+    std::vector<unsigned char>& t = out.transformed;
+    streams[5].insert(streams[5].begin(),
+      bbox_bitmap.begin(), bbox_bitmap.end());
+    test_woff2_put16(t, 0u);
+    test_woff2_put16(t, overlaps ? 1u : 0u);
+    test_woff2_put16(t, glyph_count);
+    test_woff2_put16(t, index_format);
+    for (std::vector<unsigned char> const& s : streams)
+      test_woff2_put32(t, s.size());
+    for (std::vector<unsigned char> const& s : streams)
+      t.insert(t.end(), s.begin(), s.end());
+    if (overlaps)
+      t.insert(t.end(), overlap_bitmap.begin(), overlap_bitmap.end());
+  }
+  return out;
+}
 
 MunitPlusResult test_woff2_cycle
   (const MunitPlusParameter params[], void* data)
@@ -148,6 +698,487 @@ MunitPlusResult test_woff2_tag_toi
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_woff2_decode_sfnt
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<test_woff2_table> tables;
+  (void)params;
+  (void)data;
+  /* make some tables, including a `head` */{
+    static unsigned char const extra_tag[4] = {0x5a,0x7a,0x7a,0x7a};
+    unsigned int const count = testfont_rand_uint_range(1u,10u);
+    unsigned int i;
+    for (i = 0u; i < count; ++i) {
+      test_woff2_table t;
+      if (i == 0u) {
+        std::memcpy(t.tag, tca::woff2_tag_fromi(1u), 4);
+        t.data.resize(54u);
+      } else if (i+1u == count) {
+        std::memcpy(t.tag, extra_tag, 4);
+        t.data.resize(testfont_rand_size_range(0u,64u));
+      } else {
+        std::memcpy(t.tag, tca::woff2_tag_fromi(20u+i), 4);
+        t.data.resize(testfont_rand_size_range(0u,600u));
+      }
+      for (unsigned char& c : t.data) {
+        c = static_cast<unsigned char>(munit_plus_rand_int_range(0,7)*9);
+      }
+      tables.push_back(t);
+    }
+  }
+  std::vector<unsigned char> const file = test_woff2_build(tables);
+  std::unique_ptr<tca::woff2> const w =
+    tca::woff2_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(w.get());
+  munit_plus_assert_ulong(w->get_flavor(), ==, 0x00010000u);
+  std::vector<unsigned char> sfnt(w->sfnt_size());
+  /* too small */{
+    tca::api_error ae;
+    munit_plus_assert_size(w->decode_sfnt(sfnt.data(), 11u, ae), ==, 0u);
+    munit_plus_assert(ae == tca::api_error::BlockOverflow);
+  }
+  std::size_t const len = w->decode_sfnt(sfnt.data(), sfnt.size());
+  munit_plus_assert_size(len, ==, sfnt.size());
+  munit_plus_assert_ulong(test_woff2_get32(&sfnt[0]), ==, 0x00010000u);
+  munit_plus_assert_uint(sfnt[4]*256u+sfnt[5], ==, tables.size());
+  /* search fields */{
+    unsigned int const range = sfnt[6]*256u+sfnt[7];
+    unsigned int const selector = sfnt[8]*256u+sfnt[9];
+    munit_plus_assert_uint(range, ==, 16u<<selector);
+    munit_plus_assert_uint(range, <=, tables.size()*16u);
+    munit_plus_assert_uint(range*2u, >, tables.size()*16u);
+  }
+  for (std::size_t j = 0u; j < tables.size(); ++j) {
+    unsigned char const* const record = &sfnt[12u+16u*j];
+    unsigned long const checksum = test_woff2_get32(record+4);
+    unsigned long const offset = test_woff2_get32(record+8);
+    unsigned long const length = test_woff2_get32(record+12);
+    unsigned long const padded = (length+3u)&~3ul;
+    if (j > 0u)
+      munit_plus_assert_int(std::memcmp(record-16, record, 4), <, 0);
+    munit_plus_assert_ulong(offset%4u, ==, 0u);
+    munit_plus_assert_ulong(offset+padded, <=, len);
+    for (std::size_t k = length; k < padded; ++k)
+      munit_plus_assert_uint(sfnt[offset+k], ==, 0u);
+    test_woff2_table const* t = nullptr;
+    for (test_woff2_table const& u : tables) {
+      if (std::memcmp(u.tag, record, 4) == 0)
+        t = &u;
+    }
+    munit_plus_assert_not_null(t);
+    munit_plus_assert_ulong(length, ==, t->data.size());
+    if (std::memcmp(record, tca::woff2_tag_fromi(1u), 4) == 0) {
+      munit_plus_assert_memory_equal(8u, &sfnt[offset], t->data.data());
+      munit_plus_assert_memory_equal(length-12u, &sfnt[offset+12u],
+        t->data.data()+12u);
+      /* checksum as if `checkSumAdjustment` were zero */
+      munit_plus_assert_ulong(checksum, ==,
+        (test_woff2_checksum(&sfnt[offset], length)
+          - test_woff2_get32(&sfnt[offset+8u]))&0xFFffFFffu);
+    } else {
+      if (length > 0u)
+        munit_plus_assert_memory_equal(length, &sfnt[offset], t->data.data());
+      munit_plus_assert_ulong(checksum, ==,
+        test_woff2_checksum(&sfnt[offset], length));
+    }
+  }
+  munit_plus_assert_ulong(test_woff2_checksum(sfnt.data(), len),
+    ==, 0xB1B0AFBAu);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_decode_glyf
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<test_woff2_table> tables;
+  unsigned int const glyph_count = testfont_rand_uint_range(1u,1200u);
+  unsigned int const index_format = (glyph_count < 100u)
+    ? (munit_plus_rand_uint32()&1u) : 1u;
+  test_woff2_glyf const glyf = test_woff2_make_glyf(glyph_count, index_format);
+  (void)params;
+  (void)data;
+  /* head, then glyf and loca as the transform requires */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(1u), 4);
+    t.data.resize(54u, 0u);
+    t.data[51] = static_cast<unsigned char>(index_format);
+    tables.push_back(t);
+  }
+  /* understate the glyf length to exercise the size estimate */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(10u), 4);
+    t.data = glyf.transformed;
+    t.transformed = true;
+    t.orig_length = glyf.glyf.size()/2u;
+    tables.push_back(t);
+  }
+  /* loca has no transformed data */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(11u), 4);
+    t.transformed = true;
+    t.orig_length = glyf.loca.size();
+    tables.push_back(t);
+  }
+  std::vector<unsigned char> const file = test_woff2_build(tables);
+  tca::task_pool pool(2u);
+  for (int round = 0; round < 2; ++round) {
+    std::unique_ptr<tca::woff2> const w =
+      tca::woff2_unique(mmaptwo::memopen(file.data(), file.size(), false));
+    tca::task_pool* const use_pool = round ? &pool : nullptr;
+    munit_plus_assert_not_null(w.get());
+    std::vector<unsigned char> sfnt(w->sfnt_size());
+    if (glyf.glyf.size() > 4u) {
+      /* the estimate falls short */
+      tca::api_error ae;
+      munit_plus_assert_size(
+        w->decode_sfnt(sfnt.data(), sfnt.size(), use_pool, ae), ==, 0u);
+      munit_plus_assert(ae == tca::api_error::BlockOverflow);
+      munit_plus_assert_size(w->sfnt_size(), >, sfnt.size());
+      sfnt.resize(w->sfnt_size());
+    }
+    std::size_t const len = w->decode_sfnt(sfnt.data(), sfnt.size(), use_pool);
+    munit_plus_assert_size(len, ==, sfnt.size());
+    munit_plus_assert_uint(sfnt[4]*256u+sfnt[5], ==, 3u);
+    for (std::size_t j = 0u; j < 3u; ++j) {
+      unsigned char const* const record = &sfnt[12u+16u*j];
+      unsigned long const offset = test_woff2_get32(record+8);
+      unsigned long const length = test_woff2_get32(record+12);
+      munit_plus_assert_ulong(offset%4u, ==, 0u);
+      munit_plus_assert_ulong(offset+length, <=, len);
+      if (std::memcmp(record, tca::woff2_tag_fromi(10u), 4) == 0) {
+        munit_plus_assert_ulong(length, ==, glyf.glyf.size());
+        munit_plus_assert_memory_equal(length, &sfnt[offset],
+          glyf.glyf.data());
+      } else if (std::memcmp(record, tca::woff2_tag_fromi(11u), 4) == 0) {
+        munit_plus_assert_ulong(length, ==, glyf.loca.size());
+        munit_plus_assert_memory_equal(length, &sfnt[offset],
+          glyf.loca.data());
+      }
+      munit_plus_assert_ulong(test_woff2_get32(record+4), ==,
+        (test_woff2_checksum(&sfnt[offset], length)
+          - (j == 1u ? test_woff2_get32(&sfnt[offset+8u]) : 0u))
+        & 0xFFffFFffu);
+    }
+    munit_plus_assert_ulong(test_woff2_checksum(sfnt.data(), len),
+      ==, 0xB1B0AFBAu);
+  }
+  /* a transformed glyf needs its loca */{
+    tables.pop_back();
+    std::vector<unsigned char> const bad = test_woff2_build(tables);
+    mmaptwo::mmaptwo_i* const m2i =
+      mmaptwo::memopen(bad.data(), bad.size(), false);
+    std::unique_ptr<tca::woff2> const w = tca::woff2_unique(m2i);
+    munit_plus_assert_null(w.get());
+    delete m2i;
+    std::unique_ptr<tca::woff2> const lax = tca::woff2_unique
+      (mmaptwo::memopen(bad.data(), bad.size(), false), false);
+    munit_plus_assert_not_null(lax.get());
+    std::vector<unsigned char> sfnt(lax->sfnt_size());
+    tca::api_error ae;
+    munit_plus_assert_size(
+      lax->decode_sfnt(sfnt.data(), sfnt.size(), ae), ==, 0u);
+    munit_plus_assert(ae == tca::api_error::Sanitize);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_decode_hmtx
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> hmtx;
+  std::vector<test_woff2_table> const tables = test_woff2_make_hmtx(hmtx);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const file = test_woff2_build(tables);
+  std::unique_ptr<tca::woff2> const w =
+    tca::woff2_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(w.get());
+  std::vector<unsigned char> sfnt(w->sfnt_size());
+  std::size_t const len = w->decode_sfnt(sfnt.data(), sfnt.size());
+  munit_plus_assert_size(len, ==, sfnt.size());
+  for (std::size_t j = 0u; j < tables.size(); ++j) {
+    unsigned char const* const record = &sfnt[12u+16u*j];
+    unsigned long const offset = test_woff2_get32(record+8);
+    unsigned long const length = test_woff2_get32(record+12);
+    munit_plus_assert_ulong(offset+length, <=, len);
+    if (std::memcmp(record, tca::woff2_tag_fromi(3u), 4) == 0) {
+      munit_plus_assert_ulong(length, ==, hmtx.size());
+      munit_plus_assert_memory_equal(length, &sfnt[offset], hmtx.data());
+      munit_plus_assert_ulong(test_woff2_get32(record+4), ==,
+        test_woff2_checksum(&sfnt[offset], length));
+    }
+  }
+  munit_plus_assert_ulong(test_woff2_checksum(sfnt.data(), len),
+    ==, 0xB1B0AFBAu);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_decode_real
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  std::unique_ptr<tca::woff2> const w = tca::woff2_unique(
+      mmaptwo::memopen(tcmplxAtest_woff2_real, tcmplxAtest_woff2_real_size,
+        false)
+    );
+  munit_plus_assert_not_null(w.get());
+  std::vector<unsigned char> sfnt(w->sfnt_size());
+  /* the stream stops and resumes at the end of every table */
+  std::size_t const len = w->decode_sfnt(sfnt.data(), sfnt.size());
+  munit_plus_assert_size(len, ==, sfnt.size());
+  munit_plus_assert_int(tcmplxAtest_woff2_real_check_sfnt(sfnt.data(), len),
+    ==, 0);
+  munit_plus_assert_ulong(test_woff2_checksum(sfnt.data(), len),
+    ==, 0xB1B0AFBAu);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_lazy_table
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> hmtx;
+  std::vector<test_woff2_table> const tables = test_woff2_make_hmtx(hmtx);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const file = test_woff2_build(tables);
+  std::vector<unsigned char> sfnt;
+  /* reference image */{
+    std::unique_ptr<tca::woff2> const w =
+      tca::woff2_unique(mmaptwo::memopen(file.data(), file.size(), false));
+    munit_plus_assert_not_null(w.get());
+    sfnt.resize(w->sfnt_size());
+    sfnt.resize(w->decode_sfnt(sfnt.data(), sfnt.size()));
+  }
+  std::unique_ptr<tca::woff2> const w =
+    tca::woff2_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(w.get());
+  /* missing tag */{
+    static unsigned char const extra_tag[4] = {0x5a,0x7a,0x7a,0x7a};
+    tca::api_error ae;
+    tca::table_span const span = w->table(extra_tag, ae);
+    munit_plus_assert(ae == tca::api_error::OutOfRange);
+    munit_plus_assert_ptr_null(span.data);
+  }
+  /* visit the tables in random order, twice */
+  std::size_t const n = tables.size();
+  std::vector<tca::table_span> first(n);
+  for (std::size_t k = 0u; k < 2u*n; ++k) {
+    std::size_t const j = (k < n)
+      ? testfont_rand_size_range(0u,n-1u) : k-n;
+    unsigned char const* const record = &sfnt[12u+16u*j];
+    unsigned long const offset = test_woff2_get32(record+8);
+    unsigned long const length = test_woff2_get32(record+12);
+    tca::table_span const span = w->table(record);
+    munit_plus_assert_size(span.size, ==, length);
+    if (std::memcmp(record, tca::woff2_tag_fromi(1u), 4) == 0) {
+      /* `checkSumAdjustment` is only in the full image */
+      munit_plus_assert_memory_equal(8u, span.data, &sfnt[offset]);
+      munit_plus_assert_memory_equal(length-12u, span.data+12u,
+        &sfnt[offset+12u]);
+    } else if (length > 0u) {
+      munit_plus_assert_memory_equal(length, span.data, &sfnt[offset]);
+    }
+    /* views stay put */
+    if (first[j].data) {
+      munit_plus_assert_ptr_equal(first[j].data, span.data);
+    } else first[j] = span;
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_lazy_real
+  (const MunitPlusParameter params[], void* data)
+{
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> sfnt;
+  /* reference image */{
+    std::unique_ptr<tca::woff2> const w = tca::woff2_unique(
+        mmaptwo::memopen(tcmplxAtest_woff2_real,
+          tcmplxAtest_woff2_real_size, false)
+      );
+    munit_plus_assert_not_null(w.get());
+    sfnt.resize(w->sfnt_size());
+    sfnt.resize(w->decode_sfnt(sfnt.data(), sfnt.size()));
+  }
+  std::size_t const n = sfnt[4]*256u+sfnt[5];
+  munit_plus_assert_size(n, ==, tcmplxAtest_woff2_real_count);
+  /* 0: directory order, 1: reverse, 2: head, hhea and hmtx first,
+   * 3: shuffled */
+  for (unsigned int pass = 0u; pass < 4u; ++pass) {
+    std::vector<std::size_t> order(n);
+    for (std::size_t j = 0u; j < n; ++j)
+      order[j] = (pass == 1u) ? n-1u-j : j;
+    if (pass == 2u) {
+      static char const* const front[3] = {"head", "hhea", "hmtx"};
+      std::size_t at = 0u;
+      for (char const* tag : front) {
+        for (std::size_t j = at; j < n; ++j) {
+          if (std::memcmp(&sfnt[12u+16u*order[j]], tag, 4) == 0) {
+            std::swap(order[at], order[j]);
+            at += 1u;
+            break;
+          }
+        }
+      }
+    } else if (pass == 3u) {
+      for (std::size_t j = n-1u; j > 0u; --j)
+        std::swap(order[j], order[testfont_rand_size_range(0u,j)]);
+    }
+    std::unique_ptr<tca::woff2> const w = tca::woff2_unique(
+        mmaptwo::memopen(tcmplxAtest_woff2_real,
+          tcmplxAtest_woff2_real_size, false)
+      );
+    munit_plus_assert_not_null(w.get());
+    for (std::size_t const j : order) {
+      unsigned char const* const record = &sfnt[12u+16u*j];
+      unsigned long const offset = test_woff2_get32(record+8);
+      unsigned long const length = test_woff2_get32(record+12);
+      tca::table_span const span = w->table(record);
+      munit_plus_assert_size(span.size, ==, length);
+      munit_plus_assert_int(
+          tcmplxAtest_woff2_real_check(record, span.data, span.size), ==, 0);
+      if (std::memcmp(record, tca::woff2_tag_fromi(1u), 4) == 0) {
+        munit_plus_assert_memory_equal(8u, span.data, &sfnt[offset]);
+        munit_plus_assert_memory_equal(length-12u, span.data+12u,
+          &sfnt[offset+12u]);
+      } else {
+        munit_plus_assert_memory_equal(length, span.data, &sfnt[offset]);
+      }
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2_encode
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<test_woff2_table> tables;
+  unsigned int const glyph_count = testfont_rand_uint_range(1u,600u);
+  unsigned int const index_format = (glyph_count < 100u)
+    ? (munit_plus_rand_uint32()&1u) : 1u;
+  unsigned int const metric_count = testfont_rand_uint_range(1u,glyph_count);
+  /* 0: both bearing arrays match the glyphs, 1: only the first,
+   * 2: neither */
+  unsigned int const bearings = testfont_rand_uint_range(0u,2u);
+  test_woff2_glyf const glyf = test_woff2_make_glyf(glyph_count, index_format);
+  std::vector<unsigned char> hmtx;
+  (void)params;
+  (void)data;
+  /* fixed tables */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(1u), 4);
+    t.data.resize(54u, 0u);
+    t.data[4] = 2u;
+    t.data[6] = 0x80u;
+    t.data[51] = static_cast<unsigned char>(index_format);
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(2u), 4);
+    t.data.assign(36u, 0u);
+    t.data[34] = static_cast<unsigned char>(metric_count>>8);
+    t.data[35] = static_cast<unsigned char>(metric_count&255u);
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(4u), 4);
+    t.data.assign(6u, 0u);
+    t.data[4] = static_cast<unsigned char>(glyph_count>>8);
+    t.data[5] = static_cast<unsigned char>(glyph_count&255u);
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(10u), 4);
+    t.data = glyf.glyf;
+    tables.push_back(t);
+    std::memcpy(t.tag, tca::woff2_tag_fromi(11u), 4);
+    t.data = glyf.loca;
+    tables.push_back(t);
+  }
+  /* metrics */{
+    test_woff2_table t;
+    std::memcpy(t.tag, tca::woff2_tag_fromi(3u), 4);
+    for (unsigned int i = 0u; i < glyph_count; ++i) {
+      unsigned long const start = index_format
+        ? test_woff2_get32(&glyf.loca[4u*i])
+        : (glyf.loca[2u*i]*256u+glyf.loca[2u*i+1u])*2u;
+      unsigned long const end = index_format
+        ? test_woff2_get32(&glyf.loca[4u*i+4u])
+        : (glyf.loca[2u*i+2u]*256u+glyf.loca[2u*i+3u])*2u;
+      unsigned int x_min = (end > start)
+        ? glyf.glyf[start+2u]*256u+glyf.glyf[start+3u] : 0u;
+      if (i+1u == metric_count ? bearings > 0u : bearings > 1u)
+        x_min ^= 1u;
+      if (i < metric_count)
+        test_woff2_put16(t.data, testfont_rand_uint_range(0u,0xFFFFu));
+      test_woff2_put16(t.data, x_min);
+    }
+    hmtx = t.data;
+    tables.push_back(t);
+  }
+  /* a table without a known tag */{
+    static unsigned char const extra_tag[4] = {0x5a,0x7a,0x7a,0x7a};
+    test_woff2_table t;
+    std::memcpy(t.tag, extra_tag, 4);
+    for (unsigned int i = testfont_rand_uint_range(0u,40u); i > 0u; --i)
+      t.data.push_back(static_cast<unsigned char>(munit_plus_rand_uint32()));
+    tables.push_back(t);
+  }
+  std::vector<unsigned char> const file = test_woff2_make_sfnt(tables);
+  std::unique_ptr<tca::sfnt> const src =
+    tca::sfnt_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(src.get());
+  /* the pool does not change the output */
+  tca::woff2_encoder enc;
+  std::vector<unsigned char> encoded;
+  /* encode */{
+    tca::task_pool pool(2u);
+    std::size_t const len = enc.encode(*src);
+    munit_plus_assert_size(len, ==, enc.size());
+    munit_plus_assert_ulong(len%4u, ==, 0u);
+    encoded.assign(enc.get_data(), enc.get_data()+len);
+    munit_plus_assert_size(enc.encode(*src, &pool), ==, len);
+    munit_plus_assert_memory_equal(len, enc.get_data(), encoded.data());
+  }
+  std::unique_ptr<tca::woff2> const w = tca::woff2_unique
+    (mmaptwo::memopen(encoded.data(), encoded.size(), false));
+  munit_plus_assert_not_null(w.get());
+  munit_plus_assert_ulong(test_woff2_get32(&encoded[8]), ==, encoded.size());
+  /* glyf and loca are transformed; hmtx if a bearing array matches */{
+    tca::offset_table const& offsets = w->get_offsets();
+    munit_plus_assert_size(offsets.size(), ==, tables.size());
+    std::size_t const loca_i = offsets.find(tca::woff2_tag_fromi(11u));
+    std::size_t const hmtx_i = offsets.find(tca::woff2_tag_fromi(3u));
+    munit_plus_assert_size(loca_i, <, offsets.size());
+    munit_plus_assert_size(offsets[loca_i].length, ==, 0u);
+    munit_plus_assert_size(hmtx_i, <, offsets.size());
+    if (bearings < 2u) {
+      munit_plus_assert_size(offsets[hmtx_i].length, <, hmtx.size());
+    } else munit_plus_assert_size(offsets[hmtx_i].length, ==, hmtx.size());
+  }
+  std::vector<unsigned char> sfnt(w->sfnt_size());
+  std::size_t const len = w->decode_sfnt(sfnt.data(), sfnt.size());
+  munit_plus_assert_size(len, ==, sfnt.size());
+  munit_plus_assert_uint(sfnt[4]*256u+sfnt[5], ==, tables.size());
+  for (std::size_t j = 0u; j < tables.size(); ++j) {
+    unsigned char const* const record = &sfnt[12u+16u*j];
+    unsigned long const offset = test_woff2_get32(record+8);
+    unsigned long const length = test_woff2_get32(record+12);
+    test_woff2_table const* t = nullptr;
+    for (test_woff2_table const& u : tables) {
+      if (std::memcmp(u.tag, record, 4) == 0)
+        t = &u;
+    }
+    munit_plus_assert_not_null(t);
+    munit_plus_assert_ulong(length, ==, t->data.size());
+    if (std::memcmp(record, tca::woff2_tag_fromi(1u), 4) == 0) {
+      /* the font is flagged as converted */
+      munit_plus_assert_memory_equal(8u, &sfnt[offset], t->data.data());
+      munit_plus_assert_uint(sfnt[offset+16u], ==, 0x08u);
+      munit_plus_assert_memory_equal(length-17u, &sfnt[offset+17u],
+        t->data.data()+17u);
+    } else if (length > 0u) {
+      munit_plus_assert_memory_equal(length, &sfnt[offset], t->data.data());
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
 
 int main(int argc, char **argv) {
   struct tcmplxAtest_arg tfa;
@@ -0,0 +1,270 @@
+/**
+ * @brief Test program for batch decoding of WOFF2 files
+ */
+#include "testfont.hpp"
+#include "text-complex-plus/access/woff2batch.hpp"
+#include "text-complex-plus/access/woff2.hpp"
+#include "text-complex-plus/access/sfnt.hpp"
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <vector>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+struct test_woff2batch_log {
+  std::mutex lock;
+  /** @brief Number of times each file was reported. */
+  std::vector<unsigned int> seen;
+  /** @brief Status of each file. */
+  std::vector<tca::api_error> status;
+  /** @brief Decoded image of each file. */
+  std::vector<std::vector<unsigned char> > images;
+  unsigned int workers;
+  bool bad_worker;
+};
+
+static void test_woff2batch_put32(std::vector<unsigned char>& out,
+    unsigned long x);
+static std::vector<unsigned char> test_woff2batch_make
+    (std::vector<unsigned char>& file);
+static unsigned long test_woff2batch_get32(unsigned char const* p);
+static bool test_woff2batch_match(std::vector<unsigned char> const& image,
+    std::vector<unsigned char> const& file);
+static void test_woff2batch_record
+    (void* arg, tca::woff2batch_result const& result);
+
+static MunitPlusResult test_woff2batch_cycle
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_woff2batch_decode
+    (const MunitPlusParameter params[], void* data);
+
+
+static MunitPlusTest tests_woff2batch[] = {
+  {(char*)"cycle", test_woff2batch_cycle,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,nullptr},
+  {(char*)"decode", test_woff2batch_decode,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_woff2batch = {
+  (char*)"access/woff2batch/", tests_woff2batch, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+void test_woff2batch_put32(std::vector<unsigned char>& out, unsigned long x)
+{
+  out.push_back(static_cast<unsigned char>((x>>24)&255u));
+  out.push_back(static_cast<unsigned char>((x>>16)&255u));
+  out.push_back(static_cast<unsigned char>((x>>8)&255u));
+  out.push_back(static_cast<unsigned char>(x&255u));
+  return;
+}
+
+unsigned long test_woff2batch_get32(unsigned char const* p) {
+  return (static_cast<unsigned long>(p[0])<<24)
+    | (static_cast<unsigned long>(p[1])<<16)
+    | (static_cast<unsigned long>(p[2])<<8)
+    | static_cast<unsigned long>(p[3]);
+}
+
+bool test_woff2batch_match(std::vector<unsigned char> const& image,
+    std::vector<unsigned char> const& file)
+{
+  std::size_t const n = file[4]*256u+file[5];
+  if (image.size() < 12u+16u*n || image[4] != file[4] || image[5] != file[5])
+    return false;
+  for (std::size_t i = 0u; i < n; ++i) {
+    unsigned char const* const want = &file[12u+16u*i];
+    unsigned char const* got = nullptr;
+    for (std::size_t j = 0u; j < n && !got; ++j) {
+      if (std::memcmp(&image[12u+16u*j], want, 4) == 0)
+        got = &image[12u+16u*j];
+    }
+    if (!got)
+      return false;
+    unsigned long const length = test_woff2batch_get32(want+12);
+    unsigned long const offset = test_woff2batch_get32(got+8);
+    if (test_woff2batch_get32(got+12) != length
+    ||  offset > image.size() || length > image.size()-offset)
+    {
+      return false;
+    }
+    unsigned char const* const src = &file[test_woff2batch_get32(want+8)];
+    unsigned char const* const dst = &image[offset];
+    if (std::memcmp(want, "head", 4) == 0) {
+      /* the decoder rewrites `checkSumAdjustment` */
+      if (std::memcmp(dst, src, 8) != 0
+      ||  std::memcmp(dst+12, src+12, length-12u) != 0)
+      {
+        return false;
+      }
+    } else if (length > 0u && std::memcmp(dst, src, length) != 0)
+      return false;
+  }
+  return true;
+}
+
+std::vector<unsigned char> test_woff2batch_make
+  (std::vector<unsigned char>& file)
+{
+  static unsigned char const tags[3][4] = {
+    {0x68,0x65,0x61,0x64} /* head */,
+    {0x6e,0x61,0x6d,0x65} /* name */,
+    {0x70,0x6f,0x73,0x74} /* post */
+  };
+  std::vector<unsigned char> tables[3];
+  tables[0].resize(54u, 0u);
+  tables[0][4] = 1u;
+  for (std::size_t i = 1u; i < 3u; ++i) {
+    /* compressible text of random length */
+    tables[i].resize(munit_plus_rand_int_range(1,20000));
+    for (unsigned char& ch : tables[i])
+      ch = static_cast<unsigned char>(munit_plus_rand_int_range(97,104));
+  }
+  file.clear();
+  test_woff2batch_put32(file, 0x00010000u);
+  file.push_back(0u);
+  file.push_back(3u);
+  file.resize(12u, 0u);
+  unsigned long offset = 12u + 16u*3u;
+  for (std::size_t i = 0u; i < 3u; ++i) {
+    file.insert(file.end(), tags[i], tags[i]+4);
+    test_woff2batch_put32(file, tca::sfnt_table_checksum
+      (tags[i], tables[i].data(), tables[i].size()));
+    test_woff2batch_put32(file, offset);
+    test_woff2batch_put32(file, tables[i].size());
+    offset += (tables[i].size()+3u)&~3u;
+  }
+  for (std::vector<unsigned char> const& t : tables) {
+    file.insert(file.end(), t.begin(), t.end());
+    file.resize((file.size()+3u)&~3u, 0u);
+  }
+  std::unique_ptr<tca::sfnt> const src =
+    tca::sfnt_unique(mmaptwo::memopen(file.data(), file.size(), false));
+  munit_plus_assert_not_null(src.get());
+  tca::woff2_encoder enc;
+  std::size_t const len = enc.encode(*src);
+  return std::vector<unsigned char>(enc.get_data(), enc.get_data()+len);
+}
+
+void test_woff2batch_record(void* arg, tca::woff2batch_result const& result)
+{
+  test_woff2batch_log& log = *static_cast<test_woff2batch_log*>(arg);
+  std::lock_guard<std::mutex> guard(log.lock);
+  if (result.worker >= log.workers || result.index >= log.seen.size()) {
+    log.bad_worker = true;
+    return;
+  }
+  log.seen[result.index] += 1u;
+  log.status[result.index] = result.status;
+  if (result.data)
+    log.images[result.index].assign(result.data, result.data+result.size);
+  return;
+}
+
+MunitPlusResult test_woff2batch_cycle
+  (const MunitPlusParameter params[], void* data)
+{
+  unsigned int const threads = munit_plus_rand_int_range(1,4);
+  tca::woff2_batch* ptr[2];
+  (void)params;
+  (void)data;
+  ptr[0] = tca::woff2batch_new(threads);
+  ptr[1] = new tca::woff2_batch(threads);
+  std::unique_ptr<tca::woff2_batch> ptr2 = tca::woff2batch_unique();
+  munit_plus_assert_not_null(ptr[0]);
+  munit_plus_assert_not_null(ptr[1]);
+  munit_plus_assert_not_null(ptr2.get());
+  munit_plus_assert_uint(ptr[0]->size(),==,threads);
+  munit_plus_assert_uint(ptr2->size(),>,0u);
+  /* move */{
+    tca::woff2_batch moved(std::move(*ptr[1]));
+    munit_plus_assert_uint(moved.size(),==,threads);
+    munit_plus_assert_uint(ptr[1]->size(),==,0u);
+    tca::api_error ae;
+    ptr[1]->decode(nullptr, 0u, test_woff2batch_record, nullptr, ae);
+    munit_plus_assert(ae == tca::api_error::Init);
+    moved.decode(nullptr, 0u, nullptr, nullptr, ae);
+    munit_plus_assert(ae == tca::api_error::Param);
+  }
+  tca::woff2batch_destroy(ptr[0]);
+  delete ptr[1];
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_woff2batch_decode
+  (const MunitPlusParameter params[], void* data)
+{
+  unsigned int const threads = munit_plus_rand_int_range(1,4);
+  std::size_t const count = munit_plus_rand_int_range(0,24);
+  (void)params;
+  (void)data;
+  std::vector<std::vector<unsigned char> > files(count);
+  /* source sfnt of each file; empty for bad files and the real font */
+  std::vector<std::vector<unsigned char> > expected(count);
+  std::vector<bool> real(count, false);
+  std::vector<std::unique_ptr<mmaptwo::mmaptwo_i> > handles(count);
+  std::vector<mmaptwo::mmaptwo_i*> sources(count, nullptr);
+  for (std::size_t i = 0u; i < count; ++i) {
+    /* always include the real font */
+    int const kind = (i == 0u) ? 2 : munit_plus_rand_int_range(0,7);
+    if (kind == 0) {
+      /* no file */
+      continue;
+    } else if (kind == 1) {
+      /* not a WOFF2 file */
+      files[i].resize(64u);
+      munit_plus_rand_memory(files[i].size(), files[i].data());
+    } else if (kind == 2) {
+      /* packed by an outside encoder */
+      files[i].assign(tcmplxAtest_woff2_real,
+        tcmplxAtest_woff2_real+tcmplxAtest_woff2_real_size);
+      real[i] = true;
+    } else files[i] = test_woff2batch_make(expected[i]);
+    handles[i].reset(
+      mmaptwo::memopen(files[i].data(), files[i].size(), false));
+    munit_plus_assert_not_null(handles[i].get());
+    sources[i] = handles[i].get();
+  }
+  tca::woff2_batch batch(threads);
+  /* the same workers serve several batches */
+  for (int round = 0; round < 2; ++round) {
+    test_woff2batch_log log;
+    log.seen.assign(count, 0u);
+    log.status.assign(count, tca::api_error::Unknown);
+    log.images.resize(count);
+    log.workers = threads;
+    log.bad_worker = false;
+    batch.decode(sources.data(), count, test_woff2batch_record, &log);
+    munit_plus_assert_false(log.bad_worker);
+    for (std::size_t i = 0u; i < count; ++i) {
+      munit_plus_assert_uint(log.seen[i],==,1u);
+      if (!sources[i]) {
+        munit_plus_assert(log.status[i] == tca::api_error::Param);
+      } else if (real[i]) {
+        munit_plus_assert(log.status[i] == tca::api_error::Success);
+        munit_plus_assert_int(tcmplxAtest_woff2_real_check_sfnt(
+            log.images[i].data(), log.images[i].size()), ==, 0);
+      } else if (expected[i].empty()) {
+        munit_plus_assert(log.status[i] != tca::api_error::Success);
+      } else {
+        munit_plus_assert(log.status[i] == tca::api_error::Success);
+        munit_plus_assert(test_woff2batch_match(log.images[i], expected[i]));
+      }
+    }
+  }
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  return munit_plus_suite_main(&suite_woff2batch, nullptr, argc, argv);
+}
@@ -6,6 +6,7 @@
 #include "text-complex-plus/access/zutil.hpp"
 #include "munit-plus/munit.hpp"
 #include <memory>
+#include <vector>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -17,6 +18,14 @@ static MunitPlusResult test_zcvt_item
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_zcvt_in_none
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zcvt_in_empty_stored
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zcvt_dictionary
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zcvt_stats
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zcvt_far_match
+    (const MunitPlusParameter params[], void* data);
 static void* test_zcvt_setup
     (const MunitPlusParameter params[], void* user_data);
 static void test_zcvt_teardown(void* fixture);
@@ -32,6 +41,18 @@ static MunitPlusTest tests_zcvt[] = {
   {(char*)"in/none", test_zcvt_in_none,
       test_zcvt_setup,test_zcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
       nullptr},
+  {(char*)"in/empty_stored", test_zcvt_in_empty_stored,
+      test_zcvt_setup,test_zcvt_teardown,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"dictionary", test_zcvt_dictionary,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"stats", test_zcvt_stats,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
+  {(char*)"far_match", test_zcvt_far_match,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,
+      nullptr},
   {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -128,6 +149,220 @@ MunitPlusResult test_zcvt_in_none
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_zcvt_in_empty_stored
+  (const MunitPlusParameter params[], void* data)
+{
+  text_complex::access::zcvt_state* const p =
+    static_cast<text_complex::access::zcvt_state*>(data);
+  /*
+   * A sync flush from zlib: a fixed block "abcabc", an empty stored
+   * block, then a last fixed block "xyz". The empty block's LEN/NLEN
+   * end a block; the byte after them starts the next one.
+   */
+  static unsigned char const buf[] = {
+      0x78, 0xda, 0x4a, 0x4c, 0x4a, 0x4e, 0x4c, 0x4a,
+      0x06, 0x00, 0x00, 0x00, 0xff, 0xff, 0xab, 0xa8,
+      0xac, 0x02, 0x00, 0x11, 0xc7, 0x03, 0xb8
+    };
+  static char const text[] = "abcabcxyz";
+  std::size_t const len = sizeof(text)-1;
+  if (p == nullptr)
+    return MUNIT_PLUS_SKIP;
+  (void)params;
+  /* extract some data */{
+    unsigned char to_buf[32];
+    unsigned char const* from_next;
+    unsigned char* to_next;
+    text_complex::access::api_error ae =
+      text_complex::access::zcvt_in(*p, buf, buf+sizeof(buf), from_next,
+          to_buf, to_buf+sizeof(to_buf), to_next);
+    munit_plus_assert_op(ae, ==, text_complex::access::api_error::Success);
+    munit_plus_assert_size(to_next-to_buf, ==, len);
+    munit_plus_assert_size(from_next-buf, ==, sizeof(buf));
+    munit_plus_assert_memory_equal(len, to_buf, text);
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_zcvt_dictionary
+  (const MunitPlusParameter params[], void* data)
+{
+  namespace tca = text_complex::access;
+  unsigned char dict[512];
+  std::vector<unsigned char> text;
+  std::vector<unsigned char> packed;
+  std::unique_ptr<tca::zcvt_state> p = tca::zcvt_unique(4096,32768,256);
+  std::unique_ptr<tca::zcvt_state> q = tca::zcvt_unique(4096,32768,256);
+  (void)params;
+  (void)data;
+  if (!p || !q)
+    return MUNIT_PLUS_SKIP;
+  munit_plus_rand_memory(sizeof(dict), dict);
+  /* make text out of dictionary pieces */{
+    std::size_t const len = munit_plus_rand_int_range(1,2048);
+    while (text.size() < len) {
+      std::size_t const pos = munit_plus_rand_int_range(0,sizeof(dict)-16);
+      std::size_t const span = munit_plus_rand_int_range(4,16);
+      text.insert(text.end(), dict+pos, dict+pos+span);
+      text.push_back(static_cast<unsigned char>(munit_plus_rand_uint32()));
+    }
+    text.resize(len);
+  }
+  /* compress */{
+    tca::api_error ae;
+    unsigned char buf[64];
+    unsigned char const* from_next = text.data();
+    tca::zcvt_set_dictionary(*p, dict, sizeof(dict), ae);
+    munit_plus_assert_op(ae, ==, tca::api_error::Success);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_out(*p, from_next, text.data()+text.size(), from_next,
+        buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert_op(ae, ==, tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert_op(ae, ==, tca::api_error::EndOfFile);
+  }
+  munit_plus_assert_size(packed.size(), >, 6u);
+  munit_plus_assert_uint(packed[1]&32u, ==, 32u);
+  /* decompress */{
+    std::vector<unsigned char> unpacked(text.size()+1u);
+    unsigned char const* from_next = packed.data();
+    unsigned char* to_next = unpacked.data();
+    tca::api_error ae = tca::zcvt_in(*q,
+      packed.data(), packed.data()+packed.size(), from_next,
+      unpacked.data(), unpacked.data()+unpacked.size(), to_next);
+    munit_plus_assert_op(ae, ==, tca::api_error::ZDictionary);
+    munit_plus_assert_size(from_next-packed.data(), ==, 6u);
+    munit_plus_assert_uint32(q->checksum, ==,
+      tca::zutil_adler32(sizeof(dict), dict));
+    /* a wrong dictionary is refused */{
+      unsigned char wrong[sizeof(dict)];
+      std::memcpy(wrong, dict, sizeof(dict));
+      wrong[munit_plus_rand_int_range(0,sizeof(dict)-1)] ^= 1u;
+      tca::zcvt_set_dictionary(*q, wrong, sizeof(wrong), ae);
+      munit_plus_assert_op(ae, ==, tca::api_error::ZDictionary);
+    }
+    tca::zcvt_set_dictionary(*q, dict, sizeof(dict), ae);
+    munit_plus_assert_op(ae, ==, tca::api_error::Success);
+    ae = tca::zcvt_in(*q,
+      from_next, packed.data()+packed.size(), from_next,
+      to_next, unpacked.data()+unpacked.size(), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    munit_plus_assert_size(from_next-packed.data(), ==, packed.size());
+    munit_plus_assert_size(to_next-unpacked.data(), ==, text.size());
+    munit_plus_assert_memory_equal(text.size(), unpacked.data(), text.data());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_zcvt_stats
+  (const MunitPlusParameter params[], void* data)
+{
+  namespace tca = text_complex::access;
+  std::vector<unsigned char> text;
+  std::vector<unsigned char> packed;
+  std::unique_ptr<tca::zcvt_state> p = tca::zcvt_unique(4096,32768,256);
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* make repetitive text */{
+    unsigned char piece[32];
+    std::size_t const len = munit_plus_rand_int_range(256,8192);
+    munit_plus_rand_memory(sizeof(piece), piece);
+    while (text.size() < len) {
+      std::size_t const span = munit_plus_rand_int_range(4,sizeof(piece));
+      text.insert(text.end(), piece, piece+span);
+    }
+    text.resize(len);
+  }
+  /* compress */{
+    tca::api_error ae;
+    unsigned char buf[64];
+    unsigned char const* from_next = text.data();
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_out(*p, from_next, text.data()+text.size(), from_next,
+        buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert_op(ae, ==, tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert_op(ae, ==, tca::api_error::EndOfFile);
+  }
+  tca::cvt_stats const& stats = p->stats;
+  if (!tca::cvt_stats_enabled()) {
+    munit_plus_assert_ullong(stats.bytes_in, ==, 0u);
+    munit_plus_assert_ullong(stats.matches, ==, 0u);
+    return MUNIT_PLUS_OK;
+  }
+  munit_plus_assert_ullong(stats.bytes_in, ==, text.size());
+  munit_plus_assert_ullong(stats.bytes_out, ==, packed.size());
+  munit_plus_assert_ullong(stats.copy_bytes+stats.literal_bytes,
+    ==, text.size());
+  munit_plus_assert_ullong(stats.matches, >, 0u);
+  munit_plus_assert_ullong(stats.searches, >=, stats.matches);
+  /* full blocks, plus up to one for the end of the stream */
+  munit_plus_assert_ullong(stats.dynamic_blocks+stats.stored_blocks,
+    >=, (text.size()+4095u)/4096u);
+  munit_plus_assert_ullong(stats.dynamic_blocks+stats.stored_blocks,
+    <=, (text.size()+4095u)/4096u+1u);
+  munit_plus_assert_ullong(stats.fixed_blocks, ==, 0u);
+  munit_plus_assert_double(stats.average_match_length(), >=, 3.0);
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_zcvt_far_match
+  (const MunitPlusParameter params[], void* data)
+{
+  namespace tca = text_complex::access;
+  std::vector<unsigned char> text(16384u);
+  std::vector<unsigned char> packed;
+  std::unique_ptr<tca::zcvt_state> p = tca::zcvt_unique(4096,32768,256);
+  (void)params;
+  (void)data;
+  if (!p)
+    return MUNIT_PLUS_SKIP;
+  /* noise, then pieces of that noise from far back */{
+    munit_plus_rand_memory(text.size(), text.data());
+    while (text.size() < 32768u) {
+      std::size_t const start = munit_plus_rand_int_range(0,255)*64u;
+      text.insert(text.end(), text.begin()+start, text.begin()+start+64u);
+    }
+  }
+  /* compress */{
+    tca::api_error ae;
+    unsigned char buf[64];
+    unsigned char const* from_next = text.data();
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_out(*p, from_next, text.data()+text.size(), from_next,
+        buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success);
+    munit_plus_assert_op(ae, ==, tca::api_error::Partial);
+    do {
+      unsigned char* to_next = buf;
+      ae = tca::zcvt_unshift(*p, buf, buf+sizeof(buf), to_next);
+      packed.insert(packed.end(), buf, to_next);
+    } while (ae == tca::api_error::Success || ae == tca::api_error::Partial);
+    munit_plus_assert_op(ae, ==, tca::api_error::EndOfFile);
+  }
+  /* the copies should win over stored blocks */
+  munit_plus_assert_size(packed.size(), <, text.size()*3u/4u);
+  return MUNIT_PLUS_OK;
+}
+
 
 int main(int argc, char **argv) {
   return munit_plus_suite_main(&suite_zcvt, nullptr, argc, argv);
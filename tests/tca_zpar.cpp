@@ -0,0 +1,159 @@
+/**
+ * @brief Test program for parallel zlib compression.
+ */
+#include "testfont.hpp"
+#include "text-complex-plus/access/zpar.hpp"
+#include "text-complex-plus/access/zcvt.hpp"
+#include "munit-plus/munit.hpp"
+#include <memory>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace tca = text_complex::access;
+
+static MunitPlusResult test_zpar_cycle
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zpar_roundtrip
+    (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zpar_threads
+    (const MunitPlusParameter params[], void* data);
+static std::vector<unsigned char> test_zpar_text(std::size_t len);
+static std::vector<unsigned char> test_zpar_encode
+    (std::vector<unsigned char> const& text, unsigned int segment_size,
+      unsigned int threads);
+
+
+static MunitPlusTest tests_zpar[] = {
+  {(char*)"cycle", test_zpar_cycle,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_SINGLE_ITERATION,nullptr},
+  {(char*)"roundtrip", test_zpar_roundtrip,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"threads", test_zpar_threads,
+      nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {nullptr, nullptr, nullptr,nullptr,MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
+};
+
+static MunitPlusSuite const suite_zpar = {
+  (char*)"access/zpar/", tests_zpar, nullptr,
+      1, MUNIT_PLUS_SUITE_OPTION_NONE
+};
+
+
+
+
+MunitPlusResult test_zpar_cycle
+  (const MunitPlusParameter params[], void* data)
+{
+  tca::zpar_state* ptr[2];
+  (void)params;
+  (void)data;
+  ptr[0] = tca::zpar_new(256,1024,16,4096,2);
+  ptr[1] = new tca::zpar_state(256,1024,16,4096,1);
+  std::unique_ptr<tca::zpar_state> ptr2 = tca::zpar_unique();
+  munit_plus_assert_not_null(ptr[0]);
+  munit_plus_assert_not_null(ptr[1]);
+  munit_plus_assert_not_null(ptr2.get());
+  munit_plus_assert_uint(ptr[0]->threads(),==,2u);
+  munit_plus_assert_null(tca::zpar_new(256,1024,16,0,1));
+  tca::zpar_destroy(ptr[0]);
+  delete ptr[1];
+  return MUNIT_PLUS_OK;
+}
+
+std::vector<unsigned char> test_zpar_text(std::size_t len) {
+  static char const words[][8] = {
+    "glyf", "loca", "hmtx", "cmap", "head", "name", "post", "OS/2"
+  };
+  std::vector<unsigned char> out;
+  out.reserve(len);
+  while (out.size() < len) {
+    int const pick = munit_plus_rand_int_range(0,9);
+    if (pick < 8) {
+      char const* const w = words[pick];
+      out.insert(out.end(), w, w+std::strlen(w));
+    } else out.push_back(static_cast<unsigned char>(
+        munit_plus_rand_int_range(0,255)));
+  }
+  out.resize(len);
+  return out;
+}
+
+std::vector<unsigned char> test_zpar_encode
+  ( std::vector<unsigned char> const& text, unsigned int segment_size,
+    unsigned int threads)
+{
+  std::vector<unsigned char> out;
+  tca::zpar_state state(256, 1024, 16, segment_size, threads);
+  unsigned char buf[97];
+  unsigned char const* p = text.data();
+  unsigned char const* const p_end = text.data()+text.size();
+  tca::api_error ae;
+  /* feed in uneven pieces */do {
+    std::size_t const piece = munit_plus_rand_int_range(1,700);
+    unsigned char const* const q_end =
+      (p_end - p < static_cast<std::ptrdiff_t>(piece)) ? p_end : p+piece;
+    unsigned char* to_next = buf;
+    ae = tca::zpar_out(state, p, q_end, p, buf, buf+sizeof(buf), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    out.insert(out.end(), buf, to_next);
+  } while (p < p_end);
+  do {
+    unsigned char* to_next = buf;
+    ae = tca::zpar_unshift(state, buf, buf+sizeof(buf), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    out.insert(out.end(), buf, to_next);
+  } while (ae == tca::api_error::Success);
+  munit_plus_assert(ae == tca::api_error::EndOfFile);
+  return out;
+}
+
+MunitPlusResult test_zpar_roundtrip
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const len = munit_plus_rand_int_range(0,20000);
+  unsigned int const segment_size = munit_plus_rand_int_range(512,8192);
+  std::vector<unsigned char> const text = test_zpar_text(len);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const packed =
+    test_zpar_encode(text, segment_size, munit_plus_rand_int_range(1,4));
+  /* decode */{
+    std::unique_ptr<tca::zcvt_state> q = tca::zcvt_unique(4096,32768,4096);
+    std::vector<unsigned char> unpacked(len+1u);
+    unsigned char const* p = packed.data();
+    unsigned char* to_next = unpacked.data();
+    if (!q)
+      return MUNIT_PLUS_SKIP;
+    tca::api_error const ae = tca::zcvt_in(*q,
+      packed.data(), packed.data()+packed.size(), p,
+      unpacked.data(), unpacked.data()+unpacked.size(), to_next);
+    munit_plus_assert(ae >= tca::api_error::Success);
+    munit_plus_assert_size(p-packed.data(),==,packed.size());
+    munit_plus_assert_size(to_next-unpacked.data(),==,len);
+    munit_plus_assert_memory_equal(len, unpacked.data(), text.data());
+  }
+  return MUNIT_PLUS_OK;
+}
+
+MunitPlusResult test_zpar_threads
+  (const MunitPlusParameter params[], void* data)
+{
+  std::size_t const len = munit_plus_rand_int_range(1,20000);
+  unsigned int const segment_size = munit_plus_rand_int_range(512,8192);
+  std::vector<unsigned char> const text = test_zpar_text(len);
+  (void)params;
+  (void)data;
+  std::vector<unsigned char> const one = test_zpar_encode(text, segment_size, 1);
+  std::vector<unsigned char> const many = test_zpar_encode(text, segment_size,
+    munit_plus_rand_int_range(2,8));
+  munit_plus_assert_size(one.size(),==,many.size());
+  munit_plus_assert_memory_equal(one.size(), one.data(), many.data());
+  return MUNIT_PLUS_OK;
+}
+
+
+int main(int argc, char **argv) {
+  return munit_plus_suite_main(&suite_zpar, nullptr, argc, argv);
+}
@@ -10,12 +10,16 @@ static MunitPlusResult test_zutil_adler32
     (const MunitPlusParameter params[], void* data);
 static MunitPlusResult test_zutil_adler32_long
     (const MunitPlusParameter params[], void* data);
+static MunitPlusResult test_zutil_adler32_combine
+    (const MunitPlusParameter params[], void* data);
 
 static MunitPlusTest tests_zutil[] = {
   {(char*)"adler32", test_zutil_adler32, nullptr,nullptr,
     MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
   {(char*)"adler32/long", test_zutil_adler32_long, nullptr,nullptr,
     MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
+  {(char*)"adler32/combine", test_zutil_adler32_combine, nullptr,nullptr,
+    MUNIT_PLUS_TEST_OPTION_NONE,nullptr},
   {nullptr, nullptr, nullptr,nullptr, MUNIT_PLUS_TEST_OPTION_NONE,nullptr}
 };
 
@@ -85,6 +89,30 @@ MunitPlusResult test_zutil_adler32_long
   return MUNIT_PLUS_OK;
 }
 
+MunitPlusResult test_zutil_adler32_combine
+  (const MunitPlusParameter params[], void* data)
+{
+  std::vector<unsigned char> buf;
+  std::size_t const len = munit_plus_rand_int_range(0,200000);
+  std::size_t const cut = munit_plus_rand_int_range(0,static_cast<int>(len));
+  unsigned long int checksums[2];
+  (void)params;
+  (void)data;
+  buf.resize(len+1u);
+  munit_plus_rand_memory(len, static_cast<munit_plus_uint8_t*>(&buf[0]));
+  checksums[0] = test_adler32(&buf[0], len);
+  /* compute by independent parts */{
+    text_complex::access::uint32 const chk1 =
+      text_complex::access::zutil_adler32(cut, &buf[0]);
+    text_complex::access::uint32 const chk2 =
+      text_complex::access::zutil_adler32(len-cut, &buf[cut]);
+    checksums[1] =
+      text_complex::access::zutil_adler32_combine(chk1, chk2, len-cut);
+  }
+  munit_plus_assert_ulong(checksums[1], ==, checksums[0]);
+  return MUNIT_PLUS_OK;
+}
+
 
 
 
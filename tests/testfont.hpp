@@ -128,6 +128,58 @@ std::size_t testfont_rand_size_range(std::size_t a, std::size_t b);
  * @return a number
  */
 unsigned int testfont_rand_uint_range(unsigned int a, unsigned int b);
+/**
+ * @brief Table of the source font behind the real WOFF2 test font.
+ */
+struct tcmplxAtest_sfnt_table {
+  char tag[5];
+  unsigned long length;
+  /** @brief Adler-32 of the table data. */
+  unsigned long adler32;
+};
+
+/**
+ * @brief A real WOFF2 font, packed by an outside Brotli encoder.
+ */
+extern unsigned char const tcmplxAtest_woff2_real[];
+extern std::size_t const tcmplxAtest_woff2_real_size;
+/**
+ * @brief Offset of the Brotli table stream in the real WOFF2 font.
+ */
+extern std::size_t const tcmplxAtest_woff2_real_stream;
+/**
+ * @brief Length of the Brotli table stream in the real WOFF2 font.
+ */
+extern std::size_t const tcmplxAtest_woff2_real_stream_size;
+/**
+ * @brief Tables of the source sfnt of @link tcmplxAtest_woff2_real @endlink,
+ *   in stream order.
+ */
+extern tcmplxAtest_sfnt_table const tcmplxAtest_woff2_real_tables[];
+extern std::size_t const tcmplxAtest_woff2_real_count;
+
+/**
+ * @brief Compare a decoded table against the real font's source.
+ * @param tag table tag
+ * @param data table data
+ * @param len table length in bytes
+ * @return zero on match, -1 for an unknown tag, 1 for a length
+ *   mismatch, 2 for a content mismatch
+ * @note The checkSumAdjustment of `head` is not compared.
+ */
+int tcmplxAtest_woff2_real_check
+  (unsigned char const* tag, unsigned char const* data, std::size_t len);
+
+/**
+ * @brief Compare a decoded sfnt against the real font's source.
+ * @param sfnt the decoded font file
+ * @param len length of the file
+ * @return the number of mismatched tables, or -1 if the table
+ *   directory does not match
+ */
+int tcmplxAtest_woff2_real_check_sfnt
+  (unsigned char const* sfnt, std::size_t len);
+
 /**
  * @brief Get an argument list for munit-plus.
  * @return the argument list
@@ -0,0 +1,508 @@
+/**
+ * @file tests/testwoff2.cpp
+ * @brief Real WOFF2 test font.
+ */
+#include "testfont.hpp"
+#include "text-complex-plus/access/zutil.hpp"
+#include <cstring>
+
+/*
+ * Greek subset (U+036E..U+0392) of DejaVu Sans, packed by fontTools
+ * with Brotli quality 11 and no table transforms. See the DejaVu
+ * license in the font's own name table.
+ */
+unsigned char const tcmplxAtest_woff2_real[] = {
+  0x77, 0x4f, 0x46, 0x32, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x13, 0x24,
+  0x00, 0x12, 0x00, 0x00, 0x00, 0x00, 0x1e, 0xbc, 0x00, 0x00, 0x12, 0xc4,
+  0x00, 0x02, 0x5e, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x1a, 0x1c, 0x1b, 0x20, 0x1c, 0x81, 0x54, 0x1f, 0x81, 0x76, 0x06, 0x56,
+  0x00, 0x54, 0x08, 0x83, 0x7e, 0x09, 0x81, 0x2b, 0x11, 0x0c, 0xca, 0x9a,
+  0x3a, 0x01, 0x36, 0x02, 0x24, 0x03, 0x81, 0x58, 0xcb, 0x6e, 0x04, 0x20,
+  0x05, 0x83, 0x54, 0x07, 0x83, 0x68, 0x0c, 0x8a, 0x68, 0x1b, 0x82, 0x1d,
+  0xb3, 0x03, 0x31, 0x6c, 0x1c, 0x08, 0x6c, 0x1c, 0xce, 0x11, 0xfc, 0x1f,
+  0x8a, 0x37, 0x86, 0xd0, 0x3f, 0x39, 0x0d, 0x75, 0xb3, 0xbb, 0xbc, 0xab,
+  0xce, 0x89, 0x55, 0x64, 0xa5, 0x07, 0x47, 0xda, 0xd3, 0xc5, 0x89, 0xda,
+  0x20, 0x54, 0x9f, 0x22, 0xc2, 0x64, 0x61, 0xdb, 0xc2, 0x17, 0x2d, 0x62,
+  0x3c, 0xf9, 0x6e, 0x95, 0xc9, 0x9f, 0x96, 0x4a, 0xaf, 0x08, 0x05, 0x6e,
+  0x28, 0x93, 0xb0, 0xc5, 0xa5, 0x52, 0x86, 0x85, 0xe7, 0x1f, 0xf1, 0xd0,
+  0x93, 0x88, 0x11, 0x92, 0xcc, 0xc2, 0x7f, 0xdf, 0xb2, 0xd7, 0x5b, 0x55,
+  0xaf, 0x7a, 0x82, 0x76, 0x15, 0x42, 0x86, 0x31, 0xb5, 0x94, 0x91, 0xb8,
+  0x6d, 0x94, 0x01, 0x31, 0xa2, 0x3e, 0x3c, 0x05, 0xf4, 0xd9, 0x17, 0x60,
+  0x8e, 0x80, 0x24, 0x68, 0x68, 0x80, 0x56, 0x33, 0xd3, 0xfe, 0x87, 0x4e,
+  0xb5, 0xfd, 0xfc, 0xc3, 0x06, 0x00, 0xc5, 0x1c, 0x90, 0x43, 0xa8, 0x00,
+  0x92, 0x82, 0x53, 0x71, 0x04, 0x40, 0x95, 0x60, 0x6c, 0xe7, 0xf2, 0x30,
+  0x76, 0xeb, 0x75, 0x98, 0x7a, 0x5d, 0x96, 0x2a, 0x77, 0x3f, 0x0b, 0xdb,
+  0x84, 0xab, 0x84, 0x46, 0xbd, 0x68, 0x88, 0x22, 0x52, 0x87, 0xc9, 0x76,
+  0xc4, 0xfa, 0xb3, 0xfe, 0x3c, 0xbf, 0xb6, 0xfe, 0xdc, 0x7a, 0xef, 0xcd,
+  0x30, 0x33, 0xbc, 0x07, 0x33, 0x20, 0xf4, 0xf0, 0x08, 0x15, 0x63, 0x64,
+  0xa8, 0x51, 0xbe, 0x8e, 0xc5, 0xe2, 0x26, 0x62, 0x24, 0xeb, 0x58, 0xec,
+  0x36, 0x20, 0x16, 0x16, 0x60, 0x15, 0xd6, 0x98, 0x94, 0xc5, 0xdf, 0xc5,
+  0xc2, 0xd8, 0x5d, 0x30, 0x12, 0x83, 0xda, 0x02, 0xac, 0x02, 0xcc, 0xb1,
+  0x72, 0x67, 0x1e, 0x08, 0xa2, 0x5b, 0x33, 0x13, 0xe0, 0xbd, 0x08, 0x80,
+  0xfe, 0x07, 0xe6, 0xb7, 0x8c, 0x38, 0x38, 0x18, 0xd0, 0x11, 0x03, 0x80,
+  0xb4, 0x82, 0x6a, 0xa0, 0xe0, 0xff, 0xe6, 0xca, 0xca, 0x9f, 0xe4, 0xe5,
+  0x6e, 0xf6, 0x08, 0xda, 0x5c, 0x09, 0xf7, 0xdc, 0x0a, 0xdb, 0x2a, 0x45,
+  0xba, 0x7e, 0x92, 0xd9, 0x9d, 0x37, 0x93, 0x6c, 0x5e, 0x73, 0xc7, 0x29,
+  0xee, 0xa5, 0x44, 0x73, 0x5b, 0x04, 0x45, 0x6c, 0x24, 0x0a, 0x97, 0x72,
+  0xca, 0x29, 0x21, 0xd9, 0x2a, 0xb2, 0xb5, 0xaa, 0x4e, 0xd6, 0xa1, 0xaa,
+  0xca, 0x70, 0x48, 0x8a, 0x95, 0x39, 0x63, 0x41, 0x2f, 0x0f, 0x71, 0x7a,
+  0x98, 0x4a, 0x4a, 0x9d, 0x71, 0x2a, 0x3e, 0x97, 0x89, 0x31, 0x60, 0x45,
+  0x9f, 0xbb, 0x2f, 0xbf, 0x93, 0xcb, 0x68, 0xb9, 0x2a, 0x69, 0x8f, 0x18,
+  0x46, 0x8e, 0x13, 0x44, 0xfb, 0x7c, 0xb6, 0xb9, 0x30, 0x39, 0x04, 0xd0,
+  0xda, 0x20, 0xee, 0xad, 0xc3, 0x97, 0xcc, 0x61, 0x46, 0x4f, 0x7f, 0x92,
+  0xb5, 0x9e, 0x67, 0xfe, 0x05, 0xb2, 0x90, 0x3c, 0x3e, 0xd2, 0xa4, 0x4c,
+  0x00, 0x74, 0x0b, 0x55, 0xc9, 0x29, 0x88, 0x1d, 0xb3, 0x4c, 0x91, 0xc8,
+  0x11, 0x1c, 0xc9, 0x60, 0x5e, 0xea, 0x01, 0x1a, 0x76, 0x9c, 0x07, 0x33,
+  0x18, 0x80, 0x67, 0x02, 0x71, 0x06, 0xf2, 0x10, 0x2c, 0x50, 0x2b, 0xd1,
+  0x70, 0xd0, 0x48, 0x01, 0x4b, 0x73, 0x7c, 0x74, 0x34, 0x4f, 0x46, 0x05,
+  0x8f, 0x18, 0x32, 0x73, 0x2b, 0xa3, 0x04, 0x6d, 0xd4, 0x80, 0xf4, 0x0f,
+  0xc1, 0xf4, 0x98, 0xca, 0xe7, 0x86, 0xad, 0x40, 0xef, 0x68, 0xc0, 0x8c,
+  0x08, 0x30, 0x70, 0xc0, 0x01, 0x22, 0x0b, 0x05, 0x40, 0x96, 0xd6, 0xd9,
+  0x0e, 0x8d, 0xdb, 0xa1, 0xdf, 0xe6, 0x01, 0xc9, 0x24, 0xac, 0x80, 0xbf,
+  0x01, 0x00, 0xe0, 0xb9, 0x00, 0xb5, 0x01, 0xac, 0x09, 0x49, 0x97, 0xce,
+  0xcd, 0x4b, 0xd7, 0xa0, 0x6f, 0x71, 0xed, 0x86, 0x80, 0xbd, 0x13, 0xe9,
+  0x00, 0xf0, 0x54, 0xac, 0x91, 0x41, 0x88, 0x49, 0x5b, 0x14, 0xe7, 0x75,
+  0xa6, 0x48, 0xe9, 0xcc, 0x49, 0x05, 0x80, 0xe3, 0x23, 0xff, 0xe5, 0xd7,
+  0x26, 0x30, 0xe7, 0xb6, 0x47, 0xed, 0x69, 0x6e, 0xee, 0x1d, 0x51, 0x1d,
+  0x5a, 0x05, 0x03, 0x60, 0x66, 0xb6, 0x09, 0x40, 0x81, 0xe6, 0xe7, 0x26,
+  0x97, 0x48, 0x73, 0x0f, 0x00, 0xec, 0xc6, 0x11, 0x22, 0x50, 0x8c, 0x29,
+  0x00, 0xe4, 0xd2, 0x0a, 0x97, 0xfc, 0x59, 0xff, 0x09, 0x60, 0x8d, 0x8c,
+  0x58, 0x53, 0xf4, 0x8a, 0x1e, 0x6d, 0xee, 0x7e, 0xb2, 0x66, 0x4c, 0x8e,
+  0x00, 0x08, 0x03, 0x22, 0x30, 0x5a, 0x0f, 0x01, 0x04, 0x85, 0x14, 0xac,
+  0x27, 0xa3, 0x01, 0x01, 0x30, 0x50, 0x18, 0xd3, 0x90, 0x83, 0xa5, 0x58,
+  0x8e, 0x35, 0x47, 0x70, 0x0c, 0x33, 0x30, 0x9f, 0xc2, 0xca, 0x0f, 0x9f,
+  0xde, 0x4c, 0x3f, 0xdd, 0xb4, 0xd3, 0x74, 0x5b, 0x01, 0x02, 0x6c, 0x84,
+  0x62, 0xa0, 0x82, 0x5a, 0xdf, 0xf8, 0x14, 0x65, 0x14, 0x58, 0xa9, 0x8c,
+  0x4c, 0x03, 0x20, 0xb3, 0x51, 0xbe, 0xc4, 0x0f, 0xb0, 0x80, 0x29, 0xff,
+  0x6f, 0x67, 0xac, 0xd6, 0x96, 0x78, 0x67, 0xa8, 0xa5, 0x94, 0xe7, 0xd0,
+  0x40, 0x19, 0x8b, 0xa8, 0x8d, 0x32, 0x01, 0xfa, 0x14, 0x33, 0xb5, 0x00,
+  0x5c, 0x49, 0x0c, 0xaf, 0xd1, 0x34, 0x87, 0x28, 0x30, 0x0b, 0xd2, 0x23,
+  0x0b, 0xcf, 0x51, 0xa0, 0x5f, 0xea, 0x90, 0x52, 0x54, 0xa1, 0xfb, 0xaa,
+  0x27, 0x4e, 0x59, 0xaa, 0x97, 0x4d, 0x59, 0x66, 0x26, 0xdb, 0x72, 0x68,
+  0x96, 0xe6, 0xd0, 0xb4, 0x90, 0xb3, 0xee, 0x01, 0xd5, 0x04, 0x51, 0x61,
+  0xb7, 0xc8, 0xe2, 0x70, 0x3c, 0x0c, 0x33, 0x39, 0xaa, 0x7e, 0xd2, 0xc1,
+  0xad, 0xa8, 0x8f, 0x32, 0x5a, 0xa3, 0x4c, 0x14, 0x00, 0x6a, 0xc9, 0x67,
+  0x07, 0x33, 0xa9, 0x40, 0x6f, 0xe9, 0xe4, 0xf8, 0x4c, 0x4f, 0x21, 0x9f,
+  0xf3, 0x59, 0xcf, 0x66, 0x36, 0x93, 0x4e, 0x2d, 0xf5, 0x56, 0x64, 0x0d,
+  0x3c, 0x87, 0xc3, 0x36, 0x8f, 0x26, 0x36, 0x06, 0xc5, 0x49, 0x14, 0x59,
+  0x13, 0xa7, 0xa8, 0xe5, 0x2d, 0xcc, 0x8b, 0xc1, 0x9e, 0x03, 0x10, 0x33,
+  0x4e, 0xa3, 0x81, 0xf3, 0xec, 0xa0, 0x9e, 0x7c, 0x36, 0x93, 0x25, 0x60,
+  0x4d, 0xa6, 0x06, 0x05, 0x67, 0x60, 0x07, 0x87, 0x28, 0x00, 0x60, 0x1c,
+  0x05, 0x00, 0x04, 0x44, 0x67, 0xd6, 0x84, 0x7b, 0x7e, 0x4e, 0x0e, 0x33,
+  0x19, 0xcc, 0x8e, 0x52, 0x51, 0xf4, 0xbc, 0x8c, 0x1a, 0x52, 0xee, 0x4c,
+  0x4a, 0xed, 0x8c, 0x39, 0xca, 0x5a, 0x4a, 0x68, 0x88, 0xd1, 0x91, 0x19,
+  0xd7, 0x6c, 0x81, 0x64, 0xfa, 0x8b, 0x92, 0xc8, 0x4f, 0x09, 0x87, 0xd8,
+  0x88, 0x97, 0x4d, 0xb6, 0x39, 0xe8, 0x04, 0x5c, 0x9a, 0x65, 0xcb, 0xb6,
+  0x60, 0xce, 0x14, 0x71, 0xf0, 0x34, 0x9b, 0xb2, 0x32, 0x1e, 0x16, 0x69,
+  0xdd, 0x38, 0x66, 0x72, 0x36, 0x66, 0xe5, 0x00, 0x38, 0xe4, 0x29, 0x6e,
+  0x1a, 0x47, 0x73, 0x77, 0x5a, 0x11, 0xcf, 0xe9, 0x7a, 0xa0, 0x05, 0xb1,
+  0x84, 0x7c, 0x3c, 0xb1, 0x00, 0x9e, 0xd6, 0x7d, 0xaa, 0xae, 0x50, 0xc0,
+  0x74, 0x46, 0xfc, 0x6c, 0xd2, 0x01, 0x48, 0x8f, 0x18, 0xf8, 0x9e, 0x74,
+  0x66, 0xb2, 0x97, 0x03, 0x74, 0x8e, 0xf5, 0xe4, 0xfb, 0xcc, 0x78, 0xd7,
+  0x97, 0x38, 0x56, 0x46, 0xe7, 0x53, 0xa0, 0x3b, 0x9e, 0x56, 0x6f, 0x2b,
+  0x9c, 0x1e, 0x43, 0x7d, 0xf4, 0xa3, 0x03, 0x69, 0x7a, 0x4a, 0x16, 0xa0,
+  0x07, 0xd6, 0x6f, 0xbf, 0xa6, 0xe0, 0x93, 0x89, 0xe5, 0x38, 0x6c, 0xc0,
+  0x84, 0x72, 0xeb, 0xc0, 0xe1, 0xc1, 0x17, 0x46, 0x44, 0x3a, 0x77, 0xea,
+  0xe0, 0xb1, 0xef, 0x14, 0x1f, 0x5c, 0x0e, 0xc9, 0x5b, 0xda, 0xec, 0xd3,
+  0x15, 0x6d, 0x6d, 0xc9, 0x0f, 0xea, 0xc7, 0x46, 0x6c, 0x31, 0xff, 0x72,
+  0x12, 0x26, 0x94, 0x2b, 0x4c, 0xbe, 0xd3, 0x67, 0x77, 0x7e, 0x82, 0x7d,
+  0x56, 0xc1, 0x18, 0xe0, 0xea, 0xdf, 0x8f, 0xdd, 0xed, 0x6f, 0xeb, 0xd7,
+  0xaa, 0x18, 0x34, 0xfc, 0x4b, 0x4f, 0x86, 0xbd, 0xee, 0xf1, 0x9b, 0x78,
+  0x31, 0x56, 0xee, 0x94, 0x33, 0x01, 0xe6, 0x67, 0x2b, 0x0f, 0x1e, 0xff,
+  0x6d, 0xf0, 0x52, 0x71, 0xa9, 0xdc, 0x3d, 0xfc, 0xae, 0x26, 0x76, 0xef,
+  0x0c, 0x00, 0x18, 0x04, 0xc0, 0x6d, 0x80, 0x00, 0x86, 0xa2, 0xe6, 0xe1,
+  0x8c, 0x64, 0x20, 0xa0, 0x82, 0xb0, 0xea, 0x89, 0xe7, 0xc1, 0x17, 0x69,
+  0x1e, 0xa5, 0x23, 0x2f, 0x30, 0xe4, 0x43, 0xa1, 0xdd, 0x28, 0x3a, 0x13,
+  0x1c, 0x51, 0x8d, 0x75, 0xdd, 0x40, 0xfc, 0xcf, 0xe9, 0x10, 0x9f, 0x9a,
+  0x3c, 0xcd, 0x06, 0x59, 0x32, 0x1b, 0x88, 0xec, 0xf9, 0xbc, 0xa1, 0xa1,
+  0x61, 0x47, 0x5e, 0x0a, 0x95, 0x15, 0xd7, 0x95, 0xdd, 0xca, 0x49, 0x64,
+  0x05, 0x83, 0x08, 0xb0, 0x6f, 0xb3, 0x09, 0x0c, 0x6a, 0x38, 0x5d, 0x3b,
+  0x41, 0x32, 0xa0, 0x8c, 0x62, 0x89, 0x31, 0x8a, 0x24, 0x35, 0x51, 0x83,
+  0xe4, 0x40, 0x88, 0x9a, 0x97, 0x18, 0xe5, 0x24, 0xc6, 0xa8, 0x4a, 0x22,
+  0x6a, 0xc1, 0xc5, 0x45, 0xee, 0x03, 0xe1, 0xed, 0x46, 0xf2, 0x06, 0xa6,
+  0x12, 0x78, 0x8e, 0x12, 0x8c, 0x40, 0xc5, 0xd4, 0x6e, 0x62, 0x63, 0x95,
+  0xb7, 0xa5, 0x1b, 0x74, 0x7d, 0xd0, 0xd2, 0xe8, 0xf0, 0xb0, 0x98, 0x3e,
+  0x1b, 0x34, 0x9c, 0x17, 0xd9, 0x93, 0xee, 0xa0, 0xad, 0xa4, 0x60, 0x95,
+  0x14, 0x3b, 0xbf, 0xf1, 0xf7, 0xa2, 0x07, 0x82, 0x35, 0x08, 0xa5, 0xd6,
+  0x3e, 0xee, 0xc8, 0x1d, 0xbb, 0xf3, 0xee, 0x82, 0x3b, 0x0c, 0x67, 0x2a,
+  0x19, 0x2c, 0x47, 0xc5, 0x23, 0x01, 0x73, 0x44, 0x45, 0xbd, 0x90, 0x0f,
+  0x1e, 0x6a, 0xc3, 0x3d, 0x79, 0xf5, 0x8d, 0x7d, 0xeb, 0xd3, 0x6d, 0xaa,
+  0xcf, 0x8a, 0x49, 0x9a, 0xd6, 0x4d, 0xef, 0x17, 0xd9, 0x62, 0xcf, 0x5d,
+  0x6d, 0xf4, 0x4d, 0xb1, 0x5e, 0xde, 0xa9, 0x90, 0x3a, 0x20, 0x23, 0x32,
+  0x23, 0x99, 0x18, 0x89, 0x8c, 0x8f, 0x2e, 0x4f, 0x71, 0x98, 0x32, 0xb3,
+  0x15, 0x5b, 0xfe, 0x5d, 0xec, 0x1a, 0xb3, 0xb8, 0x89, 0xe9, 0x5c, 0x47,
+  0xc8, 0xde, 0x4d, 0x24, 0xca, 0x59, 0xf2, 0x80, 0x40, 0x35, 0x40, 0x1d,
+  0xd9, 0x84, 0x00, 0x12, 0xc1, 0xf4, 0xad, 0xb2, 0x0f, 0xd8, 0x47, 0x95,
+  0x7d, 0x6f, 0x1e, 0xb2, 0x8f, 0x7b, 0x4e, 0x49, 0x6e, 0x02, 0xf6, 0xf4,
+  0x09, 0x62, 0xa0, 0xf3, 0xf7, 0x62, 0x3e, 0xfe, 0x5d, 0x54, 0xe0, 0xbf,
+  0x97, 0x1a, 0x45, 0xa7, 0x23, 0xca, 0xe9, 0x68, 0x74, 0x48, 0xde, 0x16,
+  0x4b, 0x6c, 0x85, 0xff, 0x1d, 0xaf, 0x1d, 0xe2, 0x53, 0x7f, 0xa0, 0x03,
+  0xee, 0x21, 0x08, 0xa5, 0x9a, 0x64, 0x8c, 0x8a, 0x8d, 0x89, 0x0e, 0x97,
+  0x2d, 0x58, 0x98, 0x13, 0xbd, 0x0c, 0x7a, 0x8e, 0x0f, 0x44, 0xe1, 0x76,
+  0x53, 0xd9, 0x88, 0xd6, 0x5a, 0xbf, 0x6f, 0x0a, 0x0b, 0xb7, 0x2b, 0x47,
+  0x51, 0xe4, 0xba, 0xd5, 0xab, 0xd7, 0x29, 0x6e, 0x3a, 0x7a, 0x7f, 0x93,
+  0x3b, 0xcb, 0xbe, 0x53, 0x79, 0xfe, 0x9f, 0xeb, 0x01, 0xae, 0x9e, 0x6f,
+  0x2c, 0x5a, 0xb6, 0x7c, 0x01, 0x4e, 0x5b, 0x7a, 0xa6, 0x4f, 0xca, 0xcc,
+  0x28, 0x3d, 0xb9, 0x7f, 0xc9, 0x36, 0x7d, 0x70, 0xed, 0xc6, 0x0b, 0x57,
+  0x01, 0xe9, 0x96, 0x96, 0x9d, 0x82, 0x1b, 0x74, 0xa9, 0x06, 0xce, 0x2e,
+  0x6c, 0x27, 0xaf, 0xb7, 0x6b, 0xcf, 0xc8, 0x90, 0x8a, 0x27, 0xfe, 0x40,
+  0x35, 0x2a, 0x07, 0x35, 0x56, 0x55, 0xe9, 0xc3, 0x2e, 0x12, 0xa4, 0x1d,
+  0xbb, 0xcf, 0x68, 0x30, 0x4a, 0x8b, 0x47, 0x58, 0x4d, 0xca, 0x67, 0x5f,
+  0x7c, 0x7e, 0xb6, 0xe0, 0xf7, 0x53, 0x4f, 0xd6, 0xf4, 0xb3, 0x92, 0x58,
+  0xe6, 0x6a, 0x2e, 0x13, 0xc9, 0x66, 0x3d, 0x62, 0x3a, 0x55, 0xbd, 0x60,
+  0xf7, 0x3d, 0x9a, 0x7d, 0xe4, 0x78, 0xe2, 0xcf, 0xe2, 0x55, 0xa8, 0xad,
+  0x27, 0x92, 0xc5, 0xfa, 0x47, 0x3f, 0xd3, 0x81, 0x64, 0x09, 0x64, 0x96,
+  0x70, 0xce, 0x64, 0x60, 0xec, 0xbe, 0xba, 0x06, 0xdf, 0xfc, 0xbd, 0xc6,
+  0x15, 0x52, 0xc3, 0x9a, 0xe6, 0x02, 0x3c, 0x61, 0x13, 0x29, 0x97, 0x04,
+  0x8c, 0xa0, 0xb5, 0xe9, 0x04, 0xba, 0x6c, 0xc3, 0x3e, 0x0f, 0x17, 0xe8,
+  0x96, 0x3f, 0x2b, 0x17, 0x07, 0x0f, 0xaf, 0x04, 0x00, 0xeb, 0x9d, 0x11,
+  0x0e, 0xed, 0xbb, 0x36, 0x21, 0xeb, 0xda, 0xc4, 0xac, 0x99, 0x9c, 0xb6,
+  0xcc, 0xcf, 0xe2, 0xe4, 0xfe, 0x45, 0xff, 0x75, 0xac, 0x58, 0x67, 0xdc,
+  0x44, 0x02, 0xa0, 0xb6, 0x2d, 0x69, 0x7c, 0x87, 0xe2, 0x06, 0x7d, 0xaa,
+  0xa7, 0x1b, 0x06, 0xde, 0x9e, 0xe5, 0xe4, 0xad, 0x98, 0xc0, 0x59, 0xb8,
+  0xbb, 0xa5, 0xe9, 0xdf, 0x62, 0xb1, 0x54, 0x06, 0x26, 0x7d, 0x10, 0x09,
+  0xa6, 0xcd, 0x67, 0x48, 0x5e, 0xdb, 0xd6, 0xf9, 0xeb, 0xe2, 0x35, 0x04,
+  0x8b, 0x5c, 0x24, 0x8a, 0x31, 0x47, 0xc5, 0xc6, 0x54, 0xd7, 0xd4, 0x37,
+  0x7f, 0xd1, 0xbe, 0xf0, 0x67, 0x73, 0x81, 0x37, 0x6b, 0x95, 0x97, 0xaf,
+  0xcb, 0xd6, 0x9f, 0x06, 0x0c, 0x59, 0xad, 0x39, 0xaf, 0xe4, 0x73, 0xdc,
+  0xc0, 0x1b, 0xb9, 0x7a, 0x72, 0xf6, 0xbd, 0x60, 0x5f, 0xad, 0xde, 0xbb,
+  0xbc, 0x9d, 0xca, 0xc7, 0xdd, 0x4c, 0x7c, 0x0c, 0x62, 0x3b, 0xd1, 0xe1,
+  0x68, 0xac, 0x8a, 0x24, 0xfa, 0x74, 0x28, 0x04, 0xa4, 0xdd, 0x60, 0xbe,
+  0x66, 0x64, 0x45, 0x9c, 0x56, 0x8c, 0xfe, 0x24, 0xe2, 0xba, 0xe2, 0x42,
+  0xb8, 0xfe, 0x2f, 0x42, 0x4a, 0x73, 0xe1, 0xba, 0xa3, 0xe9, 0xcb, 0x62,
+  0xe5, 0x9c, 0x72, 0x56, 0x59, 0x84, 0xb2, 0xf3, 0xf3, 0xa5, 0x42, 0x69,
+  0x55, 0xee, 0x21, 0x0a, 0x25, 0x99, 0x2f, 0xf2, 0x8b, 0xfe, 0x56, 0x19,
+  0xa5, 0x14, 0x29, 0xc5, 0x0d, 0x68, 0x87, 0x8d, 0xcb, 0x66, 0xdc, 0x09,
+  0x6a, 0x3b, 0x40, 0xef, 0x97, 0xd8, 0xd1, 0xeb, 0x6a, 0x7b, 0x22, 0xd5,
+  0xd3, 0xbe, 0x08, 0xb3, 0xe5, 0xd3, 0x26, 0x58, 0x00, 0x01, 0x49, 0x00,
+  0x42, 0x1f, 0x27, 0xb0, 0xaf, 0x60, 0x9e, 0x5a, 0xd3, 0x1f, 0xac, 0x9d,
+  0x4a, 0x6c, 0x6c, 0x71, 0xb6, 0x78, 0x14, 0x56, 0x3b, 0xaa, 0x3e, 0xd2,
+  0x5a, 0x28, 0x0b, 0x46, 0x0d, 0xcc, 0x02, 0xf5, 0x54, 0x09, 0x0c, 0xeb,
+  0x71, 0x0c, 0x36, 0x65, 0x51, 0xcc, 0x24, 0x24, 0xba, 0xf5, 0xdd, 0x4e,
+  0x6b, 0x3f, 0xd0, 0x07, 0xe6, 0xc0, 0x7e, 0xa2, 0xcf, 0xf7, 0xb5, 0x2e,
+  0x7a, 0x21, 0x5f, 0x12, 0xa4, 0x0e, 0x47, 0x1d, 0x48, 0x1c, 0x8a, 0x27,
+  0xd6, 0xf1, 0x1b, 0xfb, 0x36, 0xa6, 0x47, 0xc6, 0x58, 0x3c, 0x6a, 0x53,
+  0x49, 0x0d, 0xb3, 0x0a, 0x99, 0x91, 0x24, 0x4b, 0xf4, 0x8a, 0x15, 0xd9,
+  0x96, 0xbf, 0x5c, 0xcf, 0x6b, 0x59, 0xd3, 0xbc, 0x19, 0xa7, 0x4d, 0x2f,
+  0x5d, 0x16, 0x7c, 0x1e, 0x40, 0x90, 0xd9, 0x9a, 0xe3, 0xbe, 0x66, 0xe2,
+  0x43, 0xaf, 0xea, 0x07, 0x0b, 0x6d, 0xb1, 0x74, 0x0b, 0xd7, 0x8b, 0xc7,
+  0xca, 0x3d, 0xb4, 0xf2, 0x50, 0x85, 0xb4, 0xdc, 0x97, 0xf7, 0xd0, 0x42,
+  0xd2, 0xfe, 0xfe, 0xbe, 0xa2, 0xb3, 0x25, 0x2a, 0x65, 0x2f, 0x92, 0xf2,
+  0xfa, 0xa9, 0xf8, 0xe6, 0xa9, 0xc9, 0xea, 0xe6, 0xee, 0x27, 0xfa, 0xe5,
+  0xfa, 0xad, 0xf2, 0x2b, 0xf1, 0x63, 0x28, 0xd5, 0x0c, 0x5d, 0x90, 0x1c,
+  0xc2, 0x19, 0xf4, 0x5e, 0xe6, 0xa8, 0xd8, 0x38, 0x83, 0xee, 0x93, 0x24,
+  0xf9, 0x63, 0x7b, 0xcd, 0x8b, 0xdc, 0x7f, 0xf3, 0x3a, 0xf9, 0xe0, 0xb9,
+  0x73, 0x07, 0x93, 0x0b, 0xbf, 0xfc, 0x62, 0x67, 0xaa, 0x4b, 0xb9, 0x88,
+  0x3a, 0x23, 0x6e, 0xc8, 0xd7, 0x34, 0x66, 0x77, 0x64, 0x64, 0x73, 0x7d,
+  0x7d, 0x73, 0x64, 0x64, 0x59, 0x68, 0x28, 0xea, 0x89, 0x74, 0xc8, 0x03,
+  0x75, 0x97, 0x01, 0xc3, 0xa5, 0x4c, 0x8c, 0x0e, 0x9c, 0x08, 0x04, 0x78,
+  0x58, 0x53, 0x75, 0x1c, 0xfe, 0x53, 0x50, 0xdf, 0xa3, 0x09, 0xb0, 0x09,
+  0x12, 0xc4, 0xeb, 0xce, 0x46, 0x47, 0x37, 0x58, 0xab, 0x0a, 0x26, 0xf8,
+  0x6c, 0x4b, 0x3d, 0x38, 0x0f, 0xab, 0x1d, 0xfc, 0xc1, 0xf0, 0x63, 0x20,
+  0x80, 0x15, 0x04, 0x02, 0x08, 0x6d, 0xdd, 0x91, 0xe2, 0xe2, 0x47, 0xa0,
+  0x8e, 0xa4, 0xc6, 0x15, 0x7e, 0xc9, 0xba, 0xa4, 0xb7, 0xfb, 0x9c, 0xb6,
+  0xf2, 0xc0, 0x2a, 0xb9, 0x2f, 0xde, 0x87, 0xeb, 0xe0, 0xad, 0x92, 0x0d,
+  0xd9, 0xdc, 0x96, 0xb6, 0x92, 0x61, 0x19, 0x9e, 0x91, 0x19, 0x45, 0x48,
+  0x35, 0xb3, 0x41, 0x0e, 0xcb, 0xa3, 0xf0, 0xd7, 0x7f, 0xd4, 0x2a, 0xd9,
+  0xf5, 0x9c, 0x58, 0xa3, 0x87, 0x0f, 0x80, 0xe0, 0x9a, 0x27, 0xd9, 0xde,
+  0x48, 0x84, 0x80, 0xc7, 0x36, 0x9e, 0x07, 0x45, 0x3e, 0x40, 0xc5, 0x7f,
+  0x8d, 0x5f, 0xa4, 0xd9, 0xdf, 0xc3, 0xb5, 0x86, 0x06, 0x92, 0xb8, 0x00,
+  0x82, 0x9c, 0xd6, 0x1c, 0x6f, 0xd2, 0x1f, 0x4c, 0x81, 0x3e, 0x0b, 0x61,
+  0xf1, 0xc1, 0x4a, 0x52, 0x71, 0x54, 0xbb, 0x70, 0xb5, 0x78, 0x77, 0xa5,
+  0xca, 0x4d, 0xe5, 0xd7, 0xdf, 0xd3, 0x83, 0x4b, 0x5a, 0x03, 0xbc, 0xeb,
+  0x09, 0xaf, 0x1d, 0x1d, 0x0c, 0x1c, 0xc9, 0xd2, 0x10, 0x93, 0x67, 0x4f,
+  0x54, 0xa6, 0x1b, 0x19, 0xcf, 0x86, 0x47, 0xc4, 0x04, 0x7e, 0x92, 0x35,
+  0x9b, 0x17, 0xc2, 0xf1, 0x39, 0xa9, 0x1c, 0x85, 0xd2, 0x4a, 0x83, 0xf2,
+  0x71, 0x81, 0xcf, 0x13, 0xdf, 0xa1, 0xe6, 0x7d, 0x27, 0xca, 0x69, 0xe5,
+  0xa5, 0xf2, 0x54, 0x39, 0x27, 0xcb, 0xd0, 0x0f, 0xda, 0xac, 0xc3, 0x20,
+  0x73, 0xd4, 0x6e, 0x0e, 0xa2, 0xa1, 0xe1, 0x54, 0x19, 0xf9, 0x5b, 0xb6,
+  0x9a, 0x18, 0xd6, 0x14, 0x11, 0xce, 0x7f, 0xb4, 0x1b, 0x80, 0xe7, 0x99,
+  0xb5, 0x4a, 0x7c, 0xcd, 0x32, 0x0d, 0x1b, 0xf4, 0xbb, 0xb2, 0xb0, 0x56,
+  0x59, 0xe8, 0xb7, 0x31, 0xbd, 0xc6, 0x9b, 0x9b, 0x26, 0x16, 0xe9, 0x2a,
+  0x82, 0x15, 0xe8, 0xc4, 0x60, 0x74, 0x61, 0x64, 0x35, 0x29, 0x78, 0x5b,
+  0xe9, 0xe6, 0x17, 0x68, 0xf7, 0x25, 0x9a, 0x6c, 0xc5, 0x25, 0x0d, 0x02,
+  0x52, 0xe5, 0x10, 0x50, 0x9c, 0x6c, 0x72, 0xdd, 0x66, 0xea, 0x4c, 0x7e,
+  0xc8, 0x4c, 0x4a, 0x9e, 0x1c, 0xff, 0xb9, 0xd7, 0x7b, 0xb9, 0xe8, 0x34,
+  0x88, 0x96, 0xa1, 0x39, 0x24, 0x75, 0x87, 0x09, 0x05, 0xdc, 0x28, 0x8c,
+  0xc8, 0x9e, 0xa8, 0xd8, 0xb3, 0x24, 0xc5, 0x7b, 0x22, 0x86, 0xd9, 0xcc,
+  0xac, 0x44, 0xc1, 0xe1, 0x6c, 0x9a, 0x2d, 0x9b, 0xef, 0x01, 0xfa, 0x7d,
+  0x19, 0x8a, 0xd7, 0xb4, 0x1d, 0x68, 0x01, 0x90, 0x1c, 0x12, 0x11, 0xfe,
+  0x3f, 0x64, 0x36, 0xe8, 0xbd, 0xbd, 0x7a, 0x20, 0xbc, 0xe6, 0x0b, 0x5f,
+  0x5f, 0xbd, 0x5d, 0xad, 0xd1, 0xc9, 0xca, 0x50, 0xa3, 0x6f, 0x97, 0xd6,
+  0x56, 0x9d, 0x46, 0x0b, 0x6d, 0xf2, 0xce, 0xdb, 0xcd, 0x81, 0x96, 0x99,
+  0xd6, 0xa1, 0x69, 0x76, 0x47, 0x80, 0x06, 0x7d, 0xd5, 0xe6, 0xb7, 0x41,
+  0x4d, 0xbd, 0xc7, 0x21, 0x1b, 0x56, 0xca, 0x5a, 0xba, 0xa7, 0xc0, 0x3c,
+  0x44, 0x46, 0x74, 0xed, 0xa9, 0x73, 0xe0, 0x67, 0x00, 0x84, 0xb2, 0xf4,
+  0x34, 0x52, 0x52, 0x65, 0x73, 0xdd, 0xaa, 0x0a, 0x1f, 0xe2, 0xa0, 0x48,
+  0x3f, 0x4b, 0xf1, 0x62, 0x60, 0x14, 0x79, 0x49, 0xa5, 0xe8, 0x2c, 0x5a,
+  0x96, 0x5b, 0x51, 0xa0, 0xb0, 0x47, 0x33, 0x92, 0xf1, 0xb2, 0x5f, 0x94,
+  0xc3, 0x9b, 0xb8, 0xb4, 0x65, 0x31, 0xb4, 0xa9, 0x4b, 0x27, 0x9c, 0xd2,
+  0xfd, 0xbb, 0x37, 0x1c, 0xdc, 0x00, 0xa4, 0x0e, 0xfc, 0x01, 0xf4, 0x23,
+  0x7a, 0xac, 0xdd, 0xbe, 0xbe, 0xb8, 0x1f, 0xd3, 0x93, 0xd4, 0xca, 0x8a,
+  0x91, 0xee, 0x02, 0xce, 0xbc, 0xb2, 0x44, 0xf6, 0x3a, 0x76, 0x53, 0xd2,
+  0x76, 0x47, 0x80, 0xff, 0x72, 0x15, 0x40, 0x2c, 0x10, 0xa1, 0x95, 0x96,
+  0x6c, 0x1d, 0x96, 0x46, 0x3b, 0xbf, 0x3f, 0xae, 0x4e, 0x91, 0x26, 0x8f,
+  0xee, 0xa0, 0x03, 0x8f, 0x3c, 0xc0, 0xab, 0x5c, 0x2e, 0x48, 0xc9, 0x2d,
+  0xee, 0x48, 0x0b, 0x3c, 0xc9, 0xc5, 0xb3, 0x95, 0x19, 0x76, 0x64, 0xd0,
+  0x4e, 0x2f, 0x5b, 0x73, 0x41, 0x52, 0x8e, 0x57, 0xa0, 0xd3, 0xe5, 0x2e,
+  0xdc, 0xc9, 0xe5, 0x56, 0x2b, 0x3f, 0x17, 0x77, 0xb6, 0x32, 0x7e, 0x4d,
+  0x54, 0x66, 0x7d, 0x0b, 0x91, 0x2e, 0xb7, 0x10, 0xb0, 0x32, 0x9c, 0xdb,
+  0xfd, 0x5b, 0x10, 0xd0, 0xba, 0x93, 0x79, 0x14, 0xe8, 0xba, 0x0b, 0xe2,
+  0x47, 0xd2, 0xba, 0x16, 0x43, 0xb9, 0xb7, 0x1c, 0x74, 0x26, 0x51, 0x96,
+  0x65, 0xd0, 0x6c, 0xd6, 0x23, 0x83, 0x25, 0xf2, 0xca, 0xe4, 0x80, 0x6e,
+  0x83, 0x74, 0xc8, 0x02, 0xdd, 0x12, 0xe8, 0x00, 0xd5, 0x2d, 0x02, 0x04,
+  0x5f, 0x02, 0xec, 0xaf, 0xbc, 0x4f, 0x38, 0xe6, 0xea, 0xe7, 0x66, 0x3f,
+  0xb9, 0x3a, 0x9c, 0x78, 0x18, 0xec, 0x58, 0x4f, 0x78, 0x9f, 0xf6, 0x22,
+  0x84, 0x5c, 0xf7, 0xf5, 0xd0, 0xf9, 0x18, 0x7c, 0xc5, 0x08, 0xd1, 0x59,
+  0xe5, 0xac, 0x12, 0x5f, 0x57, 0x39, 0x9c, 0x55, 0x1b, 0x70, 0xc7, 0x11,
+  0xf5, 0x60, 0xaf, 0xcf, 0xdd, 0x84, 0x19, 0x8c, 0x31, 0xb1, 0x71, 0xb1,
+  0x31, 0xd1, 0x11, 0xe1, 0x72, 0x08, 0x14, 0x4b, 0xee, 0xdd, 0x70, 0x8c,
+  0xe1, 0xea, 0xc4, 0x88, 0x75, 0xc7, 0x18, 0xcc, 0xc3, 0x49, 0x7a, 0x9e,
+  0xe3, 0xd9, 0x5f, 0xf3, 0x2f, 0xfb, 0xc7, 0x8f, 0x9f, 0x3f, 0xff, 0xf2,
+  0x65, 0xe5, 0xdd, 0xf8, 0x09, 0x07, 0x42, 0x30, 0xea, 0x55, 0x34, 0x20,
+  0xe9, 0xe4, 0x09, 0xd4, 0x0d, 0x75, 0x3d, 0x75, 0xf2, 0x93, 0xbe, 0xad,
+  0x07, 0x1e, 0x7e, 0x63, 0x4b, 0x4b, 0x6b, 0x9e, 0xaf, 0x5e, 0xad, 0xdc,
+  0x78, 0x56, 0x43, 0xd8, 0x58, 0x2b, 0x2e, 0xb3, 0xdb, 0x2b, 0x50, 0xcf,
+  0xb3, 0x72, 0x3b, 0xaa, 0x94, 0xda, 0xd3, 0xeb, 0xd6, 0xad, 0x00, 0x40,
+  0x50, 0x0a, 0xe0, 0x9f, 0x65, 0x43, 0x0b, 0x7e, 0x95, 0x77, 0xe7, 0x40,
+  0xd0, 0x26, 0xee, 0x14, 0x9d, 0xce, 0xc6, 0xaa, 0x6e, 0x60, 0x4d, 0xed,
+  0xd1, 0x5c, 0xd4, 0x77, 0x75, 0xb4, 0x98, 0x90, 0x54, 0x3f, 0x4c, 0x43,
+  0x6d, 0xf9, 0x75, 0xc4, 0x10, 0x34, 0xfe, 0x6c, 0xe8, 0x8f, 0x23, 0xd2,
+  0x0f, 0xa5, 0xa4, 0x20, 0x6a, 0x9b, 0x23, 0x57, 0x77, 0x31, 0x15, 0xd8,
+  0xc6, 0x35, 0xe2, 0x1a, 0x00, 0xc1, 0x30, 0x80, 0x0d, 0xcc, 0x5b, 0x04,
+  0x33, 0xa0, 0xaa, 0x42, 0xc0, 0x6f, 0x3f, 0xf5, 0x77, 0xe7, 0x8d, 0xe2,
+  0xf5, 0x3a, 0xa7, 0xe5, 0x7a, 0xd5, 0xa1, 0x5e, 0x60, 0x3d, 0x86, 0x53,
+  0xff, 0xec, 0x06, 0xd6, 0x3d, 0x3c, 0xd5, 0x33, 0x9d, 0x7d, 0x57, 0x10,
+  0xd8, 0xd7, 0xf6, 0xfd, 0xed, 0xa4, 0xd5, 0xac, 0xeb, 0xeb, 0x84, 0x3a,
+  0x87, 0xa3, 0xae, 0xd1, 0x21, 0x79, 0x58, 0x2c, 0x56, 0x55, 0xfa, 0xa9,
+  0x9c, 0xa0, 0xfc, 0xa0, 0xbf, 0x82, 0x68, 0xea, 0x15, 0xc4, 0x11, 0xce,
+  0x20, 0xc9, 0x52, 0x74, 0x04, 0x8e, 0x08, 0x0f, 0xe1, 0x63, 0x62, 0xa3,
+  0xbc, 0xa9, 0xa7, 0x47, 0xd8, 0xfb, 0x19, 0xf1, 0x32, 0xe8, 0x79, 0x4e,
+  0x0e, 0xa1, 0x89, 0x5f, 0xa6, 0x74, 0xac, 0xed, 0x98, 0x52, 0xf2, 0xc5,
+  0xb4, 0xf6, 0x41, 0xe9, 0x43, 0x50, 0xdf, 0xd7, 0x3f, 0xa0, 0xa0, 0xf0,
+  0x31, 0x1d, 0x07, 0x49, 0x3e, 0x9f, 0x2d, 0x60, 0x52, 0x92, 0xf2, 0x6a,
+  0xc5, 0x4e, 0xd7, 0x54, 0xbc, 0xf4, 0xbb, 0x15, 0x48, 0x9b, 0x74, 0x4e,
+  0x55, 0x36, 0x6a, 0x4d, 0xca, 0x24, 0x34, 0xf3, 0x99, 0x2a, 0xd8, 0x3a,
+  0xaa, 0x43, 0xd7, 0x3e, 0xe5, 0xae, 0xeb, 0xad, 0x05, 0x26, 0x4b, 0xae,
+  0x05, 0xb4, 0x36, 0xb9, 0x5c, 0xa8, 0x20, 0xbb, 0x06, 0x12, 0x49, 0xa5,
+  0x12, 0x04, 0x89, 0x52, 0xd2, 0xa7, 0x27, 0x2a, 0x6e, 0x9f, 0x33, 0x15,
+  0xe5, 0x89, 0x3f, 0xc4, 0x76, 0xfe, 0x1c, 0x55, 0x8b, 0x4e, 0xc7, 0x9e,
+  0x4d, 0x3c, 0x5f, 0x6d, 0xcb, 0x26, 0x5e, 0xa2, 0x26, 0xdd, 0xb4, 0x67,
+  0x05, 0xb9, 0xdd, 0x3a, 0x53, 0xac, 0x10, 0x4f, 0x92, 0xfa, 0x4f, 0xe2,
+  0xbb, 0x3e, 0x2d, 0x72, 0x7b, 0x9e, 0xa3, 0x2a, 0x95, 0x81, 0xfa, 0xaa,
+  0x12, 0x35, 0x60, 0x18, 0xa6, 0xe1, 0xc3, 0x44, 0x7d, 0x37, 0x64, 0x0f,
+  0x0b, 0xb4, 0x74, 0xb0, 0x6b, 0xf3, 0x50, 0xbc, 0x43, 0x4c, 0x85, 0x54,
+  0x93, 0x64, 0x09, 0xed, 0xd4, 0x6d, 0x09, 0x31, 0x73, 0x95, 0xeb, 0x7b,
+  0xe5, 0x79, 0x15, 0x5e, 0xbf, 0x07, 0x96, 0xa2, 0x77, 0xde, 0x05, 0x95,
+  0x38, 0xc7, 0x18, 0x08, 0xa0, 0xf5, 0xdc, 0x04, 0xa8, 0xa0, 0x57, 0x35,
+  0xe8, 0x84, 0xa3, 0x95, 0x6e, 0x89, 0xbd, 0x34, 0x01, 0x78, 0x81, 0x4b,
+  0x6c, 0xcb, 0x8d, 0xa6, 0x03, 0xd4, 0x96, 0x15, 0xac, 0xea, 0xd8, 0xb9,
+  0xbc, 0xe8, 0x78, 0x5a, 0x23, 0x64, 0x65, 0x39, 0x98, 0x66, 0x6f, 0xbb,
+  0x5a, 0x1c, 0x7f, 0x60, 0x3f, 0x6a, 0x7b, 0x57, 0x42, 0xe6, 0x4d, 0xb3,
+  0xcb, 0xa1, 0x53, 0x0e, 0xc9, 0x5b, 0xdf, 0x4b, 0x99, 0xc0, 0x03, 0x32,
+  0x7c, 0x31, 0x23, 0x4f, 0x9b, 0x43, 0x6a, 0x6a, 0xf0, 0xcd, 0x9d, 0x4c,
+  0x63, 0x87, 0xb3, 0x16, 0xd0, 0x56, 0x65, 0x1e, 0xcf, 0x98, 0x5f, 0xc3,
+  0xf9, 0xd7, 0x8a, 0x0a, 0x3c, 0xcc, 0xa9, 0x6b, 0xa2, 0xeb, 0x8b, 0x19,
+  0x10, 0x00, 0xe0, 0xaf, 0xdf, 0xda, 0xab, 0x58, 0xf0, 0x18, 0xf7, 0x84,
+  0x37, 0x42, 0x48, 0x00, 0x00, 0x80, 0xdb, 0x57, 0x0a, 0x86, 0x99, 0x7b,
+  0x78, 0x77, 0xd1, 0xf9, 0xb9, 0x6e, 0xc4, 0x70, 0x1d, 0x00, 0x01, 0xb0,
+  0x3b, 0x3f, 0x04, 0xc0, 0xff, 0xb4, 0x04, 0x00, 0xe8, 0x14, 0x87, 0x3e,
+  0x0e, 0x44, 0xa0, 0x79, 0xe7, 0xc2, 0xc4, 0xaa, 0x9e, 0x34, 0x3f, 0x40,
+  0x51, 0x66, 0x23, 0xe6, 0x6c, 0xaa, 0x53, 0x97, 0x50, 0xa1, 0x59, 0x3e,
+  0xfa, 0xa2, 0xb4, 0xf5, 0xe5, 0x73, 0xb2, 0xd4, 0xdc, 0xae, 0x1d, 0x32,
+  0x05, 0x70, 0xc9, 0x97, 0x71, 0x4d, 0x13, 0xc9, 0xc9, 0x04, 0xa8, 0xd6,
+  0x32, 0x4e, 0x95, 0xd6, 0x55, 0xe8, 0xe2, 0x79, 0x77, 0x28, 0x81, 0x8a,
+  0x74, 0xf2, 0x74, 0x33, 0x1c, 0x16, 0xa0, 0xdf, 0xbd, 0x1b, 0xc1, 0x0d,
+  0xd3, 0x90, 0x32, 0x78, 0x3d, 0x01, 0xca, 0xe2, 0xf3, 0x72, 0x29, 0x22,
+  0xe7, 0x88, 0x7c, 0xdf, 0xee, 0x97, 0xfc, 0xdb, 0x7c, 0x15, 0xdd, 0xed,
+  0x49, 0xc9, 0x6d, 0x2f, 0xcb, 0xf3, 0x76, 0xa7, 0x6c, 0x69, 0xd7, 0xfc,
+  0x37, 0x98, 0x36, 0xaa, 0xab, 0xa1, 0x04, 0xe0, 0xcb, 0x51, 0xb1, 0x34,
+  0x37, 0x30, 0xac, 0x1c, 0x5b, 0xa5, 0xf2, 0x54, 0x5f, 0xe2, 0x24, 0xcf,
+  0xbf, 0x6b, 0x27, 0x2e, 0x94, 0x45, 0x23, 0x6d, 0x8e, 0xfd, 0x66, 0x1f,
+  0x7d, 0xc9, 0x4b, 0x03, 0x13, 0x6f, 0x32, 0x2a, 0xc6, 0xc7, 0x0f, 0x31,
+  0x2f, 0x36, 0xc7, 0xfe, 0xb8, 0x10, 0x7f, 0xc7, 0xe5, 0x78, 0x11, 0xff,
+  0x45, 0x54, 0xa2, 0x3e, 0xd4, 0x48, 0x93, 0x34, 0x46, 0x3f, 0x28, 0x4b,
+  0xb9, 0x5a, 0xa1, 0xcd, 0x2a, 0xd5, 0x41, 0x9d, 0x50, 0xad, 0x1a, 0x74,
+  0x4d, 0xcd, 0x7a, 0xac, 0x57, 0x3a, 0x4c, 0xb0, 0x91, 0x39, 0x37, 0x6f,
+  0xe6, 0xe3, 0x62, 0x2d, 0xd3, 0xca, 0xd2, 0x52, 0x38, 0x0d, 0x08, 0xb8,
+  0x15, 0xd3, 0x4c, 0x8b, 0xbd, 0x12, 0xce, 0x6e, 0x9e, 0x33, 0x02, 0xe8,
+  0x40, 0x72, 0x46, 0x11, 0x02, 0x3a, 0xde, 0x4f, 0x62, 0x9a, 0x81, 0x5d,
+  0x09, 0x0d, 0xd5, 0xc9, 0x38, 0x68, 0x55, 0x9d, 0x9c, 0xde, 0xfe, 0x05,
+  0xc3, 0x79, 0x41, 0x41, 0xa7, 0xe4, 0xb0, 0x8d, 0x9e, 0x6c, 0x61, 0xbf,
+  0xed, 0x30, 0x63, 0x7a, 0xc6, 0x8e, 0xa6, 0xa8, 0x1e, 0x47, 0x92, 0xad,
+  0x46, 0xe9, 0x8a, 0x54, 0x65, 0x3c, 0x4f, 0xf8, 0xe6, 0xa0, 0xcb, 0x21,
+  0xc5, 0x42, 0xcf, 0xc5, 0x4b, 0xe5, 0x25, 0xb0, 0xda, 0xee, 0x00, 0x46,
+  0xa9, 0xeb, 0x76, 0x9a, 0x19, 0x96, 0x3e, 0x93, 0x9c, 0x96, 0x4b, 0x72,
+  0xa9, 0xc4, 0xb9, 0xeb, 0x04, 0x71, 0x5d, 0xc5, 0x2e, 0x25, 0xe2, 0x99,
+  0x75, 0xee, 0x34, 0xfc, 0x82, 0x65, 0x9d, 0xf8, 0x70, 0x51, 0x69, 0x48,
+  0xd2, 0xb2, 0x54, 0x85, 0xf9, 0x73, 0xc2, 0xf5, 0xf5, 0xc2, 0x9b, 0xcf,
+  0xb7, 0x56, 0x2c, 0x60, 0x35, 0xc6, 0x8c, 0x3b, 0x49, 0xcc, 0x30, 0xdc,
+  0x7d, 0x04, 0x3f, 0x36, 0xea, 0xf2, 0x26, 0x95, 0x84, 0x74, 0x99, 0x2c,
+  0xf0, 0x32, 0x7f, 0x3e, 0x6b, 0xaa, 0xeb, 0xba, 0xa3, 0xd1, 0xd1, 0x64,
+  0xdc, 0xc4, 0x31, 0x07, 0x8d, 0x30, 0x6e, 0x5a, 0xa4, 0x82, 0x3c, 0xf5,
+  0x81, 0x69, 0xb7, 0x2a, 0xc1, 0x5c, 0x2f, 0xdb, 0xe5, 0x45, 0x74, 0x8b,
+  0xd7, 0xef, 0x24, 0x71, 0x04, 0x92, 0x64, 0xc8, 0x92, 0x43, 0xa4, 0x85,
+  0xde, 0x37, 0x73, 0x86, 0xcb, 0x8a, 0xaa, 0xe9, 0x86, 0x69, 0xd9, 0x8e,
+  0xeb, 0xf1, 0xfa, 0x58, 0x58, 0xd9, 0xd8, 0x39, 0x38, 0xb9, 0xb8, 0x79,
+  0x78, 0xf9, 0xf8, 0x05, 0x04, 0x85, 0x84, 0x45, 0x44, 0xe3, 0x2d, 0x2b,
+  0x8b, 0x13, 0x94, 0x4b, 0x48, 0x4a, 0xf5, 0xd3, 0xa8, 0xf5, 0xc5, 0xda,
+  0x1a, 0xb3, 0x34, 0x5f, 0x5f, 0xa5, 0x56, 0xab, 0xa2, 0x9a, 0xa7, 0xde,
+  0xd5, 0x5a, 0xb5, 0x4e, 0xad, 0x57, 0x3b, 0x55, 0x49, 0xed, 0x52, 0xbb,
+  0xd5, 0x9e, 0x8f, 0xed, 0x25, 0x8f, 0x90, 0xdc, 0xb2, 0xa8, 0x49, 0x1f,
+  0x3c, 0x36, 0x48, 0xab, 0xf0, 0x2c, 0x32, 0xe9, 0x57, 0xe6, 0xe1, 0xdc,
+  0xbe, 0x68, 0x4a, 0x1a, 0x94, 0xa6, 0xcf, 0x31, 0x66, 0x3a, 0x32, 0x18,
+  0x90, 0x9b, 0x7a, 0x58, 0xb3, 0x24, 0xa2, 0xaa, 0xb4, 0x7f, 0xb5, 0x53,
+  0x02, 0x56, 0x2c, 0x5d, 0x7d, 0xb1, 0xc2, 0x40, 0xb5, 0xa4, 0x4c, 0x22,
+  0xf5, 0xfd, 0x79, 0x25, 0x95, 0xb4, 0x99, 0x7a, 0x9e, 0xdb, 0xce, 0x0a,
+  0x39, 0xc9, 0x29, 0x33, 0x53, 0xfc, 0x76, 0x36, 0x6c, 0x3b, 0xcb, 0x6a,
+  0xa6, 0x58, 0xec, 0x9c, 0x65, 0x22, 0x85, 0xb2, 0xbb, 0xf3, 0xfd, 0x6b,
+  0xaa, 0x1b, 0x4c, 0x25, 0xef, 0x0c, 0xbb, 0x90, 0x80, 0xf0, 0x75, 0x97,
+  0x58, 0xe1, 0xb9, 0x1d, 0xed, 0x90, 0x7d, 0xb4, 0xfb, 0x20, 0x78, 0x2f,
+  0x7a, 0xa7, 0xc4, 0x5b, 0x23, 0x79, 0xd3, 0xd0, 0x5e, 0xb3, 0x57, 0xda,
+  0x4b, 0x23, 0x79, 0xc1, 0x9e, 0xef, 0x17, 0xf1, 0xd9, 0xcd, 0xca, 0x67,
+  0xec, 0xa9, 0xe2, 0x89, 0xc2, 0xa1, 0x7a, 0xac, 0x7a, 0xc4, 0x1e, 0x36,
+  0x79, 0x20, 0xb9, 0xcf, 0xee, 0x89, 0x5a, 0xff, 0x4d, 0x6d, 0x55, 0xb4,
+  0x4c, 0x60, 0x22, 0x68, 0xfe, 0x5b, 0xb9, 0xf9, 0xc0, 0xc5, 0x49, 0xbb,
+  0xc3, 0x6e, 0xb3, 0x5b, 0xa2, 0x9b, 0x76, 0x37, 0x14, 0xd7, 0xd9, 0x35,
+  0xab, 0xab, 0x67, 0x5c, 0xf9, 0xe9, 0x32, 0xbb, 0x38, 0x37, 0xd5, 0xc5,
+  0x33, 0x9a, 0xfe, 0xf4, 0x6d, 0xda, 0xb1, 0xc4, 0x68, 0xf8, 0xed, 0xdb,
+  0xc0, 0x90, 0x7f, 0xd8, 0xdf, 0x0a, 0x7f, 0xc1, 0x9f, 0x3e, 0xf5, 0x8a,
+  0xba, 0x5f, 0xc1, 0x75, 0x0c, 0xe1, 0xd4, 0x88, 0xaa, 0xd9, 0xb9, 0x2b,
+  0x79, 0xce, 0xef, 0xac, 0x53, 0x15, 0x3b, 0x03, 0x38, 0x0d, 0xa7, 0xe0,
+  0x24, 0x9c, 0x80, 0xe3, 0x70, 0x0c, 0x8e, 0xc2, 0x91, 0x70, 0x87, 0x2d,
+  0x2a, 0xaf, 0x0a, 0x2b, 0x59, 0xc5, 0xd7, 0x9f, 0x54, 0xc1, 0xfe, 0xf8,
+  0xb2, 0x92, 0x04, 0xab, 0x70, 0x5e, 0xff, 0xfb, 0x67, 0xe1, 0x2d, 0xd4,
+  0x23, 0x7c, 0xe9, 0x50, 0x98, 0xca, 0x21, 0x76, 0x50, 0xc1, 0x81, 0x42,
+  0xdb, 0xcf, 0xca, 0x61, 0x9f, 0xdf, 0x5e, 0x39, 0xf6, 0x18, 0xc9, 0xee,
+  0x4f, 0xc2, 0xdd, 0x44, 0xdb, 0xf5, 0xd1, 0x9a, 0x81, 0xaf, 0x5f, 0x6f,
+  0x76, 0xe6, 0xaf, 0xaa, 0x5f, 0xd8, 0xff, 0x15, 0x4a, 0x53, 0x3b, 0xad,
+  0x76, 0x20, 0x7a, 0xfb, 0x07, 0x23, 0xdb, 0x2e, 0x1a, 0x49, 0xb6, 0xca,
+  0x51, 0xd2, 0xab, 0x95, 0x28, 0x28, 0x16, 0x8b, 0x5e, 0x97, 0xb1, 0x22,
+  0x06, 0x5f, 0x52, 0xf0, 0xd2, 0xb3, 0x40, 0x8e, 0x2d, 0x2f, 0xcc, 0x09,
+  0x83, 0x00, 0x9b, 0x4a, 0xc8, 0x46, 0xb6, 0x41, 0x31, 0xb0, 0x0d, 0xcc,
+  0x54, 0x10, 0xfb, 0x34, 0xd8, 0xc5, 0x75, 0x8f, 0x8c, 0x6c, 0x5d, 0x12,
+  0x82, 0xc8, 0x1a, 0xd5, 0xea, 0xfb, 0x3f, 0x69, 0x35, 0x5b, 0x75, 0x6f,
+  0x25, 0x2d, 0x56, 0xe1, 0xbc, 0x3e, 0xff, 0xae, 0xf0, 0x4e, 0x45, 0x7e,
+  0x87, 0x4e, 0x3f, 0x2b, 0xd8, 0xf2, 0x5b, 0x15, 0x97, 0x33, 0x0d, 0xb2,
+  0xf4, 0xaa, 0x70, 0x69, 0x67, 0x2c, 0xb9, 0x5e, 0xca, 0x96, 0xd8, 0x99,
+  0x0a, 0xb2, 0xa8, 0x22, 0x2e, 0x92, 0x63, 0xe1, 0x15, 0x4b, 0xc2, 0x88,
+  0x60, 0x3e, 0x9b, 0x77, 0xf1, 0xae, 0x9f, 0xc7, 0x80, 0xe4, 0xb1, 0x5c,
+  0x85, 0x9c, 0xa9, 0xad, 0x47, 0x67, 0xcf, 0x9c, 0xa1, 0x39, 0x0c, 0x0e,
+  0x66, 0xcd, 0xb5, 0x9d, 0x39, 0xed, 0x38, 0x53, 0x9b, 0xc1, 0xb2, 0x03,
+  0xa7, 0x1b, 0xc9, 0xb4, 0x32, 0x32, 0xb5, 0x84, 0x4c, 0x61, 0x93, 0x55,
+  0x59, 0x02, 0x93, 0x20, 0x53, 0xcb, 0x60, 0xe9, 0xf0, 0x73, 0xc0, 0x8f,
+  0x11, 0x3f, 0xb0, 0xef, 0x2d, 0xe6, 0x4a, 0x74, 0x30, 0x85, 0x7d, 0xd2,
+  0xb0, 0x77, 0x06, 0xbb, 0x49, 0xdb, 0x61, 0xdb, 0x4c, 0x16, 0xd8, 0x82,
+  0xcd, 0xd4, 0x46, 0x13, 0xd6, 0xa7, 0xb5, 0xd5, 0x32, 0xac, 0xc0, 0x12,
+  0x5b, 0x84, 0xb8, 0x30, 0x5f, 0x42, 0x0b, 0xaa, 0x14, 0x02, 0x73, 0x4e,
+  0x0f, 0xcd, 0x89, 0x98, 0x65, 0x33, 0xd3, 0x0e, 0x9a, 0x91, 0x60, 0x02,
+  0x31, 0xa5, 0x35, 0xd3, 0x94, 0x1b, 0x93, 0x76, 0x4c, 0x0c, 0xda, 0x68,
+  0x42, 0xb4, 0xf1, 0x52, 0x8c, 0x89, 0xa3, 0x23, 0x66, 0x1a, 0x65, 0x40,
+  0x18, 0xe6, 0x43, 0x03, 0x30, 0x94, 0x1a, 0x1c, 0x30, 0x13, 0x69, 0x8b,
+  0x81, 0x80, 0x81, 0x2e, 0x30, 0xfa, 0x0d, 0xe8, 0x63, 0xbd, 0x8a, 0x1e,
+  0x45, 0x37, 0xeb, 0xd2, 0xe5, 0xa8, 0x4b, 0x25, 0xfd, 0xd4, 0x39, 0x84,
+  0x0e, 0xd6, 0xce, 0xda, 0x5a, 0xad, 0xd4, 0x66, 0x47, 0x6b, 0x8b, 0x89,
+  0x8c, 0x0f, 0x5a, 0x9a, 0x0d, 0xd4, 0xd2, 0x71, 0x64, 0x12, 0x42, 0xa0,
+  0x89, 0x35, 0xb2, 0x86, 0x7a, 0x3b, 0x35, 0xa8, 0xea, 0xeb, 0xcc, 0x84,
+  0xb6, 0xa8, 0xab, 0x2d, 0x25, 0x86, 0x63, 0x6a, 0xd4, 0x04, 0x91, 0x37,
+  0x40, 0xac, 0xe6, 0xf5, 0x22, 0x43, 0x0c, 0xaa, 0x2a, 0x4b, 0xa9, 0xca,
+  0x80, 0x18, 0x54, 0xe4, 0x8a, 0xa9, 0xc2, 0x8c, 0x20, 0x64, 0x45, 0x64,
+  0xd2, 0x02, 0x65, 0x64, 0xa4, 0x53, 0x56, 0xb2, 0x0c, 0x88, 0x41, 0x32,
+  0x21, 0x50, 0xb2, 0x13, 0x31, 0x28, 0x17, 0x4a, 0xa9, 0xdc, 0x84, 0x13,
+  0x42, 0x9c, 0xc5, 0x58, 0xd4, 0x84, 0x88, 0xd6, 0x4c, 0x11, 0x2b, 0xc2,
+  0x32, 0x42, 0xaa, 0x60, 0xc0, 0x40, 0x41, 0x60, 0xec, 0x0a, 0x7e, 0x8b,
+  0x44, 0x7e, 0xe6, 0x53, 0x79, 0x25, 0x78, 0x6e, 0xf0, 0x4c, 0xe5, 0x96,
+  0xe1, 0x72, 0x7a, 0xc8, 0x25, 0x9a, 0x53, 0x6b, 0x26, 0x04, 0x07, 0xb3,
+  0xa3, 0xc1, 0xc6, 0xac, 0x9d, 0x60, 0x4d, 0x59, 0x74, 0x39, 0x92, 0x20,
+  0x98, 0xcf, 0xc0, 0x24, 0xc3, 0xc8, 0x0c, 0x65, 0x4e, 0x32, 0x80, 0x97,
+  0x2d, 0x61, 0x41, 0x28, 0x4d, 0x95, 0x98, 0x51, 0x0c, 0x5e, 0xd4, 0x1f,
+  0x5d, 0xc4, 0x0a, 0xed, 0x28, 0xe0, 0xfa, 0x2e, 0xa6, 0x57, 0xb7, 0xc3,
+  0x81, 0x26, 0x80, 0xeb, 0x38, 0x26, 0x0c, 0x82, 0xa0, 0xf9, 0xc9, 0xd3,
+  0x7e, 0x23, 0x5f, 0x69, 0x99, 0xb9, 0x1f, 0x96, 0x26, 0xf3, 0x67, 0x06,
+  0x00, 0x00, 0x00, 0x00
+};
+
+std::size_t const tcmplxAtest_woff2_real_size =
+  sizeof(tcmplxAtest_woff2_real);
+
+std::size_t const tcmplxAtest_woff2_real_stream = 93u;
+std::size_t const tcmplxAtest_woff2_real_stream_size = 4804u;
+
+/* source tables in stream order; no table is transformed */
+tcmplxAtest_sfnt_table const tcmplxAtest_woff2_real_tables[] = {
+  { "GDEF", 28u, 0x051500acu },
+  { "GPOS", 32u, 0x2bdb037bu },
+  { "GSUB", 212u, 0x95ad34aeu },
+  { "MATH", 246u, 0x764f0df3u },
+  { "OS/2", 86u, 0x86520a44u },
+  { "cmap", 84u, 0x087311bcu },
+  { "cvt ", 510u, 0xace7833eu },
+  { "fpgm", 171u, 0xaa2f3260u },
+  { "gasp", 12u, 0x075c020eu },
+  { "glyf", 3386u, 0x84d0c52cu },
+  { "head", 54u, 0x22b40b59u },
+  { "hhea", 36u, 0x981e0653u },
+  { "hmtx", 216u, 0xa67c475fu },
+  { "loca", 110u, 0xce001dedu },
+  { "maxp", 32u, 0x2634021eu },
+  { "name", 468u, 0x1f7042cfu },
+  { "post", 488u, 0x44db79f2u },
+  { "prep", 1384u, 0x110b8f18u },
+};
+
+std::size_t const tcmplxAtest_woff2_real_count =
+  sizeof(tcmplxAtest_woff2_real_tables)/sizeof(tcmplxAtest_sfnt_table);
+
+static unsigned long tcmplxAtest_read_u32be(unsigned char const* p) {
+  return (static_cast<unsigned long>(p[0])<<24)
+    | (static_cast<unsigned long>(p[1])<<16)
+    | (static_cast<unsigned long>(p[2])<<8)
+    | static_cast<unsigned long>(p[3]);
+}
+
+int tcmplxAtest_woff2_real_check
+  (unsigned char const* tag, unsigned char const* data, std::size_t len)
+{
+  namespace tca = text_complex::access;
+  std::size_t i;
+  for (i = 0u; i < tcmplxAtest_woff2_real_count; ++i) {
+    if (std::memcmp(tcmplxAtest_woff2_real_tables[i].tag, tag, 4) == 0)
+      break;
+  }
+  if (i >= tcmplxAtest_woff2_real_count)
+    return -1;
+  tcmplxAtest_sfnt_table const& line = tcmplxAtest_woff2_real_tables[i];
+  if (len != line.length)
+    return 1;
+  tca::uint32 chk;
+  if (std::memcmp(tag, "head", 4) == 0 && len >= 12u) {
+    static unsigned char const zero[4] = {0u,0u,0u,0u};
+    chk = tca::zutil_adler32(8u, data);
+    chk = tca::zutil_adler32(4u, zero, chk);
+    chk = tca::zutil_adler32(len-12u, data+12u, chk);
+  } else chk = tca::zutil_adler32(len, data);
+  return (chk == line.adler32) ? 0 : 2;
+}
+
+int tcmplxAtest_woff2_real_check_sfnt
+  (unsigned char const* sfnt, std::size_t len)
+{
+  if (len < 12u)
+    return -1;
+  std::size_t const n = (static_cast<std::size_t>(sfnt[4])<<8) | sfnt[5];
+  if (n != tcmplxAtest_woff2_real_count || len < 12u+16u*n)
+    return -1;
+  int bad = 0;
+  for (std::size_t i = 0u; i < n; ++i) {
+    unsigned char const* const record = sfnt+12u+16u*i;
+    unsigned long const offset = tcmplxAtest_read_u32be(record+8);
+    unsigned long const length = tcmplxAtest_read_u32be(record+12);
+    if (offset > len || length > len-offset
+    ||  tcmplxAtest_woff2_real_check(record, sfnt+offset, length) != 0)
+    {
+      bad += 1;
+    }
+  }
+  return bad;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file tools/tca_tool.hpp
+ * @brief Shared input, output and statistics support for the tools.
+ */
+#ifndef hg_TCMPLXAP_TOOLS_TOOL_Hpp_
+#define hg_TCMPLXAP_TOOLS_TOOL_Hpp_
+
+#include "mmaptwo-plus/mmaptwo.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#if (defined __unix__) || (defined(__APPLE__)&&defined(__MACH__))
+#  include <sys/resource.h>
+#  define TCMPLXAP_TOOL_RUSAGE 1
+#endif /*__unix__*/
+
+/**
+ * @brief Size of each input chunk and of the output buffer.
+ */
+static constexpr std::size_t tool_chunk_size = 1048576u;
+
+/**
+ * @brief Command line settings shared by the tools.
+ */
+struct tool_options {
+  std::string ifilename;
+  std::string ofilename;
+  bool decode;
+  bool stats;
+  /** @brief Compression level, or -1 when not given. */
+  int level;
+  unsigned long block_size;
+  unsigned long window;
+  /** @brief Hash chain length, or zero to follow the level. */
+  unsigned long chain_length;
+};
+
+/**
+ * @brief Input file, memory-mapped when possible.
+ * @note Falls back to stream reads for empty files and for inputs
+ *   that cannot be mapped, such as pipes.
+ */
+class tool_input {
+private:
+  std::unique_ptr<mmaptwo::mmaptwo_i> map;
+  std::unique_ptr<mmaptwo::page_i> page;
+  std::ifstream stream;
+  std::vector<unsigned char> buf;
+  std::size_t pos;
+  std::size_t total;
+
+public:
+  tool_input(void) : pos(0u), total(0u) {}
+  /**
+   * @brief Open an input file.
+   * @param name file name
+   * @return whether the file is ready for reading
+   */
+  bool open(std::string const& name) {
+    map.reset(mmaptwo::open(name.c_str(), "re", 0u, 0u, false));
+    if (map) {
+      (void)map->advise(mmaptwo::advice_sequential, map->length(), 0u);
+      return true;
+    }
+    stream.open(name.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!stream)
+      return false;
+    buf.resize(tool_chunk_size);
+    return true;
+  }
+  /**
+   * @brief Fetch the next chunk of input.
+   * @param[out] p start of the chunk
+   * @param[out] n length of the chunk
+   * @return 1 on success, 0 at end of input, -1 on read error
+   */
+  int next(unsigned char const*& p, std::size_t& n) {
+    if (map) {
+      std::size_t const len = map->length();
+      page.reset();
+      if (pos >= len)
+        return 0;
+      n = (len-pos < tool_chunk_size) ? len-pos : tool_chunk_size;
+      page.reset(map->acquire(n, pos));
+      if (!page)
+        return -1;
+      p = static_cast<unsigned char const*>(page->get());
+    } else {
+      if (stream.eof())
+        return 0;
+      stream.read(reinterpret_cast<char*>(buf.data()),
+        static_cast<std::streamsize>(buf.size()));
+      if (stream.bad())
+        return -1;
+      n = static_cast<std::size_t>(stream.gcount());
+      if (n == 0u)
+        return 0;
+      p = buf.data();
+    }
+    pos += n;
+    total += n;
+    return 1;
+  }
+  /**
+   * @return the number of bytes fetched so far
+   */
+  std::size_t count(void) const noexcept {
+    return total;
+  }
+};
+
+/**
+ * @brief Output file with a large write buffer.
+ */
+class tool_output {
+private:
+  std::ofstream stream;
+  std::size_t total;
+
+public:
+  std::vector<unsigned char> buf;
+
+public:
+  tool_output(void) : total(0u), buf(tool_chunk_size) {}
+  /**
+   * @brief Open an output file.
+   * @param name file name
+   * @return whether the file is ready for writing
+   */
+  bool open(std::string const& name) {
+    stream.open(name.c_str(), std::ios_base::out | std::ios_base::binary);
+    return static_cast<bool>(stream);
+  }
+  /**
+   * @brief Write the front of the output buffer.
+   * @param end end of the bytes to write
+   * @return whether the write succeeded
+   */
+  bool write(unsigned char const* end) {
+    std::size_t const n = static_cast<std::size_t>(end-buf.data());
+    stream.write(reinterpret_cast<char const*>(buf.data()),
+      static_cast<std::streamsize>(n));
+    total += n;
+    return !stream.bad();
+  }
+  /**
+   * @return the number of bytes written so far
+   */
+  std::size_t count(void) const noexcept {
+    return total;
+  }
+};
+
+/**
+ * @brief Parse the command line.
+ * @param[out] opts settings
+ * @param argc argument count
+ * @param argv argument values
+ * @return whether the command line is usable
+ */
+inline
+bool tool_parse_args(tool_options& opts, int argc, char** argv) {
+  int i;
+  opts.decode = false;
+  opts.stats = false;
+  opts.level = -1;
+  opts.block_size = 0u;
+  opts.window = 0u;
+  opts.chain_length = 0u;
+  for (i = 1; i < argc; ++i) {
+    char const* const arg = argv[i];
+    unsigned long* value = nullptr;
+    if (std::strcmp(arg, "-d") == 0) {
+      opts.decode = true;
+    } else if (std::strcmp(arg, "--stats") == 0) {
+      opts.stats = true;
+    } else if (std::strcmp(arg, "-l") == 0) {
+      if (i+1 >= argc)
+        return false;
+      char* end;
+      long const level = std::strtol(argv[++i], &end, 10);
+      if (*end != 0 || level < 0 || level > 9)
+        return false;
+      opts.level = static_cast<int>(level);
+    } else if (std::strcmp(arg, "-b") == 0) {
+      value = &opts.block_size;
+    } else if (std::strcmp(arg, "-w") == 0) {
+      value = &opts.window;
+    } else if (std::strcmp(arg, "-c") == 0) {
+      value = &opts.chain_length;
+    } else if (opts.ifilename.empty()) {
+      opts.ifilename = arg;
+    } else if (opts.ofilename.empty()) {
+      opts.ofilename = arg;
+    } else return false;
+    if (value) {
+      if (i+1 >= argc)
+        return false;
+      char* end;
+      errno = 0;
+      *value = std::strtoul(argv[++i], &end, 0);
+      if (*end != 0 || errno != 0 || *value == 0u)
+        return false;
+    }
+  }
+  return !(opts.ifilename.empty() || opts.ofilename.empty());
+}
+
+/**
+ * @brief Print the usage text.
+ * @param name tool name
+ * @param window_max largest accepted window size
+ */
+inline
+void tool_usage(char const* name, unsigned long window_max) {
+  std::cerr << "usage: " << name
+    << " [-d] [-l level] [-b block] [-w window] [-c chain] [--stats]"
+       " (input) (output)\n"
+       "  -d        decompress\n"
+       "  -l level  compression level, 0 (fast) to 9 (small); picks a hash\n"
+       "            chain length from 1 to 4096 (default 256, as level 7)\n"
+       "  -b block  bytes of input to process at once\n"
+       "  -w window sliding window size, at most " << window_max << "\n"
+       "  -c chain  maximum hash chain length; overrides the level\n"
+       "  --stats   report throughput, ratio and peak memory"
+    << std::endl;
+}
+
+/**
+ * @brief Choose a hash chain length.
+ * @param opts settings
+ * @return a chain length
+ * @note Both codecs shrink their output as the chain grows, with little
+ *   gain past 256, so levels share one table and the default is level 7.
+ */
+inline
+unsigned long tool_chain_length(tool_options const& opts) {
+  static unsigned long const level_chains[10] = {
+      1u, 4u, 8u, 16u, 32u, 64u, 128u, 256u, 1024u, 4096u
+    };
+  if (opts.chain_length)
+    return opts.chain_length;
+  else if (opts.level >= 0)
+    return level_chains[opts.level];
+  else return level_chains[7];
+}
+
+/**
+ * @brief Query the peak resident memory of this process.
+ * @return a size in bytes, or zero if unknown
+ */
+inline
+std::size_t tool_peak_memory(void) {
+#if (defined TCMPLXAP_TOOL_RUSAGE)
+  struct rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0u;
+#  if (defined(__APPLE__)&&defined(__MACH__))
+  return static_cast<std::size_t>(usage.ru_maxrss);
+#  else
+  return static_cast<std::size_t>(usage.ru_maxrss)*1024u;
+#  endif /*__APPLE__*/
+#else
+  return 0u;
+#endif /*TCMPLXAP_TOOL_RUSAGE*/
+}
+
+/**
+ * @brief Print a statistics report.
+ * @param in_count bytes read
+ * @param out_count bytes written
+ * @param seconds time spent converting
+ */
+inline
+void tool_print_stats
+  (std::size_t in_count, std::size_t out_count, double seconds)
+{
+  double const mb = static_cast<double>(in_count)/1048576.0;
+  std::size_t const peak = tool_peak_memory();
+  std::cerr << "input:   " << in_count << " bytes\n"
+    << "output:  " << out_count << " bytes\n"
+    << "ratio:   ";
+  if (in_count > 0u)
+    std::cerr << static_cast<double>(out_count)/static_cast<double>(in_count);
+  else std::cerr << "n/a";
+  std::cerr << "\ntime:    " << seconds << " s\n"
+    << "speed:   ";
+  if (seconds > 0.0)
+    std::cerr << mb/seconds << " MB/s";
+  else std::cerr << "n/a";
+  std::cerr << "\npeak:    ";
+  if (peak > 0u)
+    std::cerr << (static_cast<double>(peak)/1048576.0) << " MB";
+  else std::cerr << "n/a";
+  std::cerr << std::endl;
+}
+
+#endif /*hg_TCMPLXAP_TOOLS_TOOL_Hpp_*/
@@ -1,42 +1,42 @@
 
 #include <text-complex-plus/access/zcvt.hpp>
+#include "tca_tool.hpp"
 #include <iostream>
-#include <fstream>
 #include <string>
 #include <cstdlib>
 #include <cstring>
 
 static
-int do_in(std::istream& in, std::ostream& out) {
-  unsigned char inbuf[256];
-  unsigned char outbuf[256];
+int do_in(tool_input& in, tool_output& out, tool_options const& opts) {
   int ec = EXIT_SUCCESS;
   namespace tca = text_complex::access;
   tca::zcvt_state state(1, 32768, 1);
+  unsigned char* const outbuf = out.buf.data();
+  unsigned char* const outbuf_end = outbuf+out.buf.size();
+  (void)opts;
   while (ec == EXIT_SUCCESS) {
-    if (in.eof())
+    unsigned char const* inbuf;
+    std::size_t in_count;
+    int const next_res = in.next(inbuf, in_count);
+    if (next_res == 0)
       break;
-    else if (in.fail()) {
+    else if (next_res < 0) {
       ec = EXIT_FAILURE;
+      std::cerr << "error from file read" << std::endl;
       break;
     }
-    in.read(reinterpret_cast<char*>(inbuf), 256);
-    std::streamsize const in_count = in.gcount();
     unsigned char const* src;
     for (src = inbuf; ec == EXIT_SUCCESS && src < inbuf+in_count; ) {
       unsigned char* dst;
       tca::api_error res = tca::zcvt_in
-        (state, src, inbuf+in_count, src, outbuf, outbuf+256, dst);
+        (state, src, inbuf+in_count, src, outbuf, outbuf_end, dst);
       if (res < tca::api_error::Success) {
         ec = EXIT_FAILURE;
         std::cerr << "error code from conversion:\n\t"
           <<tca::api_error_toa(res) << std::endl;
-      } else {
-        out.write(reinterpret_cast<char*>(outbuf), dst-outbuf);
-        if (!out) {
-          ec = EXIT_FAILURE;
-          std::cerr << "error from file write" << std::endl;
-        }
+      } else if (!out.write(dst)) {
+        ec = EXIT_FAILURE;
+        std::cerr << "error from file write" << std::endl;
       }
     }
   }
@@ -44,39 +44,40 @@ int do_in(std::istream& in, std::ostream& out) {
 }
 
 static
-int do_out(std::istream& in, std::ostream& out) {
-  unsigned char inbuf[256];
-  unsigned char outbuf[256];
+int do_out(tool_input& in, tool_output& out, tool_options const& opts) {
   int ec = EXIT_SUCCESS;
   bool done = false;
   namespace tca = text_complex::access;
-  tca::zcvt_state state(sizeof(inbuf), 32768, 1);
+  tca::zcvt_state state(
+      static_cast<tca::uint32>(opts.block_size ? opts.block_size : 65535u),
+      static_cast<tca::uint32>(opts.window ? opts.window : 32768u),
+      tool_chain_length(opts));
+  unsigned char* const outbuf = out.buf.data();
+  unsigned char* const outbuf_end = outbuf+out.buf.size();
   while (ec == EXIT_SUCCESS) {
-    if (in.eof())
+    unsigned char const* inbuf;
+    std::size_t in_count;
+    int const next_res = in.next(inbuf, in_count);
+    if (next_res == 0)
       break;
-    else if (in.fail()) {
+    else if (next_res < 0) {
       ec = EXIT_FAILURE;
+      std::cerr << "error from file read" << std::endl;
       break;
     }
-    in.read(reinterpret_cast<char*>(inbuf), 256);
-    std::streamsize const in_count = in.gcount();
     for (unsigned char const* src = inbuf;
       ec == EXIT_SUCCESS && src<inbuf+in_count; )
     {
       unsigned char* dst;
       tca::api_error const res = tca::zcvt_out
-        (state, src, inbuf+in_count, src,
-        outbuf, outbuf+sizeof(outbuf), dst);
-      if (res < tca::api_error::Success || dst == outbuf) {
+        (state, src, inbuf+in_count, src, outbuf, outbuf_end, dst);
+      if (res < tca::api_error::Success) {
         ec = EXIT_FAILURE;
         std::cerr << "error code from conversion:\n\t"
           << tca::api_error_toa(res) << std::endl;
-      } else {
-        out.write(reinterpret_cast<char*>(outbuf), dst-outbuf);
-        if (out.bad()) {
-          ec = EXIT_FAILURE;
-          std::cerr << "error from file write" << std::endl;
-        }
+      } else if (!out.write(dst)) {
+        ec = EXIT_FAILURE;
+        std::cerr << "error from file write" << std::endl;
       }
     }
   }
@@ -84,15 +85,13 @@ int do_out(std::istream& in, std::ostream& out) {
     return ec;
   while (ec == EXIT_SUCCESS && !done) {
     unsigned char* dst;
-    tca::api_error res = tca::zcvt_unshift(state, outbuf,
-      outbuf+sizeof(outbuf), dst);
+    tca::api_error res = tca::zcvt_unshift(state, outbuf, outbuf_end, dst);
     if (res < tca::api_error::Success) {
       ec = EXIT_FAILURE;
       std::cerr << "error code from conclusion:\n\t"
         << tca::api_error_toa(res) << std::endl;
     } else {
-      out.write(reinterpret_cast<char*>(outbuf), dst-outbuf);
-      if (out.bad()) {
+      if (!out.write(dst)) {
         ec = EXIT_FAILURE;
         std::cerr << "error from file write" << std::endl;
       }
@@ -103,36 +102,33 @@ int do_out(std::istream& in, std::ostream& out) {
 }
 
 int main(int argc, char**argv) {
-  std::string ifilename;
-  std::string ofilename;
-  bool tozs = true;
-  /* */{
-    int i;
-    for (i = 1; i < argc; ++i) {
-      if (std::strcmp(argv[i], "-d") == 0) {
-        tozs = false;
-      } else if (ifilename.empty()) {
-        ifilename = argv[i];
-      } else if (ofilename.empty()) {
-        ofilename = argv[i];
-      }
-    }
-    if (ifilename.empty() || ofilename.empty()) {
-      std::cerr << "usage: tcmplx_access_zcvt [-d] (input) (output)"
-        << std::endl;
-      return EXIT_FAILURE;
-    }
+  tool_options opts;
+  /* stored blocks hold at most 65535 bytes */
+  if (!tool_parse_args(opts, argc, argv)
+  ||  opts.window > 32768u || opts.block_size > 65535u)
+  {
+    tool_usage("tcmplx_access_zcvt", 32768u);
+    return EXIT_FAILURE;
   }
-  std::ifstream ifile
-    (ifilename.c_str(), std::ios_base::in | std::ios_base::binary);
-  std::ofstream ofile
-    (ofilename.c_str(), std::ios_base::out | std::ios_base::binary);
-  if (ifile && ofile) {
-    return tozs ? do_out(ifile, ofile) : do_in(ifile, ofile);
+  tool_input ifile;
+  tool_output ofile;
+  bool const ifile_ok = ifile.open(opts.ifilename);
+  bool const ofile_ok = ofile.open(opts.ofilename);
+  if (ifile_ok && ofile_ok) {
+    std::chrono::steady_clock::time_point const start =
+      std::chrono::steady_clock::now();
+    int const ec = opts.decode
+      ? do_in(ifile, ofile, opts) : do_out(ifile, ofile, opts);
+    if (opts.stats) {
+      std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - start;
+      tool_print_stats(ifile.count(), ofile.count(), elapsed.count());
+    }
+    return ec;
   } else {
-    if (!ifile)
+    if (!ifile_ok)
       std::cerr << "failed to open input file" << std::endl;
-    if (!ofile)
+    if (!ofile_ok)
       std::cerr << "failed to open output file" << std::endl;
     return EXIT_FAILURE;
   }